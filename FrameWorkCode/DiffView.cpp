@@ -15,6 +15,7 @@
 #include <Project.h>
 #include <QMessageBox>
 #include "crashlog.h"
+#include <QThread>
 
 
 /*!
@@ -41,8 +42,19 @@ DiffView::DiffView(QWidget *parent, QString page,QString fpath)
      if(fverifier.exists())
      {
        isValidFile = true;
+       setAttribute(Qt::WA_DeleteOnClose);
+
+       //! Diffs are computed on a worker thread so that Next/Prev never block the window
+       mCompareThread = new QThread(this);
+       mComparer = new ComparisonService(ComparisonService::VerifierCompare, gDirTwoLevelUp);
+       mComparer->moveToThread(mCompareThread);
+       connect(mCompareThread, SIGNAL(finished()), mComparer, SLOT(deleteLater()));
+       connect(this, SIGNAL(comparisonRequested(QString)), mComparer, SLOT(compare(QString)));
+       connect(this, SIGNAL(prefetchRequested(QStringList)), mComparer, SLOT(prefetch(QStringList)));
+       connect(mComparer, SIGNAL(ready(QString, PageComparison)), this, SLOT(comparisonReady(QString, PageComparison)));
+       mCompareThread->start();
+
        Load_comparePage(page.toStdString());
-       UpdateUI();
      }
      else{
           isValidFile = false;
@@ -56,6 +68,11 @@ DiffView::DiffView(QWidget *parent, QString page,QString fpath)
  */
 DiffView::~DiffView()
 {
+    if (mCompareThread)
+    {
+        mCompareThread->quit();
+        mCompareThread->wait();
+    }
     delete ui;
 }
 
@@ -72,153 +89,46 @@ bool DiffView::validFilePath()
 /*!
  * \fn DiffView::Load_comparePage
  * \param page
- * \brief For the currently opened page, the function fetches - initial text, corrector text and verifier text
- * and produces a final color coded text representing changes. The metrics are also calculated such as
- * change percentage and accuracy.
- * \sa LevenshteinWithGraphemes(),GetGraphemesCount(), diff_main(), diff_prettyHtml()
+ * \brief For the currently opened page, asks the ComparisonService for the initial text, corrector text and verifier
+ * text color coded with the changes and for the metrics such as change percentage and accuracy.
+ * \details The comparison runs on the service's thread; comparisonReady() shows it.
+ * \sa ComparisonService, comparisonReady()
  */
 void DiffView::Load_comparePage(string page)
 {
-    QString qs1="", qs2="",qs3="";
-    QMessageBox msgBox;
-
-    //! Open a Verifier's Output File
-    QString file = gDirTwoLevelUp + "/VerifierOutput/" + QString::fromStdString(page);
+    emit comparisonRequested(QString::fromStdString(page));
+}
 
-    //! Opens corresponding Corrector's Output and OCR text file
-    if(!file.isEmpty())
+/*!
+ * \fn DiffView::comparisonReady
+ * \brief Shows a comparison made by the ComparisonService if it is for the current page and prefetches the
+ * neighbouring pages.
+ * \param page
+ * \param result
+ */
+void DiffView::comparisonReady(QString page, PageComparison result)
+{
+    if (page.toStdString() != pageNo)
+        return;
+    if (!result.error.isEmpty())
     {
-        QString verifierText = file;
-        QString correctorText = file.replace("VerifierOutput","CorrectorOutput"); //CAN CHANGE ACCORDING TO FILE STRUCTURE
-        QString ocrText = file.replace("CorrectorOutput","Inds"); //CAN CHANGE ACCORDING TO FILE STRUCTURE
-        ocrText.replace(".html",".txt");
-
-        //! Reads OCR text file
-        if(!ocrText.isEmpty())
-        {
-            QFile sFile(ocrText);
-            if(sFile.open(QFile::ReadOnly | QFile::Text))
-            {
-                QTextStream in(&sFile);
-                in.setCodec("UTF-8");
-                qs1 = in.readAll().replace(" \n","\n");
-
-                //! Displays an error if OCR text file is empty
-                if(qs1=="")
-                {
-                    msgBox.setText("Error in Displaying File: "+ ocrText + "is Empty");
-                    msgBox.exec();
-                    return;
-                }
-                sFile.close();
-            }
-        }
-
-        //! Reads Corrector's Output file
-        if(!correctorText.isEmpty())
-        {
-            QFile sFile(correctorText);
-            if(sFile.open(QFile::ReadOnly | QFile::Text))
-            {
-                QTextStream in(&sFile);
-                in.setCodec("UTF-8");
-                qs2 = in.readAll();
-
-                //! Displays an error if Corrector's Output file is empty
-                if(qs2=="")
-                {
-                    msgBox.setText("Error in Displaying File: "+ correctorText + "is Empty");
-                    msgBox.exec();
-                    return;
-                }
-                sFile.close();
-            }
-        }
-
-        //! Reads Verifier's Output file
-        if(!verifierText.isEmpty())
-        {
-            QFile sFile(verifierText);
-            if(sFile.open(QFile::ReadOnly | QFile::Text))
-            {
-                QTextStream in(&sFile);
-                in.setCodec("UTF-8");
-                qs3 = in.readAll();
-
-                 //! Displays an error if Verifier's Output file is empty
-                if(qs3=="")
-                {
-                    msgBox.setText("Error in Displaying File: "+ verifierText + "is Empty");
-                    msgBox.exec();
-                    return;
-                }
-                sFile.close();
-            }
-        }
-
-        QTextDocument doc;
-
-        doc.setHtml(qs2);
-        qs2 = doc.toPlainText().replace(" \n","\n");
-
-        doc.setHtml(qs3);
-        qs3 = doc.toPlainText().replace(" \n","\n");
-
-        int l1,l2,l3, DiffOcr_Corrector,DiffCorrector_Verifier,DiffOcr_Verifier;
-        float ocrErrorPerc;
-
-        l1 = mProject.GetGraphemesCount(qs1); l2 = mProject.GetGraphemesCount(qs2); l3 = mProject.GetGraphemesCount(qs3);
-
-        diff_match_patch dmp;
-
-        //! Calculates the percentage of changes made by the corrector in OCR text file
-        auto diffs1 = dmp.diff_main(qs1,qs2);
-        DiffOcr_Corrector = mProject.LevenshteinWithGraphemes(diffs1);
-        correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l2)*100;
-        if(correctorChangesPerc>100) correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l1)*100;
-        correctorChangesPerc = (((float)lround(correctorChangesPerc*100))/100);
-
-        //! Calculates the percentage of changes made by the verifier in Corrector's Output file
-        auto diffs2 = dmp.diff_main(qs2,qs3);
-        DiffCorrector_Verifier = mProject.LevenshteinWithGraphemes(diffs2);
-        verifierChangesPerc = ((float)(DiffCorrector_Verifier)/(float)l3)*100;
-        if(verifierChangesPerc>100) verifierChangesPerc = ((float)(DiffCorrector_Verifier)/(float)l2)*100;
-        verifierChangesPerc = (((float)lround(verifierChangesPerc*100))/100);
-
-        //! Calculates the accuracy of OCR text w.r.t. Verified text
-        auto diffs3 = dmp.diff_main(qs1,qs3);
-        DiffOcr_Verifier = mProject.LevenshteinWithGraphemes(diffs3);
-        ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l3)*100;
-        if(ocrErrorPerc>100) ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l1)*100;
-        OcrAcc = 100 - (((float)lround(ocrErrorPerc*100))/100);
-
-        doc.setHtml(qs1);
-        QString interntext = doc.toPlainText();
-
-        doc.setHtml(qs2);
-        QString ocrtext = doc.toPlainText();
-
-        doc.setHtml(qs3);
-        QString verifiertext = doc.toPlainText();
-
-        //!Displays changes by color coding
-        auto diffs = dmp.diff_main(ocrtext,interntext);
-        QString textcolor = "ffd13d";
-        QList<QString> htmlList1 = dmp.diff_prettyHtml(diffs, textcolor);
-        html1 = htmlList1.first();
-        html2 = htmlList1.last();
-
-        diffs = dmp.diff_main(interntext,verifiertext);
-        textcolor = "90ff90";
-        QList<QString> htmlList2 = dmp.diff_prettyHtml(diffs, textcolor);
-        html3 = htmlList2.first();
-        html1.remove("&para;");
-        html2.remove("&para;");
-        html3.remove("&para;");
-        QString title = "Compare Verifier Output " + QString::fromStdString(page) ;
-
-        setWindowTitle(title); //sets window title
-     }
+        QMessageBox msgBox;
+        msgBox.setText(result.error);
+        msgBox.exec();
+        return;
+    }
+    html1 = result.html1;
+    html2 = result.html2;
+    html3 = result.html3;
+    correctorChangesPerc = result.correctorChangesPerc;
+    verifierChangesPerc = result.verifierChangesPerc;
+    OcrAcc = result.ocrAcc;
+
+    QString title = "Compare Verifier Output " + page;
+    setWindowTitle(title); //sets window title
+    UpdateUI();
+
+    emit prefetchRequested(ComparisonService::neighbours(page));
 }
 
 /*!
@@ -268,8 +178,7 @@ void DiffView::on_PrevButton_clicked()
          if(fverifier.exists())
          {
            pageNo.replace(loc,no.size(),to_string(stoi(no) - 1)); //Decrement the page number
-           Load_comparePage(pageNo); // get the text and metrics
-           UpdateUI();               // Update the Ui
+           Load_comparePage(pageNo); // get the text and metrics, the Ui is updated when they are ready
          }
          else{
              return ;
@@ -300,8 +209,7 @@ void DiffView::on_NextButton_clicked()
      if(fverifier.exists())
      {
        pageNo.replace(loc,no.size(),to_string(stoi(no) + 1)); //Increment the page number
-       Load_comparePage(pageNo);   // get the text and metrics
-       UpdateUI();                 // Update the Ui
+       Load_comparePage(pageNo);   // get the text and metrics, the Ui is updated when they are ready
      }
      else{
          return ;
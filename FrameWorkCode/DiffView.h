@@ -3,8 +3,11 @@
 #include <Project.h>
 #include <qlist.h>
 #include <diff_match_patch.h>
+#include "comparisonservice.h"
 #include <string>
 
+class QThread;
+
 using namespace std;
 namespace Ui { class DiffView; };
 
@@ -22,6 +25,11 @@ private slots:
     void on_PrevButton_clicked();
     void Load_comparePage(string page);
     void on_NextButton_clicked();
+    void comparisonReady(QString page, PageComparison result);
+
+signals:
+    void comparisonRequested(QString page);
+    void prefetchRequested(QStringList pages);
 
 private:
 	Ui::DiffView *ui;
@@ -35,4 +43,6 @@ private:
     float correctorChangesPerc;
     float OcrAcc;
     bool isValidFile;
+    ComparisonService *mComparer = nullptr;
+    QThread *mCompareThread = nullptr;
 };
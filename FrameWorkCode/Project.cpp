@@ -28,6 +28,8 @@
 #include <QDialogButtonBox>
 #include <QFormLayout>
 #include <QJsonObject>
+#include <vector>
+#include "tracer.h"
 
 QString user_id;
 std::string user, pass, email;
@@ -174,6 +176,7 @@ void Project::removeFile(QModelIndex & idx,Filter & pFilter, QFile & pFile)
     mTreeModel->layoutAboutToBeChanged();
     TreeItem * item = (TreeItem*)idx.internalPointer();
     auto parent = item->parentItem();
+    mSearchIndex.remove(parent, idx.row());
     mTreeModel->RemoveRow(idx.row(), 1, idx.parent());
     parent->RemoveNode(item);
 
@@ -184,22 +187,32 @@ void Project::removeFile(QModelIndex & idx,Filter & pFilter, QFile & pFile)
 
 /*!
  * \fn Project::process_node
- * \brief Here we process the nodes of the xml file by recursive iteration. Refer inline comments for more info.
+ * \brief Here we process the nodes of the xml file. Refer inline comments for more info.
+ * \details The node and its following siblings are walked with an explicit stack instead of one recursion level
+ * per sibling, so a set with thousands of File nodes doesn't run deep on the call stack.
  * \param pNode
  * \param parent
  */
 void Project::process_node(pugi::xml_node * pNode, TreeItem * parent)
 {
+    if (!pNode) {
+        setProjectOpen(false);
+        return;
+    }
 
-    if (pNode) {
-
+    std::vector<pugi::xml_node> pending;
+    pending.push_back(*pNode);
+    while (!pending.empty()) {
+        pugi::xml_node node = pending.back();
+        pending.pop_back();
+        if (!node)
+            continue;
 
-        //! If the name of the node is "ItemGroup" then we get the child name and recursively traverse it
-        std::string node_name = pNode->name();
+        //! If the name of the node is "ItemGroup" then we get the child name and traverse it
+        std::string node_name = node.name();
         if (node_name == "ItemGroup")
         {
-            pugi::xml_node p = pNode->first_child();
-            process_node(&p, parent);
+            pending.push_back(node.first_child());
         }
 
         /*! If the name of the node is "Filter" then we get the name of the filter, if this node has no child then
@@ -208,7 +221,7 @@ void Project::process_node(pugi::xml_node * pNode, TreeItem * parent)
          *  We push the filter into class variable mFilters and also create a new treeItem object with the
          *  parent.
          *
-         *  We then append the node to the parent as a child and we recursively traverse child nodes.
+         *  We then append the node to the parent as a child and continue with the next sibling.
          *
          */
         else if (node_name == "Filter")
@@ -219,8 +232,8 @@ void Project::process_node(pugi::xml_node * pNode, TreeItem * parent)
                  </Filter>
             */
 
-            std::string filter_name = pNode->attribute("Include").as_string();;
-            auto ch = pNode->child("Extensions");
+            std::string filter_name = node.attribute("Include").as_string();
+            auto ch = node.child("Extensions");
             if(!ch) setProjectOpen(false);
             std::string filter_exts =  ch.child_value();
 
@@ -228,21 +241,18 @@ void Project::process_node(pugi::xml_node * pNode, TreeItem * parent)
             mFilters.push_back(filter);
             QString str;
             str = str.fromStdString(filter_name);
-            //mFilters.push_back(filter_name);
             TreeItem * filter_node = new TreeItem(str, NodeType::FILTER, parent);
             filter_node->SetFilter(filter);
             parent->append_child(filter_node);
-            auto p = pNode->next_sibling();
-            process_node(&p, parent);
+            mFilterNodes.insert(str, filter_node);
+            mSearchIndex.append(parent, str);
+            pending.push_back(node.next_sibling());
         }
 
-        /*! If the name of the node is "File" then we do filter processing and scan through the files and add it
-         *  to the tree item.
-         *
-         *  We append the nodefile to the parent as a child and recursively traverse the children
+        /*! If the name of the node is "File" then we add the file to the folder of its filter and continue with
+         *  the next sibling. The folder creates the TreeItem of the file only once it is expanded.
          *
          */
-
         else if (node_name == "File")
         {
             /*
@@ -251,23 +261,15 @@ void Project::process_node(pugi::xml_node * pNode, TreeItem * parent)
                     <Filter>Image</Filter>
                 </File>
             */
-            std::string filtername = pNode->child("Filter").child_value();
-            QString qfilter;
-            qfilter = qfilter.fromStdString(filtername);
-            auto node = mRoot->find(qfilter);
-            QString filepath = QString(pNode->attribute("Include").value());
-
-            QString fpath = "";
-            fpath = mProjectDir.absolutePath()+ "/" + filepath;
-            QFileInfo fileinfo(fpath);
-            QFile *f = new QFile(fpath);
-            mFiles.push_back(f);
-            auto filename = fileinfo.fileName();
-            TreeItem *nodefile = new TreeItem(filename, _FILETYPE, node);
-            node->append_child(nodefile);
-            nodefile->SetFile(f);
-            auto p = pNode->next_sibling();
-            process_node(&p, parent);
+            QString qfilter = QString::fromStdString(node.child("Filter").child_value());
+            TreeItem * folder = mFilterNodes.value(qfilter);
+            if (!folder)
+                folder = mRoot->find(qfilter);
+            QString filepath = QString(node.attribute("Include").value());
+            QString fpath = mProjectDir.absolutePath()+ "/" + filepath;
+            if (folder)
+                appendFile(folder, QFileInfo(fpath).fileName(), fpath, folder->GetFilter());
+            pending.push_back(node.next_sibling());
         }
         /*! If the name of the node is "Metadata" then we check if the stage is corrector or verifier. If none
          *  of the condition holds then we set the flag setOpenProject to false to make the project unopenable.
@@ -275,14 +277,41 @@ void Project::process_node(pugi::xml_node * pNode, TreeItem * parent)
          */
         else if (node_name == "Metadata")
         {
-            QString stage = pNode->child("Stage").child_value();
+            QString stage = node.child("Stage").child_value();
             if (stage != "Corrector" && stage != "Verifier")
                 setProjectOpen(false);
         }
     }
-    else {
-        setProjectOpen(false); // otherwise we set project open to true
-    }
+}
+
+/*!
+ * \fn Project::appendFile
+ * \brief Adds a file to a folder of the tree. Until the folder has been expanded only its name and path are kept.
+ * \param folder
+ * \param name Display name
+ * \param path Absolute path of the file
+ * \param filter
+ * \param notify If false the caller emits layoutChanged() itself, once for a whole batch
+ * \return true if the view has to be told about the change
+ */
+bool Project::appendFile(TreeItem * folder, const QString & name, const QString & path, Filter * filter, bool notify)
+{
+    mSearchIndex.append(folder, name);
+    bool changed;
+    if (folder->is_fetched()) {
+        QString itemName = name;
+        TreeItem * f = new TreeItem(itemName, NodeType::_FILETYPE, folder);
+        f->SetFilePath(path);
+        f->SetFilter(filter);
+        folder->append_child(f);
+        changed = true;
+    } else {
+        folder->append_pending(name, path, filter);
+        //! Only the first pending file changes what the view shows: the folder becomes expandable
+        changed = folder->pending_count() == 1;
+    }
+    if (notify && changed && mTreeModel) mTreeModel->layoutChanged();
+    return changed;
 }
 
 /*!
@@ -295,6 +324,8 @@ void Project::process_xml(QFile & pFile)
 {
     if (mTreeModel)delete mTreeModel;
     /*if (mRoot) delete mRoot;*/
+    mSearchIndex.clear();
+    mFilterNodes.clear();
     setProjectOpen(true);
     pFile.open(QIODevice::ReadOnly);
     QFileInfo info;
@@ -377,7 +408,9 @@ void Project::addFile(Filter &f,QFile & pFile)
  */
 void Project::AddTemp(Filter * filter, QFile & file,QString prefix) {
     QString name = filter->name();
-    TreeItem * t = mRoot->find(name);
+    TreeItem * t = mFilterNodes.value(name);
+    if (!t)
+        t = mRoot->find(name);
     QFileInfo finfo(file.fileName());
 
     // Add only required files(ingore all except html and txt) to the tree view
@@ -388,14 +421,69 @@ void Project::AddTemp(Filter * filter, QFile & file,QString prefix) {
     }
 
     QString fileName = prefix+finfo.fileName();
-    TreeItem * f = new TreeItem(fileName,NodeType::_FILETYPE,t);
-    QFile * filep = new QFile(file.fileName());
-    mFiles.push_back(filep);
-    f->SetFile(filep);
-    Filter * filtr = new Filter();
-    f->SetFilter(filter);
-    t->append_child(f);
-    mTreeModel->layoutChanged();
+    appendFile(t, fileName, file.fileName(), filter);
+}
+
+/*!
+ * \fn Project::AddTemp
+ * \brief Adds a batch of files reported by the DirectoryWatcher to the folder of filter with a single view update.
+ * \param filter
+ * \param paths Absolute paths of the files
+ */
+void Project::AddTemp(Filter * filter, const QStringList & paths)
+{
+    QString name = filter->name();
+    TreeItem * t = mFilterNodes.value(name);
+    if (!t)
+        t = mRoot->find(name);
+    if (!t)
+        return;
+    bool changed = false;
+    for (const QString & path : paths) {
+        QFileInfo finfo(path);
+        QString suff = finfo.completeSuffix();
+        if (name == "Document" && suff != "txt" && suff != "html")
+            continue;
+        changed |= appendFile(t, finfo.fileName(), path, filter, false);
+    }
+    if (changed && mTreeModel) mTreeModel->layoutChanged();
+}
+
+/*!
+ * \fn Project::RemoveTemp
+ * \brief Removes files that were deleted from disk from the folder of filter with a single view update.
+ *        project.xml is not touched, the folders shown through AddTemp() aren't listed there.
+ * \param filter
+ * \param names File names as shown in the tree
+ */
+void Project::RemoveTemp(Filter * filter, const QStringList & names)
+{
+    QString name = filter->name();
+    TreeItem * t = mFilterNodes.value(name);
+    if (!t)
+        t = mRoot->find(name);
+    if (!t || names.isEmpty())
+        return;
+    if (mTreeModel) mTreeModel->layoutAboutToBeChanged();
+    for (const QString & fileName : names) {
+        if (!t->is_fetched()) {
+            int pos = t->remove_pending(fileName);
+            if (pos >= 0)
+                mSearchIndex.remove(t, t->child_count() + pos);
+            continue;
+        }
+        for (int row = 0; row < t->child_count(); row++) {
+            TreeItem * item = t->child(row);
+            if (item->data(0).toString() != fileName)
+                continue;
+            mSearchIndex.remove(t, row);
+            if (mTreeModel) mTreeModel->RemoveRow(row, 1, mTreeModel->indexFor(t));
+            t->RemoveNode(item);
+            delete item;
+            break;
+        }
+    }
+    if (mTreeModel) mTreeModel->layoutChanged();
 }
 
 /*!
@@ -442,6 +530,21 @@ TreeModel * Project::getModel()
     return mTreeModel;
 }
 
+/*!
+ * \fn Project::searchTree
+ * \brief Selects the items of the project tree whose name contains text.
+ * \param text
+ * \param pageHit If text is a page number, set to the first file of that page
+ * \return QItemSelection to apply in one call
+ * \sa TreeSearchIndex
+ */
+QItemSelection Project::searchTree(const QString &text, QModelIndex *pageHit)
+{
+    if (!mTreeModel)
+        return QItemSelection();
+    return mSearchIndex.select(mTreeModel, mRoot, text, pageHit);
+}
+
 /*!
  * \fn make_opts
  * \brief Used to set Git options. Refer to git docs for more information
@@ -705,9 +808,10 @@ void Project::set_verifier(){
  * \return bool
  */
 bool Project::push(QString gDirTwoLevelUp) {
+    TRACE_SCOPE("Project::push");
     QString branchName;
     QString gDir = gDirTwoLevelUp+"/.git/config";
-    lg2_add();
+    //! Nothing is staged here: the caller commits first, either with commit() or by flushing the CommitQueue
     git_libgit2_init();
     login_tries = 1;
     git_remote * remote = NULL;
@@ -939,6 +1043,7 @@ static int transfer_progress_cb(const git_transfer_progress *stats, void *payloa
  */
 int Project::fetch(QString gDirTwoLevelUp)
 {
+    TRACE_SCOPE("Project::fetch");
     int error = 0;
     git_remote *remote = NULL;
     //	const git_indexer_progress *stats;
@@ -1056,94 +1161,99 @@ cleanup:
 
 /*!
  * \fn Project::commit
- * \brief This function commits the changes done to the local repository.
+ * \brief This function stages the whole working tree and commits it to the local repository.
+ * \details The commit history entry is posted without blocking the caller.
  * \param message
  * \return bool
+ * \sa lg2_add(), commit_index(), post_commit_history()
  */
 bool Project::commit(std::string message)
 {
-    lg2_common lg2;
     lg2_add();
-    git_signature *sig;
-    git_index *index;
-    git_oid tree_id, commit_id;
-    git_tree *tree;
+    QString sha;
+    if (!commit_index(message, &sha))
+        return 0;
+    post_commit_history(sha);
+    return 1;
+}
 
+/*!
+ * \fn Project::commit_index
+ * \brief Creates a commit on HEAD from whatever is currently staged in the index.
+ * \details Nothing is staged and no network request is made here, so this function is safe to call from
+ * the CommitQueue thread. Errors are logged instead of being shown in a message box for the same reason.
+ * \param message
+ * \param sha Receives the full hash of the new commit when not null
+ * \return bool
+ */
+bool Project::commit_index(std::string message, QString *sha)
+{
+    TRACE_SCOPE("Project::commit_index");
+    git_signature *sig = NULL;
+    git_index *index = NULL;
+    git_oid tree_id, commit_id;
+    git_tree *tree = NULL;
     git_object *parent = NULL;
     git_reference *ref = NULL;
-    /** First use the config to initialize a commit signature for the user. */
-    //check_lg2(git_signature_default(&sig, repo),"Unable to create a commit signature.","Perhaps 'user.name' and 'user.email' are not set");
-    int klass = lg2.check_lg2(git_signature_now(&sig, mName.c_str(), mEmail.c_str()),"Could not create signature","");
-    if (klass > 0) {
-        //        if(sig)
-        //            git_signature_free(sig);
-        return 0;
-    }
+    bool ok = false;
 
-    klass = lg2.check_lg2(git_revparse_ext(&parent, &ref, repo, "HEAD"),"Head not found","");
-    if (klass > 0)
-    {
-        return 0;
+    if (git_signature_now(&sig, mName.c_str(), mEmail.c_str()) < 0) {
+        qDebug() << "Could not create signature";
+        goto cleanup;
     }
-    /* Now let's create an empty tree for this commit */
-
-    klass = lg2.check_lg2(git_repository_index(&index, repo), "Could not open repository index", "");
-    if (klass > 0) {
-        return 0;
+    if (git_revparse_ext(&parent, &ref, repo, "HEAD") < 0) {
+        qDebug() << "Head not found";
+        goto cleanup;
     }
-
-    /**
-     * Outside of this example, you could call git_index_add_bypath()
-     * here to put actual files into the index.  For our purposes, we'll
-     * leave it empty for now.
-     */
-
-    klass = lg2.check_lg2(git_index_write_tree(&tree_id, index), "Could not write tree", "");;
-    if (klass > 0)
-    {
-        return 0;
+    if (git_repository_index(&index, repo) < 0) {
+        qDebug() << "Could not open repository index";
+        goto cleanup;
     }
-
-    klass = lg2.check_lg2(git_index_write(index), "Could not write index", "");;
-    if (klass > 0)
-    {
-        return 0;
+    if (git_index_write_tree(&tree_id, index) < 0 || git_index_write(index) < 0) {
+        qDebug() << "Could not write index";
+        goto cleanup;
     }
-
-    klass = lg2.check_lg2(git_tree_lookup(&tree, repo, &tree_id), "Error looking up tree", "");
-    if (klass > 0)
-    {
-        return 0;
+    if (git_tree_lookup(&tree, repo, &tree_id) < 0) {
+        qDebug() << "Error looking up tree";
+        goto cleanup;
     }
-
-    klass = lg2.check_lg2(git_signature_now(&sig, mName.c_str(), mEmail.c_str()), "Error creating signature", "");
-    if (klass > 0) {
-        return 0;
+    if (git_commit_create_v(&commit_id, repo, "HEAD", sig, sig, NULL, message.c_str(), tree, parent ? 1 : 0, parent) < 0) {
+        qDebug() << "Could not create commit";
+        goto cleanup;
+    }
+    ok = true;
+    if (sha) {
+        char fullsha[42] = {0};
+        git_oid_tostr(fullsha, 41, &commit_id);
+        *sha = QString::fromStdString(fullsha);
     }
 
-    /**
-     * Ready to create the initial commit.
-     *
-     * Normally creating a commit would involve looking up the current
-     * HEAD commit and making that be the parent of the initial commit,
-     * but here this is the first commit so there will be no parent.
-     */
-
-    klass = lg2.check_lg2(git_commit_create_v(&commit_id, repo, "HEAD", sig, sig, NULL, message.c_str(), tree, parent ? 1 : 0, parent), "Could not create commit", "");
-    if (klass > 0) {
-        git_tree_free(tree);
-        git_signature_free(sig);
-        git_index_free(index);
-        return 0;
+cleanup:
+    if (!ok) {
+        const git_error* err = giterr_last();
+        if (err)
+            qDebug() << "Error:" << err->message;
     }
-    char fullsha[42] = {0};
-    git_oid_tostr(fullsha, 41, &commit_id);
-    QString sha = QString::fromStdString(fullsha);
-    //    qDebug()<<"Last commit full hash :"<<sha;
+    git_tree_free(tree);
+    git_index_free(index);
+    git_object_free(parent);
+    git_reference_free(ref);
+    git_signature_free(sig);
+    return ok;
+}
+
+/*!
+ * \fn Project::post_commit_history
+ * \brief Saves the commit entry in the commit history table ( Email | Commit_no ) on the server.
+ * \details The request is fire-and-forget: the reply and the network manager delete themselves once the
+ * request finishes, so saving never waits on the network. The calling thread must run an event loop.
+ * \param sha
+ */
+void Project::post_commit_history(QString sha)
+{
     QSettings settings("IIT-B", "OpenOCRCorrect");
     settings.beginGroup("login");
     QString email = settings.value("email").toString();
-    //qDebug()<<"email"<<email;
     settings.endGroup();
     QNetworkAccessManager* manager = new QNetworkAccessManager();
     QUrl url_("https://udaaniitb.aicte-india.org/udaan/commits/");
@@ -1159,23 +1269,12 @@ bool Project::commit(std::string message)
     sslConfig.setPeerVerifyMode(QSslSocket::VerifyNone);
     request.setSslConfiguration(sslConfig);
     QNetworkReply* reply = manager->post(request, postData);
-    QEventLoop loop;
-    QObject::connect(reply, &QNetworkReply::finished, [=, &loop]() {
-        if (reply->error() == QNetworkReply::NoError) {
-            QByteArray data = reply->readAll();
-            loop.quit();
-        } else {
+    QObject::connect(reply, &QNetworkReply::finished, [=]() {
+        if (reply->error() != QNetworkReply::NoError)
             qDebug() << "Error:" << reply->errorString();
-        }
         reply->deleteLater();
+        manager->deleteLater();
     });
-    loop.exec();
-    /** Clean up so we don't leak memory. */
-
-    git_tree_free(tree);
-    git_signature_free(sig);
-    git_index_free(index);
-    return 1;
 }
 
 /*!
@@ -1354,6 +1453,60 @@ void Project::lg2_add() {
     git_index_free(idx);
 }
 
+/*!
+ * \fn Project::lg2_add_paths
+ * \brief Stages only the given paths instead of the whole working tree.
+ * \details Paths may be absolute or relative to the repository work directory.
+ * \details Files which exist are added with git_index_add_bypath() and files which were deleted are removed from
+ * the index. Directories are staged with a pathspec limited to that directory, so libgit2 never has to walk
+ * Images/ or Cropped_Images/ when only a page was saved. Errors are logged, never shown, since this is called from
+ * the CommitQueue thread.
+ * \param paths
+ * \return bool
+ */
+bool Project::lg2_add_paths(const QStringList &paths)
+{
+    TRACE_SCOPE("Project::lg2_add_paths");
+    git_index *idx = NULL;
+    if (git_repository_index(&idx, repo) < 0) {
+        qDebug() << "Error Could not open index";
+        return false;
+    }
+    QDir workdir(QString::fromUtf8(git_repository_workdir(repo)));
+    bool ok = true;
+    for (const QString &path : paths) {
+        QString rel = QDir::fromNativeSeparators(workdir.relativeFilePath(path));
+        if (rel.isEmpty() || rel.startsWith("../"))
+            continue;
+        QByteArray relPath = rel.toUtf8();
+        QFileInfo info(workdir.absoluteFilePath(rel));
+        int error = 0;
+        if (info.isDir()) {
+            QByteArray spec = (rel + "/*").toUtf8();
+            char *specs[] = { spec.data() };
+            git_strarray arr = { specs, 1 };
+            error = git_index_add_all(idx, &arr, GIT_INDEX_ADD_DEFAULT, match_cb, nullptr);
+            if (error == 0)
+                error = git_index_update_all(idx, &arr, match_cb, nullptr);
+        }
+        else if (info.exists()) {
+            error = git_index_add_bypath(idx, relPath.constData());
+        }
+        else if (git_index_get_bypath(idx, relPath.constData(), 0)) {
+            error = git_index_remove_bypath(idx, relPath.constData());
+        }
+        if (error < 0) {
+            const git_error* err = giterr_last();
+            qDebug() << "Error could not stage" << rel << (err ? err->message : "");
+            ok = false;
+        }
+    }
+    if (git_index_write(idx) < 0)
+        ok = false;
+    git_index_free(idx);
+    return ok;
+}
+
 /*!
  * \fn Project::add_and_commit
  * \brief Adds and commits the file
@@ -1586,6 +1739,7 @@ int Project::GetPageNumber(std::string localFilename, std::string *no, size_t *l
  */
 int Project::clone(QString url_, QString path)
 {
+    TRACE_SCOPE("Project::clone");
     QByteArray array = url_.toLocal8Bit();
     const char *url = array.data();
 
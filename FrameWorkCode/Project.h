@@ -4,12 +4,14 @@
 #include "TreeItem.h"
 #include "TreeModel.h"
 #include <QDir>
+#include <QHash>
 #include <pugixml.hpp>
 #include <git2.h>
 #include <string>
 #include <diff_match_patch.h>
 #include <qlist.h>
 #include <QObject>
+#include "treesearchindex.h"
 
 class Project {
 public:
@@ -24,16 +26,23 @@ public:
 	void removeFile(QModelIndex & idx, Filter & pFilter, QFile & pFile);
     pugi::xml_node FindFile(QFile & file, pugi::xml_node  & n);
 	TreeModel * getModel();
+    QItemSelection searchTree(const QString &text, QModelIndex *pageHit = nullptr);
 	void open_git_repo();
     void lg2_add(QString workingFolder);
     void lg2_add();
+    bool lg2_add_paths(const QStringList &paths);
     bool commit(std::string message);
+    bool commit_index(std::string message, QString *sha = nullptr);
+    void post_commit_history(QString sha);
     bool push(QString branchName);
 	bool add_config();
 	bool add_git_config(); // New function which does not looks up the git configurations (regardless of any level)
     int fetch(QString);
     bool enable_push(bool increment);
 	void AddTemp(Filter * f, QFile &pFile,QString prefix);
+    void AddTemp(Filter * f, const QStringList & paths);
+    void RemoveTemp(Filter * f, const QStringList & names);
+    bool appendFile(TreeItem * folder, const QString & name, const QString & path, Filter * filter, bool notify = true);
     int findNumberOfFilesInDirectory(std::string);
     int LevenshteinWithGraphemes(QList<Diff> diffs);
     int GetGraphemesCount(QString string);
@@ -41,9 +50,6 @@ public:
     static int clone(QString url_, QString path);
 
 	~Project() {
-		for (auto p : mFiles) {
-			delete p;
-		}
         for (auto f : mFilters) {
                     delete f;
                 }
@@ -75,10 +81,11 @@ public:
     bool fetch_n_merge(QString gDirTwoLevelUp, QString mRole);
 private:
 	bool m_isOpen = false;
-	QVector<QFile*> mFiles;
 	QVector<Filter*> mFilters;
 	TreeItem * mRoot=nullptr;
+    QHash<QString, TreeItem*> mFilterNodes; //! Folder item of each filter, by filter name
 	TreeModel * mTreeModel=nullptr;
+    TreeSearchIndex mSearchIndex;   //! Names of the tree items, kept in step with the tree for the search box
 	QString mFileName;
 	QString mProjectName;
 	std::string mXML;
@@ -3,7 +3,8 @@
 \brief This class provide all the functionality of the project tree opened like correctors , verifiers and output files.
 
 \sa    append_child(), child(),child_count(), column_count(), data(), find(), row()
-       parentItem(), SetFile(), GetNodeType(),SetFilter(), GetFile(), GetFilter(), FindFileNode(), RemoveNode()
+       parentItem(), SetFilePath(), GetNodeType(),SetFilter(), GetFilePath(), GetFilter(), FindFileNode(), RemoveNode(),
+       append_pending(), remove_pending(), fetch_pending()
 */
 #pragma once
 #include "TreeItem.h"
@@ -124,13 +125,13 @@ TreeItem * TreeItem::parentItem()
 }
 
 /*!
- * \fn TreeItem::SetFile
- * \brief This function assigns pFile param to file variable.
- * \param pFile
+ * \fn TreeItem::SetFilePath
+ * \brief This function assigns the path of the file this item shows.
+ * \param pPath
  */
-void TreeItem::SetFile( QFile * pFile)
+void TreeItem::SetFilePath(const QString & pPath)
 {
-        file = pFile;
+        mFilePath = pPath;
 }
 
 /*!
@@ -154,13 +155,13 @@ NodeType TreeItem::GetNodeType()
 }
 
 /*!
- * \fn TreeItem::GetFile
- * \brief This function returns the file of tree.
- * \return file
+ * \fn TreeItem::GetFilePath
+ * \brief This function returns the path of the file of this item.
+ * \return mFilePath, empty for folders
  */
-QFile * TreeItem::GetFile()
+QString TreeItem::GetFilePath() const
 {
-   return file;
+   return mFilePath;
 }
 
 /*!
@@ -182,24 +183,18 @@ Filter * TreeItem::GetFilter()
  * \param item
  * \return this object's pointer
  */
-TreeItem * TreeItem::FindFileNode(QFile*f,TreeItem * item)
+TreeItem * TreeItem::FindFileNode(const QString & path, TreeItem * item)
 {
-        if (!item->file) {
-            if (f->fileName() == item->file->fileName())
-            {
-                return item;
-            }
-        }
-        if (item->mChildItems.size() == 0) return nullptr;
-        else
+        if (item->mFilePath == path)
         {
-            TreeItem * retnVal = nullptr;
-            for (TreeItem * n : mChildItems) {
-                retnVal = FindFileNode(f, item);
-                if (retnVal) return retnVal;
-            }
-            return retnVal;
+            return item;
+        }
+        TreeItem * retnVal = nullptr;
+        for (TreeItem * n : item->mChildItems) {
+            retnVal = FindFileNode(path, n);
+            if (retnVal) return retnVal;
         }
+        return retnVal;
 }
 
 /*!
@@ -214,3 +209,72 @@ void TreeItem::RemoveNode(TreeItem * item)
             mChildItems.remove(id);
        }
 }
+
+/*!
+ * \fn TreeItem::append_pending
+ * \brief Remembers a file of this folder without creating its TreeItem. The item is created by fetch_pending()
+ *        when the folder is expanded, so opening a project doesn't allocate an item per file of the set.
+ * \param name Display name
+ * \param path Path of the file
+ * \param pFilter Filter of the file
+ */
+void TreeItem::append_pending(const QString & name, const QString & path, Filter * pFilter)
+{
+    mPending.append({name, path, pFilter});
+}
+
+/*!
+ * \fn TreeItem::remove_pending
+ * \brief Forgets a pending file.
+ * \param name Display name
+ * \return Position the file had among the pending files, -1 if there was none with that name
+ */
+int TreeItem::remove_pending(const QString & name)
+{
+    for (int i = 0; i < mPending.size(); i++) {
+        if (mPending[i].name == name) {
+            mPending.remove(i);
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*!
+ * \fn TreeItem::pending_count
+ * \return Number of files not yet fetched into child items
+ */
+int TreeItem::pending_count() const
+{
+    return mPending.size();
+}
+
+/*!
+ * \fn TreeItem::is_fetched
+ * \return true once fetch_pending() ran; files added after that become items right away
+ */
+bool TreeItem::is_fetched() const
+{
+    return mFetched;
+}
+
+/*!
+ * \fn TreeItem::fetch_pending
+ * \brief Creates the child items of the pending files, in the order they were appended.
+ * \return Number of items created
+ */
+int TreeItem::fetch_pending()
+{
+    int n = mPending.size();
+    mChildItems.reserve(mChildItems.size() + n);
+    for (PendingFile & p : mPending) {
+        TreeItem * f = new TreeItem(p.name, NodeType::_FILETYPE, this);
+        f->SetFilePath(p.path);
+        f->SetFilter(p.filter);
+        mChildItems.append(f);
+    }
+    mPending.clear();
+    mPending.squeeze();
+    mFetched = true;
+    return n;
+}
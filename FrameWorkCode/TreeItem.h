@@ -35,25 +35,40 @@ public:
 
 	int row() const;
 
-    void SetFile( QFile * pFile);
+    void SetFilePath(const QString & pPath);
 
     void SetFilter(Filter * pFilter);
 
     NodeType GetNodeType();
 
-    QFile * GetFile();
+    QString GetFilePath() const;
 
     Filter * GetFilter();
 
-    TreeItem * FindFileNode(QFile*f,TreeItem * item);
+    TreeItem * FindFileNode(const QString & path, TreeItem * item);
 
     void RemoveNode(TreeItem * item);
 	TreeItem * parentItem();
+
+    void append_pending(const QString & name, const QString & path, Filter * pFilter);
+    int remove_pending(const QString & name);
+    int pending_count() const;
+    bool is_fetched() const;
+    int fetch_pending();
 private:
+    //! A file of a folder that has not been expanded yet; it becomes a TreeItem in fetch_pending()
+    struct PendingFile {
+        QString name;
+        QString path;
+        Filter *filter;
+    };
+
 	QVector<TreeItem*> mChildItems;
 	QVector<QVariant> mItemData;
 	TreeItem *mParentItem;
 	NodeType type;
-	QFile    *file = nullptr;
+	QString  mFilePath;
 	Filter   *mFilter = nullptr;
+	QVector<PendingFile> mPending;
+	bool     mFetched = false;
 };
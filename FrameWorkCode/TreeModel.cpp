@@ -148,6 +148,76 @@ int TreeModel::columnCount(const QModelIndex & pParent) const
 	return mRootItem->column_count();
 }
 
+/*!
+ * \fn TreeModel::itemFor
+ * \brief Returns the item of an index, the root item for the invalid index
+ * \param pIndex
+ * \return TreeItem *
+ */
+TreeItem * TreeModel::itemFor(const QModelIndex & pIndex) const
+{
+	if (!pIndex.isValid())
+		return mRootItem;
+	return static_cast<TreeItem*>(pIndex.internalPointer());
+}
+
+/*!
+ * \fn TreeModel::indexFor
+ * \brief Returns the index of an item, the invalid index for the root item
+ * \param item
+ * \return QModelIndex
+ */
+QModelIndex TreeModel::indexFor(TreeItem * item) const
+{
+	if (!item || item == mRootItem)
+		return QModelIndex();
+	return createIndex(item->row(), 0, item);
+}
+
+/*!
+ * \fn TreeModel::hasChildren
+ * \brief A folder whose files are not fetched yet still has children, so the view shows it as expandable
+ * \param pParent
+ * \return bool
+ */
+bool TreeModel::hasChildren(const QModelIndex & pParent) const
+{
+	if (pParent.column() > 0)
+		return false;
+	TreeItem * item = itemFor(pParent);
+	return item->child_count() > 0 || item->pending_count() > 0;
+}
+
+/*!
+ * \fn TreeModel::canFetchMore
+ * \brief Returns true while a folder has files that are not items yet
+ * \param pParent
+ * \return bool
+ */
+bool TreeModel::canFetchMore(const QModelIndex & pParent) const
+{
+	if (pParent.column() > 0)
+		return false;
+	return itemFor(pParent)->pending_count() > 0;
+}
+
+/*!
+ * \fn TreeModel::fetchMore
+ * \brief Creates the items of a folder's files. The view calls this when the folder is expanded.
+ * \param pParent
+ */
+void TreeModel::fetchMore(const QModelIndex & pParent)
+{
+	TreeItem * item = itemFor(pParent);
+	int n = item->pending_count();
+	if (n == 0)
+		return;
+	int first = item->child_count();
+	beginInsertRows(pParent, first, first + n - 1);
+	item->fetch_pending();
+	endInsertRows();
+}
+
 /*!
  * \fn TreeModel::setupModelData
  * \brief Setup the model data
@@ -15,15 +15,20 @@ public:
 	QModelIndex parent(const QModelIndex &pParent = QModelIndex()) const override;
 	int rowCount(const QModelIndex &pParent = QModelIndex()) const override;
 	int columnCount(const QModelIndex &pParent = QModelIndex()) const override;
+	bool hasChildren(const QModelIndex &pParent = QModelIndex()) const override;
+	bool canFetchMore(const QModelIndex &pParent) const override;
+	void fetchMore(const QModelIndex &pParent) override;
 	void setRoot(TreeItem * root) {
 		mRootItem = root;
 	}
+	QModelIndex indexFor(TreeItem * item) const;
 	void RemoveRow(int row, int rows, const QModelIndex & parent) {
 		beginRemoveRows(parent, row, rows+ row - 1);
 		
 		endRemoveRows();
 	}
 private:
+	TreeItem * itemFor(const QModelIndex & pIndex) const;
 	void setupModelData(const QStringList &lines, TreeItem * parent);
 	TreeItem * mRootItem;
 };
\ No newline at end of file
@@ -0,0 +1,171 @@
+/*!
+ * \brief Headless batch mode of qpadfinal.
+ * \details Every set given with --set is opened through Project and processed by a BatchRunner on the global thread
+ * pool, so several sets are processed side by side and the pages of one set are spread over the pool as well. The
+ * operations run in this order, so that the reports see the pages after the replacement:
+ * \details --replace file.tsv - global replace of the pairs in the TSV file, as Upload TSV does (--all-pages to also
+ *                               replace in pages the corrector edited)
+ * \details --accuracy         - AccuracyLog.csv in the set directory
+ * \details --spell-check      - word counts per spell check colour and the most frequent unknown words
+ * \details --pdf              - Bookset.pdf in the set directory (--pdf-range first:last, --skip-empty)
+ * \details The results of all sets are printed as one JSON document on stdout, or written to --out. The exit code is
+ * 1 if a set could not be opened or an operation reported an error.
+ * \details QPAD_TRACE=1 writes trace.json to the working directory and a timing summary to stderr, like the tool does.
+ */
+#include "batchrunner.h"
+#include "tracer.h"
+#include <QGuiApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QThreadPool>
+#include "QtConcurrent/qtconcurrentrun.h"
+#include <QFuture>
+#include <iostream>
+
+//! What to do with every set
+struct BatchOptions {
+    QString role = "Verifier";
+    int threads = 0;
+    QString tsv;
+    bool allPages = false;
+    bool accuracy = false;
+    bool spellCheck = false;
+    bool pdf = false;
+    int pdfFirst = 1;
+    int pdfLast = -1;
+    bool skipEmpty = false;
+};
+
+/*!
+ * \fn hasError
+ * \return true if an operation of a set reported an error
+ */
+static bool hasError(const QJsonObject &set)
+{
+    if (set.contains("error"))
+        return true;
+    for (const QString &key : set.keys())
+        if (set[key].isObject() && set[key].toObject().contains("error"))
+            return true;
+    return false;
+}
+
+/*!
+ * \fn processSet
+ * \brief Runs the requested operations over one set.
+ * \return The result of every operation by name, with "error" set if the set can't be opened
+ */
+static QJsonObject processSet(const QString &setDir, const BatchOptions &options)
+{
+    QElapsedTimer wall;
+    wall.start();
+    QJsonObject result;
+    BatchRunner runner(setDir, options.role, options.threads);
+    if (!runner.open()) {
+        result["error"] = runner.error();
+        return result;
+    }
+    if (!options.tsv.isEmpty())
+        result["replace"] = runner.replaceFromTSV(options.tsv, options.allPages);
+    if (options.accuracy)
+        result["accuracy"] = runner.accuracyLog(QString());
+    if (options.spellCheck && runner.loadData())
+        result["spell_check"] = runner.spellCheckReport();
+    if (options.pdf)
+        result["pdf"] = runner.exportPdf(QString(), options.pdfFirst - 1, options.pdfLast, options.skipEmpty);
+    result["wall_ms"] = wall.nsecsElapsed() / 1e6;
+    return result;
+}
+
+static int usage()
+{
+    std::cerr << "Usage: qpadbatch --set dir [--set dir]... [--role Verifier|Corrector] [--threads n]\n"
+                 "                 [--replace file.tsv [--all-pages]] [--accuracy] [--spell-check]\n"
+                 "                 [--pdf [--pdf-range first:last] [--skip-empty]] [--out result.json]" << std::endl;
+    return 2;
+}
+
+int main(int argc, char *argv[])
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+    Tracer::setEnabled(qEnvironmentVariableIsSet("QPAD_TRACE"));
+
+    QStringList sets;
+    QString out;
+    BatchOptions options;
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); i++) {
+        if (args[i] == "--set" && i + 1 < args.size())
+            sets << args[++i];
+        else if (args[i] == "--role" && i + 1 < args.size())
+            options.role = args[++i];
+        else if (args[i] == "--threads" && i + 1 < args.size())
+            options.threads = qMax(0, args[++i].toInt());
+        else if (args[i] == "--replace" && i + 1 < args.size())
+            options.tsv = QDir(args[++i]).absolutePath();
+        else if (args[i] == "--all-pages")
+            options.allPages = true;
+        else if (args[i] == "--accuracy")
+            options.accuracy = true;
+        else if (args[i] == "--spell-check")
+            options.spellCheck = true;
+        else if (args[i] == "--pdf")
+            options.pdf = true;
+        else if (args[i] == "--pdf-range" && i + 1 < args.size()) {
+            QStringList range = args[++i].split(':');
+            options.pdfFirst = qMax(1, range.value(0).toInt());
+            options.pdfLast = range.size() > 1 && !range[1].isEmpty() ? range[1].toInt() : -1;
+        } else if (args[i] == "--skip-empty")
+            options.skipEmpty = true;
+        else if (args[i] == "--out" && i + 1 < args.size())
+            out = args[++i];
+        else
+            return usage();
+    }
+    if (sets.isEmpty() || (options.role != "Verifier" && options.role != "Corrector"))
+        return usage();
+    if (options.threads > 0)
+        QThreadPool::globalInstance()->setMaxThreadCount(options.threads);
+
+    //! The loaders print progress on stdout; keep it off the JSON
+    std::streambuf *stdoutBuf = std::cout.rdbuf(std::cerr.rdbuf());
+    QElapsedTimer wall;
+    wall.start();
+    QVector<QFuture<QJsonObject>> futures;
+    for (const QString &set : sets)
+        futures.append(QtConcurrent::run(processSet, set, options));
+    QJsonObject results;
+    bool failed = false;
+    for (int i = 0; i < sets.size(); i++) {
+        QJsonObject set = futures[i].result();
+        failed = failed || hasError(set);
+        results[QDir(sets[i]).absolutePath()] = set;
+    }
+    std::cout.rdbuf(stdoutBuf);
+
+    QJsonObject result;
+    result["qt_version"] = qVersion();
+    result["role"] = options.role;
+    result["sets"] = results;
+    result["wall_ms"] = wall.nsecsElapsed() / 1e6;
+    QByteArray json = QJsonDocument(result).toJson();
+    if (out.isEmpty()) {
+        std::cout << json.toStdString();
+    } else {
+        QSaveFile file(out);
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit()) {
+            std::cerr << "Can't write " << out.toStdString() << std::endl;
+            failed = true;
+        }
+    }
+
+    if (Tracer::isEnabled()) {
+        Tracer::writeChromeTrace(QDir::current().absoluteFilePath("trace.json"));
+        std::cerr << Tracer::summary().toStdString() << std::endl;
+    }
+    return failed ? 1 : 0;
+}
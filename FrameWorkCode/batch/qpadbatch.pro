@@ -0,0 +1,87 @@
+#-------------------------------------------------
+#
+# Headless batch mode of qpadfinal for server-side
+# processing of project sets: accuracy log, spell
+# check report, global replace from a TSV file and
+# PDF export, written as JSON on stdout.
+#
+#   cd FrameWorkCode/batch
+#   qmake qpadbatch.pro && make
+#   ./qpadbatch --set /data/Book1 --accuracy --spell-check --pdf > result.json
+#
+# Runs on the offscreen QPA platform; no display is needed.
+#
+#-------------------------------------------------
+
+# gui for QTextDocument and QPdfWriter, widgets and network for the dialogs
+# and the server calls Project.cpp is built with, concurrent for the pages
+QT += core gui widgets network concurrent
+
+TARGET = qpadbatch
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+LIBS += -lpugixml
+LIBS += -lgit2
+
+QMAKE_CXXFLAGS += -w
+
+SRC = $$PWD/..
+INCLUDEPATH += $$SRC
+INCLUDEPATH += $$SRC/../include
+
+HEADERS += $$SRC/batchrunner.h \
+    $$SRC/Project.h \
+    $$SRC/TreeItem.h \
+    $$SRC/TreeModel.h \
+    $$SRC/treesearchindex.h \
+    $$SRC/tracer.h \
+    $$SRC/Filters.h \
+    $$SRC/lg2_common.h \
+    $$SRC/diff_match_patch.h \
+    $$SRC/slpNPatternDict.h \
+    $$SRC/sandhichecker.h \
+    $$SRC/confusionrewriter.h \
+    $$SRC/substringindex.h \
+    $$SRC/lcsaligner.h \
+    $$SRC/lexicon.h \
+    $$SRC/pagetokencache.h \
+    $$SRC/spellchecker.h \
+    $$SRC/trieEditdis.h \
+    $$SRC/eddis.h \
+    $$SRC/editdistance.h \
+    $$SRC/loaddataworker.h \
+    $$SRC/mappedtable.h \
+    $$SRC/correctionpairminer.h \
+    $$SRC/globalreplaceworker.h \
+    $$SRC/replacejournal.h \
+    $$SRC/handlebbox.h
+
+SOURCES += main.cpp \
+    $$SRC/batchrunner.cpp \
+    $$SRC/Project.cpp \
+    $$SRC/TreeItem.cpp \
+    $$SRC/TreeModel.cpp \
+    $$SRC/treesearchindex.cpp \
+    $$SRC/tracer.cpp \
+    $$SRC/Filters.cpp \
+    $$SRC/lg2_common.cpp \
+    $$SRC/diff_match_patch.cpp \
+    $$SRC/slpNPatternDict.cpp \
+    $$SRC/sandhichecker.cpp \
+    $$SRC/confusionrewriter.cpp \
+    $$SRC/substringindex.cpp \
+    $$SRC/lcsaligner.cpp \
+    $$SRC/lexicon.cpp \
+    $$SRC/pagetokencache.cpp \
+    $$SRC/spellchecker.cpp \
+    $$SRC/trieEditdis.cpp \
+    $$SRC/eddis.cpp \
+    $$SRC/editdistance.cpp \
+    $$SRC/loaddataworker.cpp \
+    $$SRC/mappedtable.cpp \
+    $$SRC/correctionpairminer.cpp \
+    $$SRC/globalreplaceworker.cpp \
+    $$SRC/replacejournal.cpp \
+    $$SRC/handlebbox.cpp
@@ -0,0 +1,625 @@
+/*!
+ * \class BatchRunner
+ * \brief Runs the accuracy log, spell check report, TSV global replace and PDF export of one set without MainWindow.
+ * \details The runner opens a set through Project::process_xml() and LoadDataWorker::LoadData() like opening the
+ * project in the tool does, and then calls the same engines as the MainWindow slots: pageAccuracy() is the per-page
+ * calculation of on_actionAccuracyLog_triggered(), spellCheckReport() colours words with the SpellChecker of
+ * on_actionSpell_Check_triggered(), pdfHtml() builds the html printed by on_actionas_PDF_triggered(), and
+ * replaceFromTSV() drives GlobalReplaceWorker with the map replaceInAllFilesFromTSVfile() would build.
+ * \details Pages of the accuracy log and the spell check report are spread over the global thread pool. Every thread
+ * has its own Project and slpNPatternDict and the tables are only read with find(), so nothing is shared mutably.
+ * \details Every operation returns a QJsonObject; the qpadbatch tool collects them into one JSON document.
+ * \sa MainWindow::on_actionAccuracyLog_triggered(), MainWindow::on_actionas_PDF_triggered(),
+ * MainWindow::replaceInAllFilesFromTSVfile()
+ */
+#include "batchrunner.h"
+#include "globalreplaceworker.h"
+#include "loaddataworker.h"
+#include "replacejournal.h"
+#include "tracer.h"
+#include <QAtomicInt>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QPageLayout>
+#include <QPageSize>
+#include <QPdfWriter>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QTextDocument>
+#include <QTextStream>
+#include <QThread>
+#include "QtConcurrent/qtconcurrentrun.h"
+#include <QFuture>
+#include <algorithm>
+#include <cmath>
+
+/*!
+ * \fn readPage
+ * \return Content of a UTF-8 file, empty if it cannot be read
+ */
+static QString readPage(const QString &path)
+{
+    QFile sFile(path);
+    if (!sFile.open(QFile::ReadOnly | QFile::Text))
+        return QString();
+    QTextStream in(&sFile);
+    in.setCodec("UTF-8");
+    return in.readAll();
+}
+
+/*!
+ * \fn BatchRunner::BatchRunner
+ * \brief Constructor
+ * \param setDir Set directory holding project.xml, Dicts, Inds, CorrectorOutput and VerifierOutput
+ * \param role "Corrector" or "Verifier", selects the output folder like the role of the logged-in user does
+ * \param threads Threads used per operation, 0 for QThread::idealThreadCount()
+ */
+BatchRunner::BatchRunner(QString setDir, QString role, int threads)
+{
+    this->mSetDir = QDir(setDir).absolutePath();
+    this->mRole = role;
+    this->mThreads = threads;
+}
+
+/*!
+ * \fn BatchRunner::~BatchRunner
+ * \brief Destructor
+ */
+BatchRunner::~BatchRunner()
+{
+    delete mTables;
+}
+
+/*!
+ * \fn BatchRunner::open
+ * \brief Loads project.xml of the set.
+ * \return false if the set has no valid project.xml, see error()
+ */
+bool BatchRunner::open()
+{
+    QFile xml(mSetDir + "/project.xml");
+    if (!xml.exists()) {
+        mError = "No project.xml in " + mSetDir;
+        return false;
+    }
+    mProject.process_xml(xml);
+    if (!mProject.isProjectOpen()) {
+        mError = "Invalid project.xml in " + mSetDir;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \fn BatchRunner::loadData
+ * \brief Loads the dictionaries, OCR word lists and correction pairs of the set. Only the spell check report needs them.
+ * \return bool
+ */
+bool BatchRunner::loadData()
+{
+    TRACE_SCOPE("BatchRunner::loadData");
+    delete mTables;
+    mTables = new Tables;
+    LoadDataWorker worker(nullptr, &mProject, "", "", &mTables->LSTM, &mTables->CPairs, &mTables->Dict,
+                          &mTables->GBook, &mTables->IBook, &mTables->PWords, &mTables->ConfPmap, &mTables->vGBook,
+                          &mTables->vIBook, &mTables->TDict, &mTables->TGBook, &mTables->TGBookP, &mTables->TPWords,
+                          &mTables->TPWordsP, &mTables->Synonyms);
+    worker.LoadData();
+    //! As MainWindow::on_actionLoadData_triggered() freezes them once the data is loaded
+    mTables->LexDict.freeze(mTables->Dict);
+    mTables->LexGBook.freeze(mTables->GBook);
+    return true;
+}
+
+/*!
+ * \fn BatchRunner::outputDir
+ * \return VerifierOutput or CorrectorOutput of the set, depending on the role
+ */
+QString BatchRunner::outputDir() const
+{
+    return mSetDir + (mRole == "Verifier" ? "/VerifierOutput" : "/CorrectorOutput");
+}
+
+/*!
+ * \fn BatchRunner::forEachPage
+ * \brief Calls work(0) .. work(count-1) spread over the global thread pool and the calling thread.
+ * \param count
+ * \param work Must only write to state owned by its index
+ */
+void BatchRunner::forEachPage(int count, const std::function<void(int)> &work)
+{
+    QAtomicInt next(0);
+    auto run = [&]() {
+        int n;
+        while ((n = next.fetchAndAddRelaxed(1)) < count)
+            work(n);
+    };
+    int threads = mThreads > 0 ? mThreads : QThread::idealThreadCount();
+    threads = std::max(1, std::min(threads, count));
+    QVector<QFuture<void>> futures;
+    for (int t = 1; t < threads; t++)
+        futures.append(QtConcurrent::run(run));
+    run();
+    for (QFuture<void> &future : futures)
+        future.waitForFinished();
+}
+
+/*!
+ * \fn BatchRunner::pageAccuracy
+ * \brief Calculates the values of one row of AccuracyLog.csv.
+ * \param project Used for the grapheme counts only
+ * \param qs1 OCR text
+ * \param qs2 Corrector's Output html
+ * \param qs3 Verifier's Output html
+ * \return PageAccuracy, not valid if one of the texts is empty
+ * \sa diff_match_patch::diff_main(), Project::LevenshteinWithGraphemes(), Project::GetGraphemesCount()
+ */
+PageAccuracy BatchRunner::pageAccuracy(Project &project, QString qs1, QString qs2, QString qs3)
+{
+    PageAccuracy result;
+    int l1,l2,l3, DiffOcr_Corrector,DiffOcr_Verifier; float verifierChangesPerc,ocrErrorPerc;
+
+    QTextDocument doc;
+
+    doc.setHtml(qs2);
+    qs2 = doc.toPlainText().replace(" \n","\n");
+
+    doc.setHtml(qs3);
+    qs3 = doc.toPlainText().replace(" \n","\n");
+
+    if(qs1=="" || qs2 == "" || qs3 == "")
+        return result;
+    l1 = project.GetGraphemesCount(qs1); l2 = project.GetGraphemesCount(qs2); l3 = project.GetGraphemesCount(qs3);
+
+    diff_match_patch dmp;
+
+    auto diffs1 = dmp.diff_main(qs1,qs2);
+    DiffOcr_Corrector = project.LevenshteinWithGraphemes(diffs1);
+    result.correctorChanges = ((float)(DiffOcr_Corrector)/(float)l2)*100;
+    if(result.correctorChanges>100)
+        result.correctorChanges = ((float)(DiffOcr_Corrector)/(float)l1)*100;
+    result.correctorChanges = (((float)lround(result.correctorChanges*100))/100);
+
+    auto diffs2 = dmp.diff_main(qs2,qs3);
+    result.charErrors = project.LevenshteinWithGraphemes(diffs2);
+    verifierChangesPerc = ((float)(result.charErrors)/(float)l3)*100;
+    if(verifierChangesPerc>100)
+        verifierChangesPerc = ((float)(result.charErrors)/(float)l2)*100;
+    verifierChangesPerc = (((float)lround(verifierChangesPerc*100))/100);
+    result.charAccuracy = 100- (((float)lround(verifierChangesPerc*100))/100); //Corrector accuracy = 100-changes made by Verifier
+
+    auto diffs3 = dmp.diff_main(qs1,qs3);
+    DiffOcr_Verifier = project.LevenshteinWithGraphemes(diffs3);
+    ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l3)*100;
+    if(ocrErrorPerc>100)
+        ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l1)*100;
+    result.ocrAccuracy = 100 - (((float)lround(ocrErrorPerc*100))/100);
+
+    auto a = dmp.diff_linesToChars(qs2, qs3); //LinesToChars modifed for WordstoChar in diff_match_patch.cpp
+    auto lineText1 = a[0].toString();
+    auto lineText2 = a[1].toString();
+    auto lineArray = a[2].toStringList();
+    int wordCount2 = qs2.simplified().count(" ");
+    int wordCount3 = qs3.simplified().count(" ");
+    auto diffs = dmp.diff_main(lineText1, lineText2);
+    result.wordErrors = dmp.diff_levenshtein(diffs);
+    dmp.diff_charsToLines(diffs, lineArray);
+
+    result.wordAccuracy = (float)(result.wordErrors)/(float)wordCount3*100;
+    if(result.wordAccuracy>100)
+        result.wordAccuracy = (float)(result.wordErrors)/(float)wordCount2*100;
+    result.wordAccuracy = (((float)lround(result.wordAccuracy*100))/100);
+    result.valid = true;
+    return result;
+}
+
+/*!
+ * \fn BatchRunner::accuracyLog
+ * \brief Writes AccuracyLog.csv for every html or txt page of VerifierOutput, in the format of the Accuracy Log action.
+ * \param csvPath Defaults to AccuracyLog.csv in the set directory
+ * \return {"csv", "pages": [{page, word_errors, char_errors, ...}], "skipped"}
+ */
+QJsonObject BatchRunner::accuracyLog(const QString &csvPath)
+{
+    TRACE_SCOPE("BatchRunner::accuracyLog");
+    QString folder = mSetDir + "/VerifierOutput";
+    QStringList pages = QDir(folder).entryList(QStringList() << "*.html" << "*.txt", QDir::Files);
+    QVector<PageAccuracy> results(pages.size());
+
+    forEachPage(pages.size(), [&](int i) {
+        QString verifierText = folder + "/" + pages[i];
+        QString correctorText = QString(verifierText).replace("VerifierOutput","CorrectorOutput");
+        QString ocrText = QString(correctorText).replace("CorrectorOutput","Inds");
+        ocrText.replace(".html",".txt");
+        ocrText.replace("V1_", "");
+        ocrText.replace("V2_", "");
+        ocrText.replace("V3_", "");
+        Project project;
+        results[i] = pageAccuracy(project, readPage(ocrText).simplified(), readPage(correctorText).simplified(),
+                                  readPage(verifierText).simplified());
+    });
+
+    QString csv = csvPath.isEmpty() ? mSetDir + "/AccuracyLog.csv" : csvPath;
+    QSaveFile csvFile(csv);
+    QJsonObject result;
+    result["csv"] = csv;
+    if (!csvFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        result["error"] = "Can't write " + csv;
+        return result;
+    }
+    QTextStream out(&csvFile);
+    out.setCodec("UTF-8");
+    out<<"Page Name,"<<"Errors (Word level),"<<"Errors (Character-Level),"<< "Accuracy of Corrector (Word level),"<<"Accuracy of Corrector (Character-Level)," <<"Changes made by Corrector(%)," <<"OCR Accuracy(w.rt. Verified Text)"<<"\n";
+
+    QJsonArray rows;
+    QJsonArray skipped;
+    for (int i = 0; i < pages.size(); i++) {
+        const PageAccuracy &r = results[i];
+        if (!r.valid) {
+            skipped.append(pages[i]);
+            continue;
+        }
+        out<<pages[i]<<","<<r.wordErrors<<","<<r.charErrors<<","<<r.wordAccuracy<<","<<r.charAccuracy<<","<<r.correctorChanges<<","<<r.ocrAccuracy<<"\n";
+        QJsonObject row;
+        row["page"] = pages[i];
+        row["word_errors"] = r.wordErrors;
+        row["char_errors"] = r.charErrors;
+        row["corrector_word_accuracy"] = r.wordAccuracy;
+        row["corrector_char_accuracy"] = r.charAccuracy;
+        row["corrector_changes"] = r.correctorChanges;
+        row["ocr_accuracy"] = r.ocrAccuracy;
+        rows.append(row);
+    }
+    out.flush();
+    if (!csvFile.commit())
+        result["error"] = "Can't write " + csv;
+    result["pages"] = rows;
+    result["skipped"] = skipped;
+    return result;
+}
+
+/*!
+ * \fn BatchRunner::spellCheckPage
+ * \brief Sorts the words of a page into the colours the Spell Check action gives them, with the same SpellChecker.
+ * \details Unlike the action, GBook words are not counted into PWords, so pages can be checked in parallel.
+ * \param checker
+ * \param text Plain text of the page
+ * \return SpellCheckCounts
+ * \sa MainWindow::on_actionSpell_Check_triggered()
+ */
+SpellCheckCounts BatchRunner::spellCheckPage(const SpellChecker &checker, const QString &text)
+{
+    SpellCheckCounts counts;
+    std::shared_ptr<const PageTokenCache::Page> page = PageTokenCache::shared().text((text + " ").toUtf8());
+    for (const PageTokenCache::Token &token : page->tokens) {
+        counts.words++;
+        switch (checker.classify(*token.form)) {
+        case SpellChecker::Ascii:
+            counts.ascii++;
+            break;
+        case SpellChecker::Book:
+            counts.ocrBook++;
+            break;
+        case SpellChecker::Seen:
+            counts.seen++;
+            break;
+        case SpellChecker::Pair:
+            counts.cpair++;
+            break;
+        case SpellChecker::Unknown:
+            counts.unknown++;
+            counts.unknownWords[QString::fromStdString(token.form->text)]++;
+            break;
+        }
+    }
+    return counts;
+}
+
+/*!
+ * \fn BatchRunner::spellCheckReport
+ * \brief Spell checks every page of the output folder of the role.
+ * \param topUnknown Number of most frequent unknown words to report for the set
+ * \return {"pages": [{page, words, ascii, ocr_book, seen, cpair, unknown}], "totals", "unknown_words"}
+ */
+QJsonObject BatchRunner::spellCheckReport(int topUnknown)
+{
+    TRACE_SCOPE("BatchRunner::spellCheckReport");
+    QJsonObject result;
+    if (!mTables) {
+        result["error"] = QString("Data not loaded");
+        return result;
+    }
+    QString folder = outputDir();
+    QStringList pages = QDir(folder).entryList(QStringList() << "*.html", QDir::Files);
+    QVector<SpellCheckCounts> counts(pages.size());
+
+    SpellChecker checker({ &mTables->LexGBook, &mTables->LexDict, &mTables->PWords, &mTables->CPair });
+    forEachPage(pages.size(), [&](int i) {
+        QTextDocument doc;
+        doc.setHtml(readPage(folder + "/" + pages[i]));
+        counts[i] = spellCheckPage(checker, doc.toPlainText());
+    });
+
+    auto toJson = [](const SpellCheckCounts &c) {
+        QJsonObject o;
+        o["words"] = c.words;
+        o["ascii"] = c.ascii;
+        o["ocr_book"] = c.ocrBook;
+        o["seen"] = c.seen;
+        o["cpair"] = c.cpair;
+        o["unknown"] = c.unknown;
+        return o;
+    };
+    SpellCheckCounts totals;
+    QJsonArray rows;
+    for (int i = 0; i < pages.size(); i++) {
+        const SpellCheckCounts &c = counts[i];
+        QJsonObject row = toJson(c);
+        row["page"] = pages[i];
+        rows.append(row);
+        totals.words += c.words;
+        totals.ascii += c.ascii;
+        totals.ocrBook += c.ocrBook;
+        totals.seen += c.seen;
+        totals.cpair += c.cpair;
+        totals.unknown += c.unknown;
+        for (auto it = c.unknownWords.constBegin(); it != c.unknownWords.constEnd(); ++it)
+            totals.unknownWords[it.key()] += it.value();
+    }
+
+    QVector<QPair<int, QString>> ranked;
+    ranked.reserve(totals.unknownWords.size());
+    for (auto it = totals.unknownWords.constBegin(); it != totals.unknownWords.constEnd(); ++it)
+        ranked.append(qMakePair(-it.value(), it.key()));
+    std::sort(ranked.begin(), ranked.end());
+    QJsonArray unknownWords;
+    for (int i = 0; i < ranked.size() && i < topUnknown; i++) {
+        QJsonObject w;
+        w["word"] = ranked[i].second;
+        w["count"] = -ranked[i].first;
+        unknownWords.append(w);
+    }
+
+    result["pages"] = rows;
+    result["totals"] = toJson(totals);
+    result["unknown_words"] = unknownWords;
+    return result;
+}
+
+/*!
+ * \fn BatchRunner::readTSV
+ * \brief Reads a global replace TSV file: one "source<TAB>target" pair per line, blank lines are ignored.
+ * \details A file with a non-blank line without a tab is rejected, like checkForValidTSVfile() does. Sources of more
+ * than 5 words are dropped and the first pair of a repeated source wins, like runGlobalReplace() does.
+ * \param tsvPath
+ * \param replacements
+ * \param error
+ * \return false if the file can't be read or is not a valid TSV file
+ * \sa MainWindow::checkForValidTSVfile(), MainWindow::runGlobalReplace()
+ */
+bool BatchRunner::readTSV(const QString &tsvPath, QMap<QString, QString> *replacements, QString *error)
+{
+    QFile file(tsvPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *error = "Error in opening file " + tsvPath;
+        return false;
+    }
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    QMap<QString, QString> pairs;
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        if (line == "")
+            continue;
+        int indexOfFirstTab = line.indexOf("\t");
+        if (indexOfFirstTab < 0) {
+            *error = "Incorrect file format " + tsvPath;
+            return false;
+        }
+        QString sourcePhrase = line.left(indexOfFirstTab).trimmed();
+        QString targetPhrase = line.mid(indexOfFirstTab + 1).trimmed();
+        if (sourcePhrase.isEmpty() || sourcePhrase.split(' ', QString::SkipEmptyParts).size() > 5)
+            continue;
+        if (!pairs.contains(sourcePhrase))
+            pairs.insert(sourcePhrase, targetPhrase);
+    }
+    *replacements = pairs;
+    return true;
+}
+
+/*!
+ * \fn BatchRunner::replaceFromTSV
+ * \brief Globally replaces the pairs of a TSV file in the output folder of the role.
+ * \details The change to every file is journaled in the replace journal of the role in the user's cache folder, where
+ * the tool looks for it, so that Undo Global Replace in the tool of the same user on the same machine can take it
+ * back. The replacements are logged by GlobalReplaceWorker::writeLogs().
+ * \param tsvPath
+ * \param allPages Replace in every page; otherwise pages listed in the edited files log are left alone
+ * \return {"words", "instances", "files", "journal"}
+ * \sa MainWindow::replaceInAllFilesFromTSVfile()
+ */
+QJsonObject BatchRunner::replaceFromTSV(const QString &tsvPath, bool allPages)
+{
+    TRACE_SCOPE("BatchRunner::replaceFromTSV");
+    QJsonObject result;
+    QMap<QString, QString> globalReplacementMap;
+    QString error;
+    if (!readTSV(tsvPath, &globalReplacementMap, &error)) {
+        result["error"] = error;
+        return result;
+    }
+    if (globalReplacementMap.isEmpty()) {
+        result["words"] = 0;
+        return result;
+    }
+
+    QMap<QString, QString> replaceInAllPages_Map;
+    QMap<QString, QString> replaceInUneditedPages_Map;
+    if (allPages)
+        replaceInAllPages_Map = globalReplacementMap;
+    else
+        replaceInUneditedPages_Map = globalReplacementMap;
+
+    ReplaceJournal journal(MappedTable::cachePath(QFileInfo(mSetDir), mRole + "_ReplaceJournal"));
+    journal.begin(globalReplacementMap);
+
+    QList<QString> filesChangedUsingGlobalReplace;
+    QMap<QString, QString> mapOfReplacements;
+    int r1 = 0, r2 = 0, x1 = 0, files = 0;
+    GlobalReplaceWorker worker(nullptr, &filesChangedUsingGlobalReplace, &mapOfReplacements, globalReplacementMap,
+                               {}, replaceInAllPages_Map, replaceInUneditedPages_Map, outputDir(), mSetDir, "",
+                               globalReplacementMap.size(), allPages ? 1 : 0, &r1, &r2, &x1, &files, 0, mRole,
+                               &journal);
+    worker.replaceWordsInFiles();
+    worker.writeLogs();
+
+    result["words"] = globalReplacementMap.size();
+    result["instances"] = r2;
+    result["files"] = files;
+    result["journal"] = journal.path();
+    return result;
+}
+
+/*!
+ * \fn BatchRunner::htmlPageCount
+ * \param dir
+ * \return Number of html pages in dir
+ */
+int BatchRunner::htmlPageCount(const QString &dir)
+{
+    return QDir(dir).entryList(QStringList("*.html"), QDir::Files | QDir::NoDotAndDotDot).count();
+}
+
+/*!
+ * \fn BatchRunner::pdfHtml
+ * \brief Joins the html pages of a folder into the one html document that is printed as the PDF of the set.
+ * \details Background colours are disabled, Latex equations are replaced by their png images and a page break is
+ * put after every page but the last of the folder.
+ * \param dir Folder of the pages, ending with '/'
+ * \param startPage Number of html pages to skip
+ * \param endPage Position of the html page after the last one to print
+ * \param skipEmpty Leave out pages without text
+ * \return QString
+ * \sa MainWindow::on_actionas_PDF_triggered()
+ */
+QString BatchRunner::pdfHtml(const QString &dir, int startPage, int endPage, bool skipEmpty)
+{
+    QDir directory(dir);
+    directory.setSorting(QDir::SortFlag::DirsFirst | QDir::SortFlag::Name);
+    int count = htmlPageCount(dir);
+    int counter = 0;
+    int itr = 0;
+    QString html_contents = "";
+    QString mainHtml;
+
+    //! Loop through all files; the folder also has hocr, dict, htranslate and other such files
+    foreach(auto a, directory.entryList())
+    {
+        if (a.section('.', 1, 1) != "html")
+            continue;
+        if (itr < startPage) {
+            itr++;
+            continue;
+        }
+
+        QFile file(dir + a);
+        if (!file.open(QIODevice::ReadOnly)) qDebug() << "Error reading file" << dir + a;
+        QTextStream stream(&file);
+        stream.setCodec("UTF-8");
+
+        mainHtml=stream.readAll();
+        mainHtml.replace("background-color:","Background-colour:");
+        //! append counter when one file is fully scanned
+        counter++;
+        if(skipEmpty)
+        {
+            QTextDocument doc;
+            doc.setHtml(mainHtml);
+            if(doc.toPlainText().count() == 0)
+                continue;
+        }
+
+        //! Search for Latex code in html files and replace it by corresponding png images
+        //! We save latext for mathematical equations in html, and show png in our tool as our tool can't render Latex
+        if(mainHtml.contains("$$")){
+
+            QRegularExpression rex_lat("<a(.*?)</a>",QRegularExpression::DotMatchesEverythingOption);
+            QRegularExpressionMatchIterator itr_lat;
+            itr_lat = rex_lat.globalMatch(mainHtml);
+            while(itr_lat.hasNext()){
+
+                QRegularExpressionMatch match = itr_lat.next();
+                QString text = match.captured(1);
+
+                if(text.contains("Equations_"))
+                {
+                    std::string inputText_ = text.toStdString();
+                    int ind = inputText_.find("/");
+                    int lindex = inputText_.find(".tex");
+
+                    std::string str = inputText_.substr(ind,lindex-ind);
+                    QString path = QString::fromStdString(str) + ".png";
+                    QString html = "<img src=\""+path+"\">";
+                    text = "<a"+text+"</a>";
+                    mainHtml.replace(text,html);
+                }
+
+            }
+            mainHtml = mainHtml.replace("$$","dne_nqe"); //where dne_nqe is a random string used as end delimiter here.
+            //Note that this string should not appear as an original text - else it will cause parsing issues.
+            QRegularExpression rex_dollar("dne_nqe(.*?)dne_nqe",QRegularExpression::DotMatchesEverythingOption);
+            mainHtml = mainHtml.remove(rex_dollar);
+        }
+
+        //! Once page html is extracted ... before we move to next page we add html tag
+        //! for page break so that the PDF printer separates the pages
+        if(counter<count){
+            mainHtml+="<P style=\"page-break-before: always\"></P>";
+        }
+        file.close();
+        html_contents.append(mainHtml);
+        itr++;
+
+        if (itr == endPage) {
+            break;
+        }
+    }
+    return html_contents;
+}
+
+/*!
+ * \fn BatchRunner::exportPdf
+ * \brief Prints the pages of the output folder of the role into an A4 PDF file.
+ * \details QPdfWriter is used instead of QPrinter so that no print dialog or printer support is needed.
+ * \param pdfPath Defaults to Bookset.pdf in the set directory
+ * \param startPage Number of pages to skip
+ * \param endPage Position of the page after the last one to print, -1 for all pages
+ * \param skipEmpty Leave out pages without text
+ * \return {"pdf", "pages", "bytes"}
+ */
+QJsonObject BatchRunner::exportPdf(const QString &pdfPath, int startPage, int endPage, bool skipEmpty)
+{
+    TRACE_SCOPE("BatchRunner::exportPdf");
+    QString dir = outputDir() + "/";
+    int count = htmlPageCount(dir);
+    if (endPage < 0 || endPage > count)
+        endPage = count;
+    QString pdf = pdfPath.isEmpty() ? mSetDir + "/Bookset.pdf" : pdfPath;
+
+    QTextDocument doc;
+    doc.setHtml(pdfHtml(dir, startPage, endPage, skipEmpty));
+    {
+        QPdfWriter writer(pdf);
+        writer.setPageSize(QPageSize(QPageSize::A4));
+        writer.setPageMargins(QMarginsF(5, 5, 5, 5), QPageLayout::Millimeter);
+        doc.print(&writer);
+    }
+
+    QJsonObject result;
+    result["pdf"] = pdf;
+    result["pages"] = std::max(0, endPage - startPage);
+    result["bytes"] = QFileInfo(pdf).size();
+    return result;
+}
@@ -0,0 +1,84 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include "Project.h"
+#include "mappedtable.h"
+#include "lexicon.h"
+#include "slpNPatternDict.h"
+#include "spellchecker.h"
+#include "trieEditdis.h"
+
+//! The values of one row of AccuracyLog.csv
+struct PageAccuracy {
+    int wordErrors = 0;             //! Word level errors of the corrector w.r.t. the verifier
+    int charErrors = 0;             //! Grapheme level errors of the corrector w.r.t. the verifier
+    float wordAccuracy = 0;
+    float charAccuracy = 0;
+    float correctorChanges = 0;     //! Changes made by the corrector in the OCR text, in %
+    float ocrAccuracy = 0;          //! Accuracy of the OCR text w.r.t. the verified text
+    bool valid = false;             //! False when one of the three texts is empty
+};
+
+//! How the spell check of MainWindow would colour the words of one page, see SpellChecker::Colour
+struct SpellCheckCounts {
+    int words = 0;
+    int ascii = 0;                  //! Left as they are, mostly latin text
+    int ocrBook = 0;                //! Found in GBook, shown uncoloured
+    int seen = 0;                   //! Found in PWords, shown gray
+    int cpair = 0;                  //! Corrected earlier in the session, shown purple
+    int unknown = 0;                //! Coloured by findDictEntries()
+    QMap<QString, int> unknownWords;
+};
+
+class BatchRunner
+{
+public:
+    explicit BatchRunner(QString setDir, QString role = "Verifier", int threads = 0);
+    ~BatchRunner();
+
+    bool open();
+    bool loadData();
+    QString error() const { return mError; }
+    QString outputDir() const;
+
+    QJsonObject accuracyLog(const QString &csvPath);
+    QJsonObject spellCheckReport(int topUnknown = 50);
+    QJsonObject replaceFromTSV(const QString &tsvPath, bool allPages);
+    QJsonObject exportPdf(const QString &pdfPath, int startPage = 0, int endPage = -1, bool skipEmpty = false);
+
+    static PageAccuracy pageAccuracy(Project &project, QString qs1, QString qs2, QString qs3);
+    static bool readTSV(const QString &tsvPath, QMap<QString, QString> *replacements, QString *error);
+    static QString pdfHtml(const QString &dir, int startPage, int endPage, bool skipEmpty);
+    static int htmlPageCount(const QString &dir);
+
+private:
+    //! Everything LoadDataWorker fills for MainWindow
+    struct Tables {
+        MappedTable LSTM;
+        std::map<string, set<string> > CPairs;
+        map<string, int> Dict, GBook, IBook, PWords, ConfPmap;
+        vector<string> vGBook, vIBook;
+        trie TDict, TGBook, TPWords;
+        SubstringIndex TGBookP, TPWordsP;
+        MappedTable Synonyms;
+        Lexicon LexDict, LexGBook;          //! Frozen from Dict and GBook, as MainWindow does after loading
+        map<string, string> CPair;          //! Correction pairs of the session, none in a batch run
+    };
+
+    QString mSetDir;
+    QString mRole;
+    int mThreads;
+    Project mProject;
+    Tables *mTables = nullptr;
+    QString mError;
+
+    void forEachPage(int count, const std::function<void(int)> &work);
+    static SpellCheckCounts spellCheckPage(const SpellChecker &checker, const QString &text);
+};
+
+#endif // BATCHRUNNER_H
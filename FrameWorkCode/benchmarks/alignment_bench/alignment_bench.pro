@@ -0,0 +1,43 @@
+#-------------------------------------------------
+#
+# Regression check and benchmark of LcsAligner and of
+# eddis on the full pages of data/Book2Marathi: every
+# OCR page aligned with its proofread page, by letter
+# and by word, and every OCR word matched with the
+# nearest proofread word around it.
+#
+#   qmake alignment_bench.pro && make
+#   ./alignment_bench --book ../../../data/Book2Marathi
+#
+#-------------------------------------------------
+
+QT += core gui widgets
+
+TARGET = alignment_bench
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS += -w
+
+SRC = $$PWD/../..
+INCLUDEPATH += $$SRC
+
+HEADERS += $$SRC/slpNPatternDict.h \
+    $$SRC/sandhichecker.h \
+    $$SRC/confusionrewriter.h \
+    $$SRC/substringindex.h \
+    $$SRC/lcsaligner.h \
+    $$SRC/lexicon.h \
+    $$SRC/pagetokencache.h \
+    $$SRC/eddis.h
+
+SOURCES += main.cpp \
+    $$SRC/slpNPatternDict.cpp \
+    $$SRC/sandhichecker.cpp \
+    $$SRC/confusionrewriter.cpp \
+    $$SRC/substringindex.cpp \
+    $$SRC/lcsaligner.cpp \
+    $$SRC/lexicon.cpp \
+    $$SRC/pagetokencache.cpp \
+    $$SRC/eddis.cpp
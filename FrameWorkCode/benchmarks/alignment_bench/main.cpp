@@ -0,0 +1,443 @@
+/*!
+ * \brief Regression check and benchmark of LcsAligner and eddis on the full pages of data/Book2Marathi.
+ * \details Every page of Inds/ that has a proofread version in Correct/ is aligned with it, both in SLP1. The
+ * alignments must give the same common subsequence as the Hirschberg templates slpNPatternDict used before
+ * LcsAligner, which are kept here as the reference.
+ * \details Stages, timed per page:
+ * \details page_letters     - LcsAligner::lcs() of the whole pages, letter by letter
+ * \details page_words       - LcsAligner::align() of the words of the pages
+ * \details confusions       - slpNPatternDict::appendConfusionsPairs() for every OCR word the word alignment pairs
+ *                             with a different corrected word, as loadConfusionsFont() mines them
+ * \details nearest_words    - the nearest corrected word of every OCR word within the window of
+ *                             slpNPatternDict::generatePairs(), by eddis::distanceAtMost() bounded by the nearest so far
+ * \details nearest_utf8     - the same on the Devanagari words in UTF-8, by eddis::distanceAtMostUtf8()
+ * \details invalid_utf8     - eddis::distanceAtMostUtf8() of OCR words broken into invalid UTF-8 (a truncated, stray,
+ *                             overlong or surrogate sequence) against the word, for several bounds
+ * \details reference_*      - the templates, and a full edit distance matrix per word pair, on the same input; the
+ *                             UTF-8 stages compare code points as QString::fromUtf8() decodes them, taking every byte
+ *                             it can't decode as its own value
+ * \details Results are printed as JSON on stdout. The exit code is 1 if an alignment, a nearest word or a distance
+ * differs from the reference.
+ */
+#include "slpNPatternDict.h"
+#include "lcsaligner.h"
+#include "eddis.h"
+#include "pagetokencache.h"
+#include <QApplication>
+#include <QByteArray>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVector>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+typedef std::vector<int> lengths;
+typedef std::vector<bool> members;
+
+/*!
+ * \fn referenceLens
+ * \brief slpNPatternDict::lcs_lens() before LcsAligner.
+ */
+template <typename it>
+static void referenceLens(it xlo, it xhi, it ylo, it yhi, lengths & lens)
+{
+    lengths curr(1 + distance(ylo, yhi), 0);
+    lengths prev(curr);
+    for (it x = xlo; x != xhi; ++x) {
+        swap(prev, curr);
+        int i = 0;
+        for (it y = ylo; y != yhi; ++y, ++i)
+            curr[i + 1] = *x == *y ? prev[i] + 1 : std::max(curr[i], prev[i + 1]);
+    }
+    swap(lens, curr);
+}
+
+/*!
+ * \fn referenceSplit
+ * \brief slpNPatternDict::calculate_lcs() before LcsAligner.
+ */
+template <typename it>
+static void referenceSplit(it xo, it xlo, it xhi, it ylo, it yhi, members & xs_in_lcs)
+{
+    unsigned const nx = distance(xlo, xhi);
+    if (nx == 0)
+        return;
+    if (nx == 1) {
+        xs_in_lcs[distance(xo, xlo)] = find(ylo, yhi, *xlo) != yhi;
+        return;
+    }
+    it xmid = xlo + nx / 2;
+    lengths ll_b, ll_e;
+    std::reverse_iterator<it> hix(xhi), midx(xmid), hiy(yhi), loy(ylo);
+    referenceLens(xlo, xmid, ylo, yhi, ll_b);
+    referenceLens(hix, midx, hiy, loy, ll_e);
+    lengths::const_reverse_iterator e = ll_e.rbegin();
+    int lmax = -1;
+    it y = ylo, ymid = ylo;
+    for (lengths::const_iterator b = ll_b.begin(); b != ll_b.end(); ++b, ++e) {
+        if (*b + *e > lmax) {
+            lmax = *b + *e;
+            ymid = y;
+        }
+        if (y != yhi)
+            ++y;
+    }
+    referenceSplit(xo, xlo, xmid, ylo, ymid, xs_in_lcs);
+    referenceSplit(xo, xmid, xhi, ymid, yhi, xs_in_lcs);
+}
+
+/*!
+ * \fn referenceLcs
+ * \brief slpNPatternDict::lcs() before LcsAligner.
+ */
+template <typename seq>
+static seq referenceLcs(seq const & xs, seq const & ys)
+{
+    members xs_in_lcs(xs.size(), false);
+    referenceSplit(xs.begin(), xs.begin(), xs.end(), ys.begin(), ys.end(), xs_in_lcs);
+    seq an_lcs;
+    for (size_t i = 0; i < xs.size(); i++)
+        if (xs_in_lcs[i])
+            an_lcs.push_back(xs[i]);
+    return an_lcs;
+}
+
+/*!
+ * \fn referenceDistance
+ * \brief eddis::editDist() before distanceAtMost(), with the whole matrix, of two strings or code point sequences.
+ */
+template <typename seq>
+static size_t referenceDistance(const seq &a, const seq &b)
+{
+    vector<vector<size_t>> m(a.size() + 1, vector<size_t>(b.size() + 1));
+    for (size_t i = 0; i <= a.size(); i++)
+        m[i][0] = i;
+    for (size_t j = 0; j <= b.size(); j++)
+        m[0][j] = j;
+    for (size_t i = 1; i <= a.size(); i++)
+        for (size_t j = 1; j <= b.size(); j++)
+            m[i][j] = std::min({ m[i - 1][j] + 1, m[i][j - 1] + 1, m[i - 1][j - 1] + (a[i - 1] != b[j - 1]) });
+    return m[a.size()][b.size()];
+}
+
+/*!
+ * \fn referenceCodePoints
+ * \brief Code points of UTF-8 text as QString::fromUtf8() decodes them. A byte that does not start a sequence Qt
+ * decodes and encodes back unchanged is taken as its own value.
+ */
+static std::u32string referenceCodePoints(const string &s)
+{
+    std::u32string out;
+    for (size_t i = 0; i < s.size();) {
+        size_t len = 1;
+        char32_t cp = static_cast<unsigned char>(s[i]);
+        for (size_t l = 1; l <= 4 && i + l <= s.size(); l++) {
+            QByteArray slice(s.data() + i, int(l));
+            QString decoded = QString::fromUtf8(slice);
+            QVector<uint> ucs4 = decoded.toUcs4();
+            if (ucs4.size() == 1 && decoded.toUtf8() == slice) {
+                len = l;
+                cp = ucs4[0];
+                break;
+            }
+        }
+        out.push_back(cp);
+        i += len;
+    }
+    return out;
+}
+
+/*!
+ * \fn stats
+ * \brief Summarises per-page latencies in milliseconds.
+ */
+static QJsonObject stats(std::vector<double> v)
+{
+    QJsonObject o;
+    if (v.empty())
+        return o;
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v)
+        sum += x;
+    auto pct = [&v](double p) { return v[std::min(v.size() - 1, (size_t)(p * (v.size() - 1) + 0.5))]; };
+    o["mean_ms"] = sum / v.size();
+    o["p50_ms"] = pct(0.50);
+    o["p95_ms"] = pct(0.95);
+    o["max_ms"] = v.back();
+    o["total_ms"] = sum;
+    return o;
+}
+
+//! An OCR page and its proofread version, in SLP1, and their words as they are in the files
+struct PagePair {
+    QString name;
+    string ocr, correct;
+    vector<string> ocrWords, correctWords;
+    vector<string> ocrUtf8, correctUtf8;
+};
+
+/*!
+ * \fn loadPages
+ * \return The pages of Inds/ that have a proofread version in Correct/
+ */
+static std::vector<PagePair> loadPages(const QString &book)
+{
+    std::vector<PagePair> pages;
+    slpNPatternDict slnp;
+    PageTokenCache &tokens = PageTokenCache::shared();
+    for (const QString &name : QDir(book + "/Inds").entryList({ "page-*.txt" }, QDir::Files)) {
+        QFile ocr(book + "/Inds/" + name), correct(book + "/Correct/" + name);
+        if (!ocr.open(QIODevice::ReadOnly) || !correct.open(QIODevice::ReadOnly))
+            continue;
+        QByteArray ocrText = ocr.readAll(), correctText = correct.readAll();
+        PagePair page;
+        page.name = name;
+        page.ocr = slnp.toslp1(ocrText.toStdString());
+        page.correct = slnp.toslp1(correctText.toStdString());
+        page.ocrWords = tokens.text(ocrText)->slp1();
+        page.correctWords = tokens.text(correctText)->slp1();
+        for (const PageTokenCache::Token &token : tokens.text(ocrText)->tokens)
+            page.ocrUtf8.push_back(token.form->text);
+        for (const PageTokenCache::Token &token : tokens.text(correctText)->tokens)
+            page.correctUtf8.push_back(token.form->text);
+        pages.push_back(page);
+    }
+    return pages;
+}
+
+/*!
+ * \fn nearestWords
+ * \brief Index and distance of the nearest corrected word of every OCR word, first one on ties, within the window of
+ * slpNPatternDict::generatePairs().
+ */
+template <typename Distance>
+static vector<std::pair<int, size_t>> nearestWords(const vector<string> &ocrWords, const vector<string> &correctWords,
+                                                   Distance distance)
+{
+    vector<std::pair<int, size_t>> out;
+    int n = ocrWords.size(), m = correctWords.size();
+    int win = std::max(std::abs(m - n), 5);
+    for (int t = 0; t < n; t++) {
+        std::pair<int, size_t> best(-1, 1000);
+        for (int t1 = std::max(t - win, 0); t1 < std::min(t + win, m); t1++) {
+            size_t d = distance(ocrWords[t], correctWords[t1], best.second);
+            if (d < best.second)
+                best = std::make_pair(t1, d);
+            if (d == 0)
+                break;
+        }
+        out.push_back(best);
+    }
+    return out;
+}
+
+int main(int argc, char *argv[])
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QString book = "../../../data/Book2Marathi";
+    int repeat = 3;
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); i++) {
+        if (args[i] == "--book" && i + 1 < args.size())
+            book = args[++i];
+        else if (args[i] == "--repeat" && i + 1 < args.size())
+            repeat = qMax(1, args[++i].toInt());
+        else {
+            std::cerr << "Usage: alignment_bench [--book dir] [--repeat n]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<PagePair> pages = loadPages(book);
+    if (pages.empty()) {
+        std::cerr << "No pages with a proofread version, check --book" << std::endl;
+        return 2;
+    }
+
+    QJsonObject result;
+    QJsonObject stages;
+    QJsonArray mismatches;
+    QElapsedTimer t;
+    std::vector<double> lat, ref;
+    qint64 letters = 0, commonLetters = 0, words = 0, commonWords = 0;
+
+    for (int r = 0; r < repeat; r++) {
+        for (const PagePair &page : pages) {
+            t.start();
+            string common = LcsAligner::lcs(page.ocr, page.correct);
+            lat.push_back(t.nsecsElapsed() / 1e6);
+            if (r > 0)
+                continue;
+            t.start();
+            string expected = referenceLcs(page.ocr, page.correct);
+            ref.push_back(t.nsecsElapsed() / 1e6);
+            letters += page.ocr.size() + page.correct.size();
+            commonLetters += common.size();
+            if (common != expected)
+                mismatches.append(page.name + " letters");
+        }
+    }
+    stages["page_letters"] = stats(lat);
+    stages["reference_page_letters"] = stats(ref);
+
+    lat.clear();
+    ref.clear();
+    std::vector<std::pair<string, string>> substituted;
+    for (int r = 0; r < repeat; r++) {
+        for (const PagePair &page : pages) {
+            t.start();
+            LcsAligner::Matches matches = LcsAligner::align(page.ocrWords, page.correctWords);
+            lat.push_back(t.nsecsElapsed() / 1e6);
+            if (r > 0)
+                continue;
+            t.start();
+            vector<string> expected = referenceLcs(page.ocrWords, page.correctWords);
+            ref.push_back(t.nsecsElapsed() / 1e6);
+            vector<string> common;
+            for (const auto &m : matches)
+                common.push_back(page.ocrWords[m.first]);
+            words += page.ocrWords.size() + page.correctWords.size();
+            commonWords += common.size();
+            if (common != expected)
+                mismatches.append(page.name + " words");
+
+            //! A single OCR word between two matches that faces a single corrected word was misread as it
+            int px = -1, py = -1;
+            matches.push_back(std::make_pair(int(page.ocrWords.size()), int(page.correctWords.size())));
+            for (const auto &m : matches) {
+                if (m.first - px == 2 && m.second - py == 2)
+                    substituted.push_back(std::make_pair(page.ocrWords[px + 1], page.correctWords[py + 1]));
+                px = m.first;
+                py = m.second;
+            }
+        }
+    }
+    stages["page_words"] = stats(lat);
+    stages["reference_page_words"] = stats(ref);
+
+    lat.clear();
+    size_t rules = 0;
+    slpNPatternDict slnp;
+    for (int r = 0; r < repeat; r++) {
+        vector<string> confusions;
+        t.start();
+        for (const auto &pair : substituted)
+            slnp.appendConfusionsPairs(pair.first, pair.second, confusions);
+        lat.push_back(t.nsecsElapsed() / 1e6);
+        rules = confusions.size();
+    }
+    stages["confusions"] = stats(lat);
+
+    lat.clear();
+    ref.clear();
+    qint64 nearest = 0;
+    for (int r = 0; r < repeat; r++) {
+        for (const PagePair &page : pages) {
+            t.start();
+            auto found = nearestWords(page.ocrWords, page.correctWords, [](const string &a, const string &b, size_t best) {
+                return eddis::distanceAtMost(a, b, best - 1);
+            });
+            lat.push_back(t.nsecsElapsed() / 1e6);
+            if (r > 0)
+                continue;
+            t.start();
+            auto expected = nearestWords(page.ocrWords, page.correctWords, [](const string &a, const string &b, size_t) {
+                return referenceDistance(a, b);
+            });
+            ref.push_back(t.nsecsElapsed() / 1e6);
+            nearest += found.size();
+            if (found != expected)
+                mismatches.append(page.name + " nearest");
+        }
+    }
+    stages["nearest_words"] = stats(lat);
+    stages["reference_nearest_words"] = stats(ref);
+
+    lat.clear();
+    ref.clear();
+    for (int r = 0; r < repeat; r++) {
+        for (const PagePair &page : pages) {
+            t.start();
+            auto found = nearestWords(page.ocrUtf8, page.correctUtf8, [](const string &a, const string &b, size_t best) {
+                return eddis::distanceAtMostUtf8(a, b, best - 1);
+            });
+            lat.push_back(t.nsecsElapsed() / 1e6);
+            if (r > 0)
+                continue;
+            t.start();
+            auto expected = nearestWords(page.ocrUtf8, page.correctUtf8, [](const string &a, const string &b, size_t) {
+                return referenceDistance(referenceCodePoints(a), referenceCodePoints(b));
+            });
+            ref.push_back(t.nsecsElapsed() / 1e6);
+            if (found != expected)
+                mismatches.append(page.name + " nearest utf8");
+        }
+    }
+    stages["nearest_utf8"] = stats(lat);
+    stages["reference_nearest_utf8"] = stats(ref);
+
+    //! Every OCR word broken in the ways UTF-8 can be, against the word itself and the next word of the page
+    lat.clear();
+    qint64 invalidChecks = 0;
+    for (const PagePair &page : pages) {
+        size_t n = page.ocrUtf8.size();
+        vector<std::pair<string, string>> pairs;
+        for (size_t i = 0; i < n; i++) {
+            const string &w = page.ocrUtf8[i];
+            const string &other = page.ocrUtf8[(i + 1) % n];
+            const string broken[] = {
+                w.substr(0, w.size() - 1),              //! Last sequence truncated
+                "\x80" + w,                             //! Stray continuation byte
+                "\xFF" + w.substr(1),                   //! Lead byte no sequence starts with
+                w + "\xC0\xAF",                         //! Overlong "/"
+                w + "\xED\xA0\x80",                     //! Surrogate
+            };
+            for (const string &b : broken) {
+                pairs.push_back(std::make_pair(b, w));
+                pairs.push_back(std::make_pair(b, other));
+            }
+        }
+        bool same = true;
+        t.start();
+        for (const auto &pair : pairs)
+            for (size_t k : { 0, 1, 2, 8 })
+                eddis::distanceAtMostUtf8(pair.first, pair.second, k);
+        lat.push_back(t.nsecsElapsed() / 1e6);
+        for (const auto &pair : pairs) {
+            size_t expected = referenceDistance(referenceCodePoints(pair.first), referenceCodePoints(pair.second));
+            for (size_t k : { 0, 1, 2, 8 }) {
+                invalidChecks++;
+                if (eddis::distanceAtMostUtf8(pair.first, pair.second, k) != std::min(expected, k + 1))
+                    same = false;
+            }
+        }
+        if (!same)
+            mismatches.append(page.name + " invalid utf8");
+    }
+    stages["invalid_utf8"] = stats(lat);
+
+    result["pages"] = (int)pages.size();
+    result["letters"] = letters;
+    result["common_letters"] = commonLetters;
+    result["words"] = words;
+    result["common_words"] = commonWords;
+    result["substituted_words"] = (int)substituted.size();
+    result["confusion_rules"] = (qint64)rules;
+    result["nearest_words"] = nearest;
+    result["invalid_utf8_checks"] = invalidChecks;
+    result["mismatches"] = mismatches;
+    result["stages"] = stages;
+    std::cout << QJsonDocument(result).toJson().toStdString();
+    return mismatches.isEmpty() ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# All benchmarks, built next to qpadfinal with the same Qt:
+#
+#   cd FrameWorkCode/benchmarks
+#   qmake benchmarks.pro && make
+#
+# Every benchmark prints JSON on stdout and runs headless
+# on the offscreen QPA platform.
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += alignment_bench \
+    commitqueue_bench \
+    handlebbox_bench \
+    hotpaths_bench \
+    sandhi_bench
@@ -0,0 +1,45 @@
+#-------------------------------------------------
+#
+# Benchmark for Project::lg2_add_paths() and CommitQueue
+# against a local bare repository built from data/Book2Marathi.
+#
+#   qmake commitqueue_bench.pro && make
+#   ./commitqueue_bench ../../../data/Book2Marathi 50
+#
+#-------------------------------------------------
+
+QT += core gui widgets xml network
+
+TARGET = commitqueue_bench
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+LIBS += -lpugixml
+LIBS += -lgit2
+
+QMAKE_CXXFLAGS += -w
+
+SRC = $$PWD/../..
+INCLUDEPATH += $$SRC
+
+HEADERS += $$SRC/Project.h \
+    $$SRC/commitqueue.h \
+    $$SRC/TreeItem.h \
+    $$SRC/TreeModel.h \
+    $$SRC/treesearchindex.h \
+    $$SRC/tracer.h \
+    $$SRC/Filters.h \
+    $$SRC/lg2_common.h \
+    $$SRC/diff_match_patch.h
+
+SOURCES += main.cpp \
+    $$SRC/Project.cpp \
+    $$SRC/commitqueue.cpp \
+    $$SRC/TreeItem.cpp \
+    $$SRC/TreeModel.cpp \
+    $$SRC/treesearchindex.cpp \
+    $$SRC/tracer.cpp \
+    $$SRC/Filters.cpp \
+    $$SRC/lg2_common.cpp \
+    $$SRC/diff_match_patch.cpp
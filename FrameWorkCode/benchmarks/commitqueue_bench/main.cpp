@@ -0,0 +1,244 @@
+/*!
+ * \brief Benchmark of the three ways a save can reach git:
+ * \details full     - lg2_add() of the whole tree and a commit on every save (the old behaviour)
+ * \details paths    - lg2_add_paths() of the saved page and a commit on every save
+ * \details queue    - CommitQueue::enqueue() on every save, coalesced into background commits
+ * \details The book is copied into a temporary work tree, committed once and cloned into a local bare repository
+ * that acts as origin, so the push at the end of each mode exercises the same objects a turn-in would.
+ * \details Results are printed as JSON on stdout.
+ */
+#include "Project.h"
+#include "commitqueue.h"
+#include <QApplication>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+void create_initial_commit(git_repository * repo);
+extern std::string user, email;
+
+/*!
+ * \fn copyDir
+ * \brief Recursively copies the book into the benchmark work tree.
+ */
+static int copyDir(const QString &from, const QString &to)
+{
+    int files = 0;
+    QDir src(from);
+    QDirIterator it(from, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QString path = it.next();
+        QString target = to + "/" + src.relativeFilePath(path);
+        QDir().mkpath(QFileInfo(target).absolutePath());
+        if (QFile::copy(path, target))
+            files++;
+    }
+    return files;
+}
+
+/*!
+ * \fn touchPage
+ * \brief Simulates a save by appending a line to a page.
+ */
+static void touchPage(const QString &path, int n)
+{
+    QFile f(path);
+    if (f.open(QIODevice::Append | QIODevice::Text)) {
+        QTextStream out(&f);
+        out << "benchmark edit " << n << "\n";
+    }
+}
+
+/*!
+ * \fn wait
+ * \brief Runs the event loop for ms milliseconds so that queued calls and timers are delivered.
+ */
+static void wait(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, SLOT(quit()));
+    loop.exec();
+}
+
+/*!
+ * \fn stats
+ * \brief Summarises per-save latencies in milliseconds.
+ */
+static QJsonObject stats(std::vector<double> v)
+{
+    QJsonObject o;
+    if (v.empty())
+        return o;
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v)
+        sum += x;
+    auto pct = [&v](double p) { return v[std::min(v.size() - 1, (size_t)(p * (v.size() - 1) + 0.5))]; };
+    o["mean_ms"] = sum / v.size();
+    o["p50_ms"] = pct(0.50);
+    o["p95_ms"] = pct(0.95);
+    o["max_ms"] = v.back();
+    o["total_ms"] = sum;
+    return o;
+}
+
+/*!
+ * \fn pushToOrigin
+ * \brief Pushes HEAD to the local bare origin and returns the elapsed milliseconds, or -1 on error.
+ */
+static double pushToOrigin(git_repository *repo)
+{
+    QElapsedTimer t;
+    t.start();
+    git_reference *head = NULL;
+    git_remote *remote = NULL;
+    double ms = -1;
+    if (git_repository_head(&head, repo) == 0 && git_remote_lookup(&remote, repo, "origin") == 0) {
+        QByteArray spec = QByteArray("+") + git_reference_name(head) + ":" + git_reference_name(head);
+        char *specs[] = { spec.data() };
+        git_strarray refspecs = { specs, 1 };
+        git_push_options opts = GIT_PUSH_OPTIONS_INIT;
+        if (git_remote_push(remote, &refspecs, &opts) == 0)
+            ms = t.nsecsElapsed() / 1e6;
+    }
+    git_remote_free(remote);
+    git_reference_free(head);
+    return ms;
+}
+
+int main(int argc, char *argv[])
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    git_libgit2_init();
+
+    QString book = argc > 1 ? argv[1] : "../../../data/Book2Marathi";
+    int saves = argc > 2 ? atoi(argv[2]) : 50;
+    int intervalMs = argc > 3 ? atoi(argv[3]) : 20;
+
+    QTemporaryDir tmp;
+    QString work = tmp.path() + "/work";
+    QString bare = tmp.path() + "/origin.git";
+    int copied = copyDir(book, work);
+    if (copied == 0) {
+        std::cerr << "No files found in " << book.toStdString() << std::endl;
+        return 1;
+    }
+
+    Project project;
+    project.mName = user = "bench";
+    project.mEmail = email = "bench@localhost";
+    QElapsedTimer t;
+
+    //! Initial full commit of the book, then the bare clone that plays origin
+    t.start();
+    git_repository_init(&project.repo, work.toUtf8().constData(), 0);
+    create_initial_commit(project.repo);
+    project.lg2_add();
+    project.commit_index("Import book");
+    double importMs = t.nsecsElapsed() / 1e6;
+
+    git_repository *origin = NULL;
+    git_clone_options clone_opts = GIT_CLONE_OPTIONS_INIT;
+    clone_opts.bare = 1;
+    git_clone(&origin, work.toUtf8().constData(), bare.toUtf8().constData(), &clone_opts);
+    git_repository_free(origin);
+    git_remote *remote = NULL;
+    git_remote_create(&remote, project.repo, "origin", bare.toUtf8().constData());
+    git_remote_free(remote);
+
+    QStringList pages;
+    QDirIterator it(work + "/Inds", QStringList() << "*.txt", QDir::Files);
+    while (it.hasNext())
+        pages << it.next();
+    pages.sort();
+
+    QJsonObject result;
+    result["book"] = QFileInfo(book).fileName();
+    result["files"] = copied;
+    result["saves"] = saves;
+    result["import_ms"] = importMs;
+
+    //! full: stage the whole tree on every save
+    {
+        std::vector<double> lat;
+        for (int i = 0; i < saves; i++) {
+            touchPage(pages[i % pages.size()], i);
+            t.restart();
+            project.lg2_add();
+            project.commit_index("full save");
+            lat.push_back(t.nsecsElapsed() / 1e6);
+        }
+        QJsonObject o = stats(lat);
+        o["commits"] = saves;
+        o["push_ms"] = pushToOrigin(project.repo);
+        result["full"] = o;
+    }
+
+    //! paths: stage only the saved page on every save
+    {
+        std::vector<double> lat;
+        for (int i = 0; i < saves; i++) {
+            touchPage(pages[i % pages.size()], i);
+            t.restart();
+            project.lg2_add_paths({pages[i % pages.size()]});
+            project.commit_index("paths save");
+            lat.push_back(t.nsecsElapsed() / 1e6);
+        }
+        QJsonObject o = stats(lat);
+        o["commits"] = saves;
+        o["push_ms"] = pushToOrigin(project.repo);
+        result["paths"] = o;
+    }
+
+    //! queue: saves only enqueue, commits are coalesced on the queue thread
+    {
+        CommitQueue *queue = new CommitQueue(nullptr, &project, 5 * intervalMs, 100 * intervalMs);
+        QThread *thread = new QThread;
+        int commits = 0;
+        QObject::connect(thread, SIGNAL(started()), queue, SLOT(start()));
+        QObject::connect(queue, &CommitQueue::committed, [&commits](QString, int) { commits++; });
+        queue->moveToThread(thread);
+        thread->start();
+
+        std::vector<double> lat;
+        QElapsedTimer wall;
+        wall.start();
+        for (int i = 0; i < saves; i++) {
+            touchPage(pages[i % pages.size()], i);
+            t.restart();
+            queue->enqueue({pages[i % pages.size()]}, "queued save");
+            lat.push_back(t.nsecsElapsed() / 1e6);
+            wait(intervalMs);
+        }
+        QMetaObject::invokeMethod(queue, "stop", Qt::BlockingQueuedConnection);
+        thread->quit();
+        thread->wait();
+        double drainMs = wall.nsecsElapsed() / 1e6 - saves * intervalMs;
+        wait(0);
+
+        QJsonObject o = stats(lat);
+        o["commits"] = commits;
+        o["drain_ms"] = drainMs;
+        o["push_ms"] = pushToOrigin(project.repo);
+        result["queue"] = o;
+        delete queue;
+        delete thread;
+    }
+
+    std::cout << QJsonDocument(result).toJson().toStdString();
+    git_repository_free(project.repo);
+    project.repo = nullptr;
+    git_libgit2_shutdown();
+    return 0;
+}
@@ -0,0 +1,26 @@
+#-------------------------------------------------
+#
+# Micro-benchmark for HandleBbox::storeBboxes() and
+# HandleBbox::insertBboxes() over the pages of data/Book3Hindi.
+#
+#   qmake handlebbox_bench.pro && make
+#   ./handlebbox_bench ../../../data/Book3Hindi 200
+#
+#-------------------------------------------------
+
+QT += core gui widgets
+
+TARGET = handlebbox_bench
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS += -w
+
+SRC = $$PWD/../..
+INCLUDEPATH += $$SRC
+
+HEADERS += $$SRC/handlebbox.h
+
+SOURCES += main.cpp \
+    $$SRC/handlebbox.cpp
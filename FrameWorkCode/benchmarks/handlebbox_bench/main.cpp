@@ -0,0 +1,246 @@
+/*!
+ * \brief Micro-benchmark of the bbox round trip of a page save:
+ * \details store  - HandleBbox::storeBboxes() on the html of a page that carries bboxes
+ * \details insert - HandleBbox::insertBboxes() on the same page after the bboxes were stripped, as the editor saves it
+ * \details Every page-N.txt of the book is turned into the html an OCR page would have: one <p> per paragraph, an
+ * image and a table, each with a title="bbox ..." attribute. The regex based implementation that HandleBbox used
+ * before is kept here as the baseline and its output is compared with the current one.
+ * \details Results are printed as JSON on stdout.
+ */
+#include "handlebbox.h"
+#include <QApplication>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+typedef QVector<QPair<QString, QString> > Bboxes;
+
+/*!
+ * \fn legacyStore
+ * \brief The regex based HandleBbox::storeBboxes
+ */
+static Bboxes legacyStore(const QString &initial)
+{
+    Bboxes bboxes;
+    QRegularExpression rex("(<p[^>]*>|<img[^>]*>|<table[^>]*>|</table>|<td[^>]*>)");
+    QRegularExpressionMatchIterator itr = rex.globalMatch(initial);
+    QString temp_tags;
+    bool inTable = false;
+    while (itr.hasNext()) {
+        QRegularExpressionMatch match = itr.next();
+        QString bbox_tags = match.captured(1);
+        int first, last;
+        first = bbox_tags.indexOf("bbox");
+        if ((bbox_tags.indexOf("title=\"bbox") == -1) || (first == -1)) {
+            temp_tags = "";
+        } else {
+            int i = first;
+            while (bbox_tags[i] != "\"") {
+                i++;
+            }
+            last = i - 1;
+            temp_tags = bbox_tags.mid(first, last - first + 1);
+            temp_tags = temp_tags.simplified();
+        }
+        if (bbox_tags.left(2) == "<i") {
+            bboxes.push_back({"img", temp_tags});
+        } else if (bbox_tags.left(2) == "<p" && (!inTable)) {
+            bboxes.push_back({"p", temp_tags});
+        } else if (bbox_tags.left(3) == "<td") {
+            bboxes.push_back({"td", temp_tags});
+        } else if (bbox_tags.left(6) == "<table") {
+            inTable = true;
+            bboxes.push_back({"table", temp_tags});
+        } else if (bbox_tags.left(7) == "</table") {
+            inTable = false;
+            bboxes.push_back({"/table", temp_tags});
+        }
+    }
+    return bboxes;
+}
+
+/*!
+ * \fn legacyInsert
+ * \brief The regex based HandleBbox::insertBboxes, which re-runs the match after every QString::insert
+ */
+static QString legacyInsert(const Bboxes &bboxes, QString input)
+{
+    QRegularExpression regex_p("(<p[^>]*>|</p>|<img[^>]*>|<table[^>]*>|<td[^>]*>|</table>)");
+    QRegularExpressionMatchIterator itr = regex_p.globalMatch(input);
+    int i = 0;
+    bool inTable = false;
+    bool inPara = false;
+    QString currentTag;
+    while (itr.hasNext() && i < bboxes.size()) {
+        QRegularExpressionMatch match = itr.next();
+        QString htmlTagData = match.captured(1);
+        int end = match.capturedEnd(1);
+        if (htmlTagData.indexOf("title=\"bbox") != -1) {
+            i++;
+            continue;
+        }
+        if (htmlTagData.left(6) == "<table") {
+            inTable = true;
+            currentTag = "table";
+        } else if (htmlTagData.left(7) == "</table") {
+            inTable = false;
+            continue;
+        } else if (htmlTagData.left(4) == "<img") {
+            if (inPara) {
+                i--;
+            }
+            currentTag = "img";
+        } else if (htmlTagData.left(3) == "<td") {
+            currentTag = "td";
+        } else if (htmlTagData.left(2) == "<p") {
+            if (inTable) {
+                continue;
+            }
+            currentTag = "p";
+            inPara = true;
+        } else if (htmlTagData.left(3) == "</p") {
+            inPara = false;
+            continue;
+        }
+        QString temp = " title=\"" + bboxes[i++].second + "\"";
+        if (currentTag == "img") {
+            input.insert(end - 2, temp);
+        } else {
+            input.insert(end - 1, temp);
+        }
+        itr = regex_p.globalMatch(input, end + 1);
+    }
+    return input;
+}
+
+/*!
+ * \fn pageHtml
+ * \brief Builds the html of a page from its text, with bboxes when withBboxes is set.
+ */
+static QString pageHtml(const QString &text, int page, bool withBboxes)
+{
+    int y = 0;
+    auto title = [&](int h) {
+        QString t = withBboxes ? QString(" title=\"bbox 40 %1 2400 %2\"").arg(y).arg(y + h) : QString();
+        y += h;
+        return t;
+    };
+    QString html = "<!DOCTYPE HTML PUBLIC \"-//W3C//DTD HTML 4.0//EN\">\n<html><head></head><body>\n";
+    QStringList paragraphs = text.split(QRegularExpression("\\n\\s*\\n"), QString::SkipEmptyParts);
+    QStringList lastLines;
+    for (int p = 0; p < paragraphs.size(); p++) {
+        QStringList lines = paragraphs[p].trimmed().split('\n');
+        html += "<p align=\"left\"" + title(60 * lines.size()) + ">" + lines.join("<br />\n") + "</p>\n";
+        if (p == 0)
+            html += "<img src=\"../Images/page-" + QString::number(page) + ".jpeg\"" + title(400) + "/>\n";
+        lastLines = lines;
+    }
+    html += "<table border=\"1\"" + title(240) + "><tr>";
+    for (const QString &line : lastLines.mid(0, 4))
+        html += "<td" + title(60) + "><p>" + line + "</p></td>";
+    html += "</tr></table>\n</body></html>\n";
+    return html;
+}
+
+/*!
+ * \fn stats
+ * \brief Summarises per-page latencies in microseconds.
+ */
+static QJsonObject stats(std::vector<double> v)
+{
+    QJsonObject o;
+    if (v.empty())
+        return o;
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v)
+        sum += x;
+    auto pct = [&v](double p) { return v[std::min(v.size() - 1, (size_t)(p * (v.size() - 1) + 0.5))]; };
+    o["mean_us"] = sum / v.size();
+    o["p50_us"] = pct(0.50);
+    o["p95_us"] = pct(0.95);
+    o["max_us"] = v.back();
+    o["total_us"] = sum;
+    return o;
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    QString book = argc > 1 ? argv[1] : "../../../data/Book3Hindi";
+    int iterations = argc > 2 ? atoi(argv[2]) : 200;
+
+    QStringList pages;
+    QDirIterator it(book, QStringList() << "page-*.txt", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        pages << it.next();
+    pages.sort();
+    if (pages.isEmpty()) {
+        std::cerr << "No pages found in " << book.toStdString() << std::endl;
+        return 1;
+    }
+
+    std::vector<double> oldStore, newStore, oldInsert, newInsert;
+    int mismatches = 0, tags = 0;
+    qint64 bytes = 0;
+    QElapsedTimer t;
+    HandleBbox handleBbox;
+
+    for (int n = 0; n < pages.size(); n++) {
+        QFile f(pages[n]);
+        if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+            continue;
+        QString text = QString::fromUtf8(f.readAll());
+        f.close();
+        QString withBboxes = pageHtml(text, n + 1, true);
+        QString stripped = pageHtml(text, n + 1, false);
+        bytes += withBboxes.size() * 2;
+
+        Bboxes legacy;
+        t.start();
+        for (int k = 0; k < iterations; k++)
+            legacy = legacyStore(withBboxes);
+        oldStore.push_back(t.nsecsElapsed() / 1e3 / iterations);
+
+        t.restart();
+        for (int k = 0; k < iterations; k++)
+            handleBbox.storeBboxes(withBboxes);
+        newStore.push_back(t.nsecsElapsed() / 1e3 / iterations);
+        tags += handleBbox.bboxes.size();
+
+        QString legacyOut, out;
+        t.restart();
+        for (int k = 0; k < iterations; k++)
+            legacyOut = legacyInsert(legacy, stripped);
+        oldInsert.push_back(t.nsecsElapsed() / 1e3 / iterations);
+
+        t.restart();
+        for (int k = 0; k < iterations; k++)
+            out = handleBbox.insertBboxes(stripped);
+        newInsert.push_back(t.nsecsElapsed() / 1e3 / iterations);
+
+        if (legacy != handleBbox.bboxes || legacyOut != out || out != withBboxes) {
+            mismatches++;
+            std::cerr << "Output differs for " << pages[n].toStdString() << std::endl;
+        }
+    }
+
+    QJsonObject result;
+    result["book"] = QFileInfo(book).fileName();
+    result["pages"] = (int)newStore.size();
+    result["iterations"] = iterations;
+    result["html_bytes"] = (double)bytes;
+    result["bbox_tags"] = tags;
+    result["mismatches"] = mismatches;
+    result["store_regex"] = stats(oldStore);
+    result["store_tokenizer"] = stats(newStore);
+    result["insert_regex"] = stats(oldInsert);
+    result["insert_tokenizer"] = stats(newInsert);
+    std::cout << QJsonDocument(result).toJson().toStdString();
+    return mismatches == 0 ? 0 : 1;
+}
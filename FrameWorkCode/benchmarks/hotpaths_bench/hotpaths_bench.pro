@@ -0,0 +1,94 @@
+#-------------------------------------------------
+#
+# Headless benchmark of the editor hot paths (data loading, OCR
+# suggestions, spell check, global replace, accuracy log and
+# document loading) over the bundled books in data/.
+#
+#   qmake hotpaths_bench.pro && make
+#   ./hotpaths_bench --data ../../../data --repeat 5 > result.json
+#
+#-------------------------------------------------
+
+QT += core gui widgets xml network printsupport multimedia concurrent
+
+TARGET = hotpaths_bench
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+LIBS += -lpugixml
+LIBS += -lgit2
+win32: LIBS += -lpsapi
+
+QMAKE_CXXFLAGS += -w
+
+SRC = $$PWD/../..
+INCLUDEPATH += $$SRC
+INCLUDEPATH += $$SRC/../include
+
+HEADERS += $$SRC/batchrunner.h \
+    $$SRC/Project.h \
+    $$SRC/TreeItem.h \
+    $$SRC/TreeModel.h \
+    $$SRC/treesearchindex.h \
+    $$SRC/tracer.h \
+    $$SRC/Filters.h \
+    $$SRC/lg2_common.h \
+    $$SRC/diff_match_patch.h \
+    $$SRC/slpNPatternDict.h \
+    $$SRC/sandhichecker.h \
+    $$SRC/confusionrewriter.h \
+    $$SRC/substringindex.h \
+    $$SRC/lcsaligner.h \
+    $$SRC/lexicon.h \
+    $$SRC/pagetokencache.h \
+    $$SRC/spellchecker.h \
+    $$SRC/meanStdPage.h \
+    $$SRC/pagequalityestimator.h \
+    $$SRC/trieEditdis.h \
+    $$SRC/suggestionpipeline.h \
+    $$SRC/eddis.h \
+    $$SRC/editdistance.h \
+    $$SRC/loaddataworker.h \
+    $$SRC/mappedtable.h \
+    $$SRC/correctionpairminer.h \
+    $$SRC/globalreplaceworker.h \
+    $$SRC/replacejournal.h \
+    $$SRC/handlebbox.h \
+    $$SRC/customtextbrowser.h \
+    $$SRC/completionindex.h \
+    $$SRC/rubberband.h
+
+SOURCES += main.cpp \
+    $$SRC/batchrunner.cpp \
+    $$SRC/Project.cpp \
+    $$SRC/TreeItem.cpp \
+    $$SRC/TreeModel.cpp \
+    $$SRC/treesearchindex.cpp \
+    $$SRC/tracer.cpp \
+    $$SRC/Filters.cpp \
+    $$SRC/lg2_common.cpp \
+    $$SRC/diff_match_patch.cpp \
+    $$SRC/slpNPatternDict.cpp \
+    $$SRC/sandhichecker.cpp \
+    $$SRC/confusionrewriter.cpp \
+    $$SRC/substringindex.cpp \
+    $$SRC/lcsaligner.cpp \
+    $$SRC/lexicon.cpp \
+    $$SRC/pagetokencache.cpp \
+    $$SRC/spellchecker.cpp \
+    $$SRC/meanStdPage.cpp \
+    $$SRC/pagequalityestimator.cpp \
+    $$SRC/trieEditdis.cpp \
+    $$SRC/suggestionpipeline.cpp \
+    $$SRC/eddis.cpp \
+    $$SRC/editdistance.cpp \
+    $$SRC/loaddataworker.cpp \
+    $$SRC/mappedtable.cpp \
+    $$SRC/correctionpairminer.cpp \
+    $$SRC/globalreplaceworker.cpp \
+    $$SRC/replacejournal.cpp \
+    $$SRC/handlebbox.cpp \
+    $$SRC/customtextbrowser.cpp \
+    $$SRC/completionindex.cpp \
+    $$SRC/rubberband.cpp
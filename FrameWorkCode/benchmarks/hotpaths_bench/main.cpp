@@ -0,0 +1,669 @@
+/*!
+ * \brief Headless benchmark of the editor hot paths over the bundled books.
+ * \details Every book in the data folder is copied into a temporary project (Dicts, Inds, CorrectorOutput and
+ * VerifierOutput) and the following stages are timed:
+ * \details load_data      - LoadDataWorker::LoadData(), once per run
+ * \details suggestions    - SuggestionPipeline::suggest() per word, as the right-click menu calls it, with the latency
+ *                           of every stage in suggestion_stages; --all-stages also runs the stages that are off
+ * \details session_growth - the same suggestions for 10000 right-clicks over the words of the book, after which the
+ *                           tables must have as many entries as before and the resident set size must not have grown
+ * \details spell_check    - SpellChecker::pageHtml() per page, as MainWindow::on_actionSpell_Check_triggered() colours it
+ * \details global_replace - GlobalReplaceWorker::replaceWordsInFiles() over CorrectorOutput per run
+ * \details accuracy_log   - BatchRunner::pageAccuracy(), the per-page diffs of MainWindow::on_actionAccuracyLog_triggered()
+ * \details page_quality   - meanStdPage::findMeanStd() per page, and PageQualityEstimator::estimate() over the whole
+ *                           book per run, cold and with every page cached
+ * \details pair_mining    - CorrectionPairMiner::mine() over the whole book per run, cold and with every page cached
+ * \details load_document  - the html and txt branches of MainWindow::LoadDocument() per page
+ * \details tree_search    - Project::searchTree() per keystroke of a page name and per page number, as the tree
+ *                           filter box runs it
+ * \details token_cache    - pages served by PageTokenCache from the cache and tokenized, and the words it converted
+ *                           to SLP1, over all the stages that read pages
+ * \details MainWindow needs a logged-in user and dialogs, so spell check, accuracy log and document loading call the
+ * classes those slots call, without the window around them. The benchmark only reads the tables it loaded.
+ * \details Results are printed as JSON on stdout with per-stage percentiles in milliseconds and the peak resident set
+ * size after every stage, so that runs of different commits can be compared. The exit code is 1 if the session of a
+ * book grew.
+ */
+#include "Project.h"
+#include "batchrunner.h"
+#include "loaddataworker.h"
+#include "globalreplaceworker.h"
+#include "handlebbox.h"
+#include "customtextbrowser.h"
+#include "slpNPatternDict.h"
+#include "confusionrewriter.h"
+#include "lexicon.h"
+#include "mappedtable.h"
+#include "trieEditdis.h"
+#include "meanStdPage.h"
+#include "pagequalityestimator.h"
+#include "pagetokencache.h"
+#include "correctionpairminer.h"
+#include "suggestionpipeline.h"
+#include "spellchecker.h"
+#include <QApplication>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+/*!
+ * \brief Everything LoadDataWorker fills for MainWindow, and the lexicons MainWindow freezes from it
+ */
+struct BookData {
+    MappedTable LSTM;
+    std::map<string, set<string> > CPairs;
+    map<string, int> Dict, GBook, IBook, PWords, ConfPmap;
+    vector<string> vGBook, vIBook;
+    trie TDict, TGBook, TPWords;
+    SubstringIndex TGBookP, TPWordsP;
+    MappedTable Synonyms;
+    Lexicon LexDict, LexGBook, LexConfPmap, LexConfPmapFont;
+
+    //! Entries of the tables the suggestions and spell check look words up in
+    qint64 entries() const
+    {
+        return (qint64)(Dict.size() + GBook.size() + PWords.size() + ConfPmap.size() + CPairs.size() + Synonyms.size()
+                        + LexDict.size() + LexGBook.size() + LexConfPmap.size());
+    }
+};
+
+/*!
+ * \fn peakRssKb
+ * \return Peak resident set size of the process in KiB
+ */
+static qint64 peakRssKb()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return pmc.PeakWorkingSetSize / 1024;
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef Q_OS_MACOS
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+/*!
+ * \fn currentRssKb
+ * \return Resident set size of the process in KiB, -1 where it is not known
+ */
+static qint64 currentRssKb()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return pmc.WorkingSetSize / 1024;
+    return -1;
+#elif defined(Q_OS_LINUX)
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly))
+        return -1;
+    QList<QByteArray> pages = statm.readAll().split(' ');
+    if (pages.size() < 2)
+        return -1;
+    return pages[1].toLongLong() * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return -1;
+#endif
+}
+
+/*!
+ * \fn stats
+ * \brief Summarises latencies in milliseconds.
+ */
+static QJsonObject stats(std::vector<double> v)
+{
+    QJsonObject o;
+    o["samples"] = (int)v.size();
+    if (v.empty())
+        return o;
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v)
+        sum += x;
+    auto pct = [&v](double p) { return v[std::min(v.size() - 1, (size_t)(p * (v.size() - 1) + 0.5))]; };
+    o["mean_ms"] = sum / v.size();
+    o["p50_ms"] = pct(0.50);
+    o["p90_ms"] = pct(0.90);
+    o["p95_ms"] = pct(0.95);
+    o["p99_ms"] = pct(0.99);
+    o["min_ms"] = v.front();
+    o["max_ms"] = v.back();
+    o["total_ms"] = sum;
+    return o;
+}
+
+/*!
+ * \fn stage
+ * \brief Stats of a stage together with the peak RSS reached by the end of it.
+ */
+static QJsonObject stage(const std::vector<double> &v)
+{
+    QJsonObject o = stats(v);
+    o["peak_rss_kb"] = peakRssKb();
+    return o;
+}
+
+/*!
+ * \fn readText
+ * \return Content of a UTF-8 file, empty if it cannot be read
+ */
+static QString readText(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        return QString();
+    QTextStream in(&f);
+    in.setCodec("UTF-8");
+    return in.readAll();
+}
+
+/*!
+ * \fn writeText
+ * \brief Writes a UTF-8 file.
+ */
+static void writeText(const QString &path, const QString &text)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text))
+        return;
+    QTextStream out(&f);
+    out.setCodec("UTF-8");
+    out << text;
+}
+
+/*!
+ * \fn txtToHtml
+ * \brief The txt branch of MainWindow::LoadDocument: blank lines end a paragraph, other lines end with <br />.
+ */
+static QString txtToHtml(const QString &input)
+{
+    istringstream iss(input.toUtf8().constData());
+    string strHtml = "<html><body><p>";
+    string line;
+    while (getline(iss, line)) {
+        QString qline = QString::fromStdString(line);
+        if ((line == "\n") || (line == "") || (qline.contains("\r")))
+            strHtml += line + "</p><p>";
+        else
+            strHtml += line + "<br />";
+    }
+    strHtml += "</p></body></html>";
+    QString qstrHtml = QString::fromStdString(strHtml);
+    qstrHtml.replace("<br /></p>", "</p>");
+    return qstrHtml;
+}
+
+/*!
+ * \fn copyFiles
+ * \brief Copies the files of a folder that match filters.
+ * \return Number of files copied
+ */
+static int copyFiles(const QString &from, const QString &to, const QStringList &filters)
+{
+    QDir().mkpath(to);
+    int n = 0;
+    for (const QString &name : QDir(from).entryList(filters, QDir::Files))
+        if (QFile::copy(from + "/" + name, to + "/" + name))
+            n++;
+    return n;
+}
+
+/*!
+ * \fn makeProject
+ * \brief Lays a book out as a project. Books without CorrectorOutput or VerifierOutput get them generated from the
+ * OCR pages in Inds and the proofread pages in Correct.
+ * \return Number of pages
+ */
+static int makeProject(const QString &book, const QString &dir, const QString &projectXml)
+{
+    QStringList dicts = { "Dict", "GEROCR", "IEROCR", "PWords", "CPair", "SRules", "LSTM", "synonyms.csv" };
+    QString dictsFrom = QDir(book + "/Dicts").exists() ? book + "/Dicts" : book;
+    copyFiles(dictsFrom, dir + "/Dicts", dicts);
+    QFile::copy(dir + "/Dicts/CPair", dir + "/Dicts/Corrector_CPair");
+    QFile::copy(projectXml, dir + "/project.xml");
+
+    int pages = copyFiles(book + "/Inds", dir + "/Inds", { "page-*.txt" });
+    if (copyFiles(book + "/CorrectorOutput", dir + "/CorrectorOutput", { "page-*.html" }) == 0) {
+        for (const QString &name : QDir(dir + "/Inds").entryList({ "page-*.txt" }, QDir::Files))
+            writeText(dir + "/CorrectorOutput/" + QString(name).replace(".txt", ".html"), txtToHtml(readText(dir + "/Inds/" + name)));
+    }
+    if (copyFiles(book + "/VerifierOutput", dir + "/VerifierOutput", { "page-*.html" }) == 0) {
+        for (const QString &name : QDir(dir + "/CorrectorOutput").entryList({ "page-*.html" }, QDir::Files)) {
+            QString correct = readText(book + "/Correct/" + QString(name).replace(".html", ".txt"));
+            QString html = correct.isEmpty() ? readText(dir + "/CorrectorOutput/" + name) : txtToHtml(correct);
+            writeText(dir + "/VerifierOutput/" + name, html);
+        }
+    }
+    return pages;
+}
+
+/*!
+ * \fn suggestionMenu
+ * \brief The lookups of the suggestion menu of MainWindow::mousePressEvent() for one word.
+ */
+static void suggestionMenu(SuggestionPipeline &pipeline, BookData &d, const string &selectedStr)
+{
+    bool aligned;
+    pipeline.suggest(selectedStr, true, &aligned);
+    d.Synonyms.find(selectedStr);
+}
+
+/*!
+ * \fn suggestionStages
+ * \return The stats of every stage of the pipeline
+ */
+static QJsonObject suggestionStages(const SuggestionPipeline &pipeline)
+{
+    QJsonObject o;
+    for (const SuggestionPipeline::StageStats &stats : pipeline.stats()) {
+        QJsonObject stage;
+        stage["enabled"] = stats.enabled;
+        stage["runs"] = (qint64)stats.runs;
+        stage["cache_hits"] = (qint64)stats.cacheHits;
+        stage["cut_short"] = (qint64)stats.cutShort;
+        stage["over_budget"] = (qint64)stats.overBudget;
+        stage["mean_ms"] = stats.runs ? stats.totalNs / 1e6 / stats.runs : 0.0;
+        stage["max_ms"] = stats.maxNs / 1e6;
+        stage["words"] = (qint64)stats.words;
+        o[stats.name] = stage;
+    }
+    return o;
+}
+
+/*!
+ * \fn benchBook
+ * \brief Runs all stages over one book.
+ */
+static QJsonObject benchBook(const QString &book, const QString &projectXml, int repeat, int maxWords, int sessionRequests,
+                             bool allStages)
+{
+    QElapsedTimer t, wall;
+    wall.start();
+    QTemporaryDir tmp;
+    QString dir = tmp.path();
+    QJsonObject result;
+    result["pages"] = makeProject(book, dir, projectXml);
+    //! Every book starts from a cold page cache, so token_cache counts the pages of this book only
+    PageTokenCache::shared().clear();
+
+    Project project;
+    QFile xml(dir + "/project.xml");
+    project.process_xml(xml);
+
+    QStringList indsPages, htmlPages, verifierPages;
+    for (const QString &name : QDir(dir + "/Inds").entryList({ "page-*.txt" }, QDir::Files))
+        indsPages << dir + "/Inds/" + name;
+    for (const QString &name : QDir(dir + "/CorrectorOutput").entryList({ "page-*.html" }, QDir::Files))
+        htmlPages << dir + "/CorrectorOutput/" + name;
+    for (const QString &name : QDir(dir + "/VerifierOutput").entryList({ "page-*.html" }, QDir::Files))
+        verifierPages << dir + "/VerifierOutput/" + name;
+
+    QJsonObject stages;
+
+    //! load_data: a fresh set of maps per run; the last one feeds the other stages
+    std::vector<double> lat;
+    BookData *data = nullptr;
+    for (int r = 0; r < repeat; r++) {
+        delete data;
+        data = new BookData;
+        LoadDataWorker worker(nullptr, &project, "", "", &data->LSTM, &data->CPairs, &data->Dict, &data->GBook,
+                              &data->IBook, &data->PWords, &data->ConfPmap, &data->vGBook, &data->vIBook,
+                              &data->TDict, &data->TGBook, &data->TGBookP, &data->TPWords, &data->TPWordsP,
+                              &data->Synonyms);
+        t.start();
+        worker.LoadData();
+        lat.push_back(t.nsecsElapsed() / 1e6);
+    }
+    stages["load_data"] = stage(lat);
+    //! As MainWindow::on_actionLoadData_triggered() freezes them once the data is loaded
+    t.start();
+    data->LexDict.freeze(data->Dict);
+    data->LexGBook.freeze(data->GBook);
+    data->LexConfPmap.freeze(data->ConfPmap);
+    result["lexicon_freeze_ms"] = t.nsecsElapsed() / 1e6;
+    result["lexicon_bytes"] = (qint64)(data->LexDict.bytes() + data->LexGBook.bytes() + data->LexConfPmap.bytes());
+    result["dict_words"] = (int)data->Dict.size();
+    result["ocr_words"] = (int)data->GBook.size();
+    result["substring_index_states"] = (qint64)(data->TGBookP.states() + data->TPWordsP.states());
+
+    //! suggestions: the distinct OCR words of the book in page order
+    slpNPatternDict slnp;
+    std::vector<string> words;
+    std::set<string> seen;
+    for (const QString &page : indsPages) {
+        istringstream iss(readText(page).toUtf8().constData());
+        string word;
+        while (iss >> word && (int)words.size() < maxWords)
+            if (seen.insert(word).second)
+                words.push_back(word);
+    }
+    //! The confusion rules as MainWindow::on_actionLoadGDocPage_triggered() compiles them
+    t.restart();
+    ConfusionRewriter rewriter(data->ConfPmap);
+    result["confusion_compile_ms"] = t.nsecsElapsed() / 1e6;
+    result["confusion_rules"] = (qint64)rewriter.ruleCount();
+    map<string, vector<string>> SRules;
+    SuggestionPipeline pipeline({ &data->TGBookP, &data->TGBook, &data->TPWords, &data->TPWordsP, &data->vIBook,
+                                  &data->PWords, &data->CPairs, &data->LexDict, &data->LexConfPmap,
+                                  &data->LexConfPmapFont, &rewriter, &SRules });
+    if (allStages)
+        for (const SuggestionPipeline::StageStats &stats : pipeline.stats())
+            pipeline.setEnabled(stats.name, true);
+    lat.clear();
+    for (const string &selectedStr : words) {
+        t.restart();
+        suggestionMenu(pipeline, *data, selectedStr);
+        lat.push_back(t.nsecsElapsed() / 1e6);
+    }
+    stages["suggestions"] = stage(lat);
+    result["suggestion_stages"] = suggestionStages(pipeline);
+
+    //! session_growth: every word has been suggested once above, so whatever grows from here on grows per request
+    QJsonObject session;
+    qint64 entriesBefore = data->entries();
+    qint64 rssBefore = currentRssKb();
+    data->LexDict.resetStats();
+    data->LexConfPmap.resetStats();
+    lat.clear();
+    for (int i = 0; i < sessionRequests && !words.empty(); i++) {
+        t.restart();
+        suggestionMenu(pipeline, *data, words[i % words.size()]);
+        lat.push_back(t.nsecsElapsed() / 1e6);
+    }
+    stages["session_growth"] = stage(lat);
+    qint64 entriesAfter = data->entries();
+    qint64 rssAfter = currentRssKb();
+    session["requests"] = (int)lat.size();
+    session["entries_before"] = entriesBefore;
+    session["entries_after"] = entriesAfter;
+    session["rss_before_kb"] = rssBefore;
+    session["rss_after_kb"] = rssAfter;
+    session["dict_lookups"] = (qint64)data->LexDict.stats().lookups;
+    session["dict_misses"] = (qint64)data->LexDict.stats().misses;
+    session["confusion_lookups"] = (qint64)data->LexConfPmap.stats().lookups;
+    session["confusion_misses"] = (qint64)data->LexConfPmap.stats().misses;
+    //! Allocator slack of up to 1% or 4 MiB is not growth
+    bool rssFlat = rssBefore < 0 || rssAfter - rssBefore <= qMax<qint64>(4096, rssBefore / 100);
+    session["flat"] = entriesAfter == entriesBefore && rssFlat;
+    result["session_growth"] = session;
+
+    //! spell_check: every OCR page, including setting the coloured html on a document; no session CPair yet
+    map<string, string> CPair;
+    SpellChecker checker({ &data->LexGBook, &data->LexDict, &data->PWords, &CPair });
+    lat.clear();
+    for (int r = 0; r < repeat; r++) {
+        for (const QString &page : indsPages) {
+            QString text = readText(page);
+            t.restart();
+            QTextDocument doc;
+            doc.setHtml(QString::fromStdString(checker.pageHtml(*PageTokenCache::shared().text((text + " ").toUtf8()), slnp)));
+            lat.push_back(t.nsecsElapsed() / 1e6);
+        }
+    }
+    stages["spell_check"] = stage(lat);
+
+    //! global_replace: the most frequent words of the book replaced by themselves, so every run sees the same pages
+    std::map<QString, int> frequency;
+    for (const QString &page : indsPages)
+        for (const QString &word : readText(page).split(QRegularExpression("\\s+"), QString::SkipEmptyParts))
+            if (word.size() > 2 && !word.contains(QRegularExpression("[\\d\\p{P}\\p{S}]")))
+                frequency[word]++;
+    std::vector<std::pair<int, QString> > ranked;
+    for (auto &f : frequency)
+        ranked.push_back({ -f.second, f.first });
+    std::sort(ranked.begin(), ranked.end());
+    QMap<QString, QString> replacements;
+    for (size_t i = 0; i < ranked.size() && i < 10; i++)
+        replacements[ranked[i].second] = ranked[i].second;
+
+    lat.clear();
+    int replaced = 0;
+    for (int r = 0; r < repeat; r++) {
+        QList<QString> filesChanged;
+        QMap<QString, QString> mapOfReplacements;
+        int r1 = 0, r2 = 0, x1 = 0, files = 0;
+        GlobalReplaceWorker worker(nullptr, &filesChanged, &mapOfReplacements, replacements, {}, {}, {},
+                                   dir + "/CorrectorOutput", dir, "", 1, 1, &r1, &r2, &x1, &files, 0, "Corrector");
+        t.restart();
+        worker.replaceWordsInFiles();
+        lat.push_back(t.nsecsElapsed() / 1e6);
+        replaced = r2;
+    }
+    stages["global_replace"] = stage(lat);
+    result["replaced_words"] = replaced;
+
+    //! accuracy_log: OCR text against CorrectorOutput against VerifierOutput
+    lat.clear();
+    for (int r = 0; r < repeat; r++) {
+        for (const QString &verifier : verifierPages) {
+            QString corrector = QString(verifier).replace("VerifierOutput", "CorrectorOutput");
+            QString ocr = QString(corrector).replace("CorrectorOutput", "Inds").replace(".html", ".txt");
+            QString qs1 = readText(ocr).simplified(), qs2 = readText(corrector).simplified(), qs3 = readText(verifier).simplified();
+            t.restart();
+            BatchRunner::pageAccuracy(project, qs1, qs2, qs3);
+            lat.push_back(t.nsecsElapsed() / 1e6);
+        }
+    }
+    stages["accuracy_log"] = stage(lat);
+
+    //! page_quality: CorrectorOutput against the OCR text, page by page and for the whole book at once
+    QVector<PageQualityEstimator::Page> qualityPages;
+    for (const QString &corrector : htmlPages) {
+        QString ocr = QString(corrector).replace("CorrectorOutput", "Inds").replace(".html", ".txt");
+        qualityPages.append({ QFileInfo(corrector).fileName(), corrector, ocr });
+    }
+    lat.clear();
+    for (int r = 0; r < repeat; r++) {
+        for (const PageQualityEstimator::Page &page : qualityPages) {
+            double mean, sd, error;
+            meanStdPage msp;
+            t.restart();
+            msp.findMeanStd(mean, sd, error, page.correctedPath, page.ocrPath, data->LexGBook, data->PWords);
+            lat.push_back(t.nsecsElapsed() / 1e6);
+        }
+    }
+    stages["mean_std_page"] = stage(lat);
+    std::vector<double> warm;
+    lat.clear();
+    double meanError = 0;
+    for (int r = 0; r < repeat; r++) {
+        PageQualityEstimator estimator;
+        t.restart();
+        estimator.setTables(data->LexGBook, data->PWords);
+        QHash<QString, PageQuality> book = estimator.estimate(qualityPages);
+        lat.push_back(t.nsecsElapsed() / 1e6);
+        t.restart();
+        estimator.estimate(qualityPages);
+        warm.push_back(t.nsecsElapsed() / 1e6);
+        meanError = 0;
+        for (const PageQuality &q : book)
+            meanError += q.error;
+        if (!book.isEmpty())
+            meanError /= book.size();
+    }
+    stages["page_quality_book"] = stage(lat);
+    stages["page_quality_book_cached"] = stage(warm);
+    result["page_quality_mean_error"] = meanError;
+
+    //! pair_mining: the corrected pages against the OCR text, as LoadDataWorker feeds ConfPmap and CPairs
+    QVector<CorrectionPairMiner::Page> miningPages = CorrectionPairMiner::bookPages(dir);
+    lat.clear();
+    warm.clear();
+    int minedPairs = 0;
+    for (int r = 0; r < repeat; r++) {
+        CorrectionPairMiner miner;
+        t.restart();
+        minedPairs = miner.mine(miningPages).pairs;
+        lat.push_back(t.nsecsElapsed() / 1e6);
+        t.restart();
+        miner.mine(miningPages);
+        warm.push_back(t.nsecsElapsed() / 1e6);
+    }
+    stages["pair_mining_book"] = stage(lat);
+    stages["pair_mining_book_cached"] = stage(warm);
+    result["mined_pairs"] = minedPairs;
+
+    //! load_document: html pages through HandleBbox, txt pages through setHtml, both into a CustomTextBrowser
+    lat.clear();
+    for (int r = 0; r < repeat; r++) {
+        for (const QString &page : htmlPages) {
+            t.restart();
+            CustomTextBrowser b;
+            HandleBbox handleBbox;
+            QFile f(page);
+            QTextDocument *curDoc = handleBbox.loadFileInDoc(&f);
+            if (curDoc)
+                b.setDocument(curDoc->clone(&b));
+            b.toPlainText();
+            lat.push_back(t.nsecsElapsed() / 1e6);
+        }
+    }
+    stages["load_document_html"] = stage(lat);
+    lat.clear();
+    for (int r = 0; r < repeat; r++) {
+        for (const QString &page : indsPages) {
+            QString input = readText(page);
+            t.restart();
+            CustomTextBrowser b;
+            b.setHtml(txtToHtml(input));
+            b.toPlainText();
+            lat.push_back(t.nsecsElapsed() / 1e6);
+        }
+    }
+    stages["load_document_txt"] = stage(lat);
+
+    //! tree_search: the tree as opening the project fills it, queried like the filter box is typed into
+    const QStringList folders = { "CorrectorOutput", "VerifierOutput", "Inds" };
+    const QStringList filters = { "CorrectorOutput", "VerifierOutput", "Document" };
+    for (int i = 0; i < folders.size(); i++) {
+        Filter *filter = project.getFilter(filters[i]);
+        if (!filter)
+            continue;
+        for (const QString &name : QDir(dir + "/" + folders[i]).entryList(QDir::Files)) {
+            QFile f(dir + "/" + folders[i] + "/" + name);
+            project.AddTemp(filter, f, "");
+        }
+    }
+    QStringList queries;
+    for (const QString &name : { QString("page-12.html"), QString("page-7") })
+        for (int i = 1; i <= name.size(); i++)
+            queries << name.left(i);
+    for (int i = 1; i <= indsPages.size(); i++)
+        queries << QString::number(i);
+    lat.clear();
+    int selected = 0;
+    for (int r = 0; r < repeat; r++) {
+        for (const QString &query : queries) {
+            QModelIndex pageHit;
+            t.restart();
+            QItemSelection selection = project.searchTree(query, &pageHit);
+            lat.push_back(t.nsecsElapsed() / 1e6);
+            selected += selection.size();
+        }
+    }
+    stages["tree_search"] = stage(lat);
+    result["tree_search_ranges"] = selected;
+
+    PageTokenCache::Stats tokenStats = PageTokenCache::shared().stats();
+    QJsonObject tokenCache;
+    tokenCache["hits"] = (qint64)tokenStats.hits;
+    tokenCache["misses"] = (qint64)tokenStats.misses;
+    tokenCache["converted"] = (qint64)tokenStats.converted;
+    tokenCache["forms"] = tokenStats.forms;
+    result["token_cache"] = tokenCache;
+
+    delete data;
+    result["stages"] = stages;
+    result["wall_ms"] = wall.nsecsElapsed() / 1e6;
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QString dataDir = "../../../data";
+    QStringList books;
+    int repeat = 3;
+    int maxWords = 300;
+    int sessionRequests = 10000;
+    bool allStages = false;
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); i++) {
+        if (args[i] == "--data" && i + 1 < args.size())
+            dataDir = args[++i];
+        else if (args[i] == "--book" && i + 1 < args.size())
+            books << args[++i];
+        else if (args[i] == "--repeat" && i + 1 < args.size())
+            repeat = qMax(1, args[++i].toInt());
+        else if (args[i] == "--words" && i + 1 < args.size())
+            maxWords = args[++i].toInt();
+        else if (args[i] == "--session" && i + 1 < args.size())
+            sessionRequests = args[++i].toInt();
+        else if (args[i] == "--all-stages")
+            allStages = true;
+        else {
+            std::cerr << "Usage: hotpaths_bench [--data dir] [--book name]... [--repeat n] [--words n] [--session n]"
+                         " [--all-stages]" << std::endl;
+            return 2;
+        }
+    }
+    if (books.isEmpty())
+        books = QDir(dataDir).entryList({ "Book*" }, QDir::Dirs | QDir::NoDotAndDotDot);
+    QString projectXml = QDir(dataDir).absoluteFilePath("../TestProject/project.xml");
+
+    QProcess git;
+    git.setWorkingDirectory(dataDir);
+    git.start("git", { "rev-parse", "--short", "HEAD" });
+    git.waitForFinished(5000);
+
+    QJsonObject result;
+    result["commit"] = QString::fromUtf8(git.readAllStandardOutput()).trimmed();
+    result["qt_version"] = qVersion();
+    result["platform"] = QGuiApplication::platformName();
+    result["repeat"] = repeat;
+
+    //! The loaders print progress on stdout; keep it off the JSON
+    std::streambuf *stdoutBuf = std::cout.rdbuf(std::cerr.rdbuf());
+    QElapsedTimer wall;
+    wall.start();
+    QJsonObject results;
+    bool flat = true;
+    for (const QString &book : books) {
+        QJsonObject r = benchBook(QDir(dataDir).absoluteFilePath(book), projectXml, repeat, maxWords, sessionRequests,
+                                  allStages);
+        flat = flat && r.value("session_growth").toObject().value("flat").toBool();
+        results[book] = r;
+    }
+    std::cout.rdbuf(stdoutBuf);
+
+    result["books"] = results;
+    result["wall_ms"] = wall.nsecsElapsed() / 1e6;
+    result["peak_rss_kb"] = peakRssKb();
+    std::cout << QJsonDocument(result).toJson().toStdString();
+    return flat ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+/*!
+ * \brief Regression check and benchmark of SandhiChecker over the compounds of data/Book1Sanskrit.
+ * \details Dict is built from the proofread pages in Correct/: every word of less than 10 letters in SLP1, and the
+ * stem of such a word without a final H, M or m. SRules is Dicts/SRules. Every word of corpus.tsv is checked and the
+ * answers must equal the ones recorded in the corpus, which come from the recursive SamasCheck() and SandhiCheck()
+ * that SandhiChecker replaced.
+ * \details Stages, timed per word:
+ * \details checker   - a new SandhiChecker per word, as slpNPatternDict::SamasCheck() and SandhiCheck() use it
+ * \details shared    - one SandhiChecker for the whole corpus, as generatePossibilitesNsuggest() shares one between
+ *                      the candidates of a word
+ * \details reference - the old recursion, only with --reference
+ * \details Results are printed as JSON on stdout. The exit code is 1 if an answer differs from the corpus.
+ */
+#include "slpNPatternDict.h"
+#include "sandhichecker.h"
+#include "lexicon.h"
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#ifndef SANDHI_CORPUS
+#define SANDHI_CORPUS "corpus.tsv"
+#endif
+
+//! One line of corpus.tsv
+struct CorpusWord {
+    string word;
+    bool samas;
+    bool sandhi;
+};
+
+/*!
+ * \fn referenceSamas
+ * \brief slpNPatternDict::SamasCheck() before SandhiChecker, kept to compare with.
+ */
+static bool referenceSamas(string OCRNew, map<string, int>& Dict){
+    if (OCRNew == "") return 1;
+    if (Dict[OCRNew] > 0) return 1;
+    size_t sz = OCRNew.size();
+    for(size_t ts = sz ; ts > 0; ts--){
+        string s1 = OCRNew.substr(0,ts); string rem = OCRNew.substr(ts,sz-ts);
+        if((Dict[s1] > 0) &&(s1.size() >3) &&(rem.size() >3)) return referenceSamas(rem,Dict);
+    }
+    return 0;
+}
+
+/*!
+ * \fn referenceSandhi
+ * \brief slpNPatternDict::SandhiCheck() before SandhiChecker, kept to compare with.
+ */
+static bool referenceSandhi(string OCRNew, map<string, int>& Dict,map<string, vector<string>>& SRules){
+    if (Dict[OCRNew] > 0) return 1;
+    size_t sz = OCRNew.size();
+    for(size_t ts = sz ; ts > 0; ts--){
+        string s1 = OCRNew.substr(0,ts); string rem = OCRNew.substr(ts,sz-ts);
+        if( (s1.size() >3)&&(rem.size() >2)){
+            size_t k = 1;
+            vector<string> v = SRules[s1.substr(ts-k,k)];
+            size_t vsz = v.size();
+            if(vsz > 0) {
+                bool SandhiFlag = 0;
+                for(size_t vt =0; vt < vsz; vt++) {
+                    istringstream s(v[vt]); string l,r; s>>l; s>>r;
+                    string s1new = s1.substr(0,s1.size()-1)+l;
+                    if((Dict[s1new] > 0) ){
+                        SandhiFlag = (SandhiFlag | referenceSamas(r+rem,Dict));
+                    } else { SandhiFlag = (SandhiFlag | (referenceSandhi(s1new,Dict,SRules) & referenceSamas(r+rem,Dict)) | (referenceSamas(s1new,Dict) & referenceSamas(r+rem,Dict)));}
+                }
+                return  SandhiFlag;
+            }
+        }
+    }
+    return 0;
+}
+
+/*!
+ * \fn stats
+ * \brief Summarises per-word latencies in microseconds.
+ */
+static QJsonObject stats(std::vector<double> v)
+{
+    QJsonObject o;
+    if (v.empty())
+        return o;
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v)
+        sum += x;
+    auto pct = [&v](double p) { return v[std::min(v.size() - 1, (size_t)(p * (v.size() - 1) + 0.5))]; };
+    o["mean_us"] = sum / v.size();
+    o["p50_us"] = pct(0.50);
+    o["p95_us"] = pct(0.95);
+    o["max_us"] = v.back();
+    o["total_us"] = sum;
+    return o;
+}
+
+/*!
+ * \fn loadDict
+ * \brief Builds Dict from the proofread pages of the book as the corpus was recorded with.
+ */
+static void loadDict(const QString &book, map<string, int> &Dict)
+{
+    slpNPatternDict slnp;
+    for (const QString &name : QDir(book + "/Correct").entryList({ "*.txt" }, QDir::Files)) {
+        ifstream f(QString(book + "/Correct/" + name).toStdString());
+        string token;
+        while (f >> token) {
+            string w = slnp.toslp1(token);
+            if (w.size() >= 10)
+                continue;
+            Dict[w]++;
+            char e = w.back();
+            if (w.size() > 4 && (e == 'H' || e == 'M' || e == 'm'))
+                Dict[w.substr(0, w.size() - 1)]++;
+        }
+    }
+}
+
+/*!
+ * \fn loadCorpus
+ * \return The words of corpus.tsv with their recorded answers
+ */
+static std::vector<CorpusWord> loadCorpus(const QString &path)
+{
+    std::vector<CorpusWord> corpus;
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        return corpus;
+    QTextStream in(&f);
+    in.setCodec("UTF-8");
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+        QStringList fields = line.split('\t');
+        if (fields.size() == 3)
+            corpus.push_back({ fields[0].toStdString(), fields[1] == "1", fields[2] == "1" });
+    }
+    return corpus;
+}
+
+int main(int argc, char *argv[])
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QString book = "../../../data/Book1Sanskrit";
+    QString corpusPath = SANDHI_CORPUS;
+    int repeat = 3;
+    bool reference = false;
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); i++) {
+        if (args[i] == "--book" && i + 1 < args.size())
+            book = args[++i];
+        else if (args[i] == "--corpus" && i + 1 < args.size())
+            corpusPath = args[++i];
+        else if (args[i] == "--repeat" && i + 1 < args.size())
+            repeat = qMax(1, args[++i].toInt());
+        else if (args[i] == "--reference")
+            reference = true;
+        else {
+            std::cerr << "Usage: sandhi_bench [--book dir] [--corpus corpus.tsv] [--repeat n] [--reference]" << std::endl;
+            return 2;
+        }
+    }
+
+    map<string, int> Dict;
+    map<string, vector<string>> SRules;
+    loadDict(book, Dict);
+    slpNPatternDict slnp;
+    slnp.loadSandhiRules(QString(book + "/Dicts/SRules").toStdString(), SRules);
+    std::vector<CorpusWord> corpus = loadCorpus(corpusPath);
+    if (corpus.empty() || Dict.empty()) {
+        std::cerr << "No corpus or dictionary, check --book and --corpus" << std::endl;
+        return 2;
+    }
+    Lexicon lexicon(Dict);
+
+    QJsonObject result;
+    QJsonObject stages;
+    QJsonArray mismatches;
+    QElapsedTimer t;
+    std::vector<double> lat;
+    int samasAccepted = 0, sandhiAccepted = 0;
+
+    for (int r = 0; r < repeat; r++) {
+        for (const CorpusWord &c : corpus) {
+            t.start();
+            bool samas = SandhiChecker(lexicon).samas(c.word);
+            bool sandhi = SandhiChecker(lexicon, SRules).sandhi(c.word);
+            lat.push_back(t.nsecsElapsed() / 1e3);
+            if (r > 0)
+                continue;
+            samasAccepted += samas;
+            sandhiAccepted += sandhi;
+            if (samas != c.samas || sandhi != c.sandhi)
+                mismatches.append(QString::fromStdString(c.word));
+        }
+    }
+    stages["checker"] = stats(lat);
+
+    lat.clear();
+    size_t states = 0;
+    for (int r = 0; r < repeat; r++) {
+        SandhiChecker checker(lexicon, SRules);
+        for (const CorpusWord &c : corpus) {
+            t.start();
+            checker.samas(c.word);
+            checker.sandhi(c.word);
+            lat.push_back(t.nsecsElapsed() / 1e3);
+        }
+        states = checker.states();
+    }
+    stages["shared"] = stats(lat);
+
+    if (reference) {
+        lat.clear();
+        for (int r = 0; r < repeat; r++) {
+            for (const CorpusWord &c : corpus) {
+                map<string, int> dict = Dict;
+                map<string, vector<string>> rules = SRules;
+                t.start();
+                referenceSamas(c.word, dict);
+                referenceSandhi(c.word, dict, rules);
+                lat.push_back(t.nsecsElapsed() / 1e3);
+            }
+        }
+        stages["reference"] = stats(lat);
+    }
+
+    result["words"] = (int)corpus.size();
+    result["dict_words"] = (int)Dict.size();
+    result["samas_accepted"] = samasAccepted;
+    result["sandhi_accepted"] = sandhiAccepted;
+    result["shared_states"] = (qint64)states;
+    result["mismatches"] = mismatches;
+    result["stages"] = stages;
+    std::cout << QJsonDocument(result).toJson().toStdString();
+    return mismatches.isEmpty() ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+#-------------------------------------------------
+#
+# Regression check and benchmark of the samas and
+# sandhi checks over the compounds of
+# data/Book1Sanskrit listed in corpus.tsv.
+#
+#   qmake sandhi_bench.pro && make
+#   ./sandhi_bench --book ../../../data/Book1Sanskrit --reference
+#
+#-------------------------------------------------
+
+QT += core gui widgets
+
+TARGET = sandhi_bench
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS += -w
+
+SRC = $$PWD/../..
+INCLUDEPATH += $$SRC
+
+DEFINES += SANDHI_CORPUS=\\\"$$PWD/corpus.tsv\\\"
+
+HEADERS += $$SRC/slpNPatternDict.h \
+    $$SRC/sandhichecker.h \
+    $$SRC/confusionrewriter.h \
+    $$SRC/substringindex.h \
+    $$SRC/lcsaligner.h \
+    $$SRC/lexicon.h \
+    $$SRC/pagetokencache.h \
+    $$SRC/eddis.h
+
+SOURCES += main.cpp \
+    $$SRC/slpNPatternDict.cpp \
+    $$SRC/sandhichecker.cpp \
+    $$SRC/confusionrewriter.cpp \
+    $$SRC/substringindex.cpp \
+    $$SRC/lcsaligner.cpp \
+    $$SRC/lexicon.cpp \
+    $$SRC/pagetokencache.cpp \
+    $$SRC/eddis.cpp
@@ -0,0 +1,176 @@
+/*!
+ * \class CommitQueue
+ * \brief Commits the files touched in a session to the local git repository from a background thread.
+ * \details Saves only enqueue the paths they wrote. The queue waits until no save has arrived for coalesceMs
+ * (but never longer than maxDelayMs after the first pending save) and then stages exactly those paths with
+ * Project::lg2_add_paths() and makes a single commit. A burst of saves therefore becomes one commit and the GUI
+ * thread never waits on libgit2 or on the network.
+ * \details committed() is emitted after every successful commit; the receiver is expected to post the commit
+ * history entry from its own thread.
+ */
+#include "commitqueue.h"
+#include "Project.h"
+#include "tracer.h"
+#include <QTimer>
+#include <QThread>
+#include <QDebug>
+
+/*!
+ * \fn CommitQueue::CommitQueue
+ * \brief Constructor
+ * \param parent
+ * \param mProject
+ * \param coalesceMs Quiet period after the last save before the pending paths are committed
+ * \param maxDelayMs Upper bound on how long a save can stay uncommitted during a continuous burst
+ */
+CommitQueue::CommitQueue(QObject *parent, Project *mProject, int coalesceMs, int maxDelayMs)
+    : QObject{parent}
+{
+    this->mProject = mProject;
+    this->coalesceMs = coalesceMs;
+    this->maxDelayMs = maxDelayMs;
+}
+
+/*!
+ * \fn CommitQueue::start
+ * \brief Creates the coalescing timer. Connect this to QThread::started() after moveToThread() so that the
+ * timer lives in the queue thread.
+ */
+void CommitQueue::start()
+{
+    mTimer = new QTimer(this);
+    mTimer->setSingleShot(true);
+    connect(mTimer, SIGNAL(timeout()), this, SLOT(commitOnTimeout()));
+}
+
+/*!
+ * \fn CommitQueue::stop
+ * \brief Commits whatever is still pending and emits stopped(). Connect stopped() to QThread::quit() with
+ * Qt::DirectConnection, a queued quit() would wait for the thread that waits for this one.
+ */
+void CommitQueue::stop()
+{
+    if (mTimer)
+        mTimer->stop();
+    commitPending("");
+    emit stopped();
+}
+
+/*!
+ * \fn CommitQueue::enqueue
+ * \brief Records the paths written by a save. Safe to call from any thread.
+ * \param paths Absolute paths of files or directories inside the project
+ * \param message Commit message for this save; messages of coalesced saves are joined
+ */
+void CommitQueue::enqueue(const QStringList &paths, QString message)
+{
+    {
+        QMutexLocker locker(&mMutex);
+        if (mPending.isEmpty())
+            mFirstPending.start();
+        for (const QString &path : paths)
+            mPending.insert(path);
+        if (!message.isEmpty())
+            mMessages.append(message);
+    }
+    QMetaObject::invokeMethod(this, "scheduleCommit", Qt::QueuedConnection);
+}
+
+/*!
+ * \fn CommitQueue::pendingCount
+ * \return Number of distinct paths waiting to be committed
+ */
+int CommitQueue::pendingCount()
+{
+    QMutexLocker locker(&mMutex);
+    return mPending.size();
+}
+
+/*!
+ * \fn CommitQueue::scheduleCommit
+ * \brief Restarts the quiet-period timer, or commits at once if the oldest pending save has waited maxDelayMs.
+ */
+void CommitQueue::scheduleCommit()
+{
+    qint64 waited;
+    {
+        QMutexLocker locker(&mMutex);
+        if (mPending.isEmpty())
+            return;
+        waited = mFirstPending.elapsed();
+    }
+    if (waited >= maxDelayMs || !mTimer) {
+        if (mTimer)
+            mTimer->stop();
+        commitPending("");
+        return;
+    }
+    mTimer->start(coalesceMs);
+}
+
+/*!
+ * \fn CommitQueue::commitOnTimeout
+ * \brief Called once no save has been enqueued for coalesceMs.
+ */
+void CommitQueue::commitOnTimeout()
+{
+    commitPending("");
+}
+
+/*!
+ * \fn CommitQueue::flush
+ * \brief Synchronously commits everything pending on the calling thread.
+ * \details Used before fetch/merge/push at turn-in so that the remote always receives the latest saves.
+ * If message is not empty a commit is made even if no path is pending.
+ * \param message
+ * \return bool
+ */
+bool CommitQueue::flush(QString message)
+{
+    return commitPending(message);
+}
+
+/*!
+ * \fn CommitQueue::commitPending
+ * \brief Takes the pending paths, stages them and creates one commit.
+ * \param message Overrides the joined save messages when not empty
+ * \return bool
+ */
+bool CommitQueue::commitPending(QString message)
+{
+    TRACE_SCOPE("CommitQueue::commitPending");
+    QMutexLocker gitLocker(&mGitMutex);
+    QStringList paths;
+    QStringList messages;
+    {
+        QMutexLocker locker(&mMutex);
+        paths = mPending.values();
+        messages = mMessages;
+        mPending.clear();
+        mMessages.clear();
+    }
+    if (paths.isEmpty() && message.isEmpty())
+        return true;
+    if (!mProject || !mProject->repo)
+        return false;
+
+    if (message.isEmpty()) {
+        messages.removeDuplicates();
+        message = messages.isEmpty() ? QString("Saved %1 files").arg(paths.size()) : messages.join("\n");
+    }
+
+    QString sha;
+    bool ok = mProject->lg2_add_paths(paths) && mProject->commit_index(message.toStdString(), &sha);
+    if (!ok) {
+        //! Keep the paths and the save messages so that the next save or flush retries them
+        QMutexLocker locker(&mMutex);
+        for (const QString &path : paths)
+            mPending.insert(path);
+        mMessages = messages + mMessages;
+        qDebug() << "Commit failed, will retry" << paths.size() << "files";
+        emit commitFailed(message);
+        return false;
+    }
+    emit committed(sha, paths.size());
+    return true;
+}
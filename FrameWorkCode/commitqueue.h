@@ -0,0 +1,50 @@
+#ifndef COMMITQUEUE_H
+#define COMMITQUEUE_H
+
+#include <QObject>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+#include <QElapsedTimer>
+
+class Project;
+class QTimer;
+
+class CommitQueue : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CommitQueue(QObject *parent = nullptr, Project *mProject = nullptr, int coalesceMs = 3000, int maxDelayMs = 30000);
+    void enqueue(const QStringList &paths, QString message);
+    bool flush(QString message = "");
+    int pendingCount();
+    QMutex * gitMutex() { return &mGitMutex; }
+
+private:
+    Project *mProject;
+    int coalesceMs;
+    int maxDelayMs;
+    QTimer *mTimer = nullptr;
+    QMutex mMutex;                       //! Guards mPending, mMessages and mFirstPending
+    QMutex mGitMutex{QMutex::Recursive}; //! Serialises every libgit2 call made on mProject->repo
+    QSet<QString> mPending;
+    QStringList mMessages;
+    QElapsedTimer mFirstPending;
+
+    bool commitPending(QString message);
+
+public slots:
+    void start();
+    void stop();
+
+private slots:
+    void scheduleCommit();
+    void commitOnTimeout();
+
+signals:
+    void committed(QString sha, int files);
+    void commitFailed(QString message);
+    void stopped();
+};
+
+#endif // COMMITQUEUE_H
@@ -0,0 +1,298 @@
+/*!
+ * \class ComparisonService
+ * \brief Computes the page comparisons of DiffView and InternDiffView on a worker thread.
+ * \details The service lives on the compare window's own QThread. compare() reads the OCR, Corrector and Verifier
+ * files of a page and answers with ready(); the diffs and metrics are only computed when the page is not in the cache.
+ * The cache is shared by all compare windows and keyed by a hash of the file contents, so an edited page is compared
+ * again while flipping back to an unchanged one costs three file reads.
+ * \details prefetch() queues the neighbours of the page being shown. They are computed one per event loop pass, so a
+ * compare() for the page the reviewer actually navigated to waits for at most one prefetched page.
+ * \sa DiffView, InternDiffView
+ */
+#include "comparisonservice.h"
+#include "diff_match_patch.h"
+#include <QCryptographicHash>
+#include <QFile>
+#include <QTextDocument>
+#include <QTextStream>
+#include <QTimer>
+#include <cmath>
+
+using namespace std;
+
+QMutex ComparisonService::sCacheMutex;
+QCache<QByteArray, PageComparison> ComparisonService::sCache(32 * 1024 * 1024);
+
+/*!
+ * \fn ComparisonService::ComparisonService
+ * \brief Constructor
+ * \param mode VerifierCompare for DiffView, CorrectorCompare for InternDiffView
+ * \param gDirTwoLevelUp Set directory holding Inds, CorrectorOutput and VerifierOutput
+ * \param parent
+ */
+ComparisonService::ComparisonService(Mode mode, QString gDirTwoLevelUp, QObject *parent) : QObject(parent)
+{
+    this->mode = mode;
+    this->gDirTwoLevelUp = gDirTwoLevelUp;
+    qRegisterMetaType<PageComparison>("PageComparison");
+}
+
+/*!
+ * \fn ComparisonService::readInput
+ * \brief Reads one input of a comparison. A file that can't be opened is read as empty text, an empty file is an error.
+ * \param path
+ * \param ocr True for the OCR text, whose " \n" line ends are normalised
+ * \param text
+ * \param error
+ * \return false if the file is empty
+ */
+bool ComparisonService::readInput(const QString &path, bool ocr, QString *text, QString *error)
+{
+    QFile sFile(path);
+    if (!sFile.open(QFile::ReadOnly | QFile::Text))
+        return true;
+    QTextStream in(&sFile);
+    in.setCodec("UTF-8");
+    *text = in.readAll();
+    if (ocr)
+        text->replace(" \n", "\n");
+    sFile.close();
+    if (text->isEmpty()) {
+        *error = "Error in Displaying File: " + path + "is Empty";
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \fn ComparisonService::comparePage
+ * \brief Returns the comparison of a page from the cache, computing it first if needed.
+ * \param page File name of the page, e.g. page-3.html
+ * \param result
+ * \return false if the page doesn't exist in the set
+ */
+bool ComparisonService::comparePage(const QString &page, PageComparison *result)
+{
+    QString verifierText = gDirTwoLevelUp + "/VerifierOutput/" + page;
+    QString correctorText = gDirTwoLevelUp + "/CorrectorOutput/" + page;
+    QString ocrText = gDirTwoLevelUp + "/Inds/" + page;
+    ocrText.replace(".html", ".txt");
+    if (!QFile::exists(mode == VerifierCompare ? verifierText : correctorText))
+        return false;
+
+    QString qs1, qs2, qs3, error;
+    if (!readInput(ocrText, true, &qs1, &error) || !readInput(correctorText, false, &qs2, &error)
+            || (mode == VerifierCompare && !readInput(verifierText, false, &qs3, &error))) {
+        *result = PageComparison();
+        result->error = error;
+        return true;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const QString &text : { qs1, qs2, qs3 }) {
+        QByteArray bytes = text.toUtf8();
+        int size = bytes.size();
+        hash.addData(reinterpret_cast<const char *>(&size), sizeof(size));
+        hash.addData(bytes);
+    }
+    QByteArray key = QByteArray(1, char(mode)) + hash.result();
+
+    {
+        QMutexLocker locker(&sCacheMutex);
+        if (PageComparison *cached = sCache.object(key)) {
+            *result = *cached;
+            return true;
+        }
+    }
+
+    *result = mode == VerifierCompare ? compareVerifier(qs1, qs2, qs3) : compareCorrector(qs1, qs2);
+    QMutexLocker locker(&sCacheMutex);
+    sCache.insert(key, new PageComparison(*result), result->html1.size() + result->html2.size() + result->html3.size() + 1);
+    return true;
+}
+
+/*!
+ * \fn ComparisonService::compareVerifier
+ * \brief Colour codes the OCR, Corrector and Verifier text of a page and calculates the change percentages and the
+ * accuracy of the OCR text w.r.t. the verified text.
+ * \param qs1 OCR text
+ * \param qs2 Corrector's Output html
+ * \param qs3 Verifier's Output html
+ * \return PageComparison
+ * \sa LevenshteinWithGraphemes(),GetGraphemesCount(), diff_main(), diff_prettyHtml()
+ */
+PageComparison ComparisonService::compareVerifier(QString qs1, QString qs2, QString qs3)
+{
+    PageComparison result;
+    Project mProject;
+    QTextDocument doc;
+
+    doc.setHtml(qs2);
+    qs2 = doc.toPlainText().replace(" \n","\n");
+
+    doc.setHtml(qs3);
+    qs3 = doc.toPlainText().replace(" \n","\n");
+
+    int l1,l2,l3, DiffOcr_Corrector,DiffCorrector_Verifier,DiffOcr_Verifier;
+    float ocrErrorPerc;
+
+    l1 = mProject.GetGraphemesCount(qs1); l2 = mProject.GetGraphemesCount(qs2); l3 = mProject.GetGraphemesCount(qs3);
+
+    diff_match_patch dmp;
+
+    //! Calculates the percentage of changes made by the corrector in OCR text file
+    auto diffs1 = dmp.diff_main(qs1,qs2);
+    DiffOcr_Corrector = mProject.LevenshteinWithGraphemes(diffs1);
+    result.correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l2)*100;
+    if(result.correctorChangesPerc>100) result.correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l1)*100;
+    result.correctorChangesPerc = (((float)lround(result.correctorChangesPerc*100))/100);
+
+    //! Calculates the percentage of changes made by the verifier in Corrector's Output file
+    auto diffs2 = dmp.diff_main(qs2,qs3);
+    DiffCorrector_Verifier = mProject.LevenshteinWithGraphemes(diffs2);
+    result.verifierChangesPerc = ((float)(DiffCorrector_Verifier)/(float)l3)*100;
+    if(result.verifierChangesPerc>100) result.verifierChangesPerc = ((float)(DiffCorrector_Verifier)/(float)l2)*100;
+    result.verifierChangesPerc = (((float)lround(result.verifierChangesPerc*100))/100);
+
+    //! Calculates the accuracy of OCR text w.r.t. Verified text
+    auto diffs3 = dmp.diff_main(qs1,qs3);
+    DiffOcr_Verifier = mProject.LevenshteinWithGraphemes(diffs3);
+    ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l3)*100;
+    if(ocrErrorPerc>100) ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l1)*100;
+    result.ocrAcc = 100 - (((float)lround(ocrErrorPerc*100))/100);
+
+    doc.setHtml(qs1);
+    QString interntext = doc.toPlainText();
+
+    doc.setHtml(qs2);
+    QString ocrtext = doc.toPlainText();
+
+    doc.setHtml(qs3);
+    QString verifiertext = doc.toPlainText();
+
+    //!Displays changes by color coding
+    auto diffs = dmp.diff_main(ocrtext,interntext);
+    QList<QString> htmlList1 = dmp.diff_prettyHtml(diffs, "ffd13d");
+    result.html1 = htmlList1.first();
+    result.html2 = htmlList1.last();
+
+    diffs = dmp.diff_main(interntext,verifiertext);
+    QList<QString> htmlList2 = dmp.diff_prettyHtml(diffs, "90ff90");
+    result.html3 = htmlList2.first();
+    result.html1.remove("&para;");
+    result.html2.remove("&para;");
+    result.html3.remove("&para;");
+    return result;
+}
+
+/*!
+ * \fn ComparisonService::compareCorrector
+ * \brief Colour codes the OCR and Corrector text of a page and calculates the percentage of changes made by the corrector.
+ * \param qs1 OCR text
+ * \param qs2 Corrector's Output html
+ * \return PageComparison
+ * \sa LevenshteinWithGraphemes(),GetGraphemesCount(), diff_main(), diff_prettyHtml()
+ */
+PageComparison ComparisonService::compareCorrector(QString qs1, QString qs2)
+{
+    PageComparison result;
+    Project mProject;
+    QTextDocument doc;
+    doc.setHtml(qs2);
+    qs2 = doc.toPlainText().replace(" \n", "\n");
+
+    int l1,l2, DiffOcr_Corrector;
+
+    l1 = mProject.GetGraphemesCount(qs1); l2 = mProject.GetGraphemesCount(qs2);
+
+    diff_match_patch dmp;
+    auto diffs = dmp.diff_main(qs1,qs2);
+
+    //! Calculates the percentage of changes made by the corrector in OCR text file
+    DiffOcr_Corrector = mProject.LevenshteinWithGraphemes(diffs);
+    result.correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l2)*100;
+    if(result.correctorChangesPerc>100) result.correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l1)*100;
+    result.correctorChangesPerc = (((float)lround(result.correctorChangesPerc*100))/100);
+
+    //! The colour coding is made from the same diff the metric was calculated from
+    auto html = dmp.diff_prettyHtml(diffs, "ffd13d");
+    result.html1 = html[0];
+    result.html2 = html[1];
+    result.html1.remove("&para;");
+    result.html2.remove("&para;");
+    return result;
+}
+
+/*!
+ * \fn ComparisonService::neighbours
+ * \brief Names of the pages a reviewer is likely to open next from page: the following ones, then the previous one.
+ * \param page
+ * \param ahead Number of following pages
+ * \return QStringList
+ */
+QStringList ComparisonService::neighbours(const QString &page, int ahead)
+{
+    QStringList pages;
+    Project mProject;
+    string no = "";
+    size_t loc;
+    QString ext = "";
+    string name = page.toStdString();
+    if (!mProject.GetPageNumber(name, &no, &loc, &ext) || no.empty())
+        return pages;
+    int n = stoi(no);
+    for (int i = 1; i <= ahead; i++)
+        pages << QString::fromStdString(string(name).replace(loc, no.size(), to_string(n + i)));
+    if (n - 1 > 0)
+        pages << QString::fromStdString(string(name).replace(loc, no.size(), to_string(n - 1)));
+    return pages;
+}
+
+/*!
+ * \fn ComparisonService::compare
+ * \brief Emits ready() with the comparison of page.
+ * \param page
+ */
+void ComparisonService::compare(QString page)
+{
+    mPrefetch.removeAll(page);
+    PageComparison result;
+    if (comparePage(page, &result))
+        emit ready(page, result);
+}
+
+/*!
+ * \fn ComparisonService::prefetch
+ * \brief Replaces the queue of pages to compute ahead of time.
+ * \param pages Nearest neighbour first
+ */
+void ComparisonService::prefetch(QStringList pages)
+{
+    mPrefetch = pages;
+    schedulePrefetch();
+}
+
+/*!
+ * \fn ComparisonService::schedulePrefetch
+ */
+void ComparisonService::schedulePrefetch()
+{
+    if (mPrefetchScheduled || mPrefetch.isEmpty())
+        return;
+    mPrefetchScheduled = true;
+    QTimer::singleShot(0, this, SLOT(prefetchNext()));
+}
+
+/*!
+ * \fn ComparisonService::prefetchNext
+ * \brief Computes the next queued page into the cache.
+ */
+void ComparisonService::prefetchNext()
+{
+    mPrefetchScheduled = false;
+    if (mPrefetch.isEmpty())
+        return;
+    PageComparison result;
+    comparePage(mPrefetch.takeFirst(), &result);
+    schedulePrefetch();
+}
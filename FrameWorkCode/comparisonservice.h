@@ -0,0 +1,58 @@
+#ifndef COMPARISONSERVICE_H
+#define COMPARISONSERVICE_H
+
+#include <QObject>
+#include <QCache>
+#include <QMutex>
+#include <QMetaType>
+#include <QStringList>
+#include "Project.h"
+
+//! Colour coded html and change metrics of one page, as shown by DiffView and InternDiffView
+struct PageComparison {
+    QString html1;
+    QString html2;
+    QString html3;
+    float correctorChangesPerc = 0;
+    float verifierChangesPerc = 0;
+    float ocrAcc = 0;
+    QString error;          //! Set when one of the inputs is empty; nothing else is then valid
+};
+Q_DECLARE_METATYPE(PageComparison)
+
+class ComparisonService : public QObject
+{
+    Q_OBJECT
+public:
+    enum Mode { VerifierCompare, CorrectorCompare };
+
+    explicit ComparisonService(Mode mode, QString gDirTwoLevelUp, QObject *parent = nullptr);
+    static PageComparison compareVerifier(QString qs1, QString qs2, QString qs3);
+    static PageComparison compareCorrector(QString qs1, QString qs2);
+    static QStringList neighbours(const QString &page, int ahead = 2);
+
+private:
+    Mode mode;
+    QString gDirTwoLevelUp;
+    QStringList mPrefetch;
+    bool mPrefetchScheduled = false;
+
+    static QMutex sCacheMutex;
+    static QCache<QByteArray, PageComparison> sCache;   //! Shared by every compare window, keyed by content hash
+
+    bool readInput(const QString &path, bool ocr, QString *text, QString *error);
+    bool comparePage(const QString &page, PageComparison *result);
+    void schedulePrefetch();
+
+public slots:
+    void compare(QString page);
+    void prefetch(QStringList pages);
+
+private slots:
+    void prefetchNext();
+
+signals:
+    void ready(QString page, PageComparison result);
+};
+
+#endif // COMPARISONSERVICE_H
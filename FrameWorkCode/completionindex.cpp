@@ -0,0 +1,222 @@
+/*!
+ * \class CompletionIndex
+ * \brief Sorted, read-mostly word table behind the inline completer of CustomTextBrowser.
+ * \details The word list is kept as one blob of case-folded UTF-8 words and a vector of offsets sorted by byte order,
+ * which for UTF-8 is code point order. All words that start with a prefix are then one contiguous range that is found
+ * with two binary searches, and the completer only ever sees the top-k words of that range.
+ * \details A line of the word list may carry a count after a tab ("word(tab)count"). Counts and the completions the
+ * user picks during the session rank the words of a range; without counts the range is returned in sorted order.
+ * \details One index is loaded per script on first use and shared by every CustomTextBrowser.
+ */
+#include "completionindex.h"
+#include <QFile>
+#include <QGuiApplication>
+#include <QCursor>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+/*!
+ * \fn CompletionIndex::CompletionIndex
+ * \brief Loads and sorts a word list with one word per line.
+ * \param fileName
+ */
+CompletionIndex::CompletionIndex(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        qDebug() << "File not opened..." << fileName;
+        return;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+
+    //! Append every folded word to the blob first; pointers into it are only taken once it stops growing
+    QVector<quint32> offsets;
+    QVector<quint32> counts;
+    QHash<quint32, QString> display;
+    mBlob.reserve(data.size() + 1);
+    int start = 0;
+    while (start < data.size()) {
+        int end = data.indexOf('\n', start);
+        if (end < 0)
+            end = data.size();
+        QByteArray line = data.mid(start, end - start).trimmed();
+        start = end + 1;
+
+        quint32 count = 0;
+        int tab = line.indexOf('\t');
+        if (tab >= 0) {
+            count = line.mid(tab + 1).trimmed().toUInt();
+            line.truncate(tab);
+        }
+        if (line.isEmpty() || line.contains('\0'))
+            continue;
+
+        QString word = QString::fromUtf8(line);
+        QByteArray key = word.toLower().toUtf8();
+        if (key != line)
+            display.insert(mBlob.size(), word);
+        offsets.append(mBlob.size());
+        counts.append(count);
+        mBlob.append(key);
+        mBlob.append('\0');
+    }
+
+    QVector<int> order(offsets.size());
+    for (int i = 0; i < order.size(); i++)
+        order[i] = i;
+    const char *blob = mBlob.constData();
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return strcmp(blob + offsets[a], blob + offsets[b]) < 0;
+    });
+
+    //! Duplicate keys (e.g. "Ram" and "ram") keep the first spelling and the highest count
+    mOffsets.reserve(order.size());
+    mCounts.reserve(order.size());
+    for (int i : order) {
+        if (!mOffsets.isEmpty() && strcmp(blob + mOffsets.last(), blob + offsets[i]) == 0) {
+            mCounts.last() = qMax(mCounts.last(), counts[i]);
+            continue;
+        }
+        mOffsets.append(offsets[i]);
+        mCounts.append(counts[i]);
+        if (display.contains(offsets[i]))
+            mDisplay.insert(offsets[i], display.value(offsets[i]));
+        if (counts[i] > 0)
+            mHasCounts = true;
+    }
+    mLoaded = true;
+}
+
+/*!
+ * \fn CompletionIndex::forScript
+ * \brief Returns the shared index of a script, loading its word list the first time it is asked for.
+ * \param script
+ * \return CompletionIndex*
+ */
+CompletionIndex *CompletionIndex::forScript(Script script)
+{
+    static const char *files[ScriptCount] = {
+        ":/WordList/wordlists/english.txt",
+        ":/WordList/wordlists/hindi.txt",
+        ":/WordList/wordlists/gujarati.txt"
+    };
+    static CompletionIndex *indexes[ScriptCount] = {};
+
+    if (!indexes[script]) {
+#ifndef QT_NO_CURSOR
+        QGuiApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+#endif
+        indexes[script] = new CompletionIndex(files[script]);
+#ifndef QT_NO_CURSOR
+        QGuiApplication::restoreOverrideCursor();
+#endif
+    }
+    return indexes[script];
+}
+
+/*!
+ * \fn CompletionIndex::scriptOf
+ * \brief Decides the script of a word from the code points of its characters.
+ * \details The first Devanagari (U+0900-U+097F, U+1CD0-U+1CFF, U+A8E0-U+A8FF) or Gujarati (U+0A80-U+0AFF)
+ * character decides; a word with neither is Latin.
+ * \param word
+ * \return Script
+ */
+CompletionIndex::Script CompletionIndex::scriptOf(const QString &word)
+{
+    for (const QChar &ch : word) {
+        ushort u = ch.unicode();
+        if ((u >= 0x0900 && u <= 0x097F) || (u >= 0x1CD0 && u <= 0x1CFF) || (u >= 0xA8E0 && u <= 0xA8FF))
+            return Devanagari;
+        if (u >= 0x0A80 && u <= 0x0AFF)
+            return Gujarati;
+    }
+    return Latin;
+}
+
+/*!
+ * \fn CompletionIndex::wordAt
+ * \param i Position in sorted order
+ * \return The word as it is spelt in the word list
+ */
+QString CompletionIndex::wordAt(int i) const
+{
+    auto it = mDisplay.constFind(mOffsets[i]);
+    if (it != mDisplay.constEnd())
+        return it.value();
+    return QString::fromUtf8(keyAt(i));
+}
+
+/*!
+ * \fn CompletionIndex::prefixRange
+ * \brief Finds the sorted positions of all words that start with prefix, ignoring case.
+ * \param prefix
+ * \return [first, last) positions; first == last if no word matches
+ */
+QPair<int, int> CompletionIndex::prefixRange(const QString &prefix) const
+{
+    QByteArray p = prefix.toLower().toUtf8();
+    const char *blob = mBlob.constData();
+    size_t len = p.size();
+    auto lo = std::partition_point(mOffsets.constBegin(), mOffsets.constEnd(), [&](quint32 o) {
+        return strncmp(blob + o, p.constData(), len) < 0;
+    });
+    auto hi = std::partition_point(lo, mOffsets.constEnd(), [&](quint32 o) {
+        return strncmp(blob + o, p.constData(), len) == 0;
+    });
+    return qMakePair(int(lo - mOffsets.constBegin()), int(hi - mOffsets.constBegin()));
+}
+
+/*!
+ * \fn CompletionIndex::topK
+ * \brief Returns at most k words starting with prefix, most frequent first and in sorted order among equals.
+ * \param prefix
+ * \param k
+ * \return QStringList
+ */
+QStringList CompletionIndex::topK(const QString &prefix, int k) const
+{
+    QStringList words;
+    QPair<int, int> range = prefixRange(prefix);
+    int n = range.second - range.first;
+    if (n <= 0 || k <= 0)
+        return words;
+    int m = qMin(k, n);
+    words.reserve(m);
+
+    if (!mHasCounts) {
+        for (int i = range.first; i < range.first + m; i++)
+            words << wordAt(i);
+        return words;
+    }
+
+    QVector<int> order(n);
+    for (int i = 0; i < n; i++)
+        order[i] = range.first + i;
+    std::partial_sort(order.begin(), order.begin() + m, order.end(), [this](int a, int b) {
+        return mCounts[a] != mCounts[b] ? mCounts[a] > mCounts[b] : a < b;
+    });
+    for (int i = 0; i < m; i++)
+        words << wordAt(order[i]);
+    return words;
+}
+
+/*!
+ * \fn CompletionIndex::recordUse
+ * \brief Counts a completion picked by the user so that it ranks higher for the rest of the session.
+ * \param word
+ */
+void CompletionIndex::recordUse(const QString &word)
+{
+    QByteArray key = word.toLower().toUtf8();
+    const char *blob = mBlob.constData();
+    auto it = std::lower_bound(mOffsets.constBegin(), mOffsets.constEnd(), key, [&](quint32 o, const QByteArray &k) {
+        return strcmp(blob + o, k.constData()) < 0;
+    });
+    if (it == mOffsets.constEnd() || strcmp(blob + *it, key.constData()) != 0)
+        return;
+    mCounts[int(it - mOffsets.constBegin())]++;
+    mHasCounts = true;
+}
@@ -0,0 +1,38 @@
+#ifndef COMPLETIONINDEX_H
+#define COMPLETIONINDEX_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class CompletionIndex
+{
+public:
+    enum Script { Latin, Devanagari, Gujarati, ScriptCount };
+
+    explicit CompletionIndex(const QString &fileName);
+    static CompletionIndex *forScript(Script script);
+    static Script scriptOf(const QString &word);
+
+    bool isLoaded() const { return mLoaded; }
+    int size() const { return mOffsets.size(); }
+    QString wordAt(int i) const;
+    QPair<int, int> prefixRange(const QString &prefix) const;
+    QStringList topK(const QString &prefix, int k) const;
+    void recordUse(const QString &word);
+
+private:
+    QByteArray mBlob;               //! Case-folded UTF-8 words, each terminated by '\0'
+    QVector<quint32> mOffsets;      //! Offsets into mBlob in byte order of the words
+    QVector<quint32> mCounts;       //! Frequency of the word at the same position as mOffsets
+    QHash<quint32, QString> mDisplay; //! Original spelling of the few words that differ from their folded key
+    bool mHasCounts = false;
+    bool mLoaded = false;
+
+    const char *keyAt(int i) const { return mBlob.constData() + mOffsets[i]; }
+};
+
+#endif // COMPLETIONINDEX_H
@@ -0,0 +1,194 @@
+/*!
+ * \class ConfusionRewriter
+ * \brief Rewrites an OCR word by the confusion rules mined from the corrected pages, most frequent rule first.
+ * \details The rules of ConfPmap ("left right" -> frequency) are grouped by their left side, with the right sides
+ * sorted by frequency, and the left sides are compiled into an Aho-Corasick automaton. rewrites() finds every left
+ * side in "@word#" in one pass and then takes the single-rule rewrites out of a priority queue in descending rule
+ * frequency, so the best ranked candidates come first and only as many are built as are asked for.
+ * \details This replaces the TopConfusions/TopConfusionsMask lookup of generatePossibilitesNsuggest(), which kept one
+ * right side per left side (the last one in map order) and probed every substring of length 1 to 3 at every offset.
+ * \sa slpNPatternDict::generatePossibilitesNsuggest(), slpNPatternDict::loadConfusionsFont()
+ */
+#include "confusionrewriter.h"
+#include <algorithm>
+#include <queue>
+#include <set>
+#include <tuple>
+
+/*!
+ * \fn ConfusionRewriter::ConfusionRewriter
+ * \brief Constructor of an empty rewriter, compile() loads the rules.
+ */
+ConfusionRewriter::ConfusionRewriter()
+{
+    clear();
+}
+
+/*!
+ * \fn ConfusionRewriter::ConfusionRewriter
+ * \brief Constructor
+ * \param ConfPmap Confusion rules as loaded by slpNPatternDict::loadConfusionsFont()
+ */
+ConfusionRewriter::ConfusionRewriter(const std::map<std::string, int> &ConfPmap)
+{
+    compile(ConfPmap);
+}
+
+/*!
+ * \fn ConfusionRewriter::clear
+ * \brief Drops all rules.
+ */
+void ConfusionRewriter::clear()
+{
+    mNodes.assign(1, Node());
+    mRules.clear();
+}
+
+/*!
+ * \fn ConfusionRewriter::ruleCount
+ * \return Number of (left, right) rules compiled
+ */
+size_t ConfusionRewriter::ruleCount() const
+{
+    size_t count = 0;
+    for (const Rules &rules : mRules)
+        count += rules.rights.size();
+    return count;
+}
+
+/*!
+ * \fn ConfusionRewriter::compile
+ * \brief Replaces the rules by the ones of ConfPmap.
+ * \details A key is split at its first space. Rules with an empty left side, which would apply at every offset, and
+ * rules that don't change anything are left out.
+ * \param ConfPmap Confusion rules "left right" with their frequencies
+ */
+void ConfusionRewriter::compile(const std::map<std::string, int> &ConfPmap)
+{
+    clear();
+    for (const auto &rule : ConfPmap) {
+        size_t space = rule.first.find(' ');
+        if (space == std::string::npos || space == 0 || rule.second <= 0)
+            continue;
+        std::string left = rule.first.substr(0, space);
+        std::string right = rule.first.substr(space + 1);
+        if (left == right)
+            continue;
+
+        int state = 0;
+        for (char c : left) {
+            auto it = mNodes[state].next.find(c);
+            if (it == mNodes[state].next.end()) {
+                int depth = mNodes[state].depth + 1;
+                mNodes[state].next[c] = mNodes.size();
+                state = mNodes.size();
+                mNodes.push_back(Node());
+                mNodes[state].depth = depth;
+            } else {
+                state = it->second;
+            }
+        }
+        if (mNodes[state].rules < 0) {
+            mNodes[state].rules = mRules.size();
+            mRules.push_back({ left, {} });
+        }
+        mRules[mNodes[state].rules].rights.emplace_back(rule.second, right);
+    }
+
+    for (Rules &rules : mRules)
+        std::stable_sort(rules.rights.begin(), rules.rights.end(),
+                         [](const std::pair<int, std::string> &a, const std::pair<int, std::string> &b) { return a.first > b.first; });
+
+    //! Fail and output links, breadth first so that a node's fail target is done before it
+    std::queue<int> queue;
+    for (const auto &child : mNodes[0].next)
+        queue.push(child.second);
+    while (!queue.empty()) {
+        int node = queue.front();
+        queue.pop();
+        for (const auto &child : mNodes[node].next) {
+            int fail = mNodes[node].fail;
+            while (fail > 0 && !mNodes[fail].next.count(child.first))
+                fail = mNodes[fail].fail;
+            auto it = mNodes[fail].next.find(child.first);
+            int target = (it != mNodes[fail].next.end() && it->second != child.second) ? it->second : 0;
+            mNodes[child.second].fail = target;
+            mNodes[child.second].output = mNodes[target].rules >= 0 ? target : mNodes[target].output;
+            queue.push(child.second);
+        }
+    }
+}
+
+/*!
+ * \fn ConfusionRewriter::step
+ * \return The automaton state after reading c in state
+ */
+int ConfusionRewriter::step(int state, char c) const
+{
+    while (true) {
+        auto it = mNodes[state].next.find(c);
+        if (it != mNodes[state].next.end())
+            return it->second;
+        if (state == 0)
+            return 0;
+        state = mNodes[state].fail;
+    }
+}
+
+/*!
+ * \fn ConfusionRewriter::rewrites
+ * \brief Enumerates the words one confusion rule away from word, most frequent rule first.
+ * \details The rules apply to "@word#", so rules mined at the start or end of a word only match there. Ties in
+ * frequency go to the shorter left side and then to the leftmost match. Rewrites that touch the markers without
+ * keeping them, and words already given, are skipped.
+ * \param word SLP1 word
+ * \param k Most rewrites to return
+ * \param budget Most rule applications to try, skipped ones included
+ * \return Up to k rewrites in descending rule frequency
+ */
+std::vector<ConfusionRewriter::Rewrite> ConfusionRewriter::rewrites(const std::string &word, size_t k, size_t budget) const
+{
+    std::vector<Rewrite> out;
+    if (mRules.empty() || k == 0)
+        return out;
+
+    const std::string wrapped = "@" + word + "#";
+    //! Every match as (position, rules)
+    std::vector<std::pair<size_t, int>> matches;
+    int state = 0;
+    for (size_t i = 0; i < wrapped.size(); i++) {
+        state = step(state, wrapped[i]);
+        for (int node = mNodes[state].rules >= 0 ? state : mNodes[state].output; node > 0; node = mNodes[node].output)
+            matches.emplace_back(i + 1 - mNodes[node].depth, mNodes[node].rules);
+    }
+
+    //! (frequency, -left length, -position, match, right) so that the top is the best next rewrite
+    typedef std::tuple<int, int, long, size_t, size_t> Candidate;
+    std::priority_queue<Candidate> queue;
+    for (size_t m = 0; m < matches.size(); m++) {
+        const Rules &rules = mRules[matches[m].second];
+        queue.emplace(rules.rights[0].first, -(int)rules.left.size(), -(long)matches[m].first, m, 0);
+    }
+
+    std::set<std::string> seen;
+    seen.insert(word);
+    while (!queue.empty() && budget > 0 && out.size() < k) {
+        Candidate top = queue.top();
+        queue.pop();
+        budget--;
+        size_t m = std::get<3>(top), r = std::get<4>(top);
+        const Rules &rules = mRules[matches[m].second];
+        if (r + 1 < rules.rights.size())
+            queue.emplace(rules.rights[r + 1].first, std::get<1>(top), std::get<2>(top), m, r + 1);
+
+        std::string rewritten = wrapped;
+        rewritten.replace(matches[m].first, rules.left.size(), rules.rights[r].second);
+        if (rewritten.size() < 2 || rewritten.front() != '@' || rewritten.back() != '#')
+            continue;
+        rewritten = rewritten.substr(1, rewritten.size() - 2);
+        if (rewritten.find_first_of("@#") != std::string::npos || !seen.insert(rewritten).second)
+            continue;
+        out.push_back({ rewritten, rules.rights[r].first, matches[m].first, rules.left, rules.rights[r].second });
+    }
+    return out;
+}
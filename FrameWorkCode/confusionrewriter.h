@@ -0,0 +1,52 @@
+#ifndef CONFUSIONREWRITER_H
+#define CONFUSIONREWRITER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+class ConfusionRewriter
+{
+public:
+    //! One rewrite of a word: the left side of a rule at pos replaced by its right side
+    struct Rewrite {
+        std::string word;
+        int freq;
+        size_t pos;
+        std::string left;
+        std::string right;
+    };
+
+    ConfusionRewriter();
+    explicit ConfusionRewriter(const std::map<std::string, int> &ConfPmap);
+
+    void compile(const std::map<std::string, int> &ConfPmap);
+    void clear();
+    bool empty() const { return mRules.empty(); }
+    size_t ruleCount() const;
+
+    std::vector<Rewrite> rewrites(const std::string &word, size_t k = 32, size_t budget = 256) const;
+
+private:
+    //! Right sides of one left side with their frequencies, most frequent first
+    struct Rules {
+        std::string left;
+        std::vector<std::pair<int, std::string>> rights;
+    };
+
+    //! Aho-Corasick automaton node over the bytes of the left sides
+    struct Node {
+        std::map<char, int> next;
+        int fail = 0;
+        int output = -1;    //! Nearest node on the fail chain, itself excluded, that ends a left side
+        int rules = -1;     //! Index into mRules if a left side ends here
+        int depth = 0;
+    };
+
+    std::vector<Node> mNodes;
+    std::vector<Rules> mRules;
+
+    int step(int state, char c) const;
+};
+
+#endif // CONFUSIONREWRITER_H
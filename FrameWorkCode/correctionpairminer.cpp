@@ -0,0 +1,408 @@
+/*!
+ * \class CorrectionPairMiner
+ * \brief Mines correction pairs and confusion rules from every corrected page of a book in parallel.
+ * \details slpNPatternDict::generateCorrectionPairs() pairs each OCR word with the corrected word of least edit
+ * distance in a window around its position, computing a full edit distance for every word of the window. Here the
+ * words of a page are aligned as two sequences instead: a dynamic program over a band of the same width around the
+ * diagonal, where keeping a word costs nothing, replacing it costs the edit distance of the two words and dropping or
+ * adding a word costs its length. The edit distance is only computed up to the length of the longer word, which is
+ * all the alignment can use, and the pages are tokenized and converted to SLP1 by the shared PageTokenCache, so a
+ * word is converted once however many pages it occurs on.
+ * \details A replaced word whose edit distance is below the length of the longer word gives a pair (OCR word,
+ * corrected word), and the pair gives the confusion rules loadConfusionsFont() would find for it.
+ * \details Pages are mined on the global thread pool. The pairs and rules of every page are cached with a SHA-1 hash
+ * of both files, in memory and, with save(), in a file of the user's cache folder, so mining the book again only aligns
+ * the pages that were edited since.
+ * \sa slpNPatternDict::generateCorrectionPairs(), slpNPatternDict::loadConfusionsFont(), LoadDataWorker
+ */
+#include "correctionpairminer.h"
+#include "eddis.h"
+#include "pagetokencache.h"
+#include "slpNPatternDict.h"
+#include "tracer.h"
+#include <QAtomicInt>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QSaveFile>
+#include <QTextDocument>
+#include <QTextStream>
+#include <QThread>
+#include <QDebug>
+#include "QtConcurrent/qtconcurrentrun.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+static const quint32 CacheMagic = 0x43504d31;    //! "CPM1"
+
+/*!
+ * \fn CorrectionPairMiner::CorrectionPairMiner
+ * \brief Constructor
+ * \param cachePath File the mined pages are kept in between runs, e.g. from MappedTable::cachePath(); empty for none
+ * \param threads Threads used by mine(), 0 for QThread::idealThreadCount()
+ */
+CorrectionPairMiner::CorrectionPairMiner(QString cachePath, int threads)
+{
+    this->mCachePath = cachePath;
+    this->mThreads = threads;
+}
+
+/*!
+ * \fn CorrectionPairMiner::bookPages
+ * \brief Lists the OCR pages of a set that have a corrected version.
+ * \details The corrected version of Inds/page.txt is VerifierOutput/page.html if the page was verified, else
+ * CorrectorOutput/page.html.
+ * \param setDir Set directory holding Inds, CorrectorOutput and VerifierOutput
+ * \return Pages in the order of Inds
+ */
+QVector<CorrectionPairMiner::Page> CorrectionPairMiner::bookPages(const QString &setDir)
+{
+    QVector<Page> pages;
+    for (const QString &name : QDir(setDir + "/Inds").entryList(QStringList("*.txt"), QDir::Files)) {
+        QString html = QString(name).replace(".txt", ".html");
+        QString corrected = setDir + "/VerifierOutput/" + html;
+        if (!QFileInfo::exists(corrected))
+            corrected = setDir + "/CorrectorOutput/" + html;
+        if (QFileInfo::exists(corrected))
+            pages.append({ name, setDir + "/Inds/" + name, corrected });
+    }
+    return pages;
+}
+
+/*!
+ * \fn CorrectionPairMiner::hashFiles
+ * \return SHA-1 of the contents of both files of a page
+ */
+QByteArray CorrectionPairMiner::hashFiles(const QByteArray &ocr, const QByteArray &corrected)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(ocr.size()));
+    hash.addData(ocr);
+    hash.addData(corrected);
+    return hash.result();
+}
+
+/*!
+ * \fn CorrectionPairMiner::wordDistance
+ * \brief Edit distance of two words, computed only as far as it stays below cap.
+ * \return The edit distance, or cap if it is cap or more
+ * \sa eddis::distanceAtMost()
+ */
+int CorrectionPairMiner::wordDistance(const std::string &a, const std::string &b, int cap)
+{
+    if (a == b)
+        return 0;
+    return int(eddis::distanceAtMost(a, b, cap - 1));
+}
+
+/*!
+ * \fn CorrectionPairMiner::align
+ * \brief Aligns the words of an OCR page with the words of its corrected version.
+ * \details The band is as wide as the window of generateCorrectionPairs(): the difference in word count, at least 5
+ * words, on either side of the diagonal.
+ * \param ocr Words of the OCR page in SLP1
+ * \param corrected Words of the corrected page in SLP1
+ * \return (OCR word, corrected word) for every replaced word that shares letters with its replacement, in page order
+ */
+std::vector<std::pair<std::string, std::string>> CorrectionPairMiner::align(const std::vector<std::string> &ocr,
+                                                                            const std::vector<std::string> &corrected)
+{
+    std::vector<std::pair<std::string, std::string>> out;
+    const int n = ocr.size(), m = corrected.size();
+    if (n == 0 || m == 0)
+        return out;
+    const int win = std::max(std::abs(m - n), 5);
+    const int width = 2 * win + 1;
+    //! Row i covers the corrected words lo(i) .. lo(i) + width - 1
+    auto lo = [&](int i) { return int((long long)i * m / n) - win; };
+
+    enum Step : unsigned char { None, Keep, Drop, Add };
+    std::vector<int> prev(width, INT_MAX), cur(width);
+    std::vector<unsigned char> steps((size_t)(n + 1) * width, None);
+    auto at = [&](int i, int j) -> unsigned char & { return steps[(size_t)i * width + (j - lo(i))]; };
+
+    //! Row 0: only corrected words added
+    for (int j = std::max(lo(0), 0), acc = 0; j < std::min(lo(0) + width, m + 1); j++) {
+        if (j > 0)
+            acc += int(corrected[j - 1].size());
+        prev[j - lo(0)] = acc;
+        at(0, j) = j > 0 ? Add : None;
+    }
+    for (int i = 1; i <= n; i++) {
+        const int l = lo(i), pl = lo(i - 1);
+        auto prevCost = [&](int j) { return (j >= pl && j < pl + width && j >= 0) ? prev[j - pl] : INT_MAX; };
+        const std::string &a = ocr[i - 1];
+        for (int k = 0; k < width; k++) {
+            int j = l + k;
+            cur[k] = INT_MAX;
+            if (j < 0 || j > m)
+                continue;
+            int best = INT_MAX;
+            unsigned char step = None;
+            if (prevCost(j) != INT_MAX) {
+                best = prevCost(j) + int(a.size());
+                step = Drop;
+            }
+            if (j > 0 && prevCost(j - 1) != INT_MAX) {
+                const std::string &b = corrected[j - 1];
+                int cap = std::max(a.size(), b.size());
+                int cost = prevCost(j - 1) + wordDistance(a, b, cap);
+                if (cost <= best) {
+                    best = cost;
+                    step = Keep;
+                }
+            }
+            if (k > 0 && cur[k - 1] != INT_MAX && cur[k - 1] + int(corrected[j - 1].size()) < best) {
+                best = cur[k - 1] + int(corrected[j - 1].size());
+                step = Add;
+            }
+            cur[k] = best;
+            at(i, j) = step;
+        }
+        std::swap(prev, cur);
+    }
+
+    //! Walk back from (n, m), which the band always covers
+    int i = n, j = m;
+    while (i > 0 || j > 0) {
+        unsigned char step = at(i, j);
+        if (step == Keep) {
+            const std::string &a = ocr[i - 1], &b = corrected[j - 1];
+            if (a != b && wordDistance(a, b, std::max(a.size(), b.size())) < int(std::max(a.size(), b.size())))
+                out.emplace_back(a, b);
+            i--;
+            j--;
+        } else if (step == Drop) {
+            i--;
+        } else if (step == Add) {
+            j--;
+        } else {
+            break;
+        }
+    }
+    std::reverse(out.begin(), out.end());
+    return out;
+}
+
+/*!
+ * \fn CorrectionPairMiner::minePage
+ * \brief Aligns one page and finds the confusion rules of its pairs.
+ * \param ocr Content of the OCR text file
+ * \param corrected Content of the corrected file
+ * \param html true if corrected is html, whose plain text is aligned
+ * \return Entry without hash
+ */
+CorrectionPairMiner::Entry CorrectionPairMiner::minePage(const QByteArray &ocr, const QByteArray &corrected, bool html)
+{
+    Entry entry;
+    QString correctedText = QString::fromUtf8(corrected);
+    if (html) {
+        QTextDocument doc;
+        doc.setHtml(correctedText);
+        correctedText = doc.toPlainText();
+    }
+    PageTokenCache &tokens = PageTokenCache::shared();
+    entry.pairs = align(tokens.text(ocr)->slp1(), tokens.text(correctedText.toUtf8())->slp1());
+    slpNPatternDict slnp;
+    for (const auto &pair : entry.pairs)
+        slnp.appendConfusionsPairs(pair.first, pair.second, entry.confusions);
+    return entry;
+}
+
+/*!
+ * \fn CorrectionPairMiner::mine
+ * \brief Mines the pages that are new or changed since they were last mined, in parallel.
+ * \details pairs() and feed() then cover exactly these pages.
+ * \param pages
+ * \return Stats
+ */
+CorrectionPairMiner::Stats CorrectionPairMiner::mine(const QVector<Page> &pages)
+{
+    TRACE_SCOPE("CorrectionPairMiner::mine");
+    Stats stats;
+    stats.pages = pages.size();
+    QVector<Entry> entries(pages.size());
+    QVector<bool> ok(pages.size(), false);
+
+    QAtomicInt next(0);
+    QAtomicInt mined(0);
+    auto work = [&]() {
+        int i;
+        while ((i = next.fetchAndAddRelaxed(1)) < pages.size()) {
+            QFile ocrFile(pages[i].ocrPath), correctedFile(pages[i].correctedPath);
+            if (!ocrFile.open(QIODevice::ReadOnly) || !correctedFile.open(QIODevice::ReadOnly))
+                continue;
+            QByteArray ocr = ocrFile.readAll(), corrected = correctedFile.readAll();
+            QByteArray hash = hashFiles(ocr, corrected);
+            ok[i] = true;
+            {
+                QMutexLocker locker(&mMutex);
+                auto cached = mCache.constFind(pages[i].key);
+                if (cached != mCache.constEnd() && cached->hash == hash)
+                    continue;
+            }
+            entries[i] = minePage(ocr, corrected, pages[i].correctedPath.endsWith(".html"));
+            entries[i].hash = hash;
+            mined.fetchAndAddRelaxed(1);
+        }
+    };
+    int threads = mThreads > 0 ? mThreads : QThread::idealThreadCount();
+    threads = std::max(1, std::min(threads, int(pages.size())));
+    QVector<QFuture<void>> futures;
+    for (int t = 1; t < threads; t++)
+        futures.append(QtConcurrent::run(work));
+    work();
+    for (QFuture<void> &future : futures)
+        future.waitForFinished();
+
+    QMutexLocker locker(&mMutex);
+    mLastPages.clear();
+    for (int i = 0; i < pages.size(); i++) {
+        if (!ok[i]) {
+            stats.failed++;
+            continue;
+        }
+        if (!entries[i].hash.isEmpty())
+            mCache.insert(pages[i].key, entries[i]);
+        mLastPages.append(pages[i].key);
+        stats.pairs += mCache[pages[i].key].pairs.size();
+    }
+    stats.mined = mined.load();
+    stats.cached = stats.pages - stats.failed - stats.mined;
+    return stats;
+}
+
+/*!
+ * \fn CorrectionPairMiner::pairs
+ * \brief Appends the pairs of the pages of the last mine(), in page order.
+ * \param wrong OCR words
+ * \param right Corrected words
+ */
+void CorrectionPairMiner::pairs(std::vector<std::string> &wrong, std::vector<std::string> &right) const
+{
+    QMutexLocker locker(&mMutex);
+    for (const QString &key : mLastPages) {
+        for (const auto &pair : mCache.constFind(key)->pairs) {
+            wrong.push_back(pair.first);
+            right.push_back(pair.second);
+        }
+    }
+}
+
+/*!
+ * \fn CorrectionPairMiner::feed
+ * \brief Adds what the last mine() found to the tables of LoadDataWorker.
+ * \details Every confusion rule is counted into ConfPmap, as loadConfusionsFont() counts it. A pair is added to
+ * CPairs only if its OCR word has no entry yet, so the pairs of the CPair file keep precedence.
+ * \param ConfPmap
+ * \param CPairs
+ * \return Number of pairs added to CPairs
+ */
+int CorrectionPairMiner::feed(std::map<std::string, int> &ConfPmap, std::map<std::string, std::set<std::string>> &CPairs) const
+{
+    int added = 0;
+    QMutexLocker locker(&mMutex);
+    for (const QString &key : mLastPages) {
+        const Entry &entry = *mCache.constFind(key);
+        for (const std::string &rule : entry.confusions)
+            ConfPmap[rule]++;
+        for (const auto &pair : entry.pairs) {
+            if (CPairs.find(pair.first) == CPairs.end()) {
+                CPairs[pair.first].insert(pair.second);
+                added++;
+            }
+        }
+    }
+    return added;
+}
+
+/*!
+ * \fn CorrectionPairMiner::clear
+ * \brief Forgets every mined page.
+ */
+void CorrectionPairMiner::clear()
+{
+    QMutexLocker locker(&mMutex);
+    mCache.clear();
+    mLastPages.clear();
+}
+
+/*!
+ * \fn CorrectionPairMiner::save
+ * \brief Writes the mined pages to the cache file atomically.
+ * \return bool
+ */
+bool CorrectionPairMiner::save()
+{
+    if (mCachePath.isEmpty())
+        return false;
+    QMutexLocker locker(&mMutex);
+    QSaveFile file(mCachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Can't write correction pair cache" << mCachePath;
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_3);
+    out << CacheMagic << qint32(mCache.size());
+    for (auto it = mCache.constBegin(); it != mCache.constEnd(); ++it) {
+        out << it.key() << it->hash << qint32(it->pairs.size());
+        for (const auto &pair : it->pairs)
+            out << QByteArray::fromStdString(pair.first) << QByteArray::fromStdString(pair.second);
+        out << qint32(it->confusions.size());
+        for (const std::string &rule : it->confusions)
+            out << QByteArray::fromStdString(rule);
+    }
+    return file.commit();
+}
+
+/*!
+ * \fn CorrectionPairMiner::load
+ * \brief Reads the pages mined in an earlier run.
+ * \return false if there is no readable cache file
+ */
+bool CorrectionPairMiner::load()
+{
+    QMutexLocker locker(&mMutex);
+    mCache.clear();
+    mLastPages.clear();
+    QFile file(mCachePath);
+    if (mCachePath.isEmpty() || !file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_3);
+    quint32 magic;
+    qint32 pages;
+    in >> magic;
+    if (magic != CacheMagic)
+        return false;
+    in >> pages;
+    for (qint32 p = 0; p < pages && in.status() == QDataStream::Ok; p++) {
+        QString key;
+        Entry entry;
+        qint32 count;
+        in >> key >> entry.hash >> count;
+        for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+            QByteArray wrong, right;
+            in >> wrong >> right;
+            entry.pairs.emplace_back(wrong.toStdString(), right.toStdString());
+        }
+        in >> count;
+        for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+            QByteArray rule;
+            in >> rule;
+            entry.confusions.push_back(rule.toStdString());
+        }
+        mCache.insert(key, entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qDebug() << "Discarding damaged correction pair cache" << mCachePath;
+        mCache.clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef CORRECTIONPAIRMINER_H
+#define CORRECTIONPAIRMINER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CorrectionPairMiner
+{
+public:
+    //! One page of the book: the OCR text and its corrected version, txt or html
+    struct Page {
+        QString key;
+        QString ocrPath;
+        QString correctedPath;
+    };
+
+    //! Outcome of mine()
+    struct Stats {
+        int pages = 0;          //! Pages given
+        int mined = 0;          //! Pages aligned because they were new or changed
+        int cached = 0;         //! Pages taken from the cache
+        int failed = 0;         //! Pages whose files could not be read
+        int pairs = 0;          //! Correction pairs of all pages
+    };
+
+    explicit CorrectionPairMiner(QString cachePath = QString(), int threads = 0);
+
+    bool load();
+    bool save();
+    void clear();
+    Stats mine(const QVector<Page> &pages);
+    void pairs(std::vector<std::string> &wrong, std::vector<std::string> &right) const;
+    int feed(std::map<std::string, int> &ConfPmap, std::map<std::string, std::set<std::string>> &CPairs) const;
+    QString cachePath() const { return mCachePath; }
+
+    static QVector<Page> bookPages(const QString &setDir);
+    static std::vector<std::pair<std::string, std::string>> align(const std::vector<std::string> &ocr,
+                                                                  const std::vector<std::string> &corrected);
+
+private:
+    //! Pairs and confusions of one page, with the hash of the files they were mined from
+    struct Entry {
+        QByteArray hash;
+        std::vector<std::pair<std::string, std::string>> pairs;
+        std::vector<std::string> confusions;    //! "left right" rules of every pair, as loadConfusionsFont() finds them
+    };
+
+    QString mCachePath;
+    int mThreads;
+    mutable QMutex mMutex;          //! Guards mCache and mLastPages
+    QHash<QString, Entry> mCache;   //! Mined pages by page key
+    QVector<QString> mLastPages;    //! Keys of the pages of the last mine(), in order
+
+    static QByteArray hashFiles(const QByteArray &ocr, const QByteArray &corrected);
+    static Entry minePage(const QByteArray &ocr, const QByteArray &corrected, bool html);
+    static int wordDistance(const std::string &a, const std::string &b, int cap);
+};
+
+#endif // CORRECTIONPAIRMINER_H
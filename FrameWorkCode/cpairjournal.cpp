@@ -0,0 +1,207 @@
+/*!
+ * \class CPairJournal
+ * \brief Keeps the Dicts/<Role>_CPair file up to date with an append-only journal.
+ * \details New correction pairs are appended to <Role>_CPair.journal as "incorrect(tab)correct" lines, so a save costs
+ * O(new pairs) and never rewrites or truncates existing data. Duplicate checks use an in-memory hash of the incorrect
+ * words that is built once when the project is opened.
+ * \details Once the journal grows past compactThreshold records, compact() folds it into the base file. The merged
+ * file is written with QSaveFile and atomically renamed over the base, and only then is the journal emptied; a crash
+ * at any point leaves either the old base plus the journal or the new base plus a redundant journal.
+ * \details If a crash tore the last journal line, open() cuts the journal back to its last complete record.
+ */
+#include "cpairjournal.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QByteArray>
+#include <QStringList>
+#include <QDebug>
+
+/*!
+ * \fn CPairJournal::CPairJournal
+ * \brief Constructor
+ * \param basePath Path of the CPair file, e.g. Dicts/Corrector_CPair
+ * \param compactThreshold Number of journal records after which needsCompaction() returns true
+ */
+CPairJournal::CPairJournal(QString basePath, int compactThreshold)
+{
+    this->mBasePath = basePath;
+    this->mJournalPath = basePath + ".journal";
+    this->compactThreshold = compactThreshold;
+}
+
+/*!
+ * \fn CPairJournal::open
+ * \brief Builds the duplicate index from the base file and the journal, repairing a torn journal tail.
+ * \return bool
+ */
+bool CPairJournal::open()
+{
+    QMutexLocker locker(&mMutex);
+    mIndex.clear();
+    mJournalRecords = 0;
+    indexFile(mBasePath, false);
+    indexFile(mJournalPath, true);
+    return true;
+}
+
+/*!
+ * \fn CPairJournal::indexFile
+ * \brief Adds the incorrect word of every complete "incorrect(tab)correct" line of a file to the index.
+ * \param path
+ * \param repairTail When true the file is the journal: its records are counted and an incomplete last line is cut off
+ */
+void CPairJournal::indexFile(const QString &path, bool repairTail)
+{
+    QFile file(path);
+    if (!file.open(repairTail ? QIODevice::ReadWrite : QIODevice::ReadOnly))
+        return;
+    QByteArray data = file.readAll();
+    int end = data.lastIndexOf('\n') + 1;
+    if (repairTail && end < data.size()) {
+        qDebug() << "Discarding torn CPair journal record in" << path;
+        file.resize(end);
+    }
+    if (!repairTail)
+        end = data.size();
+
+    int start = 0;
+    while (start < end) {
+        int nl = data.indexOf('\n', start);
+        if (nl < 0 || nl > end)
+            nl = end;
+        int tab = data.indexOf('\t', start);
+        if (tab >= 0 && tab < nl) {
+            mIndex.insert(QString::fromUtf8(data.constData() + start, tab - start));
+            if (repairTail)
+                mJournalRecords++;
+        }
+        start = nl + 1;
+    }
+    file.close();
+}
+
+/*!
+ * \fn CPairJournal::isStorable
+ * \brief Special symbols are not added to the CPair file; a word is stored if it has at least one other character.
+ * \param word
+ * \return bool
+ */
+bool CPairJournal::isStorable(const QString &word)
+{
+    static const QString special_symbols = "~`!@#$%^&*()-+={}[]|\"/: ;'<>,.?;";
+    for (const QChar &ch : word) {
+        if (!special_symbols.contains(ch))
+            return true;
+    }
+    return false;
+}
+
+/*!
+ * \fn CPairJournal::append
+ * \brief Appends the pairs whose incorrect word is not yet known to the journal.
+ * \details The first correction recorded for a word wins, as it always has for the CPair file.
+ * \param pairs
+ * \return Number of records appended, -1 if the journal could not be written
+ */
+int CPairJournal::append(const std::map<std::string, std::string> &pairs)
+{
+    QMutexLocker locker(&mMutex);
+    QByteArray records;
+    QStringList added;
+    for (auto &elem : pairs) {
+        QString wrong = QString::fromStdString(elem.first);
+        if (wrong.isEmpty() || elem.second.empty() || mIndex.contains(wrong) || !isStorable(wrong))
+            continue;
+        records += wrong.toUtf8() + '\t' + QByteArray::fromStdString(elem.second) + '\n';
+        added.append(wrong);
+    }
+    if (added.isEmpty())
+        return 0;
+
+    QFile journal(mJournalPath);
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "Can't open CPair journal" << mJournalPath;
+        return -1;
+    }
+    bool ok = journal.write(records) == records.size() && journal.flush();
+    journal.close();
+    if (!ok)
+        return -1;
+    for (const QString &wrong : added)
+        mIndex.insert(wrong);
+    mJournalRecords += added.size();
+    return added.size();
+}
+
+/*!
+ * \fn CPairJournal::needsCompaction
+ * \return true once the journal holds more than compactThreshold records
+ */
+bool CPairJournal::needsCompaction()
+{
+    QMutexLocker locker(&mMutex);
+    return mJournalRecords > compactThreshold;
+}
+
+/*!
+ * \fn CPairJournal::compact
+ * \brief Folds the journal into the base CPair file.
+ * \details Journal records never repeat a word of the base file, so the new base is the old base followed by the
+ * journal. It is committed atomically before the journal is emptied.
+ * \return bool
+ */
+bool CPairJournal::compact()
+{
+    QMutexLocker locker(&mMutex);
+    QFile base(mBasePath), journal(mJournalPath);
+    QByteArray baseData, journalData;
+    if (base.open(QIODevice::ReadOnly)) {
+        baseData = base.readAll();
+        base.close();
+    }
+    if (!journal.open(QIODevice::ReadOnly))
+        return mJournalRecords == 0;
+    journalData = journal.readAll();
+    journal.close();
+    journalData.truncate(journalData.lastIndexOf('\n') + 1);
+    if (journalData.isEmpty())
+        return true;
+
+    QSaveFile merged(mBasePath);
+    if (!merged.open(QIODevice::WriteOnly))
+        return false;
+    merged.write(baseData);
+    if (!baseData.isEmpty() && !baseData.endsWith('\n'))
+        merged.write("\n");
+    merged.write(journalData);
+    if (!merged.commit()) {
+        qDebug() << "CPair compaction failed, journal kept";
+        return false;
+    }
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    journal.close();
+    mJournalRecords = 0;
+    return true;
+}
+
+/*!
+ * \fn CPairJournal::contains
+ * \param word
+ * \return true if word already has a correction in the base file or the journal
+ */
+bool CPairJournal::contains(const QString &word)
+{
+    QMutexLocker locker(&mMutex);
+    return mIndex.contains(word);
+}
+
+/*!
+ * \fn CPairJournal::size
+ * \return Number of incorrect words known to the journal and base file
+ */
+int CPairJournal::size()
+{
+    QMutexLocker locker(&mMutex);
+    return mIndex.size();
+}
@@ -0,0 +1,34 @@
+#ifndef CPAIRJOURNAL_H
+#define CPAIRJOURNAL_H
+
+#include <QString>
+#include <QSet>
+#include <QMutex>
+#include <map>
+#include <string>
+
+class CPairJournal {
+public:
+    explicit CPairJournal(QString basePath, int compactThreshold = 2000);
+    bool open();
+    int append(const std::map<std::string, std::string> &pairs);
+    bool needsCompaction();
+    bool compact();
+    bool contains(const QString &word);
+    int size();
+    QString basePath() const { return mBasePath; }
+    QString journalPath() const { return mJournalPath; }
+
+private:
+    QString mBasePath;
+    QString mJournalPath;
+    int compactThreshold;
+    int mJournalRecords = 0;
+    QSet<QString> mIndex;   //! Incorrect words already present in the base file or the journal
+    QMutex mMutex;
+
+    void indexFile(const QString &path, bool repairTail);
+    static bool isStorable(const QString &word);
+};
+
+#endif // CPAIRJOURNAL_H
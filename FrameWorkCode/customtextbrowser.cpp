@@ -1,4 +1,5 @@
 #include "customtextbrowser.h"
+#include "completionindex.h"
 
 #include <QCompleter>
 #include <QKeyEvent>
@@ -15,6 +16,7 @@
  * \fn CustomTextBrowser::CustomTextBrowser
  * \brief This class is used for creating a custom QTextBrowser which supports auto-completion
  * \details Auto-completion suggestions are being shown on the basis of the words stored in the specific language file. It matches by taking the first 3 letters of the words and then gives suggestions whose prefix matches.
+ * The word lists are loaded once per script into a shared CompletionIndex.
  * \param QWidget *parent
  */
 CustomTextBrowser::CustomTextBrowser(QWidget *parent): QTextBrowser(parent)
@@ -39,12 +41,6 @@ CustomTextBrowser::CustomTextBrowser(QWidget *parent): QTextBrowser(parent)
                                         "  ⚫ Select the project you want to open from the list of recent projects.\n"
                                         "For detailed instructions, you can refer to the User Guide under the 'Help' menu.");
 
-    if(modelFlag == 0){
-        engModel = modelFromFile(":/WordList/wordlists/english.txt");
-        devModel = modelFromFile(":/WordList/wordlists/sanskrit.txt");
-        modelFlag = 1;
-    }
-
     // Setup grip band
     m_gripBand = new RubberBand(this);
     m_gripBand->setMoveEnabled(false);
@@ -81,8 +77,11 @@ void CustomTextBrowser::setCompleter(QCompleter *completer)
     if (!c)
         return;
 
+    //! The model only ever holds the top completions of the current prefix, so the completer must not filter it again
+    completionModel = new QStringListModel(c);
+    c->setModel(completionModel);
     c->setWidget(this);
-    c->setCompletionMode(QCompleter::PopupCompletion);
+    c->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
     c->setCaseSensitivity(Qt::CaseInsensitive);
     QObject::connect(c, QOverload<const QString &>::of(&QCompleter::activated),
                      this, &CustomTextBrowser::insertCompletion);
@@ -98,37 +97,6 @@ QCompleter *CustomTextBrowser::completer() const
     return c;
 }
 
-/*!
- * \fn CustomTextBrowser::modelFromFile
- * \brief This function takes a filename and reads the data line by line and adds it to an array which it stores in the QStringListModel and returns this model.
- * \param fileName
- * \return QAbstractItemModel *model
- */
-QAbstractItemModel *CustomTextBrowser::modelFromFile(const QString& fileName)
-{
-	QFile file(fileName);
-	if (!file.open(QFile::ReadOnly)){
-
-		qDebug()<<"File not opened...";
-        return new QStringListModel(nullptr);
-	}
-#ifndef QT_NO_CURSOR
-	QGuiApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-#endif
-	QStringList words;
-
-	while (!file.atEnd()) {
-		QByteArray line = file.readLine();
-		if (!line.isEmpty())
-			words << QString::fromUtf8(line.trimmed());
-	}
-
-#ifndef QT_NO_CURSOR
-	QGuiApplication::restoreOverrideCursor();
-#endif
-    return new QStringListModel(words, nullptr);
-}
-
 /*!
  * \fn CustomTextBrowser::insertCompletion
  * \brief This function inserts the top-most suggestion in the browser
@@ -144,6 +112,7 @@ void CustomTextBrowser::insertCompletion(const QString &completion)
     tc.movePosition(QTextCursor::EndOfWord);
     tc.insertText(completion.right(extra));
     setTextCursor(tc);
+    CompletionIndex::forScript(CompletionIndex::scriptOf(completion))->recordUse(completion);
 }
 
 /*!
@@ -286,30 +255,17 @@ void CustomTextBrowser::keyPressEvent(QKeyEvent *e)
         return;
     }
 
-    string str = completionPrefix.toStdString();
-    slpNPatternDict justForCheck ;
-    int  x = 0;
-    x = (str == justForCheck.toDev(str));
-    if(e->key()==Qt::Key_Tab || e->key()== Qt::Key_Enter || e->key()== Qt::Key_Space) x = 0;
-
-    else if(x)
-    {
-        x=1;
-        c->setModel(devModel);
-        c->setModelSorting(QCompleter::CaseInsensitivelySortedModel);
-    }
-    else
-    {
-        x=1;
-        c->setModel(engModel);
-        c->setModelSorting(QCompleter::CaseInsensitivelySortedModel);
-        c->setCaseSensitivity(Qt::CaseInsensitive);
-    }
-
+    //! The script is told apart by code point ranges, the typed prefix is not transliterated
     if (completionPrefix != c->completionPrefix()) {
+        CompletionIndex *index = CompletionIndex::forScript(CompletionIndex::scriptOf(completionPrefix));
+        completionModel->setStringList(index->topK(completionPrefix, maxCompletions));
         c->setCompletionPrefix(completionPrefix);
         c->popup()->setCurrentIndex(c->completionModel()->index(0, 0));
     }
+    if (completionModel->rowCount() == 0) {
+        c->popup()->hide();
+        return;
+    }
     QRect cr = cursorRect();
     cr.setWidth(c->popup()->sizeHintForColumn(0)
                 + c->popup()->verticalScrollBar()->sizeHint().width());
@@ -9,6 +9,7 @@
 QT_BEGIN_NAMESPACE
 class QCompleter;
 class QAbstractItemModel;
+class QStringListModel;
 QT_END_NAMESPACE
 
 //! [0]
@@ -22,10 +23,7 @@ public:
 
     void setCompleter(QCompleter *c);
     QCompleter *completer() const;
-    QAbstractItemModel *modelFromFile(const QString&);
-    static int modelFlag;
-    static QAbstractItemModel *engModel ;
-    static QAbstractItemModel *devModel ;
+    static const int maxCompletions = 100;
 
 protected:
     void keyPressEvent(QKeyEvent *e) override;
@@ -42,6 +40,7 @@ private:
 
 private:
     QCompleter *c = nullptr;
+    QStringListModel *completionModel = nullptr;
     RubberBand *m_gripBand;
 };
 //! [0]
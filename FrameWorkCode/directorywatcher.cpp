@@ -0,0 +1,158 @@
+/*!
+ * \class DirectoryWatcher
+ * \brief Watches the CorrectorOutput and VerifierOutput folders of a set from a background thread.
+ * \details A save, a git checkout or a fetch touches many files at once and QFileSystemWatcher reports every one of
+ * them. The watcher only marks the directory as dirty and waits until no notification has arrived for coalesceMs
+ * (but never longer than maxDelayMs after the first one). It then lists each dirty directory once, compares the listing
+ * with the files it reported last time and emits changed() with the added and the removed names, so the GUI thread
+ * gets one batch per burst and never lists a directory itself.
+ * \details Temporary files that are created and renamed within one burst, e.g. by QSaveFile, never show up in a batch.
+ * \sa MainWindow::directoryFilesChanged(), Project::AddTemp(), Project::RemoveTemp()
+ */
+#include "directorywatcher.h"
+#include <QDir>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+/*!
+ * \fn DirectoryWatcher::DirectoryWatcher
+ * \brief Constructor
+ * \param parent
+ * \param coalesceMs Quiet period after the last notification before the dirty directories are listed
+ * \param maxDelayMs Upper bound on how long a change can go unreported during a continuous burst
+ */
+DirectoryWatcher::DirectoryWatcher(QObject *parent, int coalesceMs, int maxDelayMs)
+    : QObject{parent}
+{
+    this->coalesceMs = coalesceMs;
+    this->maxDelayMs = maxDelayMs;
+}
+
+/*!
+ * \fn DirectoryWatcher::start
+ * \brief Creates the file system watcher and the coalescing timer. Connect this to QThread::started() after
+ * moveToThread() so that both live in the watcher thread.
+ */
+void DirectoryWatcher::start()
+{
+    mWatcher = new QFileSystemWatcher(this);
+    connect(mWatcher, SIGNAL(directoryChanged(const QString&)), this, SLOT(directoryChanged(const QString&)));
+    mTimer = new QTimer(this);
+    mTimer->setSingleShot(true);
+    connect(mTimer, SIGNAL(timeout()), this, SLOT(scanOnTimeout()));
+}
+
+/*!
+ * \fn DirectoryWatcher::stop
+ * \brief Stops watching without reporting pending changes and emits stopped(). Connect stopped() to QThread::quit()
+ * with Qt::DirectConnection, stopDirectoryWatcher() waits for the thread on the thread a queued quit() would run on.
+ */
+void DirectoryWatcher::stop()
+{
+    if (mTimer)
+        mTimer->stop();
+    if (mWatcher && !mWatcher->directories().isEmpty())
+        mWatcher->removePaths(mWatcher->directories());
+    mKnown.clear();
+    mDirty.clear();
+    emit stopped();
+}
+
+/*!
+ * \fn DirectoryWatcher::watch
+ * \brief Starts watching a directory.
+ * \param path
+ * \param files Names of the files the caller already knows about; only changes relative to these are reported
+ */
+void DirectoryWatcher::watch(QString path, QStringList files)
+{
+    path = QDir::cleanPath(path);
+    QSet<QString> &known = mKnown[path];
+    known.clear();
+    for (const QString &f : files)
+        known.insert(f);
+    if (mWatcher && !mWatcher->directories().contains(path))
+        mWatcher->addPath(path);
+    //! Catch files that appeared between the caller's listing and now
+    directoryChanged(path);
+}
+
+/*!
+ * \fn DirectoryWatcher::directoryChanged
+ * \brief Marks the directory as dirty and restarts the quiet-period timer, or lists at once if the first
+ * notification of the burst has waited maxDelayMs.
+ * \param path
+ */
+void DirectoryWatcher::directoryChanged(const QString &path)
+{
+    QString dir = QDir::cleanPath(path);
+    if (!mKnown.contains(dir))
+        return;
+    if (mDirty.isEmpty())
+        mFirstDirty.start();
+    mDirty.insert(dir);
+    if (mFirstDirty.elapsed() >= maxDelayMs || !mTimer) {
+        if (mTimer)
+            mTimer->stop();
+        scan();
+        return;
+    }
+    mTimer->start(coalesceMs);
+}
+
+/*!
+ * \fn DirectoryWatcher::scanOnTimeout
+ * \brief Called once no notification has arrived for coalesceMs.
+ */
+void DirectoryWatcher::scanOnTimeout()
+{
+    scan();
+}
+
+/*!
+ * \fn DirectoryWatcher::scan
+ * \brief Lists every dirty directory and emits changed() for each one whose files differ from the last report.
+ */
+void DirectoryWatcher::scan()
+{
+    QSet<QString> dirty;
+    dirty.swap(mDirty);
+    for (const QString &dir : dirty) {
+        QSet<QString> &known = mKnown[dir];
+        QStringList now = QDir(dir).entryList(QDir::Files);
+        QStringList added, removed;
+        diff(known, now, &added, &removed);
+        if (added.isEmpty() && removed.isEmpty())
+            continue;
+        for (const QString &f : removed)
+            known.remove(f);
+        for (const QString &f : added)
+            known.insert(f);
+        emit changed(dir, added, removed);
+    }
+}
+
+/*!
+ * \fn DirectoryWatcher::diff
+ * \brief Compares a directory listing with the files reported before.
+ * \param before
+ * \param now
+ * \param added Names in now but not in before, in listing order
+ * \param removed Names in before but not in now, sorted
+ */
+void DirectoryWatcher::diff(const QSet<QString> &before, const QStringList &now, QStringList *added, QStringList *removed)
+{
+    QSet<QString> present;
+    present.reserve(now.size());
+    for (const QString &f : now) {
+        present.insert(f);
+        if (!before.contains(f))
+            added->append(f);
+    }
+    if (present.size() - added->size() == before.size())
+        return;
+    for (const QString &f : before)
+        if (!present.contains(f))
+            removed->append(f);
+    removed->sort();
+}
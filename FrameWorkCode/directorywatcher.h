@@ -0,0 +1,45 @@
+#ifndef DIRECTORYWATCHER_H
+#define DIRECTORYWATCHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QElapsedTimer>
+
+class QFileSystemWatcher;
+class QTimer;
+
+class DirectoryWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DirectoryWatcher(QObject *parent = nullptr, int coalesceMs = 300, int maxDelayMs = 2000);
+    static void diff(const QSet<QString> &before, const QStringList &now, QStringList *added, QStringList *removed);
+
+private:
+    int coalesceMs;
+    int maxDelayMs;
+    QFileSystemWatcher *mWatcher = nullptr;
+    QTimer *mTimer = nullptr;
+    QHash<QString, QSet<QString>> mKnown;   //! Files of each watched directory as last reported
+    QSet<QString> mDirty;                   //! Directories notified since the last scan
+    QElapsedTimer mFirstDirty;
+
+    void scan();
+
+public slots:
+    void start();
+    void stop();
+    void watch(QString path, QStringList files);
+
+private slots:
+    void directoryChanged(const QString &path);
+    void scanOnTimeout();
+
+signals:
+    void changed(QString path, QStringList added, QStringList removed);
+    void stopped();
+};
+
+#endif // DIRECTORYWATCHER_H
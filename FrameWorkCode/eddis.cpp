@@ -1,8 +1,13 @@
 /*!
-\class size_t eddi
+\class eddis
 \brief This class provides the functionality for suggestion of simliar words
        or nearest smilar word based on edit distance algorithm.
-\sa    min(),editDist()
+\details Most callers only need the nearest of a few candidates, or whether a distance is below a small bound.
+         distanceAtMost() computes only the diagonal band of the matrix within k of the main diagonal, as Ukkonen
+         ("Algorithms for approximate string matching", Information and Control 64, 1985) showed is enough for
+         distances up to k, and stops as soon as a whole row of the band is above k. The band is kept in a single row
+         reused by every call of the same thread, so no call allocates once the longest word has been seen.
+\sa    min(),editDist(),distanceAtMost(),distanceAtMostUtf8()
 */
 #include <cassert>
 #include <string>
@@ -25,6 +30,100 @@ size_t eddis :: min(size_t x, size_t y, size_t z)
             return y < z ? y : z;
 }
 
+/*!
+ * \fn eddis::banded
+ * \brief Edit distance of a and b computed within the band of width k around the diagonal.
+ * \details Common prefixes and suffixes are skipped first, they never change the distance. Cells are capped at k + 1,
+ *          the value of every cell outside the band.
+ * \return The edit distance if it is k or less, k + 1 otherwise
+ */
+template <typename T>
+size_t eddis::banded(const T* a, size_t na, const T* b, size_t nb, size_t k)
+{
+    while (na > 0 && nb > 0 && *a == *b) {
+        a++; b++; na--; nb--;
+    }
+    while (na > 0 && nb > 0 && a[na - 1] == b[nb - 1]) {
+        na--; nb--;
+    }
+    const size_t over = k + 1;
+    if ((na > nb ? na - nb : nb - na) > k)
+        return over;
+    if (na == 0 || nb == 0)
+        return na + nb;
+
+    //! row[j] is the cell (i - 1, j) before column j of row i is computed and (i, j) after
+    thread_local vector<size_t> row;
+    if (row.size() < nb + 1)
+        row.resize(nb + 1);
+    for (size_t j = 0; j <= nb; j++)
+        row[j] = j < over ? j : over;
+
+    for (size_t i = 1; i <= na; i++) {
+        size_t lo = i > k ? i - k : 1;
+        size_t hi = i + k < nb ? i + k : nb;
+        size_t diag = row[lo - 1];
+        size_t left = lo == 1 && i < over ? i : over;
+        if (lo == 1)
+            row[0] = left;
+        size_t rowMin = left;
+        const T c = a[i - 1];
+        for (size_t j = lo; j <= hi; j++) {
+            size_t up = row[j];
+            size_t cell = diag + (c == b[j - 1] ? 0 : 1);
+            if (up + 1 < cell)
+                cell = up + 1;
+            if (left + 1 < cell)
+                cell = left + 1;
+            if (cell > over)
+                cell = over;
+            diag = up;
+            row[j] = left = cell;
+            if (cell < rowMin)
+                rowMin = cell;
+        }
+        //! Every path to the last cell crosses this row
+        if (rowMin > k)
+            return over;
+    }
+    return row[nb];
+}
+
+/*!
+ * \fn eddis::decodeUtf8
+ * \brief Splits UTF-8 text into code points. A byte that does not start a valid sequence is taken as its own value.
+ * \details Overlong sequences, surrogates and values above U+10FFFF are not valid, as in QString::fromUtf8().
+ * \param s
+ * \param out Cleared and filled with the code points of s
+ */
+void eddis::decodeUtf8(const string& s, u32string& out)
+{
+    out.clear();
+    size_t n = s.size();
+    for (size_t i = 0; i < n;) {
+        unsigned char c = s[i];
+        size_t len = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+        char32_t cp = len == 1 ? c : len == 2 ? c & 0x1F : len == 3 ? c & 0x0F : c & 0x07;
+        for (size_t t = 1; t < len; t++) {
+            if (i + t >= n || (static_cast<unsigned char>(s[i + t]) >> 6) != 0x2) {
+                len = 0;
+                break;
+            }
+            cp = (cp << 6) | (static_cast<unsigned char>(s[i + t]) & 0x3F);
+        }
+        if ((len == 2 && cp < 0x80) || (len == 3 && (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF)))
+            || (len == 4 && (cp < 0x10000 || cp > 0x10FFFF)))
+            len = 0;
+        if (len == 0) {
+            out.push_back(c);
+            i++;
+        } else {
+            out.push_back(cp);
+            i += len;
+        }
+    }
+}
+
 /*!
  * \fn size_t eddis::editDist
  * \brief This function takes two strings as argument then calculates the edit distance of both strings
@@ -32,30 +131,41 @@ size_t eddis :: min(size_t x, size_t y, size_t z)
  *        it returns the converted string
  * \param A
  * \param B
- * \return M[A.size()][B.size()]
- * \sa min()
+ * \return The edit distance of A and B, byte by byte
+ * \sa distanceAtMost()
  */
 size_t eddis::editDist(const string& A, const string& B)
 {
-    size_t NA = A.size();
-       size_t NB = B.size();
-
-       vector<vector<size_t>> M(NA + 1, vector<size_t>(NB + 1));
-
-       for (size_t a = 0; a <= NA; ++a)
-           M[a][0] = a;
-
-       for (size_t b = 0; b <= NB; ++b)
-           M[0][b] = b;
+    //! No distance is above the longer length, so the band is the whole matrix
+    return banded(A.data(), A.size(), B.data(), B.size(), A.size() > B.size() ? A.size() : B.size());
+}
 
-       for (size_t a = 1; a <= NA; ++a)
-           for (size_t b = 1; b <= NB; ++b)
-           {
-               size_t x = M[a-1][b] + 1;
-               size_t y = M[a][b-1] + 1;
-               size_t z = M[a-1][b-1] + (A[a-1] == B[b-1] ? 0 : 1);
-               M[a][b] = min(x,y,z);
-           }
+/*!
+ * \fn eddis::distanceAtMost
+ * \brief Edit distance of a and b byte by byte, e.g. of two SLP1 words, as far as it is at most k.
+ * \param a
+ * \param b
+ * \param k Largest distance of interest
+ * \return The edit distance if it is k or less, k + 1 otherwise
+ */
+size_t eddis::distanceAtMost(const string& a, const string& b, size_t k)
+{
+    return banded(a.data(), a.size(), b.data(), b.size(), k);
+}
 
-       return M[A.size()][B.size()];
+/*!
+ * \fn eddis::distanceAtMostUtf8
+ * \brief Edit distance of a and b code point by code point, e.g. of two Devanagari words in UTF-8, as far as it is
+ *        at most k.
+ * \param a
+ * \param b
+ * \param k Largest distance of interest
+ * \return The edit distance if it is k or less, k + 1 otherwise
+ */
+size_t eddis::distanceAtMostUtf8(const string& a, const string& b, size_t k)
+{
+    thread_local u32string x, y;
+    decodeUtf8(a, x);
+    decodeUtf8(b, y);
+    return banded(x.data(), x.size(), y.data(), y.size(), k);
 }
@@ -12,6 +12,13 @@ inline size_t min(size_t x, size_t y, size_t z);
 
 size_t editDist(const string& A, const string& B);
 
+static size_t distanceAtMost(const string& a, const string& b, size_t k);
+static size_t distanceAtMostUtf8(const string& a, const string& b, size_t k);
+
+private:
+template <typename T>
+static size_t banded(const T* a, size_t na, const T* b, size_t nb, size_t k);
+static void decodeUtf8(const string& s, u32string& out);
 };
 
 #endif // EDDIS_H
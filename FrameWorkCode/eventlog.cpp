@@ -0,0 +1,186 @@
+/*!
+ * \class EventLog
+ * \brief Append-only log in front of a per-action JSON file such as Comments/HighlightsLog.json.
+ * \details Every event is one "put value at path" operation, e.g. ["page-3", "10:42:17"] -> {highlight}, appended as
+ * a record to a hidden .<name>.log next to the JSON file. A record is a 4 byte little-endian payload length, a 2 byte
+ * checksum and the compact JSON array [path, value], so an event costs one small write however big the JSON file is.
+ * \details compact() replays the log over the JSON file, writes the result in the existing layout with QSaveFile and
+ * then empties the log. It runs on its own every compactThreshold events and should be called before the JSON file is
+ * read by anybody else (commit, push, export). Replaying a put twice gives the same result, so a crash between the
+ * two steps loses nothing; a record torn by a crash is dropped when the log is opened.
+ */
+#include "eventlog.h"
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtEndian>
+#include <QDebug>
+
+/*!
+ * \fn EventLog::EventLog
+ * \brief Constructor
+ * \param jsonPath JSON file the events belong to
+ * \param compactThreshold Number of records after which append() compacts the log into the JSON file
+ */
+EventLog::EventLog(QString jsonPath, int compactThreshold)
+{
+    QFileInfo info(jsonPath);
+    this->mJsonPath = jsonPath;
+    this->mLogPath = info.absolutePath() + "/." + info.fileName() + ".log";
+    this->compactThreshold = compactThreshold;
+}
+
+/*!
+ * \fn EventLog::~EventLog
+ * \brief Destructor. Pending records stay in the log and are replayed by the next compact().
+ */
+EventLog::~EventLog()
+{
+    if (mLog.isOpen())
+        mLog.close();
+}
+
+/*!
+ * \fn EventLog::open
+ * \brief Counts the records left by the last session, drops a torn last record and opens the log for appending.
+ * \return bool
+ */
+bool EventLog::open()
+{
+    mRecords = replay(nullptr, true);
+    mLog.setFileName(mLogPath);
+    if (!mLog.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "Can't open event log" << mLogPath;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \fn EventLog::replay
+ * \brief Applies the records of the log to obj.
+ * \param obj Object to apply the records to, nullptr to only count them
+ * \param repairTail When true an incomplete or corrupt last record is cut off the log
+ * \return Number of valid records
+ */
+int EventLog::replay(QJsonObject *obj, bool repairTail)
+{
+    QFile log(mLogPath);
+    if (!log.open(repairTail ? QIODevice::ReadWrite : QIODevice::ReadOnly))
+        return 0;
+    QByteArray data = log.readAll();
+    int records = 0;
+    int pos = 0;
+    while (pos + 6 <= data.size()) {
+        quint32 length = qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(data.constData() + pos));
+        quint16 checksum = qFromLittleEndian<quint16>(reinterpret_cast<const uchar *>(data.constData() + pos + 4));
+        if (length > quint32(data.size() - pos - 6))
+            break;
+        const char *payload = data.constData() + pos + 6;
+        if (qChecksum(payload, length) != checksum)
+            break;
+        if (obj) {
+            QJsonArray record = QJsonDocument::fromJson(QByteArray::fromRawData(payload, length)).array();
+            QStringList path;
+            for (const QJsonValue &key : record.at(0).toArray())
+                path << key.toString();
+            if (!path.isEmpty())
+                put(*obj, path, 0, record.at(1));
+        }
+        records++;
+        pos += 6 + length;
+    }
+    if (repairTail && pos < data.size()) {
+        qDebug() << "Discarding torn event log record in" << mLogPath;
+        log.resize(pos);
+    }
+    log.close();
+    return records;
+}
+
+/*!
+ * \fn EventLog::put
+ * \brief Sets obj[path[depth]]...[path.last()] = value, creating the objects on the way.
+ */
+void EventLog::put(QJsonObject &obj, const QStringList &path, int depth, const QJsonValue &value)
+{
+    if (depth == path.size() - 1) {
+        obj.insert(path[depth], value);
+        return;
+    }
+    QJsonObject child = obj.value(path[depth]).toObject();
+    put(child, path, depth + 1, value);
+    obj.insert(path[depth], child);
+}
+
+/*!
+ * \fn EventLog::append
+ * \brief Records that value was put at path of the JSON file.
+ * \param path Keys from the top level object down, e.g. {pagename, time}
+ * \param value
+ * \return bool
+ */
+bool EventLog::append(const QStringList &path, const QJsonValue &value)
+{
+    if (!mLog.isOpen() && !open())
+        return false;
+    QByteArray payload = QJsonDocument(QJsonArray{ QJsonArray::fromStringList(path), value }).toJson(QJsonDocument::Compact);
+    uchar header[6];
+    qToLittleEndian<quint32>(payload.size(), header);
+    qToLittleEndian<quint16>(qChecksum(payload.constData(), payload.size()), header + 4);
+    QByteArray record(reinterpret_cast<const char *>(header), 6);
+    record += payload;
+    if (mLog.write(record) != record.size() || !mLog.flush()) {
+        qDebug() << "Can't write event log" << mLogPath;
+        return false;
+    }
+    if (++mRecords >= compactThreshold)
+        compact();
+    return true;
+}
+
+/*!
+ * \fn EventLog::snapshot
+ * \return The JSON file with every logged event applied, in the layout of the JSON file
+ */
+QJsonObject EventLog::snapshot()
+{
+    QJsonObject obj;
+    QFile json(mJsonPath);
+    if (json.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        obj = QJsonDocument::fromJson(json.readAll()).object();
+        json.close();
+    }
+    replay(&obj, false);
+    return obj;
+}
+
+/*!
+ * \fn EventLog::compact
+ * \brief Writes snapshot() to the JSON file atomically and empties the log.
+ * \return bool
+ */
+bool EventLog::compact()
+{
+    if (mRecords == 0 && QFile::exists(mJsonPath))
+        return true;
+    QSaveFile json(mJsonPath);
+    if (!json.open(QIODevice::WriteOnly))
+        return false;
+    json.write(QJsonDocument(snapshot()).toJson());
+    if (!json.commit()) {
+        qDebug() << "Event log compaction failed, log kept" << mJsonPath;
+        return false;
+    }
+    bool wasOpen = mLog.isOpen();
+    if (wasOpen)
+        mLog.close();
+    QFile log(mLogPath);
+    if (log.exists() && !log.resize(0))
+        return false;
+    mRecords = 0;
+    if (wasOpen)
+        mLog.open(QIODevice::WriteOnly | QIODevice::Append);
+    return true;
+}
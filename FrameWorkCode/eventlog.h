@@ -0,0 +1,33 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <QJsonObject>
+#include <QJsonValue>
+
+class EventLog {
+public:
+    explicit EventLog(QString jsonPath, int compactThreshold = 500);
+    ~EventLog();
+    bool open();
+    bool append(const QStringList &path, const QJsonValue &value);
+    QJsonObject snapshot();
+    bool compact();
+    int pendingRecords() const { return mRecords; }
+    QString jsonPath() const { return mJsonPath; }
+    QString logPath() const { return mLogPath; }
+
+private:
+    QString mJsonPath;
+    QString mLogPath;
+    int compactThreshold;
+    int mRecords = 0;
+    QFile mLog;
+
+    int replay(QJsonObject *obj, bool repairTail);
+    static void put(QJsonObject &obj, const QStringList &path, int depth, const QJsonValue &value);
+};
+
+#endif // EVENTLOG_H
@@ -9,6 +9,7 @@
 #include <mainwindow.h>
 #include <QFile>
 #include <editdistance.h>
+#include "tracer.h"
 
 
 /*!
@@ -31,6 +32,8 @@
  * \param x1
  * \param files
  * \param pairMap
+ * \param mRole
+ * \param replaceJournal Receives the change made to every file, may be nullptr
  */
 GlobalReplaceWorker::GlobalReplaceWorker(QObject *parent,
                                          QList<QString> *filesChangedUsingGlobalReplace,
@@ -49,7 +52,8 @@ GlobalReplaceWorker::GlobalReplaceWorker(QObject *parent,
                                          int *x1,
                                          int *files,
                                          int pairMap,
-                                         QString mRole
+                                         QString mRole,
+                                         ReplaceJournal *replaceJournal
                                          ) : QObject(parent)
 {
     this->filesChangedUsingGlobalReplace = filesChangedUsingGlobalReplace;
@@ -71,6 +75,7 @@ GlobalReplaceWorker::GlobalReplaceWorker(QObject *parent,
     this-> globalReplacementMapAfterCheck = globalReplacementMapAfterCheck;
     this->pairMap = pairMap;
     this->mRole = mRole;
+    this->replaceJournal = replaceJournal;
 
     editedFilesLogPath = gDirTwoLevelUp + "/Dicts/." +mRole+"_EditedFiles.txt";
 }
@@ -258,12 +263,41 @@ int GlobalReplaceWorker::writeGlobalCPairsToFiles(QString file_path, QMap<QStrin
     return tot_replaced;
 }
 
+/*!
+ * \fn GlobalReplaceWorker::replaceInFile
+ * \brief Calls writeGlobalCPairsToFiles() and records the change it made to the file in the replace journal.
+ * \param file_path
+ * \param globalReplacementMap
+ * \param doc
+ * \return Number of replaced words
+ */
+int GlobalReplaceWorker::replaceInFile(QString file_path, QMap<QString, QString> globalReplacementMap, QTextDocument *doc)
+{
+    if (!replaceJournal)
+        return writeGlobalCPairsToFiles(file_path, globalReplacementMap, doc);
+
+    QFile f(file_path);
+    QByteArray before;
+    if (f.open(QIODevice::ReadOnly)) {
+        before = f.readAll();
+        f.close();
+    }
+    int replaced = writeGlobalCPairsToFiles(file_path, globalReplacementMap, doc);
+    if (f.open(QIODevice::ReadOnly)) {
+        replaceJournal->record(file_path, before, f.readAll());
+        f.close();
+    }
+    return replaced;
+}
+
 /*!
  * \fn GlobalReplaceWorker::replaceWordsInFiles
  * \brief This function traverses the user role's dir and filters the html files and passes the required files to writeGlobalCPairsToFiles() function for replacing the required replacements. It also emits the signal for updating progress bar.
+ * \details The change made to each html file goes to the replace journal, which is saved once all files are done.
  */
 void GlobalReplaceWorker::replaceWordsInFiles()
 {
+    TRACE_SCOPE("GlobalReplaceWorker::replaceWordsInFiles");
     QTextDocument* doc = new QTextDocument();
     QDirIterator dirIterator(currentFileDirectory, QDirIterator::Subdirectories);
     QDir currDir(currentFileDirectory);
@@ -294,7 +328,7 @@ void GlobalReplaceWorker::replaceWordsInFiles()
                 {
                     (*filesChangedUsingGlobalReplace).append(it_file_path);
                     if(suff == "html") {
-                        *r1 = writeGlobalCPairsToFiles(it_file_path, globalReplacementMap, doc);
+                        *r1 = replaceInFile(it_file_path, globalReplacementMap, doc);
                         *r2 = *r2 + *r1;
                         if(*r1 > 0)
                             (*files)++;
@@ -318,7 +352,7 @@ void GlobalReplaceWorker::replaceWordsInFiles()
                 QString suff = dirIterator.fileInfo().completeSuffix();
                 (*filesChangedUsingGlobalReplace).append(it_file_path);
                 if(suff == "html") {
-                    *r1 = writeGlobalCPairsToFiles(it_file_path, globalReplacementMap, doc);
+                    *r1 = replaceInFile(it_file_path, globalReplacementMap, doc);
                     *r2 = *r2 + *r1;
                     if(*r1 > 0)
                         (*files)++;
@@ -347,7 +381,7 @@ void GlobalReplaceWorker::replaceWordsInFiles()
             {
                 (*filesChangedUsingGlobalReplace).append(it_file_path);
                 if(suff == "html") {
-                    *r1 = writeGlobalCPairsToFiles(it_file_path, replaceInUneditedPages_Map, doc);
+                    *r1 = replaceInFile(it_file_path, replaceInUneditedPages_Map, doc);
                     *r2 = *r2 + *r1;
                     if(*r1 > 0)
                         (*files)++;
@@ -376,7 +410,7 @@ void GlobalReplaceWorker::replaceWordsInFiles()
             QString suff = dirIterator_2.fileInfo().completeSuffix();
             (*filesChangedUsingGlobalReplace).append(it_file_path);
             if(suff == "html") {
-                *r1 = writeGlobalCPairsToFiles(it_file_path, replaceInAllPages_Map, doc);
+                *r1 = replaceInFile(it_file_path, replaceInAllPages_Map, doc);
                 *r2 = *r2 + *r1;
                 if(*r1 > 0)
                     (*files)++;
@@ -394,6 +428,8 @@ void GlobalReplaceWorker::replaceWordsInFiles()
         }
     }
 
+    if (replaceJournal)
+        replaceJournal->save();
     emit changeProgressBarValue(100);
     emit finishedReplacingWords();
 }
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QMap>
 #include "handlebbox.h"
+#include "replacejournal.h"
 
 class QTextBrowser;
 
@@ -29,7 +30,8 @@ public:
             int *x1 = nullptr,
             int *files = nullptr,
             int pairMap = 1,
-            QString mRole ="Corrector"
+            QString mRole ="Corrector",
+            ReplaceJournal *replaceJournal = nullptr
             );
     int pairMap;
 
@@ -49,9 +51,11 @@ private:
     int numOfChangedWords, check, *r1, *r2, *x1, *files;
 
     int writeGlobalCPairsToFiles(QString file_path, QMap <QString, QString> globalReplacementMap, QTextDocument* doc);
+    int replaceInFile(QString file_path, QMap <QString, QString> globalReplacementMap, QTextDocument* doc);
     bool isStringInFile(QString file_path, QString searchString);
     HandleBbox *handleBbox = nullptr;
     QString mRole;
+    ReplaceJournal *replaceJournal;
 
 public slots:
     void replaceWordsInFiles();
@@ -259,12 +259,57 @@ QTextDocument *HandleBbox::loadFileInDoc(QFile *f)
 //    cur.deleteChar();
 //    f->close();
 
+    //! The bboxes are taken from the html already read instead of reading the file again
+    storeBboxes(line);
     line = latex2png(line);
     cur.insertHtml(line);
-    storeBboxes(f);
     return doc;
 }
 
+/*!
+ * \fn HandleBbox::nextTag
+ * \brief Finds the next tag that can carry a bbox: <p>, </p>, <img>, <table>, </table> and <td>
+ * \details
+ * Scans forward from \a from without copying, so walking a page from the first tag to the last is a single linear
+ * pass. A tag ends at the first '>' after its start, exactly like the "<p[^>]*>" style patterns used before.
+ * \param html
+ * \param from Position to start scanning at
+ * \param tagEnd Set to the position just after the closing '>'
+ * \param kind Set to the kind of the tag found
+ * \return Start of the tag, -1 if there are no more tags
+ */
+int HandleBbox::nextTag(const QString &html, int from, int &tagEnd, TagKind &kind)
+{
+    for (int i = html.indexOf('<', from); i >= 0; i = html.indexOf('<', i + 1)) {
+        QStringRef rest = html.midRef(i, 8);
+        if (rest.startsWith(QLatin1String("</p>"))) {
+            kind = ParaEndTag;
+            tagEnd = i + 4;
+            return i;
+        } else if (rest.startsWith(QLatin1String("</table>"))) {
+            kind = TableEndTag;
+            tagEnd = i + 8;
+            return i;
+        } else if (rest.startsWith(QLatin1String("<img"))) {
+            kind = ImgTag;
+        } else if (rest.startsWith(QLatin1String("<table"))) {
+            kind = TableTag;
+        } else if (rest.startsWith(QLatin1String("<td"))) {
+            kind = TdTag;
+        } else if (rest.startsWith(QLatin1String("<p"))) {
+            kind = ParaTag;
+        } else {
+            continue;
+        }
+        int gt = html.indexOf('>', i);
+        if (gt < 0)
+            return -1;
+        tagEnd = gt + 1;
+        return i;
+    }
+    return -1;
+}
+
 /*!
  * \fn HandleBbox::insertBboxes
  * \param file
@@ -272,8 +317,7 @@ QTextDocument *HandleBbox::loadFileInDoc(QFile *f)
  * \details
  * if file is not available for writing mode,function terminates
  * all the lines of file are read and stored in varaible(input)
- * If bbox is already present, move to next entry
- * tages for table, image are added
+ * the bboxes are inserted by insertBboxes(const QString &)
  * are successfull insertion the file is flushed and closed
  */
 void HandleBbox::insertBboxes(QFile *file)
@@ -284,46 +328,73 @@ void HandleBbox::insertBboxes(QFile *file)
     }
     QString input = file->readAll();
     file->close();
-    QRegularExpression regex_p("(<p[^>]*>|</p>|<img[^>]*>|<table[^>]*>|<td[^>]*>|</table>)");
-    QRegularExpressionMatchIterator itr = regex_p.globalMatch(input);
+    QString output = insertBboxes(input);
+
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "Cannot open file for writing";
+        return;
+    }
+
+    QTextStream out(file);
+    out.setCodec("utf-8");
+    out << output;
+    out.flush();
+    file->close();
+}
+
+/*!
+ * \fn HandleBbox::insertBboxes
+ * \param input Html of the page without bboxes
+ * \brief Inserts the stored bboxes as title attributes of the matching tags
+ * \details
+ * The output is built in one pass over the input into a buffer that is reserved up front, so the cost is linear in
+ * the page size whatever the number of bboxes.
+ * If bbox is already present, move to next entry
+ * tages for table, image are added
+ * \return Html with the bboxes inserted
+ */
+QString HandleBbox::insertBboxes(const QString &input)
+{
+    int extra = 0;
+    for (const auto &bbox : bboxes) {
+        extra += bbox.second.size() + 9;
+    }
+    QString output;
+    output.reserve(input.size() + extra);
 
     int i = 0;
     bool inTable = false;
     bool inPara = false;
-    int increment = 0;
+    int copied = 0;
+    int end = 0;
+    TagKind kind;
     QString currentTag;
-    while (itr.hasNext() && i < bboxes.size()) {
-        QRegularExpressionMatch match = itr.next();
-        QString htmlTagData = match.captured(1);
-        int end = match.capturedEnd(1);
-
-
-        if (htmlTagData.indexOf("title=\"bbox") != -1) {
+    for (int start = nextTag(input, 0, end, kind); start >= 0 && i < bboxes.size(); start = nextTag(input, end, end, kind)) {
+        if (input.midRef(start, end - start).contains(QLatin1String("title=\"bbox"))) {
             i++;
             continue;
         }
 
-        if (htmlTagData.left(6) == "<table") {
+        if (kind == TableTag) {
             inTable = true;
             currentTag = "table";
-        } else if (htmlTagData.left(7) == "</table") {
+        } else if (kind == TableEndTag) {
             inTable = false;
-            currentTag = "/table";
             continue;
-        } else if (htmlTagData.left(4) == "<img") {
-            if (inPara) {
+        } else if (kind == ImgTag) {
+            if (inPara && i > 0) {
                 i--;
             }
             currentTag = "img";
-        } else if (htmlTagData.left(3) == "<td") {
+        } else if (kind == TdTag) {
             currentTag = "td";
-        } else if (htmlTagData.left(2) == "<p") {
+        } else if (kind == ParaTag) {
             if (inTable) {
                 continue;
             }
             currentTag = "p";
             inPara = true;
-        } else if (htmlTagData.left(3) == "</p") {
+        } else if (kind == ParaEndTag) {
             inPara = false;
             continue;
         }
@@ -331,77 +402,50 @@ void HandleBbox::insertBboxes(QFile *file)
         if (bboxes[i].first != currentTag) {
             qDebug() << "tags not matching at " << i;
         }
-        QString temp = " title=\"" + bboxes[i++].second + "\"";
-        increment += temp.length();
-
-        if (currentTag == "img") {
-            input.insert(end - 2, temp);
-        } else {
-            input.insert(end - 1, temp);
-        }
 
-        itr = regex_p.globalMatch(input, end + 1);
+        //! The title goes before "/>" of an image and before ">" of every other tag
+        int at = (kind == ImgTag) ? end - 2 : end - 1;
+        output.append(input.midRef(copied, at - copied));
+        output.append(QLatin1String(" title=\""));
+        output.append(bboxes[i++].second);
+        output.append(QLatin1Char('"'));
+        copied = at;
     }
-
-    if (!file->open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Cannot open file for writing";
-        return;
-    }
-
-    QTextStream out(file);
-    out.setCodec("utf-8");
-    out << input;
-    out.flush();
-    file->close();
+    output.append(input.midRef(copied));
+    return output;
 }
 
 /*!
  * \fn HandleBbox::storeBboxes
- * \param file
+ * \param input Html of the page
  * \brief Stores the bboxes in the vector
  * \details
- * Function terminates if file is available for writing mode
- * text of the input file is read
  * If bbox tag is not present,tags(variable) are set to null
- * loop itreates through the input file
+ * the tags are walked once with nextTag()
  * several tags are check and stored inside bBox accordingly
  */
-void HandleBbox::storeBboxes(QFile *file)
+void HandleBbox::storeBboxes(const QString &input)
 {
-    if (!file->open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return;
-    }
-
-    QTextStream st(file);
-    QString initial = st.readAll();
-    file->close();
     bboxes.clear();
 
-    QRegularExpression rex("(<p[^>]*>|<img[^>]*>|<table[^>]*>|</table>|<td[^>]*>)");
-    QRegularExpressionMatchIterator itr;
-
-    itr = rex.globalMatch(initial);
-
-    QString temp_tags;
     bool inTable = false;
-
-    while (itr.hasNext())
+    int end = 0;
+    TagKind kind;
+    for (int start = nextTag(input, 0, end, kind); start >= 0; start = nextTag(input, end, end, kind))
     {
-        QRegularExpressionMatch match = itr.next();
-        QString bbox_tags = match.captured(1);
-
-        int first, last;
-        first = bbox_tags.indexOf("bbox");
-        if ((bbox_tags.indexOf("title=\"bbox") == -1) || (first == -1)) {
-            temp_tags = "";
-        } else { // If bbox tag is present
-            int i = first;
-            while (bbox_tags[i] != "\"") {
-                i++;
+        if (kind == ParaEndTag) {
+            continue;
+        }
+        QStringRef bbox_tags = input.midRef(start, end - start);
+
+        QString temp_tags;
+        int first = bbox_tags.indexOf(QLatin1String("bbox"));
+        if (first != -1 && bbox_tags.contains(QLatin1String("title=\"bbox"))) { // If bbox tag is present
+            int last = bbox_tags.indexOf('"', first);
+            if (last == -1) {
+                last = bbox_tags.size();
             }
-            last = i - 1;
-            temp_tags = bbox_tags.mid(first, last - first + 1);
-            temp_tags = temp_tags.simplified();
+            temp_tags = bbox_tags.mid(first, last - first).toString().simplified();
         }
 
         /*! @todo
@@ -409,16 +453,16 @@ void HandleBbox::storeBboxes(QFile *file)
          * 2. If multiple lines are there in one cell of table i.e. if there are multiple paragraphs in one table cell
          */
 
-        if(bbox_tags.left(2) == "<i") {
-            bboxes.push_back({"img",temp_tags});
-        } else if(bbox_tags.left(2) == "<p" && (!inTable)) {
-            bboxes.push_back({"p",temp_tags});
-        } else if (bbox_tags.left(3) == "<td") {
+        if (kind == ImgTag) {
+            bboxes.push_back({"img", temp_tags});
+        } else if (kind == ParaTag && (!inTable)) {
+            bboxes.push_back({"p", temp_tags});
+        } else if (kind == TdTag) {
             bboxes.push_back({"td", temp_tags});
-        } else if (bbox_tags.left(6) == "<table") { // Table start
+        } else if (kind == TableTag) { // Table start
             inTable = true;
             bboxes.push_back({"table", temp_tags});
-        } else if (bbox_tags.left(7) == "</table") {
+        } else if (kind == TableEndTag) {
             inTable = false;
             bboxes.push_back({"/table", temp_tags});
         }
@@ -26,6 +26,8 @@ public:
 	~HandleBbox();
 	QTextDocument *loadFileInDoc(QFile *f);
 	void insertBboxes(QFile *f);
+	QString insertBboxes(const QString &input);
+	void storeBboxes(const QString &input);
 	int blockCount = -1;
 	QVector<QPair<QString,QString> > bboxes;
 
@@ -33,7 +35,8 @@ private:
     QTextBlockFormat blockFormat;
 	QTextDocument *doc;
 	bool docIsPassed;
-	void storeBboxes(QFile *f);
+	enum TagKind { ParaTag, ParaEndTag, ImgTag, TableTag, TableEndTag, TdTag };
+	static int nextTag(const QString &html, int from, int &tagEnd, TagKind &kind);
     QString latex2png(QString);
 };
 
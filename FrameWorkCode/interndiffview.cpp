@@ -11,6 +11,7 @@
 #include <Project.h>
 #include <QMessageBox>
 #include <QGraphicsRectItem>
+#include <QThread>
 
 /*!
  * \fn InternDiffView::InternDiffView
@@ -31,12 +32,22 @@ InternDiffView::InternDiffView( QWidget *parent, QString page, QString fpath)
      if(fcorrector.exists())
      {
        isValidFile = true;
-       Load_comparePage(page.toStdString());
+       setAttribute(Qt::WA_DeleteOnClose);
+
+       //! Diffs are computed on a worker thread so that Next/Prev never block the window
+       mCompareThread = new QThread(this);
+       mComparer = new ComparisonService(ComparisonService::CorrectorCompare, gDirTwoLevelUp);
+       mComparer->moveToThread(mCompareThread);
+       connect(mCompareThread, SIGNAL(finished()), mComparer, SLOT(deleteLater()));
+       connect(this, SIGNAL(comparisonRequested(QString)), mComparer, SLOT(compare(QString)));
+       connect(this, SIGNAL(prefetchRequested(QStringList)), mComparer, SLOT(prefetch(QStringList)));
+       connect(mComparer, SIGNAL(ready(QString, PageComparison)), this, SLOT(comparisonReady(QString, PageComparison)));
+       mCompareThread->start();
 
-       ui->current->setHtml(html1);
-       ui->ocroutput->setHtml(html2);
+       Load_comparePage(page.toStdString());
 
        img.load(ocrimage);
+       shownImage = ocrimage;
        scene->addPixmap(QPixmap::fromImage(img));
        ui->graphicsView->setScene(scene);
        ui->graphicsView->adjustSize();
@@ -54,10 +65,6 @@ InternDiffView::InternDiffView( QWidget *parent, QString page, QString fpath)
        scene->addItem(crop_rect);
        connect(ui->horizontalSlider, SIGNAL(valueChanged(int)), this, SLOT(zoom_slider_valueChanged(int)));
        connect(ui->horizontalSlider, SIGNAL(sliderMoved(int)), this, SLOT(zoom_slider_moved(int)));
-       QString label1 = ui->InternLabel->text();
-       QString acc = QString::number(correctorChangesPerc,'f',2) + "%";
-       label1.append(acc+"%");
-       ui->InternLabel->setText(label1);
      }
      else{
         QMessageBox::information(0, "Error", "File Doesn't Exist");
@@ -71,6 +78,11 @@ InternDiffView::InternDiffView( QWidget *parent, QString page, QString fpath)
  */
 InternDiffView::~InternDiffView()
 {
+    if (mCompareThread)
+    {
+        mCompareThread->quit();
+        mCompareThread->wait();
+    }
     delete ui;
 }
 
@@ -86,25 +98,20 @@ bool InternDiffView::validFilePath()
 /*!
  * \fn InternDiffView::Load_comparePage
  * \param page
- * \brief For the currently opened page, the function fetches - corresponding image file, initial text and corrector text
- *  and produces a final color coded text representing changes. The metrics are also calculated such
- *  as change percentage and accuracy.
- *
- * \sa LevenshteinWithGraphemes(),GetGraphemesCount(), diff_main(), diff_prettyHtml()
+ * \brief For the currently opened page, the function selects the corresponding image file and asks the
+ *  ComparisonService for the initial text and corrector text color coded with the changes and for the
+ *  change percentage.
+ * \details The comparison runs on the service's thread; comparisonReady() shows it.
+ * \sa ComparisonService, comparisonReady()
  */
 void InternDiffView::Load_comparePage(string page)
 {
-
-   QString qs1="", qs2="";
-   QMessageBox msgBox;
-
    //! Open a Corrector's Output File
    QString file = gDirTwoLevelUp + "/CorrectorOutput/" + QString::fromStdString(page);
 
    //! Opens corresponding OCR text file and image
    if(!file.isEmpty())
    {
-       QString correctortext = file;
        QString ocrtext = file;
        ocrtext.replace("CorrectorOutput","Inds"); //CAN CHANGE ACCORDING TO FILE STRUCTURE
        ocrtext.replace(".html",".txt");
@@ -186,76 +193,37 @@ void InternDiffView::Load_comparePage(string page)
            }
        }
 
-       //! Reads the OCR text file
-       if(!ocrtext.isEmpty())
-       {
-           QFile sFile(ocrtext);
-           if(sFile.open(QFile::ReadOnly | QFile::Text))
-           {
-               QTextStream in(&sFile);
-               in.setCodec("UTF-8");
-               qs1 = in.readAll().replace(" \n","\n");
-               //! Displays an error if OCR text file is empty
-               if(qs1=="")
-               {
-                   msgBox.setText("Error in Displaying File: "+ ocrtext+ "is Empty");
-                   msgBox.exec();
-                   return;
-               }
-               sFile.close();
-           }
-       }
-
-       //! Reads the Corrector's Output file
-       if(!correctortext.isEmpty())
-       {
-           QFile sFile(correctortext);
-           if(sFile.open(QFile::ReadOnly | QFile::Text))
-           {
-               QTextStream in(&sFile);
-               in.setCodec("UTF-8");
-               qs2 = in.readAll();
-
-               //! Displays an error if Corrector's Output file is empty
-               if(qs2=="")
-               {
-                   msgBox.setText("Error in Displaying File: "+ correctortext + "is Empty");
-                   msgBox.exec();
-                   return;
-               }
-               sFile.close();
-           }
-       }
-
-       QTextDocument doc;
-       doc.setHtml(qs2);
-       qs2 = doc.toPlainText().replace(" \n", "\n");
-
-       int l1,l2, DiffOcr_Corrector;
-
-       l1 = mProject.GetGraphemesCount(qs1); l2 = mProject.GetGraphemesCount(qs2);
-
-       diff_match_patch dmp;
-       auto diffs1 = dmp.diff_main(qs1,qs2);
+       emit comparisonRequested(QString::fromStdString(page));
+  }
+}
 
-       //! Calculates the percentage of changes made by the corrector in OCR text file
-       DiffOcr_Corrector = mProject.LevenshteinWithGraphemes(diffs1);
-       correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l2)*100;
-       if(correctorChangesPerc>100) correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l1)*100;
-       correctorChangesPerc = (((float)lround(correctorChangesPerc*100))/100);
+/*!
+ * \fn InternDiffView::comparisonReady
+ * \brief Shows a comparison made by the ComparisonService if it is for the current page and prefetches the
+ * neighbouring pages.
+ * \param page
+ * \param result
+ */
+void InternDiffView::comparisonReady(QString page, PageComparison result)
+{
+    if (page.toStdString() != pageNo)
+        return;
+    if (!result.error.isEmpty())
+    {
+        QMessageBox msgBox;
+        msgBox.setText(result.error);
+        msgBox.exec();
+        return;
+    }
+    html1 = result.html1;
+    html2 = result.html2;
+    correctorChangesPerc = result.correctorChangesPerc;
 
-       QString title = "Compare Corrector Output " + QString::fromStdString(page) ;
-       setWindowTitle(title);
-       doc.setHtml(qs1);
-       doc.setHtml(qs2);
+    QString title = "Compare Corrector Output " + page;
+    setWindowTitle(title);
+    Update_UI();
 
-       auto diffs = dmp.diff_main(qs1, qs2);
-       auto html = dmp.diff_prettyHtml(diffs, "ffd13d");
-       html1 = html[0];
-       html2 = html[1];
-       html1.remove("&para;");
-       html2.remove("&para;");
-  }
+    emit prefetchRequested(ComparisonService::neighbours(page));
 }
 
 /*!
@@ -264,11 +232,15 @@ void InternDiffView::Load_comparePage(string page)
  */
 void InternDiffView::Update_UI()
 {
-    //!Load Image
-    QImage image;
-    image.load(ocrimage);
-    scene->addPixmap(QPixmap::fromImage(image));
-    ui->graphicsView->setScene(scene);
+    //!Load Image, unless it is already shown
+    if (ocrimage != shownImage)
+    {
+        QImage image;
+        image.load(ocrimage);
+        scene->addPixmap(QPixmap::fromImage(image));
+        ui->graphicsView->setScene(scene);
+        shownImage = ocrimage;
+    }
 
     //!Set corrector Change Percentage
     QString acc = QString::number(correctorChangesPerc,'f',2) + "%";
@@ -300,8 +272,7 @@ void InternDiffView::on_NextButton_clicked()
     if(fcorrector.exists())
     {
       pageNo.replace(loc,no.size(),to_string(stoi(no) + 1)); //Increment the page number
-      Load_comparePage(pageNo);
-      Update_UI();
+      Load_comparePage(pageNo);   // the Ui is updated when the comparison is ready
     }
     else{
         return;
@@ -331,8 +302,7 @@ void InternDiffView::on_prevButton_clicked()
      if(fcorrector.exists())
      {
        pageNo.replace(loc,no.size(),to_string(stoi(no) - 1)); //decrement the page number
-       Load_comparePage(pageNo);
-       Update_UI();
+       Load_comparePage(pageNo);   // the Ui is updated when the comparison is ready
      }
      else{
          return;
@@ -6,6 +6,9 @@
 #include <diff_match_patch.h>
 #include <QGraphicsScene>
 #include <zoom.h>
+#include "comparisonservice.h"
+
+class QThread;
 
 using namespace std;
 namespace Ui { class InternDiffView; };
@@ -36,6 +39,11 @@ private slots:
 
     void on_horizontalSlider_valueChanged(int value);
 
+    void comparisonReady(QString page, PageComparison result);
+
+signals:
+    void comparisonRequested(QString page);
+    void prefetchRequested(QStringList pages);
 
 private:
 	Ui::InternDiffView *ui;
@@ -47,7 +55,10 @@ private:
     QString html1;
     QString html2;
     QString ocrimage;
+    QString shownImage;
     float correctorChangesPerc;
     bool isValidFile;
     Graphics_view_zoom* z;
+    ComparisonService *mComparer = nullptr;
+    QThread *mCompareThread = nullptr;
 };
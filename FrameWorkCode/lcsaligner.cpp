@@ -0,0 +1,187 @@
+/*!
+ * \class LcsAligner
+ * \brief Longest common subsequence of two sequences, with the positions of its elements in both.
+ * \details This is Hirschberg's linear space algorithm ("A linear space algorithm for computing maximal common
+ * subsequences", CACM 18(6), 1975), as the lcs() templates of slpNPatternDict implemented it: the x range is halved,
+ * the LCS lengths of the first half against every prefix of the y range and of the second half against every suffix
+ * give the best place to split the y range, and both halves are solved again. A single x element is matched with its
+ * first occurrence in its y range.
+ * \details The length rows are computed bit-parallel after Allison and Dix and Hyyrö: the row is a bit vector over the
+ * y range, with a 0 bit where the LCS grows by one, and a whole word of it is updated by one add and a few logical
+ * operations per element of x. A row costs |x| * |y| / 64 word operations instead of |x| * |y| comparisons. The rows
+ * are the same as the comparisons gave, so the split points and the LCS found are the same as well.
+ * \details Elements are interned as ints first: the bytes of a string, or the distinct words of a word sequence.
+ * \sa slpNPatternDict::appendConfusionsPairs(), slpNPatternDict::allignlcsnew()
+ */
+#include "lcsaligner.h"
+#include <algorithm>
+#include <unordered_map>
+
+/*!
+ * \fn LcsAligner::LcsAligner
+ * \brief Constructor
+ * \param x
+ * \param y
+ * \param symbols Number of distinct symbols, every element is below it
+ */
+LcsAligner::LcsAligner(std::vector<int> x, std::vector<int> y, int symbols)
+{
+    this->mX.swap(x);
+    this->mY.swap(y);
+    this->mSlot.assign(symbols, -1);
+}
+
+/*!
+ * \fn LcsAligner::bytes
+ * \return Bytes of s as unsigned symbols
+ */
+std::vector<int> LcsAligner::bytes(const std::string &s)
+{
+    std::vector<int> out(s.size());
+    for (size_t i = 0; i < s.size(); i++)
+        out[i] = static_cast<unsigned char>(s[i]);
+    return out;
+}
+
+/*!
+ * \fn LcsAligner::rowLengths
+ * \brief LCS lengths of x[xlo, xhi) against every prefix of y[ylo, yhi), or of both ranges reversed.
+ * \param lens Set to yhi - ylo + 1 lengths, lens[j] for the first j elements of the (reversed) y range
+ */
+void LcsAligner::rowLengths(int xlo, int xhi, int ylo, int yhi, bool reverse, std::vector<int> &lens)
+{
+    int m = yhi - ylo;
+    int words = (m + 63) / 64;
+    //! There are no more distinct symbols than positions or symbols
+    mMasks.assign(size_t(std::min<size_t>(m, mSlot.size())) * words, 0);
+    int rows = 0;
+    for (int k = 0; k < m; k++) {
+        int symbol = mY[reverse ? yhi - 1 - k : ylo + k];
+        if (mSlot[symbol] < 0)
+            mSlot[symbol] = rows++;
+        mMasks[size_t(mSlot[symbol]) * words + k / 64] |= uint64_t(1) << (k % 64);
+    }
+
+    mRow.assign(words, ~uint64_t(0));
+    for (int i = 0; i < xhi - xlo; i++) {
+        int slot = mSlot[mX[reverse ? xhi - 1 - i : xlo + i]];
+        if (slot < 0)
+            continue;
+        if (words == 1) {
+            //! Most words of a page are shorter than 64 letters
+            uint64_t v = mRow[0], mask = mMasks[slot];
+            mRow[0] = (v + (v & mask)) | (v & ~mask);
+            continue;
+        }
+        const uint64_t *mask = mMasks.data() + size_t(slot) * words;
+        uint64_t carry = 0;
+        for (int w = 0; w < words; w++) {
+            uint64_t v = mRow[w], u = v & mask[w];
+            uint64_t sum = v + u;
+            uint64_t c = sum < v;
+            sum += carry;
+            carry = c | (sum < carry);
+            mRow[w] = sum | (v & ~mask[w]);
+        }
+    }
+
+    lens.resize(m + 1);
+    lens[0] = 0;
+    for (int k = 0; k < m; k++)
+        lens[k + 1] = lens[k] + !((mRow[k / 64] >> (k % 64)) & 1);
+
+    for (int k = ylo; k < yhi; k++)
+        mSlot[mY[k]] = -1;
+}
+
+/*!
+ * \fn LcsAligner::split
+ * \brief Finds the matches of x[xlo, xhi) against y[ylo, yhi).
+ */
+void LcsAligner::split(int xlo, int xhi, int ylo, int yhi)
+{
+    int nx = xhi - xlo;
+    if (nx == 0 || ylo == yhi)
+        return;
+    if (nx == 1) {
+        for (int j = ylo; j < yhi; j++) {
+            if (mY[j] == mX[xlo]) {
+                mMatches.push_back(std::make_pair(xlo, j));
+                break;
+            }
+        }
+        return;
+    }
+
+    int xmid = xlo + nx / 2;
+    rowLengths(xlo, xmid, ylo, yhi, false, mForward);
+    rowLengths(xmid, xhi, ylo, yhi, true, mBackward);
+
+    //! The first split with the longest total, as the templates chose it
+    int best = -1, ymid = ylo;
+    for (int j = 0; j <= yhi - ylo; j++) {
+        int total = mForward[j] + mBackward[yhi - ylo - j];
+        if (total > best) {
+            best = total;
+            ymid = ylo + j;
+        }
+    }
+    split(xlo, xmid, ylo, ymid);
+    split(xmid, xhi, ymid, yhi);
+}
+
+/*!
+ * \fn LcsAligner::align
+ * \brief Aligns two strings byte by byte.
+ * \return Matches, in order
+ */
+LcsAligner::Matches LcsAligner::align(const std::string &xs, const std::string &ys)
+{
+    LcsAligner aligner(bytes(xs), bytes(ys), 256);
+    aligner.split(0, xs.size(), 0, ys.size());
+    return aligner.mMatches;
+}
+
+/*!
+ * \fn LcsAligner::align
+ * \brief Aligns two word sequences, e.g. the OCR and the corrected words of a page.
+ * \return Matches, in order
+ */
+LcsAligner::Matches LcsAligner::align(const std::vector<std::string> &xs, const std::vector<std::string> &ys)
+{
+    std::unordered_map<std::string, int> ids;
+    std::vector<int> x, y;
+    x.reserve(xs.size());
+    y.reserve(ys.size());
+    for (const std::string &w : xs)
+        x.push_back(ids.emplace(w, int(ids.size())).first->second);
+    for (const std::string &w : ys)
+        y.push_back(ids.emplace(w, int(ids.size())).first->second);
+    LcsAligner aligner(x, y, ids.size());
+    aligner.split(0, xs.size(), 0, ys.size());
+    return aligner.mMatches;
+}
+
+/*!
+ * \fn LcsAligner::lcs
+ * \return The longest common subsequence of xs and ys that align() finds
+ */
+std::string LcsAligner::lcs(const std::string &xs, const std::string &ys)
+{
+    std::string out;
+    for (const auto &match : align(xs, ys))
+        out += xs[match.first];
+    return out;
+}
+
+/*!
+ * \fn LcsAligner::length
+ * \return Length of the longest common subsequence of xs and ys, from a single row
+ */
+int LcsAligner::length(const std::string &xs, const std::string &ys)
+{
+    LcsAligner aligner(bytes(xs), bytes(ys), 256);
+    std::vector<int> lens;
+    aligner.rowLengths(0, xs.size(), 0, ys.size(), false, lens);
+    return lens.back();
+}
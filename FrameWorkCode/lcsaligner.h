@@ -0,0 +1,35 @@
+#ifndef LCSALIGNER_H
+#define LCSALIGNER_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class LcsAligner
+{
+public:
+    //! Positions (in xs, in ys) of the elements of a longest common subsequence, increasing in both
+    typedef std::vector<std::pair<int, int>> Matches;
+
+    static Matches align(const std::string &xs, const std::string &ys);
+    static Matches align(const std::vector<std::string> &xs, const std::vector<std::string> &ys);
+    static std::string lcs(const std::string &xs, const std::string &ys);
+    static int length(const std::string &xs, const std::string &ys);
+
+private:
+    std::vector<int> mX, mY;            //! Both sequences as interned symbols
+    std::vector<int> mSlot;             //! Row of mMasks of every symbol of the y range in use, -1 for none
+    std::vector<uint64_t> mMasks;       //! Positions of every symbol in the y range, one bit per position
+    std::vector<uint64_t> mRow;         //! Bit vector of the LCS row, a 0 bit where the row grows by one
+    std::vector<int> mForward;          //! Row lengths of the first half of the x range, see split()
+    std::vector<int> mBackward;         //! Row lengths of the second half, from the end
+    Matches mMatches;
+
+    LcsAligner(std::vector<int> x, std::vector<int> y, int symbols);
+    void rowLengths(int xlo, int xhi, int ylo, int yhi, bool reverse, std::vector<int> &lens);
+    void split(int xlo, int xhi, int ylo, int yhi);
+    static std::vector<int> bytes(const std::string &s);
+};
+
+#endif // LCSALIGNER_H
@@ -0,0 +1,161 @@
+/*!
+ * \class Lexicon
+ * \brief Read-only word table with the counts of a frequency table such as Dict, GBook or ConfPmap.
+ * \details The suggestion and spell check code tested words with Dict[s] > 0 and the like, and every miss inserted
+ * s into the shared std::map, so the tables grew with every word, substring and confusion looked up in a session. A
+ * Lexicon is frozen from the map once it is loaded and can only be looked up afterwards: frequency() and contains()
+ * insert nothing, so a Lexicon can also be read from several threads at once.
+ * \details The words with a positive count are kept sorted in one buffer with an offset and a count per word, and
+ * a table of where the words starting with each byte begin narrows the binary search to them. A word of the map with
+ * a count of 0 or less is left out, as Dict[s] > 0 never found it either.
+ * \details Every lookup and every miss is counted, see stats().
+ * \sa slpNPatternDict::findDictEntries(), slpNPatternDict::print2OCRSugg(), SandhiChecker
+ */
+#include "lexicon.h"
+#include <algorithm>
+#include <cstring>
+
+/*!
+ * \fn Lexicon::Lexicon
+ * \brief Constructor of an empty lexicon, freeze() fills it.
+ */
+Lexicon::Lexicon() : mLookups(0), mMisses(0)
+{
+    clear();
+}
+
+/*!
+ * \fn Lexicon::Lexicon
+ * \brief Constructor
+ * \param words Frequency table to freeze
+ */
+Lexicon::Lexicon(const std::map<std::string, int> &words) : mLookups(0), mMisses(0)
+{
+    freeze(words);
+}
+
+/*!
+ * \fn Lexicon::clear
+ * \brief Drops every word and resets the stats.
+ */
+void Lexicon::clear()
+{
+    std::string().swap(mChars);
+    mOffsets.assign(1, 0);
+    std::vector<int>().swap(mCounts);
+    std::fill(mFirst, mFirst + 257, 0u);
+    resetStats();
+}
+
+/*!
+ * \fn Lexicon::freeze
+ * \brief Replaces the words by the ones of a frequency table.
+ * \details Must not be called while another thread looks words up.
+ * \param words Frequency table, e.g. Dict once LoadDataWorker has loaded it
+ */
+void Lexicon::freeze(const std::map<std::string, int> &words)
+{
+    clear();
+    size_t chars = 0, count = 0;
+    for (const auto &w : words) {
+        if (w.second > 0) {
+            chars += w.first.size();
+            count++;
+        }
+    }
+    mChars.reserve(chars);
+    mOffsets.reserve(count + 1);
+    mCounts.reserve(count);
+
+    //! std::map orders its keys by unsigned bytes, as memcmp() and the mFirst table do
+    size_t next = 0;
+    for (const auto &w : words) {
+        if (w.second <= 0)
+            continue;
+        if (!w.first.empty()) {
+            size_t b = static_cast<unsigned char>(w.first[0]);
+            for (; next <= b; next++)
+                mFirst[next] = mCounts.size();
+        }
+        mChars += w.first;
+        mOffsets.push_back(mChars.size());
+        mCounts.push_back(w.second);
+    }
+    for (; next < 257; next++)
+        mFirst[next] = mCounts.size();
+}
+
+/*!
+ * \fn Lexicon::bytes
+ * \return Memory held by the words, offsets and counts
+ */
+size_t Lexicon::bytes() const
+{
+    return mChars.capacity() + mOffsets.capacity() * sizeof(unsigned int) + mCounts.capacity() * sizeof(int);
+}
+
+/*!
+ * \fn Lexicon::compare
+ * \return <0, 0 or >0 as word i sorts before, equal to or after word
+ */
+int Lexicon::compare(size_t i, const std::string &word) const
+{
+    size_t len = mOffsets[i + 1] - mOffsets[i];
+    int c = std::memcmp(mChars.data() + mOffsets[i], word.data(), std::min(len, word.size()));
+    if (c != 0)
+        return c;
+    return len < word.size() ? -1 : (len > word.size() ? 1 : 0);
+}
+
+/*!
+ * \fn Lexicon::frequency
+ * \param word
+ * \return Count of word, 0 if it is not in the lexicon
+ */
+int Lexicon::frequency(const std::string &word) const
+{
+    mLookups.fetch_add(1, std::memory_order_relaxed);
+    size_t lo, hi;
+    if (word.empty()) {
+        lo = 0;
+        hi = mFirst[0];
+    } else {
+        size_t b = static_cast<unsigned char>(word[0]);
+        lo = mFirst[b];
+        hi = mFirst[b + 1];
+    }
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int c = compare(mid, word);
+        if (c == 0)
+            return mCounts[mid];
+        if (c < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    mMisses.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+}
+
+/*!
+ * \fn Lexicon::stats
+ * \return Lookups and misses since the last freeze() or resetStats()
+ */
+Lexicon::Stats Lexicon::stats() const
+{
+    Stats s;
+    s.lookups = mLookups.load(std::memory_order_relaxed);
+    s.misses = mMisses.load(std::memory_order_relaxed);
+    return s;
+}
+
+/*!
+ * \fn Lexicon::resetStats
+ * \brief Sets the lookup and miss counters to 0.
+ */
+void Lexicon::resetStats()
+{
+    mLookups.store(0, std::memory_order_relaxed);
+    mMisses.store(0, std::memory_order_relaxed);
+}
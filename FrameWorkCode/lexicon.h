@@ -0,0 +1,46 @@
+#ifndef LEXICON_H
+#define LEXICON_H
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+class Lexicon
+{
+public:
+    //! Lookups counted since the lexicon was frozen or the stats were reset
+    struct Stats {
+        unsigned long long lookups = 0;
+        unsigned long long misses = 0;
+    };
+
+    Lexicon();
+    explicit Lexicon(const std::map<std::string, int> &words);
+    Lexicon(const Lexicon &) = delete;
+    Lexicon &operator=(const Lexicon &) = delete;
+
+    void freeze(const std::map<std::string, int> &words);
+    void clear();
+    bool empty() const { return mCounts.empty(); }
+    size_t size() const { return mCounts.size(); }
+    size_t bytes() const;
+
+    int frequency(const std::string &word) const;
+    bool contains(const std::string &word) const { return frequency(word) > 0; }
+
+    Stats stats() const;
+    void resetStats();
+
+private:
+    std::string mChars;                         //! Every word, in order, back to back
+    std::vector<unsigned int> mOffsets;         //! Start of every word in mChars, and the end of the last one
+    std::vector<int> mCounts;                   //! Count of every word
+    unsigned int mFirst[257];                   //! Words starting with byte b are mFirst[b] .. mFirst[b + 1] - 1
+    mutable std::atomic<unsigned long long> mLookups;
+    mutable std::atomic<unsigned long long> mMisses;
+
+    int compare(size_t i, const std::string &word) const;
+};
+
+#endif // LEXICON_H
@@ -1,4 +1,6 @@
 #include "loaddataworker.h"
+#include "correctionpairminer.h"
+#include "tracer.h"
 
 /*!
  * \fn LoadDataWorker::LoadDataWorker
@@ -7,7 +9,7 @@
  * \param mProject
  * \param mFilename
  * \param mFilename1
- * \param LSTM
+ * \param LSTM Table of Dicts/LSTM
  * \param CPairs
  * \param Dict
  * \param GBook
@@ -21,15 +23,14 @@
  * \param TGBookP
  * \param TPWords
  * \param TPWordsP
- * \param synonym
- * \param synrows
+ * \param Synonyms Table of Dicts/synonyms.csv
  */
 LoadDataWorker::LoadDataWorker(
         QObject *parent,
         Project* mProject,
         QString mFilename,
         QString mFilename1,
-        map<string, string>* LSTM,
+        MappedTable* LSTM,
         std::map<string, set<string> >* CPairs,
         map<string, int>* Dict,
         map<string, int>* GBook,
@@ -40,11 +41,10 @@ LoadDataWorker::LoadDataWorker(
         vector<string>* vIBook,
         trie* TDict,
         trie* TGBook,
-        trie* TGBookP,
+        SubstringIndex* TGBookP,
         trie* TPWords,
-        trie* TPWordsP,
-        map<string, vector<int> >* synonym,
-        vector<vector<string> >* synrows
+        SubstringIndex* TPWordsP,
+        MappedTable* Synonyms
         ) : QObject(parent)
 {
     this->mProject = mProject;
@@ -64,8 +64,7 @@ LoadDataWorker::LoadDataWorker(
     this->TGBookP = TGBookP;
     this->TPWords = TPWords;
     this->TPWordsP = TPWordsP;
-    this->synonym = synonym;
-    this->synrows = synrows;
+    this->Synonyms = Synonyms;
 }
 
 /*!
@@ -74,6 +73,7 @@ LoadDataWorker::LoadDataWorker(
  */
 void LoadDataWorker::LoadData()
 {
+    TRACE_SCOPE("LoadDataWorker::LoadData");
     on_actionLoadDict_triggered();
     //!GEROCR IEROCR PWords and CPair files are loaded and reflected in terminal
     on_actionLoadOCRWords_triggered();
@@ -81,8 +81,18 @@ void LoadDataWorker::LoadData()
     on_actionLoadSubPS_triggered();
     on_actionLoadConfusions_triggered();
     QString filepath = (*mProject).GetDir().absolutePath() + "/Dicts/synonyms.csv" ;
-    slpNPatternDict slnp;
-    slnp.loadFileCSV(*synonym, *synrows, filepath.toUtf8().constData());
+    //! The rows are parsed only when the table of synonyms.csv is missing or synonyms.csv changed since it was built
+    QFileInfo synonymsSource(filepath);
+    QString synonymsTable = MappedTable::cachePath(synonymsSource);
+    if (!synonymsSource.exists()) {
+        Synonyms->clear();
+    } else if (!Synonyms->load(synonymsTable, MappedTable::Groups, synonymsSource)) {
+        slpNPatternDict slnp;
+        map<string, vector<int>> synonym;
+        vector<vector<string>> synrows;
+        slnp.loadFileCSV(synonym, synrows, filepath.toUtf8().constData());
+        Synonyms->build(synonymsTable, MappedTable::groupsImage(synonym, synrows, synonymsSource));
+    }
     emit finishedLoadingData();
 }
 
@@ -163,21 +173,33 @@ void LoadDataWorker::on_actionLoadSubPS_triggered()
     size_t count = trie.loadPWordsPatternstoTrie(*TPWordsP, *PWords);// justsubstrings not patterns exactly // PWordsP,
     QString localmFilename1 = (*mProject).GetDir().absolutePath() + "/Dicts/" + "Corrector_CPair";
 
+    slnp.loadCPairs(localmFilename1.toUtf8().constData(), *CPairs, *Dict, *PWords);
+    //! Pairs added since the last compaction are still in the append-only journal next to the CPair file
+    localmFilename1 += ".journal";
     slnp.loadCPairs(localmFilename1.toUtf8().constData(), *CPairs, *Dict, *PWords);
     localmFilename1 = mFilename1;
 
     localmFilename1 = (*mProject).GetDir().absolutePath() + "/Dicts/" + "LSTM";
-    ifstream myfile(localmFilename1.toUtf8().constData());
-    if (myfile.is_open())
-    {
-        string str1, str2, line;
-        while (getline(myfile, line))
+    //! The pairs are parsed only when the table of LSTM is missing or LSTM changed since it was built
+    QFileInfo lstmSource(localmFilename1);
+    QString lstmTable = MappedTable::cachePath(lstmSource);
+    if (!lstmSource.exists()) {
+        LSTM->clear();
+    } else if (!LSTM->load(lstmTable, MappedTable::Pairs, lstmSource)) {
+        map<string, string> pairs;
+        ifstream myfile(localmFilename1.toUtf8().constData());
+        if (myfile.is_open())
         {
-            istringstream slinenew(line); slinenew >> str1; slinenew >> str2;
-            if (str2.size() > 0) (*LSTM)[str1] = str2;
+            string str1, str2, line;
+            while (getline(myfile, line))
+            {
+                istringstream slinenew(line); slinenew >> str1; slinenew >> str2;
+                if (str2.size() > 0) pairs[str1] = str2;
+            }
         }
+        LSTM->build(lstmTable, MappedTable::pairsImage(pairs, lstmSource));
     }
-    cout << (*LSTM).size() << "LSTM Pairs Loaded";
+    cout << LSTM->size() << "LSTM Pairs Loaded";
     localmFilename1 = mFilename1;
 
     trie.loadmaptoTrie(*TPWords, *PWords);
@@ -189,6 +211,9 @@ void LoadDataWorker::on_actionLoadSubPS_triggered()
 /*!
  * \fn LoadDataWorker::on_actionLoadConfusions_triggered
  * \brief Loads the confusions for CPair
+ * \details The confusions and correction pairs of every corrected page of the set are added as well. They are mined
+ * by CorrectionPairMiner, which keeps them in the user's cache folder, out of the set's repository, and only aligns
+ * the pages edited since.
  */
 void LoadDataWorker::on_actionLoadConfusions_triggered()
 {
@@ -196,5 +221,15 @@ void LoadDataWorker::on_actionLoadConfusions_triggered()
     QString localmFilename1 = (*mProject).GetDir().absolutePath() + "/Dicts/" + "CorrectorCPair";
     slnp.loadConfusions(localmFilename1.toUtf8().constData(), *ConfPmap);
     localmFilename1 = mFilename;
+
+    QString setDir = (*mProject).GetDir().absolutePath();
+    CorrectionPairMiner miner(MappedTable::cachePath(QFileInfo(setDir), "CorrectionPairs"));
+    miner.load();
+    CorrectionPairMiner::Stats stats = miner.mine(CorrectionPairMiner::bookPages(setDir));
+    if (stats.mined > 0)
+        miner.save();
+    int added = miner.feed(*ConfPmap, *CPairs);
+    cout << stats.pairs << " correction pairs mined from " << stats.pages << " pages (" << stats.mined << " aligned), "
+         << added << " added to CPairs" << endl;
 }
 
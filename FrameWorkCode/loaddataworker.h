@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <Project.h>
+#include "mappedtable.h"
 #include "slpNPatternDict.h"
 #include "trieEditdis.h"
 
@@ -15,7 +16,7 @@ public:
             Project* mProject = nullptr,
             QString mFilename = "",
             QString mFilename1 = "",
-            map<string, string>* LSTM = nullptr,
+            MappedTable* LSTM = nullptr,
             std::map<string, set<string> >* CPairs = nullptr,
             map<string, int>* Dict = nullptr,
             map<string, int>* GBook = nullptr,
@@ -26,22 +27,21 @@ public:
             vector<string>* vIBook = nullptr,
             trie* TDict = nullptr,
             trie* TGBook = nullptr,
-            trie* TGBookP = nullptr,
+            SubstringIndex* TGBookP = nullptr,
             trie* TPWords = nullptr,
-            trie* TPWordsP = nullptr,
-            map<string, vector<int> >* synonym = nullptr,
-            vector<vector<string> >* synrows = nullptr
+            SubstringIndex* TPWordsP = nullptr,
+            MappedTable* Synonyms = nullptr
             );
 private:
-    map<string, string>* LSTM;
+    MappedTable* LSTM;
     map<string, set<string> >* CPairs;
     map<string, int> *Dict, *GBook, *IBook, *PWords, *ConfPmap;
     vector<string> *vGBook, *vIBook;
-    trie *TDict, *TGBook, *TGBookP, *TPWords, *TPWordsP;
+    trie *TDict, *TGBook, *TPWords;
+    SubstringIndex *TGBookP, *TPWordsP;
     Project *mProject;
     QString mFilename1, mFilename;
-    map<string, vector<int> >* synonym;
-    vector<vector<string> >* synrows;
+    MappedTable* Synonyms;
 
     bool loadDict(Project & project);
     void on_actionLoadDict_triggered();
@@ -14,10 +14,7 @@
 #include <QDateTime>
 #include <signal.h>
 #include "crashlog.h"
-#include <QAbstractItemModel>
-QAbstractItemModel* CustomTextBrowser::engModel = nullptr;
-QAbstractItemModel* CustomTextBrowser::devModel = nullptr;
-int CustomTextBrowser::modelFlag = 0;
+#include "tracer.h"
 
 /*!
  * \fn signalHandler
@@ -107,6 +104,8 @@ int main(int argc, char *argv[])
     logFile.close();
 
     mySignal();
+    //! QPAD_TRACE=1 times the hot paths from the start; the trace is written next to application.log on exit
+    Tracer::setEnabled(qEnvironmentVariableIsSet("QPAD_TRACE"));
     MainWindow w;
     //! Checking login
     if(w.exitStatus()) {
@@ -121,6 +120,10 @@ int main(int argc, char *argv[])
     }
 
     int retn = a.exec();
+    if (Tracer::isEnabled()) {
+        Tracer::writeChromeTrace(qApp->applicationDirPath() + "/trace.json");
+        qDebug().noquote() << "Timing summary:\n" + Tracer::summary();
+    }
     git_libgit2_shutdown();
     return retn;
 }
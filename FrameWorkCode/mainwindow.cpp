@@ -6,8 +6,16 @@
 #include "threadingpush.h"
 #include "ui_mainwindow.h"
 #include "averageaccuracies.h"
-#include "eddis.h"
+#include "batchrunner.h"
+#include "confusionrewriter.h"
+#include "correctionpairminer.h"
+#include "lexicon.h"
+#include "mappedtable.h"
+#include "pagequalityestimator.h"
+#include "pagetokencache.h"
+#include "spellchecker.h"
 #include "slpNPatternDict.h"
+#include "suggestionpipeline.h"
 #include "trieEditdis.h"
 #include <math.h>
 #include "QProgressBar"
@@ -28,6 +36,8 @@
 #include <string>
 #include <fstream>
 #include <vector>
+#include <QHeaderView>
+#include <QShortcut>
 #include <utility>
 #include <regex>
 #include "crashlog.h"
@@ -93,9 +103,10 @@
 
 
 
-map<string, string> LSTM;
+MappedTable LSTM;
 map<string, int> Dict, GBook, IBook, PWords, PWordsP,ConfPmap,ConfPmapFont,CPairRight;
-trie TDict,TGBook,TGBookP, newtrie,TPWords,TPWordsP;
+trie TDict,TGBook, newtrie,TPWords;
+SubstringIndex TGBookP, TPWordsP;
 vector<string> vGBook,vIBook;
 QImage imageOrig;
 QString gDirOneLevelUp,gDirTwoLevelUp,gCurrentPageName, gCurrentDirName;
@@ -105,16 +116,21 @@ map<QString, int> timeLog;
 QMap<QString, QJsonArray> newTimeLog;
 vector<QString> vs; vector<int> vx, vy, vw, vh, vright;
 map<string, vector<string>> SRules;
-map<string, string> TopConfusions;
-map<string, int> TopConfusionsMask;
+ConfusionRewriter ConfRewriter;
+//! Dict, GBook and the confusion maps frozen for lookups once loaded, so that looking a word up inserts nothing
+Lexicon LexDict, LexGBook, LexConfPmap, LexConfPmapFont;
 map<string, int> TimeLog;
 string TimeLogLocation = "../Logs/log.txt";
 string alignment = "left";
 bool prevTRig = 0;
-map<string, vector<int>> synonym;
-vector<vector<string>> synrows;
+MappedTable Synonyms;
 map<string, string> CPair;
 std::map<string, set<string> > CPairs;
+//! The sources of the right click suggestions, reading the tables above
+SuggestionPipeline Suggestions({ &TGBookP, &TGBook, &TPWords, &TPWordsP, &vIBook, &PWords, &CPairs, &LexDict, &LexConfPmap,
+                                 &LexConfPmapFont, &ConfRewriter, &SRules });
+//! Estimates of the OCR quality of the pages of the set, measured against LexGBook and a snapshot of PWords
+PageQualityEstimator PageEstimates;
 bool highlightchecked = false;
 map<int, QString> commentdict;
 map<int, vector<int>> commentederrors;
@@ -154,6 +170,20 @@ QList<QTableWidgetItem *> selectedItems;
 QTableWidget *m_table;
 QDialog *tableDialog;
 
+/*!
+ * \fn fetchedRowCount
+ * \brief Rows of a project tree folder, after fetching the files TreeModel keeps pending until the folder is expanded
+ * \param model
+ * \param parent
+ * \return int
+ */
+static int fetchedRowCount(QAbstractItemModel *model, const QModelIndex &parent)
+{
+    if (model->canFetchMore(parent))
+        model->fetchMore(parent);
+    return model->rowCount(parent);
+}
+
 
 /*!
  * \fn MainWindow::MainWindow
@@ -278,8 +308,10 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),ui(new Ui::MainWin
     ui->horizontalSlider->setEnabled(false);
 
     connect(ui->horizontalSlider, SIGNAL(valueChanged(int)), this, SLOT(zoom_slider_valueChanged(int)));
+
+    QShortcut *traceShortcut = new QShortcut(QKeySequence("Ctrl+Alt+Shift+T"), this);
+    connect(traceShortcut, SIGNAL(activated()), this, SLOT(toggleTracing()));
     connect(ui->horizontalSlider, SIGNAL(sliderMoved(int)), this, SLOT(zoom_slider_moved(int)));
-    connect(&watcher, SIGNAL(directoryChanged(const QString&)), this, SLOT(directoryChanged(const QString&)));
 
     qApp->installEventFilter(this);
     AddRecentProjects();
@@ -497,6 +529,15 @@ bool MainWindow::setRole(QString role)
  */
 MainWindow::~MainWindow()
 {
+    stopDirectoryWatcher();
+    mCPairJournal.reset();
+    delete mReplaceJournal;
+    if (mHighlightsLog)
+        mHighlightsLog->compact();
+    delete mHighlightsLog;
+    if (mTimeLog)
+        mTimeLog->compact();
+    delete mTimeLog;
     delete ui;
 }
 
@@ -547,24 +588,19 @@ int gSeconds;
 /*!
  * \fn MainWindow::SaveTimeLog
  * \brief This function saves the time of changes commit into the log json file.
- * \sa writeJsonFile()
+ * \details Only the record of the page being saved is written; the other pages of newTimeLog have not changed.
+ * \param key Time log key of the page, i.e. role:page:V-version
+ * \sa TimeLogStore
  */
-void MainWindow::SaveTimeLog()
+void MainWindow::SaveTimeLog(const QString &key)
 {
-    QJsonObject mainObj;
-    QJsonObject page;
-
+    if (!mTimeLog || !newTimeLog.contains(key))
+        return;
     int nMilliseconds = myTimer.elapsed();
     int sec = nMilliseconds / 1000;
-    //! Iterating over newTimeLog and and assinging time details into the page and finally inserting page into json object.
-    for (auto i = newTimeLog.begin(); i != newTimeLog.end(); i++)
-    {
-        page["directory"] = i.key();
-        page["seconds"] = i.value().at(0).toInt()+sec;
-        page["Date/Time"] = i.value().at(1).toString();
-        mainObj.insert(i.key(), page);
-    }
-    writeJsonFile(gTimeLogLocation, mainObj);
+    QJsonArray entry = newTimeLog.value(key);
+    QDateTime dateTime = QDateTime::fromString(entry.at(1).toString());
+    mTimeLog->record(key, entry.at(0).toInt() + sec, dateTime.isValid() ? dateTime : QDateTime::currentDateTime());
 }
 
 /*!
@@ -631,7 +667,7 @@ string selectedStr ="";
  * \param ev
  * \brief Checks if the right click is pressed on the mouse and loads suggestion changes
  * \details Custom mouse event is created which loads a suggestion and translation menu for the string on which the current string highlight is present. These are loaded with the help of dictionary files which are loaded with the help of loaddata function. Works with the help of a flag.
- * \sa print5NearestEntries(), print2OCRSugg(), loadWConfusionsNindex1(), editDist(), make_pair()
+ * \sa SuggestionPipeline::suggest()
  */
 void MainWindow::mousePressEvent(QMouseEvent *ev)
 {
@@ -639,7 +675,6 @@ void MainWindow::mousePressEvent(QMouseEvent *ev)
     if(!curr_browser)
         return;
     slpNPatternDict slnp;
-    trieEditDis trie;
 
     // to make sure the right menu click is not taking place outside of the tabWidget_2
     QRect tabRect = curr_browser->frameGeometry();
@@ -739,6 +774,7 @@ void MainWindow::mousePressEvent(QMouseEvent *ev)
 
         if (((ev->button() == Qt::RightButton) && (!LoadDataFlag)) || (RightclickFlag))
         {
+            TRACE_SCOPE_AS(trace, "MainWindow::mousePressEvent suggestions");
             QMenu* spell_menu, *translate_menu, *clipboard_menu;
             QAction *act;
             QTextCursor cursor1 = curr_browser->cursorForPosition(ev->pos());
@@ -805,159 +841,33 @@ void MainWindow::mousePressEvent(QMouseEvent *ev)
             connect(gtrans, SIGNAL(triggered()), this, SLOT(GoogleTranslation()));
             connect(insertImage, SIGNAL(triggered()), this, SLOT(insertImageAction()));
             QString str = QString::fromStdString(selectedStr);
-            vector<string> Alligned = trie.print5NearestEntries(TGBookP, selectedStr);
-            if (!selectedStr.empty() && !Alligned.empty()) {
-
-
+            bool aligned;
+            vector<SuggestionPipeline::Suggestion> suggestions = Suggestions.suggest(selectedStr, mProject.get_configuration() == "True", &aligned);
+            if (aligned) {
                 spell_menu = new QMenu("suggestions", this);
 
                 spell_menu->setFont(font);
 
 
                 QAction* act;
-                vector<string>  Words1 = trie.print5NearestEntries(TGBook, selectedStr);
-                // if (Words1.empty()) return;
-
-
-                //if (Alligned.empty()) return;
-
-                vector<string> PWords1 = trie.print5NearestEntries(TPWords, selectedStr);
-                // if (PWords1.empty()) return;
-
-                string PairSugg = slnp.print2OCRSugg(selectedStr, Alligned[0], ConfPmap, Dict); // map<string,int>&
-                //  if (PairSugg.empty())return;
-
-                vector<string>  Words = trie.print1OCRNearestEntries(slnp.toslp1(selectedStr), vIBook);
-                //  if (Words.empty())return;
-
-
-                //! find nearest confirming to OCR Sugg from Book
-                string nearestCOnfconfirmingSuggvec;
-                vector<string> vec = Words1;
-                int min = 100;
-                for (size_t t = 0; t < vec.size(); t++)
-                {
-                    vector<string> wordConfusions; vector<int> wCindex;
-                    int minFactor = slnp.loadWConfusionsNindex1(selectedStr, vec[t], ConfPmap, wordConfusions, wCindex);
-                    wordConfusions.clear(); wCindex.clear();
-                    if (minFactor < min) { min = minFactor; nearestCOnfconfirmingSuggvec = vec[t]; }
-                }
-
-                //! find nearest confirming to OCR Sugg from PWords
-                string nearestCOnfconfirmingSuggvec1;
-                vector<string> vec1 = PWords1;
-                min = 100;
-                for (size_t t = 0; t < vec1.size(); t++) {
-                    vector<string> wordConfusions; vector<int> wCindex;
-                    int minFactor = slnp.loadWConfusionsNindex1(selectedStr, vec1[t], ConfPmap, wordConfusions, wCindex);
-                    wordConfusions.clear(); wCindex.clear();
-                    if (minFactor < min) { min = minFactor; nearestCOnfconfirmingSuggvec1 = vec1[t]; }
-                }
-
-                vector<pair<int, string>> vecSugg, vecSugg1;
-                map<string, int> mapSugg;
-
-                vector<string> out;
-                map<string, set<string>>::iterator itr;
-                set<string>::iterator set_it;
-
-                for (itr = CPairs.begin(); itr != CPairs.end(); ++itr)
-                {
-                    if(slnp.toslp1(itr->first) == slnp.toslp1(selectedStr))
-                    {
-                        for (set_it = itr->second.begin(); set_it != itr->second.end(); ++set_it)
-                        {
-                            out.push_back(slnp.toslp1(*set_it));
-                        }
-                    }
-                }
-
-                cout<<"From CPairs: ";
-                for(auto& it : out){
-                    cout << slnp.toslp1(it) << endl;
-                }
-                for (size_t ksugg1 = 0; ksugg1 < 6; ksugg1++)
-                {
-                    if (out.size() > ksugg1)  mapSugg[slnp.toslp1(out[ksugg1])]++;
-                }
-
-                if(mProject.get_configuration()=="True")
-                {
-                    if (Words.size() > 0)  mapSugg[slnp.toslp1(Words[0])]++;
-                    if (Words1.size() > 0) mapSugg[slnp.toslp1(nearestCOnfconfirmingSuggvec)]++;
-                    if (PWords1.size() > 0) mapSugg[slnp.toslp1(nearestCOnfconfirmingSuggvec1)]++;
-                    if (PairSugg.size() > 0) mapSugg[slnp.toslp1(PairSugg)]++;
-                    mapSugg[trie.SamasBreakLRCorrect(slnp.toslp1(selectedStr), Dict, PWords, TPWords, TPWordsP)]++;
-                    string s1 = slnp.toslp1(selectedStr);
-                    string nearestCOnfconfirmingSuggvecFont = "";
-                    min = 100;
-                    for (size_t t = 0; t < vec.size(); t++)
-                    {
-                        vector<string> wordConfusions; vector<int> wCindex;
-                        int minFactor = slnp.loadWConfusionsNindex1(s1, vec[t], ConfPmapFont, wordConfusions, wCindex);
-                        wordConfusions.clear(); wCindex.clear();
-                        if (minFactor < min) { min = minFactor; nearestCOnfconfirmingSuggvecFont = vec[t]; }
-                    }
-                    //if (nearestCOnfconfirmingSuggvecFont.size() > 0) mapSugg[nearestCOnfconfirmingSuggvecFont]++;
-
-                    string PairSuggFont = "";
-                    if (Alligned.size() > 0) PairSuggFont = slnp.print2OCRSugg(s1, Alligned[0], ConfPmap, Dict);
-                    //if (PairSuggFont.size() > 0) mapSugg[PairSuggFont]++;
-
-                    string sugg9 = "";
-                    sugg9 = slnp.generatePossibilitesNsuggest(s1, TopConfusions, TopConfusionsMask, Dict, SRules);
-                    //if (sugg9.size() > 0) mapSugg[sugg9]++;
-
-                    cout<<"selected string: "<<slnp.toslp1(selectedStr)<<endl;
-                    cout<<"Mapped Suggestion 0: "<<endl; //(string,int) Words, last no. of occuring, create single entry for single same word
-
-                    cout<<"From Primary OCR: ";
-                    for(auto& it : Words){
-                        for(uint i = 0;i<it.size();i++){
-                            cout << it[i];
-                        }
-                        cout<<"\n";
-                    }
-                    cout<<"Nearest confirming from Secondary OCR "<<nearestCOnfconfirmingSuggvec<<endl;
-                    cout<<"Nearest confirming from PWords "<<nearestCOnfconfirmingSuggvec1<<endl;
-                    cout<<"One suggestion from ConfusionPair and secondary OCR Trie Pattern Data "<<slnp.toslp1(PairSugg)<<endl;
-                    cout<<"One suggestion from Pwords which is present in Dict "<<trie.SamasBreakLRCorrect(slnp.toslp1(selectedStr), Dict, PWords, TPWords, TPWordsP)<<endl;
-                    //                cout<<"Nearest confirming from Secondary OCR by converting the string in English "<<nearestCOnfconfirmingSuggvecFont<<endl;
-                    //                cout<<"One suggestion from ConfusionPair and secondary OCR Trie Pattern Data by converting the string in English "<<toslp1(PairSuggFont)<<endl;
-                    //                cout<<"One suggestion from TopConfusion and SandhiRules by converting the string in English "<<sugg9<<endl;
-                }
-                eddis e;
-                for (map<string, int>::const_iterator eptr = mapSugg.begin(); eptr != mapSugg.end(); eptr++)
-                {
-                    vecSugg.push_back(make_pair(e.editDist(slnp.toslp1(eptr->first), slnp.toslp1(selectedStr)), eptr->first));
-                }
-
-                sort(vecSugg.begin(), vecSugg.end());
-
-                cout << "\nVector Suggestions 0\n";
-                cout << "MappingNum\t vector_int\t Word\n";
-                for (uint i = 0; i < vecSugg.size(); i++){
-                    cout<<mapSugg[vecSugg[i].second]<<"\t"<<vecSugg[i].first<<"\t"<<slnp.toDev(vecSugg[i].second)<<endl;
-                }
-
-                for (uint bitarrayi = 0; bitarrayi < vecSugg.size(); bitarrayi++)
+                for (const SuggestionPipeline::Suggestion& suggestion : suggestions)
                 {
-                    act = new QAction(QString::fromStdString(slnp.toDev(vecSugg[bitarrayi].second)), spell_menu);
+                    act = new QAction(QString::fromStdString(slnp.toDev(suggestion.word)), spell_menu);
                     spell_menu->addAction(act);
                 }
 
                 selectedStr.erase(remove(selectedStr.begin(), selectedStr.end(), ' '), selectedStr.end());
                 vector<string> translate;
-                vector<int>& syn = synonym[selectedStr];
-                for(int i=0; i < syn.size(); i++)
+                int synonymKey = Synonyms.find(selectedStr);
+                if (synonymKey >= 0)
                 {
-                    vector<string>& rowit = synrows[syn[i]];
-                    for(int j=0; j < rowit.size(); j++)
+                    for (quint32 row : Synonyms.groups(synonymKey))
                     {
-                        if(rowit[j] != selectedStr)
+                        for (quint32 member : Synonyms.members(row))
                         {
-                            translate.push_back(rowit[j]);
-                            cout << rowit[j] << endl;
+                            MappedTable::Text word = Synonyms.key(member);
+                            if (word != selectedStr)
+                                translate.push_back(word.toStdString());
                         }
                     }
                 }
@@ -981,6 +891,7 @@ void MainWindow::mousePressEvent(QMouseEvent *ev)
             }
 
             DisplayTimeLog();
+            TRACE_END(trace);
 
             //QMenu* popup_menu = curr_browser->createStandardContextMenu();
             popup_menu->exec(ev->globalPos());
@@ -1008,8 +919,11 @@ void MainWindow::menuSelection(QAction* action)
         cursor.removeSelectedText();
 
         string target = (action->text().toUtf8().constData());
-        CPair[slnp.toslp1(selectedStr)] = slnp.toslp1(target);
-        PWords[slnp.toslp1(target)]++;
+        PageTokenCache& tokenCache = PageTokenCache::shared();
+        const string& targetSlp1 = tokenCache.slp1(target);
+        CPair[tokenCache.slp1(selectedStr)] = targetSlp1;
+        PWords[targetSlp1]++;
+        Suggestions.invalidate();
         cursor.insertText(action->text());     //inserting into the page
 
         cursor.endEditBlock();
@@ -1203,6 +1117,15 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
             QMessageBox::warning(0, "Project Error", "Couldn't open project. Please check your project.");
             return;
         }
+        startCommitQueue();
+        mCPairJournal.reset(new CPairJournal(mProject.GetDir().absolutePath() + "/Dicts/" + mRole + "_CPair"));
+        mCPairJournal->open();
+        delete mReplaceJournal;
+        //! Kept in the user's cache folder: it holds absolute paths and must not be committed with Dicts
+        mReplaceJournal = new ReplaceJournal(MappedTable::cachePath(QFileInfo(mProject.GetDir().absolutePath()), mRole + "_ReplaceJournal"));
+        //! The last global replace of this set can still be undone after a restart
+        if (mReplaceJournal->load())
+            globallyReplacedWords = mReplaceJournal->words();
         ui->treeView->setModel(mProject.getModel());
         ui->treeView->setContextMenuPolicy(Qt::CustomContextMenu);
 
@@ -1220,10 +1143,6 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
         QString str3 = mProject.GetDir().absolutePath() + "/Inds/";
         QString str4 = mProject.GetDir().absolutePath() + "/Images/";
 
-        //!To lookout for changes in CorrectorOutput and VerifierOutput directory
-        watcher.addPath(str1);
-        watcher.addPath(str2);
-
         //!To Display tree view for Document
         QDir cdir(str1);
 
@@ -1241,8 +1160,8 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
                 totalFileCountInDir++;
                 mProject.AddTemp(filter,f2,"");
             }
-            corrector_set.insert(f);
         }
+        QStringList correctorFiles = list;
         fileCountInDir["Corrector"] = totalFileCountInDir;
         totalFileCountInDir = 0;
 
@@ -1262,11 +1181,15 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
                 totalFileCountInDir++;
                 mProject.AddTemp(filter, f2, "");
             }
-            verifier_set.insert(f);
         }
         fileCountInDir["Verifier"] = totalFileCountInDir;
         totalFileCountInDir = 0;
 
+        //!To lookout for changes in CorrectorOutput and VerifierOutput directory
+        startDirectoryWatcher();
+        QMetaObject::invokeMethod(mDirectoryWatcher, "watch", Qt::QueuedConnection, Q_ARG(QString, str1), Q_ARG(QStringList, correctorFiles));
+        QMetaObject::invokeMethod(mDirectoryWatcher, "watch", Qt::QueuedConnection, Q_ARG(QString, str2), Q_ARG(QStringList, list));
+
         filter = mProject.getFilter("Document");
         //!Adds the files from inds folder to treeView
         cdir.setPath(str3);
@@ -1343,7 +1266,10 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
 
         //!Get the elapsed time in Timelog.json file under Comments folder
         gTimeLogLocation = gDirTwoLevelUp + "/Comments/"+mRole+"_Timelog.json";     //Navigate to Timelog.json uder Comments folder
-        QJsonObject mainObj =  readJsonFile(gTimeLogLocation);
+        delete mTimeLog;
+        mTimeLog = new TimeLogStore(gTimeLogLocation);
+        mTimeLog->open();
+        QJsonObject mainObj = mTimeLog->toJson();
 
         //!Get the seconds elapsed for their file name in json file
         foreach(const QJsonValue &val, mainObj)
@@ -1430,6 +1356,10 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
     IBook.clear();
     PWords.clear();
     ConfPmap.clear();
+    LexDict.clear();
+    LexGBook.clear();
+    LexConfPmap.clear();
+    LexConfPmapFont.clear();
     vGBook.clear();
     vIBook.clear();
     TDict.clear();
@@ -1437,8 +1367,9 @@ void MainWindow::on_actionOpen_Project_triggered() { //Version Based
     TGBookP.clear();
     TPWords.clear();
     TPWordsP.clear();
-    synonym.clear();
-    synrows.clear();
+    Synonyms.clear();
+    Suggestions.invalidate();
+    PageEstimates.setTables(LexGBook, PWords);
 
     ui->pushButton->setDisabled(false);
     ui->pushButton_2->setDisabled(false);
@@ -1501,8 +1432,6 @@ bool ConvertSlpDevFlag = 0;
  */
 void MainWindow::SaveFile_GUI_Preprocessing()
 {
-
-    SaveTimeLog();
     if (!mProject.isProjectOpen())
         return;
     //! Adding entries in Timelog.json about the elapsed time
@@ -1519,7 +1448,7 @@ void MainWindow::SaveFile_GUI_Preprocessing()
     QString dateTime = QDateTime::currentDateTime().toString();
     newTimeLog[mRole +":"+ gCurrentPageName +":V-"+ currentVersion] = {gSeconds, dateTime};
 
-    SaveTimeLog();
+    SaveTimeLog(mRole +":"+ gCurrentPageName +":V-"+ currentVersion);
     DisplayTimeLog();
     //! When changes are made by the verifier the following values are also updated.
     if(isVerifier)
@@ -1727,6 +1656,7 @@ void MainWindow::SaveFile_GUI_Postprocessing()
  */
 void MainWindow::on_actionSave_triggered()
 {
+    TRACE_SCOPE("MainWindow::on_actionSave_triggered");
     // check if file is new
     if (mFilename=="Untitled")
     {
@@ -1765,6 +1695,18 @@ void MainWindow::on_actionSave_triggered()
 
         SaveFile_GUI_Postprocessing(); // GUI Postprocessing
 
+        //! Only the files written by this save are staged, the commit itself happens in the background
+        if(mCommitQueue)
+        {
+            QString savedFilename = gDirTwoLevelUp + "/" + filestructure_fw[gCurrentDirName] + "/" + gCurrentPageName;
+            savedFilename.replace(".txt",".html");
+            QString dictsDir = gDirTwoLevelUp + "/Dicts/" + mRole;
+            QStringList paths = {savedFilename, gTimeLogLocation, dictsDir + "_DictChanges", dictsDir + "_CPair", dictsDir + "_CPair.journal"};
+            if(mTimeLog)
+                paths << mTimeLog->logPath() << mTimeLog->keysPath();
+            mCommitQueue->enqueue(paths, gCurrentPageName + " saved by " + mRole);
+        }
+
         writeSettings();
     }
     // Run Global Replace
@@ -1826,7 +1768,7 @@ map<string, int> wordLineIndex;
  * \fn MainWindow::on_actionSpell_Check_triggered
  * \brief Converts the whole html page to the original text page in orange color
  * \note works on the basis of a pre-defined flag which helps to always convert the text to Devanagari
- * \sa findDictEntries(), find_and_replace_oddInstancesblue(), find_and_replace_oddInstancesorange(),hasM40PerAsci()
+ * \sa SpellChecker, findDictEntries(), find_and_replace_oddInstancesblue(), find_and_replace_oddInstancesorange(),hasM40PerAsci()
  */
 void MainWindow::on_actionSpell_Check_triggered()
 {
@@ -1840,79 +1782,38 @@ void MainWindow::on_actionSpell_Check_triggered()
     textBrowserText+=" ";
     string str1=textBrowserText.toUtf8().constData();
 
-    //! load number of words
-    istringstream iss1(str1);
-    size_t WordCount = 0;
-    string word1;
-    while(iss1 >> word1) WordCount++;
-
-    //str1 = toslp1(str1);
-    istringstream iss(str1);
-    string strHtml = "<html><body>";
+    //! Every distinct word of the page is converted to SLP1 and Devanagari once, by the shared token cache
+    std::shared_ptr<const PageTokenCache::Page> page = PageTokenCache::shared().text(textBrowserText.toUtf8());
+    const vector<PageTokenCache::Token>& tokens = page->tokens;
+    string strHtml;
     string line;
 
-    int value = 0;
-    while (getline(iss, line))
+    if(ConvertSlpDevFlag)
     {
-        istringstream issw(line);
-        string word;
-
-        while(issw >> word)
+        strHtml = "<html><body>";
+        size_t next = 0;
+        for (unsigned int lineNo = 0; lineNo < page->lines; lineNo++)
         {
-            if(ConvertSlpDevFlag)
+            for (; next < tokens.size() && tokens[next].line == lineNo; next++)
             {
-                string word1 = word;
-                word = slnp.toslp1(word);
-                string wordNext;
-                if(slnp.hasM40PerAsci(word1))
-                {
-                    wordNext = word1;
-                }
-                else
-                {
-                    wordNext = slnp.toDev(word);
-                }
-                strHtml += wordNext; strHtml += " ";
-                value ++;
-            }
-            else
-            {
-                string word1 = word;
-                word = slnp.toslp1(word);
-                string wordNext;
-                //! checks if the word exists in the English language, Seconday OCR, Pwords, Dict and CPair; convert its color coding
-                if(slnp.hasM40PerAsci(word1))
-                    wordNext = word1;
-
-                else if(GBook[(word)] > 0 )
-                {
-                    wordNext = slnp.toDev(word);
-                    PWords[word]++;
-                }
-
-                else if(PWords[word] > 0)
-                {
-                    wordNext = "<font color=\'gray\'>" + slnp.toDev(word) + "</font>";
-                }
-                else if((Dict[word] ==0) && (PWords[word] == 0) && (CPair[word].size() > 0))
-                {
-                    wordNext = "<font color=\'purple\'>" + slnp.toDev(CPair[word]) + "</font>";
-                }
-                else
-                {
-                    wordNext = slnp.findDictEntries(slnp.toslp1(word),Dict,PWords, word.size());     //replace m1 with m2,m1 for combined search
-                    wordNext = slnp.find_and_replace_oddInstancesblue(wordNext);
-                    wordNext = slnp.find_and_replace_oddInstancesorange(wordNext);
-                }
-                strHtml += wordNext;
+                const PageTokenCache::Form& form = *tokens[next].form;
+                strHtml += form.ascii ? form.text : form.dev();
                 strHtml += " ";
-                value ++;
             }
+            strHtml +="<br>";  // To add new line
         }
-        strHtml +="<br>";  // To add new line
+        strHtml += "</body></html>";
+    }
+    else
+    {
+        //! checks if the word exists in the English language, Seconday OCR, Pwords, Dict and CPair; convert its color coding
+        //! The GBook words are counted into PWords as they are met
+        SpellChecker checker({ &LexGBook, &LexDict, &PWords, &CPair });
+        strHtml = checker.pageHtml(*page, slnp, [](const string &word) { PWords[word]++; });
     }
-    strHtml += "</body></html>";
     curr_browser->setHtml(QString::fromStdString(strHtml));
+    //! PWords has learned the GBook words of the page
+    Suggestions.invalidate();
 
     str1=textBrowserText.toUtf8().constData();
 
@@ -1974,7 +1875,7 @@ void MainWindow::on_actionLoad_Next_Page_triggered()
         QModelIndex currentTreeItemIndex = ui->treeView->selectionModel()->currentIndex();
         QModelIndex parentIndex = currentTreeItemIndex.parent();
         auto model = ui->treeView->model();
-        int rowCount = ui->treeView->model()->rowCount(parentIndex);
+        int rowCount = fetchedRowCount(model, parentIndex);
 
         QString treeItemLabel;
         for (int i = 0; i <= rowCount-1; i++)
@@ -2034,7 +1935,7 @@ void MainWindow::on_actionLoad_Prev_Page_triggered()
         QModelIndex currentTreeItemIndex = ui->treeView->selectionModel()->currentIndex();
         QModelIndex parentIndex = currentTreeItemIndex.parent();
         auto model = ui->treeView->model();
-        int rowCount = ui->treeView->model()->rowCount(parentIndex);
+        int rowCount = fetchedRowCount(model, parentIndex);
 
         QString treeItemLabel;
         for (int i = 0; i < rowCount; i++)
@@ -2107,7 +2008,7 @@ void MainWindow::on_actionToSlp1_triggered()
  * \fn MainWindow::on_actionLoadGDocPage_triggered
  * \brief Loads PWords and its associated trie data structure
  * \details It first saves the file and then loads the data into the variables
- * \sa on_actionSave_As_triggered(), loadMap(), loadmaptoTrie(), generateCorrectionPairs(), loadConfusionsFont, loadTopConfusions()
+ * \sa on_actionSave_As_triggered(), loadMap(), loadmaptoTrie(), generateCorrectionPairs(), loadConfusionsFont, ConfusionRewriter::compile()
 */
 void MainWindow::on_actionLoadGDocPage_triggered()
 {
@@ -2151,9 +2052,10 @@ void MainWindow::on_actionLoadGDocPage_triggered()
         slnp.loadConfusionsFont(wrong, right, ConfPmapFont);
         slnp.loadConfusionsFont(wrong, right, ConfPmap);
 
-        TopConfusions.clear();
-        TopConfusionsMask.clear();
-        slnp.loadTopConfusions(ConfPmap, TopConfusions, TopConfusionsMask);
+        ConfRewriter.compile(ConfPmap);
+        LexConfPmap.freeze(ConfPmap);
+        LexConfPmapFont.freeze(ConfPmapFont);
+        Suggestions.invalidate();
     }
 }
 
@@ -2226,8 +2128,7 @@ void MainWindow::on_actionLoadData_triggered()
                         &TGBookP,
                         &TPWords,
                         &TPWordsP,
-                        &synonym,
-                        &synrows
+                        &Synonyms
                         );
             QThread *thread = new QThread;
 
@@ -2244,6 +2145,17 @@ void MainWindow::on_actionLoadData_triggered()
             spinner->setModal(false);
             spinner->exec();
 
+            //! Dict and GBook are only looked up from now on, the lexicons replace them
+            LexDict.freeze(Dict);
+            LexGBook.freeze(GBook);
+            LexConfPmap.freeze(ConfPmap);
+            map<string, int>().swap(Dict);
+            map<string, int>().swap(GBook);
+            Suggestions.invalidate();
+            PageEstimates.setTables(LexGBook, PWords);
+            QSettings suggestionSettings("IIT-B", "OpenOCRCorrect");
+            Suggestions.loadSettings(suggestionSettings);
+
             ui->lineEdit->setText(initialText);
             LoadDataFlag = 0;
             qDebug() << "done loading ....";
@@ -2315,7 +2227,7 @@ void MainWindow::on_actionFind_and_Replace_triggered()
  * Percent Change made by Corrector wrt OCR Text
  * Percent Word Errors
  * Percent Accuracy of OCR
- * \sa diff_match_patch::diff_main(),  Project::LevenshteinWithGraphemes(), Project::GetGraphemesCount()
+ * \sa BatchRunner::pageAccuracy()
 */
 void MainWindow::on_actionAccuracyLog_triggered()
 {
@@ -2383,64 +2295,13 @@ void MainWindow::on_actionAccuracyLog_triggered()
             }
 
         }
-        int l1,l2,l3, DiffOcr_Corrector,DiffCorrector_Verifier,DiffOcr_Verifier; float correctorChangesPerc,verifierChangesPerc,ocrErrorPerc;
-
-
-        QTextDocument doc;
-
-        doc.setHtml(qs2);
-        qs2 = doc.toPlainText().replace(" \n","\n");
-
-        doc.setHtml(qs3);
-        qs3 = doc.toPlainText().replace(" \n","\n");
-
-        l1 = mProject.GetGraphemesCount(qs1); l2 = mProject.GetGraphemesCount(qs2); l3 = mProject.GetGraphemesCount(qs3);
-        if(qs1=="" | qs2 == "" | qs3 == "")
+        PageAccuracy accuracy = BatchRunner::pageAccuracy(mProject, qs1, qs2, qs3);
+        if(!accuracy.valid)
         {
             continue;
         }
 
-        diff_match_patch dmp;
-
-        auto diffs1 = dmp.diff_main(qs1,qs2);
-        DiffOcr_Corrector = mProject.LevenshteinWithGraphemes(diffs1);
-        correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l2)*100;
-        if(correctorChangesPerc>100)
-            correctorChangesPerc = ((float)(DiffOcr_Corrector)/(float)l1)*100;
-        correctorChangesPerc = (((float)lround(correctorChangesPerc*100))/100);
-
-        auto diffs2 = dmp.diff_main(qs2,qs3);
-        DiffCorrector_Verifier = mProject.LevenshteinWithGraphemes(diffs2);
-        verifierChangesPerc = ((float)(DiffCorrector_Verifier)/(float)l3)*100;
-        if(verifierChangesPerc>100)
-            verifierChangesPerc = ((float)(DiffCorrector_Verifier)/(float)l2)*100;
-        verifierChangesPerc = (((float)lround(verifierChangesPerc*100))/100);
-        float correctorCharAcc =100- (((float)lround(verifierChangesPerc*100))/100); //Corrector accuracy = 100-changes mabe by Verfier
-
-        auto diffs3 = dmp.diff_main(qs1,qs3);
-        DiffOcr_Verifier = mProject.LevenshteinWithGraphemes(diffs3);
-        ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l3)*100;
-        if(ocrErrorPerc>100)
-            ocrErrorPerc = ((float)(DiffOcr_Verifier)/(float)l1)*100;
-        float ocrAcc = 100 - (((float)lround(ocrErrorPerc*100))/100);
-
-
-        auto a = dmp.diff_linesToChars(qs2, qs3); //LinesToChars modifed for WordstoChar in diff_match_patch.cpp
-        auto lineText1 = a[0].toString();
-        auto lineText2 = a[1].toString();
-        auto lineArray = a[2].toStringList();
-        int wordCount2 = qs2.simplified().count(" ");
-        int wordCount3 = qs3.simplified().count(" ");
-        auto diffs = dmp.diff_main(lineText1, lineText2);
-        int worderrors = dmp.diff_levenshtein(diffs);
-        dmp.diff_charsToLines(diffs, lineArray);
-
-        float correctorwordaccuracy = (float)(worderrors)/(float)wordCount3*100;
-        if(correctorwordaccuracy>100)
-            correctorwordaccuracy = (float)(worderrors)/(float)wordCount2*100;
-        correctorwordaccuracy = (((float)lround(correctorwordaccuracy*100))/100);
-
-        csvFile<<pageName<<","<<worderrors<<","<<DiffCorrector_Verifier<<","<< correctorwordaccuracy<<","<<correctorCharAcc<<"," <<correctorChangesPerc<<","<<ocrAcc<<"\n";
+        csvFile<<pageName<<","<<accuracy.wordErrors<<","<<accuracy.charErrors<<","<< accuracy.wordAccuracy<<","<<accuracy.charAccuracy<<"," <<accuracy.correctorChanges<<","<<accuracy.ocrAccuracy<<"\n";
 
     }
 
@@ -2864,7 +2725,9 @@ void MainWindow::on_actionHighlight_triggered()
  * \fn MainWindow::LogHighlights
  * \param QString text
  * \brief Stores highlight metadata to JSON files
- * \sa writeJsonFile()
+ * \details The highlight is appended to the EventLog of HighlightsLog.json instead of rewriting the whole file;
+ * the JSON file is brought up to date when the log is compacted.
+ * \sa EventLog
  * \note Meta data includes: Word highlighted, timestamp, time elapsed, page name
 */
 void MainWindow::LogHighlights(QString word) //Verifier Only
@@ -2878,8 +2741,13 @@ void MainWindow::LogHighlights(QString word) //Verifier Only
     pagename.replace(".txt", "");                                                 // remove extension from file name to use it as a key
     pagename.replace(".html", "");
 
-    QJsonObject mainObj = readJsonFile(highlightsFilename);                       // read JSON file into mainObj
-    QJsonObject page = mainObj.value(pagename).toObject();                        // set values for page name
+    if (!mHighlightsLog || mHighlightsLog->jsonPath() != highlightsFilename) {
+        if (mHighlightsLog)
+            mHighlightsLog->compact();
+        delete mHighlightsLog;
+        mHighlightsLog = new EventLog(highlightsFilename);
+        mHighlightsLog->open();
+    }
     QJsonObject highlights;                                                       // make a new JSON object to store new metadata
 
     int nMilliseconds = myTimer.elapsed();
@@ -2891,12 +2759,7 @@ void MainWindow::LogHighlights(QString word) //Verifier Only
     highlights["Time Elapsed (s)"] = secs;
     highlights["Page Name"] = pagename;
 
-    page.remove(time);
-    page.insert(time, highlights);
-    mainObj.remove(pagename);
-    mainObj.insert(pagename, page);
-
-    writeJsonFile(highlightsFilename, mainObj);
+    mHighlightsLog->append({pagename, time}, highlights);
 }
 
 /*!
@@ -3287,6 +3150,11 @@ void MainWindow::on_actionFetch_2_triggered()
         int error;
         if (forPullBox.clickedButton() == okButton)
         {
+            //! Saves still waiting in the CommitQueue are committed first, and the git lock keeps the queue thread
+            //! away from the repository during the fetch
+            QMutexLocker gitLocker(mCommitQueue ? mCommitQueue->gitMutex() : nullptr);
+            if(mCommitQueue)
+                mCommitQueue->flush();
             if ((error = mProject.fetch(gDirTwoLevelUp)) != 0) {
                 qDebug() << "Fetch failed with error code " << error;
             }
@@ -4263,6 +4131,8 @@ void MainWindow::saveImageRegion(QPixmap cropped, QString a, QString s1,int z, i
             QString path = "/Cropped_Images/figures/Figure"+a+"-"+QString::number(z)+".jpg";
 
             cropped.save(gDirTwoLevelUp+path,"JPG",100);       //100 is storing the image in uncompressed high resolution
+            if(mCommitQueue)
+                mCommitQueue->enqueue({gDirTwoLevelUp+path}, "");
 
             QString src = ".."+path;
             QString html = QString("\n <img src='%1' width='%2' height='%3'>").arg(src).arg(w).arg(h); //Creating an img tag for image resize in latek
@@ -4274,6 +4144,8 @@ void MainWindow::saveImageRegion(QPixmap cropped, QString a, QString s1,int z, i
             QString path = "/Cropped_Images/tables/Table"+a+"-"+QString::number(z)+".jpg";
 
             cropped.save(gDirTwoLevelUp+path,"JPG", 100);
+            if(mCommitQueue)
+                mCommitQueue->enqueue({gDirTwoLevelUp+path}, "");
 
             QString src = ".."+path;
 
@@ -4287,6 +4159,8 @@ void MainWindow::saveImageRegion(QPixmap cropped, QString a, QString s1,int z, i
             QString path = "/Cropped_Images/equations/Equation"+a+"-"+QString::number(z)+".jpg";
 
             cropped.save(gDirTwoLevelUp+path,"JPG",100);
+            if(mCommitQueue)
+                mCommitQueue->enqueue({gDirTwoLevelUp+path}, "");
 
             QString src = ".."+path;
             QString html = QString("\n <img src='%1' width='%2' height='%3'>").arg(src).arg(w).arg(h);
@@ -5135,6 +5009,8 @@ void MainWindow::runGlobalReplace(QString currentFileDirectory , QVector <QStrin
     if(!globalReplacementMap.isEmpty())
     {
         globallyReplacedWords = globalReplacementMap;
+        if (mReplaceJournal)
+            mReplaceJournal->begin(globalReplacementMap);
 
         int pairMap = 1;
         if(changesCheckedInPreviewMap.size()==0) pairMap = 0;
@@ -5159,7 +5035,8 @@ void MainWindow::runGlobalReplace(QString currentFileDirectory , QVector <QStrin
                     &x1,
                     &files,
                     pairMap,
-                    mRole
+                    mRole,
+                    mReplaceJournal
                     );
 
         QThread *thread = new QThread;
@@ -5178,6 +5055,8 @@ void MainWindow::runGlobalReplace(QString currentFileDirectory , QVector <QStrin
         progressBarDialog->setModal(false);
         progressBarDialog->exec();
 
+        if(mCommitQueue)
+            mCommitQueue->enqueue(filesChangedUsingGlobalReplace, "Global replace by " + mRole);
     }
     map<string, string> new_cpair;
     QMapIterator<QString, QString>i(globalReplacementMap);
@@ -5200,10 +5079,14 @@ void MainWindow::runGlobalReplace(QString currentFileDirectory , QVector <QStrin
                                 &CPairs,
                                 filestructure_fw,
                                 &dict_set1,
-                                mRole);
+                                mRole,
+                                mCPairJournal);
     QThread *thread = new QThread;
 
     connect(thread, SIGNAL(started()), worker, SLOT(addCpair()));
+    connect(worker, SIGNAL(finished()), thread, SLOT(quit()));
+    connect(worker, SIGNAL(finished()), worker, SLOT(deleteLater()));
+    connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
     worker->moveToThread(thread);
     thread->start();
     QString msg  = QString::fromStdString(std::to_string(globalReplacementMap.values().length()) + " words changed" + "\n" + std::to_string(r2) + " instances replaced" + "\n" + std::to_string(files) + " files modified");
@@ -5901,6 +5784,7 @@ void MainWindow::LoadDocument(QFile * f, QString ext, QString name)
         }
     }
 
+    TRACE_SCOPE("MainWindow::LoadDocument");
     f->open(QIODevice::ReadOnly);
     QFileInfo finfo(f->fileName());
 
@@ -6173,7 +6057,7 @@ void MainWindow::LoadDocument(QFile * f, QString ext, QString name)
     QModelIndex currentTreeItemIndex = ui->treeView->selectionModel()->currentIndex();
     QModelIndex parentIndex = currentTreeItemIndex.parent();
     auto model = ui->treeView->model();
-    int rowCount = ui->treeView->model()->rowCount(parentIndex);
+    int rowCount = fetchedRowCount(model, parentIndex);
 
     QString treeItemLabel;
     for (int i = 0; i < rowCount; i++)
@@ -6282,7 +6166,8 @@ void MainWindow::file_click(const QModelIndex & indx)
     auto qvar = item->data(0).toString();
     if(qvar == "Document" || qvar == "Image" || qvar=="CorrectorOutput" || qvar=="VerifierOutput")
         return;
-    auto file = item->GetFile();
+    QFile fileOfItem(item->GetFilePath());
+    auto file = &fileOfItem;
     QString fileName = file->fileName();          //gets filename
     // Set the file's permissions to readonly
     if(fileName.contains("CorrectorOutput") && mRole == "Verifier"){
@@ -6360,10 +6245,10 @@ void MainWindow::RemoveFile()
     //std::cout << "Test";
     auto item = (TreeItem*)curr_idx.internalPointer();
     Filter * filtr = item->GetFilter();
-    QFile * file = item->GetFile();
-    if (file->exists())
+    QFile file(item->GetFilePath());
+    if (filtr && file.exists())
     {
-        mProject.removeFile(curr_idx, *filtr, *file);
+        mProject.removeFile(curr_idx, *filtr, file);
         ui->treeView->reset();
     }
 }
@@ -6599,49 +6484,28 @@ void MainWindow::setMFilename( QString name )
 }
 
 /*!
- * \fn MainWindow::directoryChanged
- * \brief This funcction is called when directory of project is changed. This function sets all
- *        file paths of corrector output and verifier output to the new loaction.
- * \param path
+ * \fn MainWindow::directoryFilesChanged
+ * \brief This function is called with one batch of changes to the CorrectorOutput or VerifierOutput directory and
+ *        updates the files of that folder in the tree view.
+ * \param path Directory that changed
+ * \param added Names of the files that appeared
+ * \param removed Names of the files that were deleted
+ * \sa DirectoryWatcher
  */
-void MainWindow::directoryChanged(const QString &path)
+void MainWindow::directoryFilesChanged(QString path, QStringList added, QStringList removed)
 {
-    QDir d(path);
-
-    QString dirstr = d.dirName();
-    auto list = d.entryList(QDir::Files);
-    QSet<QString> s;
-    for (auto file : list)    //iterating on set
-    {
-        s.insert(file);
-    }
-    if (dirstr == "CorrectorOutput")
-    {
-        QSet<QString> added = s - corrector_set;
-        QSet<QString> removed = corrector_set - s;
-        QString str = mProject.GetDir().absolutePath() + "/CorrectorOutput/";  //new location
-        Filter * filter = mProject.getFilter("CorrectorOutput");
-        for (auto f : added)
-        {
-            QString t = str + "/" + f;
-            QFile f2(t);
-            mProject.AddTemp(filter, f2, "");
-            corrector_set.insert(f);
-        }
-    }
-    else
-    {
-        QSet<QString> added = s - verifier_set;
-        QString str = mProject.GetDir().absolutePath() + "/VerifierOutput/"; //new location
-        Filter * filter = mProject.getFilter("VerifierOutput");
-        for (auto f : added)
-        {
-            QString t = str + "/" + f;
-            QFile f2(t);
-            mProject.AddTemp(filter, f2, "");
-            verifier_set.insert(f);
-        }
-    }
+    if (!mProject.isProjectOpen())
+        return;
+    QString dirstr = QDir(path).dirName();
+    Filter * filter = mProject.getFilter(dirstr == "CorrectorOutput" ? "CorrectorOutput" : "VerifierOutput");
+    if (!filter)
+        return;
+    QStringList paths;
+    paths.reserve(added.size());
+    for (const QString &f : added)
+        paths.append(path + "/" + f);
+    mProject.RemoveTemp(filter, removed);
+    mProject.AddTemp(filter, paths);
 }
 
 /*!
@@ -6738,6 +6602,7 @@ void MainWindow::closeEvent (QCloseEvent *event)
 
 
     autoSave();
+    stopCommitQueue();
 }
 
 /*!
@@ -6852,26 +6717,9 @@ void MainWindow::on_actionas_PDF_triggered()
         currentDirAbsolutePath = gDirTwoLevelUp + "/CorrectorOutput/";
     }
 
-    //! We then open this directory and set sorting preferences.
-    QDir dir(currentDirAbsolutePath);
-    dir.setSorting(QDir::SortFlag::DirsFirst | QDir::SortFlag::Name);
-    QDirIterator dirIterator(dir,QDirIterator::NoIteratorFlags);
-
     //! Set count of files in directory
+    int count = BatchRunner::htmlPageCount(currentDirAbsolutePath);
 
-    QString html_contents=""; // Final HTML Content
-    QString mainHtml;
-    int count = dir.entryList(QStringList("*.html"), QDir::Files | QDir::NoDotAndDotDot).count();
-    int counter=0;
-
-    //    int stIndex, startFrom = 0;
-
-    //    //! Set the background of the pdf to be printed to be white
-    //    QString searchString = "background-color:#"; // string to be searched
-    //    int l = searchString.length();
-    //    QString whiteColor = "ffffff";
-
-    int itr = 0;
     PdfRangeDialog *pdfRangeDialog = new PdfRangeDialog(this, count, 100);
     pdfRangeDialog->exec();
     int startPage = 0;
@@ -6885,113 +6733,8 @@ void MainWindow::on_actionas_PDF_triggered()
     }
     qDebug() << startPage << " : " << endPage;
 
-
-    //! Loop through all files
-    foreach(auto a, dir.entryList())
-    {
-        QString x = currentDirAbsolutePath + a;
-
-        //        startFrom = 0; // The position from which searchString will be scanned
-        //! if condition makes sure we extract only html files for PDF Processing
-        //! (folder has hocr, dict, htranslate, and other such files)
-        if(x.contains("."))
-        {
-            QStringList html_files = x.split(QRegExp("[.]"));
-
-            //! condition to check if file is html
-            if(html_files[1]=="html")
-            {
-                if (itr < startPage) {
-                    itr++;
-                    continue;
-                }
-
-                QFile file(x);
-                if (!file.open(QIODevice::ReadOnly)) qDebug() << "Error reading file main.html";
-                QTextStream stream(&file);
-                stream.setCodec("UTF-8");
-
-                //! Read the file
-
-                mainHtml=stream.readAll();
-                mainHtml.replace("background-color:","Background-colour:");
-                //                mainHtml.remove("background-color:");
-                //                mainHtml.remove("background-color:#ffff00");
-                //                //! Changing the text background to white by setting the background to #fffff
-                //                while (true){
-                //                    stIndex = mainHtml.indexOf(searchString, startFrom);
-                //                    if (stIndex == -1)
-                //                        break;
-                //                    stIndex += l; // increment line
-                //                    mainHtml.replace(stIndex, 6, whiteColor); // Here, 6 is used because length of whiteColor is 6
-                //                    startFrom = stIndex + 6;
-                //                }
-                //! append counter when one file is fully scanned
-                counter++;
-                if(pdfRangeDialog->on_checkBox_clicked())
-                {
-                    QTextDocument doc;
-                    doc.setHtml(mainHtml);
-                    QString s1 = doc.toPlainText();
-                    if(s1.count() == 0)
-                        continue;
-                }
-
-                //! Search for Latex code in html files and replace it by corresponding png images
-                //! We save latext for mathematical equations in html, and show png in our tool as our tool can't render Latex
-                if(mainHtml.contains("$$")){
-
-                    QRegularExpression rex_lat("<a(.*?)</a>",QRegularExpression::DotMatchesEverythingOption);
-                    QRegularExpressionMatchIterator itr_lat;
-                    itr_lat = rex_lat.globalMatch(mainHtml);
-                    while(itr_lat.hasNext()){
-
-                        QRegularExpressionMatch match = itr_lat.next();
-                        QString text = match.captured(1);
-
-                        if(text.contains("Equations_"))
-                        {
-                            int sindex = match.capturedStart(1);
-                            int l_index = match.capturedEnd(1);
-                            std::string inputText_ = text.toStdString();
-                            int ind = inputText_.find("/");
-                            int lindex = inputText_.find(".tex");
-
-                            std::string str = inputText_.substr(ind,lindex-ind);
-                            QString path = QString::fromStdString(str) + ".png";
-                            QString html = "<img src=\""+path+"\">";
-                            text = "<a"+text+"</a>";
-                            mainHtml.replace(text,html);
-                        }
-
-                    }
-                    mainHtml = mainHtml.replace("$$","dne_nqe"); //where dne_nqe is a random string used as end delimiter here.
-                    //Note that this string should not appear as an original text - else it will cause parsing issues.
-                    QRegularExpression rex_dollar("dne_nqe(.*?)dne_nqe",QRegularExpression::DotMatchesEverythingOption);
-                    mainHtml = mainHtml.remove(rex_dollar);
-                }
-
-                //! Once page html is extracted ... before we move to next page we add html tag
-                //! for page break so that the PDF printer separates the pages
-                //! We do this till all pages done
-                if(counter<count){
-                    mainHtml+="<P style=\"page-break-before: always\"></P>";
-                }
-                file.close();
-                html_contents.append(mainHtml);
-                itr++;
-
-                if (itr == endPage) {
-                    break;
-                }
-
-            }
-            //! if file is not html
-            else {
-                continue;
-            }
-        }
-    }
+    //! Final HTML Content, the html pages of the folder with a page break between them
+    QString html_contents = BatchRunner::pdfHtml(currentDirAbsolutePath, startPage, endPage, pdfRangeDialog->on_checkBox_clicked());
 
     // Asking the path where to save the PDF
     QString saveFileName = QFileDialog::getSaveFileName(this, "Save File", gDirTwoLevelUp, tr("PDF(*.pdf)"));
@@ -7184,7 +6927,10 @@ void MainWindow::createActions()
  *        accordingly the appropriate function is called.
  *        This function retrives a map for undo global replace in a variable "UndoGRMap" and
  *        writes all the new words back to the old words thereby undoing the last global replace
- * \sa undoGlobalReplace_Single_Word(), writeGlobalCPairsToFiles(), getUndoGlobalReplaceMap_Multiple_Words()
+ * \details When every word of the last global replace is undone, the files are restored from the ReplaceJournal:
+ *          only the files the replace changed are touched, exactly as they were before. Files edited since the
+ *          replace, and a partial undo, still replace the words back file by file.
+ * \sa undoGlobalReplace_Single_Word(), writeGlobalCPairsToFiles(), getUndoGlobalReplaceMap_Multiple_Words(), ReplaceJournal
  */
 void MainWindow::on_actionUndo_Global_Replace_triggered()
 {
@@ -7195,27 +6941,46 @@ void MainWindow::on_actionUndo_Global_Replace_triggered()
 
     reverseGlobalReplacedWordsMap();
 
-    undoGRMap = getUndoGlobalReplaceMap_Multiple_Words(globallyReplacedWords);
-
+    if (globallyReplacedWords.size() == 1)
+    {
+        //! A single word only needs a yes/no, the undo below is the same journaled path
+        QMap<QString, QString>::const_iterator only = globallyReplacedWords.constBegin();
+        if (undoGlobalReplace_Single_Word(only.key(), only.value()))
+            undoGRMap.insert(only.key(), only.value());
+    }
+    else
+        undoGRMap = getUndoGlobalReplaceMap_Multiple_Words(globallyReplacedWords);
 
     QString currentDirAbsolutePath = gDirTwoLevelUp + "/" + gCurrentDirName;
-    QDirIterator dirIterator(currentDirAbsolutePath, QDirIterator::Subdirectories);
 
     if ( !undoGRMap.isEmpty() )
     {
-        //for (auto itFile : filesChangedUsingGlobalReplace)
-        while(dirIterator.hasNext())
+        TRACE_SCOPE("MainWindow::undo global replace");
+        QStringList filesToRewrite;
+        if (mReplaceJournal && mReplaceJournal->covers(undoGRMap))
+        {
+            ReplaceJournal::UndoResult undone = mReplaceJournal->undo();
+            files = undone.files;
+            r2 = undone.hunks;
+            filesToRewrite = undone.skipped;
+        }
+        else
+        {
+            if (mReplaceJournal)
+                mReplaceJournal->clear();
+            QDirIterator dirIterator(currentDirAbsolutePath, QDirIterator::Subdirectories);
+            while(dirIterator.hasNext())
+                filesToRewrite.append(dirIterator.next());
+        }
+
+        for (const QString &itFile : filesToRewrite)
         {
-            //QString suff = dirIterator.fileInfo().completeSuffix();
-            QString itFile = dirIterator.next();
             if(itFile.contains(".html")){
                 r1 = writeGlobalCPairsToFiles(itFile, undoGRMap);
                 r2 = r2+r1;
                 if(r1 > 0)
                     files++;
             }
-            //             else
-            //                writeGlobalCPairsToFiles(itFile, undoGRMap);
         }
 
         QDir directory(gDirTwoLevelUp);
@@ -7223,66 +6988,34 @@ void MainWindow::on_actionUndo_Global_Replace_triggered()
         if(!QDir(gDirTwoLevelUp+"/logs").exists())
             QDir().mkdir(gDirTwoLevelUp+"/logs");
         QString filename = gDirTwoLevelUp+"/logs/"+mRole+"_"+setName+"_logs.csv";
-        //qDebug()<<filename;
         QFile csvFile(filename);
-        if(!csvFile.exists())
+        if(csvFile.open(QIODevice::ReadOnly))
         {
-        }
+            //! Drop the log lines of the undone source words in one pass
+            QSet<QString> undoneWords;
+            for (const QString &value : undoGRMap)
+                undoneWords.insert(value);
 
-        else
-        {
-            csvFile.open(QIODevice::ReadOnly);
-            QMap <QString, QString>::iterator grmIterator;
-            QStringList s1;
+            QStringList kept;
             QTextStream s2(&csvFile);
             s2.setCodec("UTF-8");
             while (!s2.atEnd()) {
                 QString line = s2.readLine();
-                //qDebug()<<line;
-                //s1.append(line.split(',').first());
-                s1.append(line);
+                if (!undoneWords.contains(line.section(',', 0, 0)))
+                    kept.append(line);
             }
-            //qDebug()<<"S1"<<s1;
-
             csvFile.close();
-            csvFile.open(QIODevice::WriteOnly);
-            QTextStream output(&csvFile);
-            output.setCodec("UTF-8");
-            QStringList s4;
-            for(grmIterator = undoGRMap.begin(); grmIterator != undoGRMap.end();++grmIterator)
-            {
-                QString value=grmIterator.value();
-                //qDebug()<<value;
-                for(int i=0;i<s1.length();i++)
-                {
-                    QString s3;
-                    s3.append(s1[i].split(',').first());
-                    if(s3==value)
-                    {
-                        s4.append(s1[i]);
-                    }
-                }
 
-            }
-            //qDebug()<<"S4"<<s4;
-            for(int i=0;i<s1.length();i++)
+            QSaveFile out(filename);
+            if (out.open(QIODevice::WriteOnly))
             {
-                for(int j=0;j<s4.length();j++)
-                {
-                    if(s1[i]==s4[j])
-                    {
-                        s1.removeAll(s1[i]);
-                    }
-                }
-            }
-            //qDebug()<<"S1 Final"<<s1;
-
-            for(int i=0;i<s1.length();i++){
-                output<<s1[i];
-                output << "\n";
-
+                QTextStream output(&out);
+                output.setCodec("UTF-8");
+                for (const QString &line : kept)
+                    output << line << "\n";
+                output.flush();
+                out.commit();
             }
-            csvFile.close();
         }
     }
     QString msg  = QString::fromStdString(std::to_string(undoGRMap.values().length()) + " words changed" + "\n" + std::to_string(r2) + " instances replaced" + "\n" + std::to_string(files) + " files modified");
@@ -7310,6 +7043,7 @@ void MainWindow::reverseGlobalReplacedWordsMap()
  * \fn MainWindow::undoGlobalReplace_Single_Word
  * \brief This function shows a dialog box asking the user whether the global replacement for the word has to be undone
  *        This function is only called when the last global replace was done for a single word ONLY.
+ *        The undo itself is done by on_actionUndo_Global_Replace_triggered(), from the ReplaceJournal when it covers the word.
  * \param oldWord
  * \param newWord
  * \return bool
@@ -7521,46 +7255,26 @@ void MainWindow::reLoadTabWindow()
  * If set is very large then user can enter page number or any keyword related to file name and get
  * it filtered. The tool will show him that page and thus he will be able to open more easily.
  *
- * This function scans the whole files and stores in a list. Whenever the user types on the search
- * text box it will check the keyword to match in the list. The respective files are highlighted.
+ * The names of the project tree are indexed by Project while the tree is built, so a keystroke only
+ * scans that index. The matching files are highlighted with one batched selection and, when the user
+ * types a page number, the tree scrolls to that page.
  * \param arg1
+ * \sa Project::searchTree(), TreeSearchIndex
  */
 void MainWindow::on_lineEditSearch_textChanged(const QString &arg1)
 {
-    ui->treeView->selectionModel()->clearSelection();
-    QModelIndex currentTreeItemIndex=ui->treeView->selectionModel()->currentIndex();
-    QModelIndex parentIndex = currentTreeItemIndex.parent();
-
-    auto *model = ui->treeView->model();
-    int rowCount = ui->treeView->model()->rowCount(parentIndex);
-    //qDebug()<<"rowCount"<<rowCount;
-    QModelIndexList children;
-
-    QString item;
-    for(int i=0;i<model->rowCount();i++){
-        children<<model->index(i,0);
-        item=children[i].data(Qt::DisplayRole).toString();
-        //        qDebug()<<"Item"<<item;
-    }
-
-    //qDebug()<<"Children size"<<children.size();
-    for(int i=0;i<children.size();i++){
-        for(int j=0;j<model->rowCount(children[i]);j++){
-            children<<children[i].child(j,0);
+    QItemSelectionModel *selectionModel = ui->treeView->selectionModel();
+    if (!selectionModel)
+        return;
+    QModelIndex pageHit;
+    QItemSelection selection = mProject.searchTree(arg1, &pageHit);
+    selectionModel->select(selection, QItemSelectionModel::ClearAndSelect);
 
-            //qDebug()<<"Item"<<item;
-            //if(item.contains(arg1)){
-            //ui->treeView->selectionModel()->setCurrentIndex(children[j],QItemSelectionModel::Select);
-            //}
-        }
-    }
-    //qDebug()<<"Children size"<<children.size();
-    for(int i=0;i<children.size();i++){
-        item=children[i].data(Qt::DisplayRole).toString();
-        //qDebug()<<"Item"<<item;
-        if(item.contains(arg1)){
-            ui->treeView->selectionModel()->setCurrentIndex(children[i],QItemSelectionModel::Select);
-        }
+    QModelIndex current = pageHit.isValid() ? pageHit : (selection.isEmpty() ? QModelIndex() : selection.first().topLeft());
+    if (current.isValid())
+    {
+        selectionModel->setCurrentIndex(current, QItemSelectionModel::NoUpdate);
+        ui->treeView->scrollTo(current);
     }
 }
 
@@ -7697,8 +7411,6 @@ void MainWindow::RecentPageInfo()
     QModelIndex currentTreeItemIndex=ui->treeView->selectionModel()->currentIndex();
     QModelIndex parentIndex = currentTreeItemIndex.parent();
     auto *model = ui->treeView->model();
-    int rowCount = ui->treeView->model()->rowCount(parentIndex);
-    //qDebug()<<"rowCount"<<rowCount;
     QModelIndexList children;
     QString var1,var2;
     QSettings settings("IIT-B", "OpenOCRCorrect");
@@ -7719,11 +7431,13 @@ void MainWindow::RecentPageInfo()
     }
     settings.endGroup();
     QString item,item1;
-    for(int i=0;i<model->rowCount();i++){
+    int folders = fetchedRowCount(model, QModelIndex());
+    for(int i=0;i<folders;i++){
         children<<model->index(i,0);
         item=children[i].data(Qt::DisplayRole).toString();
         if(item == var2){
-            for(int j=0;j<model->rowCount(children[i]);j++){
+            int pages = fetchedRowCount(model, children[i]);
+            for(int j=0;j<pages;j++){
                 children<<children[i].child(j,0);
                 item1 = children[i].child(j,0).data(Qt::DisplayRole).toString();
                 //qDebug ()<<"Item1"<<item1;
@@ -8510,6 +8224,19 @@ void MainWindow::on_actionClose_project_triggered()
         return;                                                                  //checking if the project is already
         // opened or not
     }
+    stopCommitQueue();
+    stopDirectoryWatcher();
+    mCPairJournal.reset();
+    delete mReplaceJournal;
+    mReplaceJournal = nullptr;
+    if (mHighlightsLog)
+        mHighlightsLog->compact();
+    delete mHighlightsLog;
+    mHighlightsLog = nullptr;
+    if (mTimeLog)
+        mTimeLog->compact();
+    delete mTimeLog;
+    mTimeLog = nullptr;
     mProject.setProjectOpen(false);
     //disableing the buttons after project is closed
     e_d_features(false);
@@ -8527,6 +8254,10 @@ void MainWindow::on_actionClose_project_triggered()
     IBook.clear();
     PWords.clear();
     ConfPmap.clear();
+    LexDict.clear();
+    LexGBook.clear();
+    LexConfPmap.clear();
+    LexConfPmapFont.clear();
     vGBook.clear();
     vIBook.clear();
     TDict.clear();
@@ -8534,8 +8265,11 @@ void MainWindow::on_actionClose_project_triggered()
     TGBookP.clear();
     TPWords.clear();
     TPWordsP.clear();
-    synonym.clear();
-    synrows.clear();
+    Synonyms.clear();
+    Suggestions.invalidate();
+    PageEstimates.setTables(LexGBook, PWords);
+    //! The tokens of this project's pages are not needed any more
+    PageTokenCache::shared().clear();
 
     if(ui->lineEdit_3->text()!="" && ui->lineEdit_3->text()!="Words 0" && ui->lineEdit_3->text()!="0 Words"){
         curr_browser->clear();
@@ -9100,6 +8834,10 @@ void MainWindow::messageTimer(){
 void MainWindow::cloud_save(){
 
     messageTimer();
+    if (mHighlightsLog)
+        mHighlightsLog->compact();                    //! Bring HighlightsLog.json and the time log up to date before they are committed
+    if (mTimeLog)
+        mTimeLog->compact();
     QString date = QDate::currentDate().toString();
     QString corrected_count = gDirTwoLevelUp + "/Comments/"+mRole+"_count.json";
     QJsonObject mainObj, parObj;
@@ -9146,8 +8884,23 @@ void MainWindow::cloud_save(){
 
     QString commit_msg = gCurrentPageName + " completed by "+ mRole;    // append current version
 
-    //! commits and pushes the file. commit() and push() from Project.cpp creates a commit and pushes the file to git repo
-    if(mProject.commit(commit_msg.toStdString()))
+    //! Pages were already committed in the background by CommitQueue; stage the folders written outside of a save
+    //! and flush the queue into the turn-in commit. push() from Project.cpp then pushes the commit to the git repo.
+    //! The git lock keeps the queue thread away from the repository until the push is over.
+    QMutexLocker gitLocker(mCommitQueue ? mCommitQueue->gitMutex() : nullptr);
+    bool committed;
+    if(mCommitQueue)
+    {
+        QStringList turnInPaths;
+        for(QString folder : {"Comments", "Dicts", "logs", "Equations_", "CorrectorOutput", "VerifierOutput"})
+            turnInPaths << gDirTwoLevelUp + "/" + folder;
+        turnInPaths << gDirTwoLevelUp + "/project.xml" << gDirTwoLevelUp + "/image.xml";
+        mCommitQueue->enqueue(turnInPaths, "");
+        committed = mCommitQueue->flush(commit_msg);
+    }
+    else
+        committed = mProject.commit(commit_msg.toStdString());
+    if(committed)
     {
         if(mProject.fetch_n_merge(gDirTwoLevelUp, mRole)){
             //            threadingPush *tp = new threadingPush(nullptr, mProject.repo, m_user, m_pass, gDirTwoLevelUp);
@@ -9222,6 +8975,109 @@ void MainWindow::cloud_save(){
     //    }
 }
 
+/*!
+ * \brief MainWindow::startCommitQueue
+ * \details Starts the background CommitQueue for the opened project on its own thread.
+ * \sa CommitQueue, stopCommitQueue()
+ */
+void MainWindow::startCommitQueue()
+{
+    stopCommitQueue();
+    if(!mProject.repo)
+        return;
+    mCommitQueue = new CommitQueue(nullptr, &mProject);
+    mCommitThread = new QThread;
+
+    connect(mCommitThread, SIGNAL(started()), mCommitQueue, SLOT(start()));
+    //! Direct, as stopCommitQueue() blocks the GUI thread the QThread object lives in until the thread has quit
+    connect(mCommitQueue, SIGNAL(stopped()), mCommitThread, SLOT(quit()), Qt::DirectConnection);
+    connect(mCommitThread, SIGNAL(finished()), mCommitQueue, SLOT(deleteLater()));
+    connect(mCommitThread, SIGNAL(finished()), mCommitThread, SLOT(deleteLater()));
+    connect(mCommitQueue, &CommitQueue::committed, this, [this](QString sha, int) {
+        mProject.post_commit_history(sha);
+    });
+    mCommitQueue->moveToThread(mCommitThread);
+    mCommitThread->start();
+}
+
+/*!
+ * \brief MainWindow::stopCommitQueue
+ * \details Commits whatever is still pending and waits for the queue thread to finish.
+ */
+void MainWindow::stopCommitQueue()
+{
+    if(!mCommitQueue)
+        return;
+    QMetaObject::invokeMethod(mCommitQueue, "stop", Qt::BlockingQueuedConnection);
+    mCommitThread->wait();
+    mCommitQueue = nullptr;
+    mCommitThread = nullptr;
+}
+
+/*!
+ * \brief MainWindow::toggleTracing
+ * \details Starts timing the hot paths, or, when tracing is already on, writes the spans recorded so far to a
+ * Chrome trace file next to application.log, shows the summary table and stops tracing.
+ * \sa Tracer
+ */
+void MainWindow::toggleTracing()
+{
+    if (!Tracer::isEnabled()) {
+        Tracer::reset();
+        Tracer::setEnabled(true);
+        QMessageBox::information(this, "Tracing", "Timing of load, save, suggestions, global replace, git and PDF export started.\nPress Ctrl+Alt+Shift+T again to export it.");
+        return;
+    }
+    Tracer::setEnabled(false);
+    QString path = qApp->applicationDirPath() + "/trace-" + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".json";
+    bool written = Tracer::writeChromeTrace(path);
+    QString summary = Tracer::summary();
+    qDebug().noquote() << "Timing summary:\n" + summary;
+
+    QMessageBox box(this);
+    box.setWindowTitle("Tracing");
+    box.setText(written ? "Trace written to " + path : "Could not write " + path);
+    box.setDetailedText(summary);
+    box.exec();
+}
+
+/*!
+ * \brief MainWindow::startDirectoryWatcher
+ * \details Starts the DirectoryWatcher of the opened project on its own thread. Directories are added with
+ * DirectoryWatcher::watch() once the tree shows their files.
+ * \sa DirectoryWatcher, stopDirectoryWatcher()
+ */
+void MainWindow::startDirectoryWatcher()
+{
+    stopDirectoryWatcher();
+    mDirectoryWatcher = new DirectoryWatcher;
+    mWatcherThread = new QThread;
+
+    connect(mWatcherThread, SIGNAL(started()), mDirectoryWatcher, SLOT(start()));
+    //! Direct for the same reason as in startCommitQueue()
+    connect(mDirectoryWatcher, SIGNAL(stopped()), mWatcherThread, SLOT(quit()), Qt::DirectConnection);
+    connect(mWatcherThread, SIGNAL(finished()), mDirectoryWatcher, SLOT(deleteLater()));
+    connect(mWatcherThread, SIGNAL(finished()), mWatcherThread, SLOT(deleteLater()));
+    connect(mDirectoryWatcher, SIGNAL(changed(QString, QStringList, QStringList)), this, SLOT(directoryFilesChanged(QString, QStringList, QStringList)));
+    mDirectoryWatcher->moveToThread(mWatcherThread);
+    mWatcherThread->start();
+}
+
+/*!
+ * \brief MainWindow::stopDirectoryWatcher
+ * \details Stops watching and waits for the watcher thread to finish. Changes not reported yet are dropped.
+ */
+void MainWindow::stopDirectoryWatcher()
+{
+    if(!mDirectoryWatcher)
+        return;
+    disconnect(mDirectoryWatcher, nullptr, this, nullptr);
+    QMetaObject::invokeMethod(mDirectoryWatcher, "stop", Qt::BlockingQueuedConnection);
+    mWatcherThread->wait();
+    mDirectoryWatcher = nullptr;
+    mWatcherThread = nullptr;
+}
+
 /*!
  * \brief MainWindow::preprocessing
  * \details This function is called when is html file is loaded for the first timne in tool.
@@ -9964,6 +9820,68 @@ void MainWindow::on_actionResize_Image_2_triggered()
     on_actionResize_Image_triggered();
 }
 
+/*!
+ * \fn MainWindow::on_actionRank_Pages_triggered
+ * \brief Shows the pages of the set ranked by expected correction effort, highest estimated OCR error first.
+ * \details Every OCR page in Inds that has a corrected version is measured by PageQualityEstimator in parallel. The
+ * estimates are cached, so ranking again only measures the pages saved since. Needs the data to be loaded, the
+ * estimates use GBook and PWords.
+ * \sa PageQualityEstimator::estimate(), PageQualityEstimator::ranked(), CorrectionPairMiner::bookPages()
+ */
+void MainWindow::on_actionRank_Pages_triggered()
+{
+    if(LoadDataFlag)
+    {
+        QMessageBox::information(this, "Rank Pages", "Please load the data first (Tools > Load Data).");
+        return;
+    }
+    QVector<PageQualityEstimator::Page> pages;
+    QStringList keys;
+    for(const CorrectionPairMiner::Page &page : CorrectionPairMiner::bookPages(gDirTwoLevelUp))
+    {
+        pages.append({ page.key, page.correctedPath, page.ocrPath });
+        keys << page.key;
+    }
+    if(pages.isEmpty())
+    {
+        QMessageBox::information(this, "Rank Pages", "No page of this set has a corrected version yet.");
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    //! PWords grows with every Spell Check and replacement after Load Data
+    PageEstimates.updateWords(PWords);
+    QHash<QString, PageQuality> estimates = PageEstimates.estimate(pages);
+    QStringList order = PageEstimates.ranked(keys);
+    QApplication::restoreOverrideCursor();
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("Pages by Estimated OCR Error");
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    QTableWidget *table = new QTableWidget(order.size(), 5, &dialog);
+    table->setHorizontalHeaderLabels({ "Page", "Estimated error (%)", "Known words", "Mean length", "Std. deviation" });
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->verticalHeader()->setVisible(false);
+    for(int row = 0; row < order.size(); row++)
+    {
+        PageQuality quality = estimates.value(order[row]);
+        table->setItem(row, 0, new QTableWidgetItem(order[row]));
+        if(!quality.valid)
+            continue;
+        table->setItem(row, 1, new QTableWidgetItem(QString::number(quality.error, 'f', 1)));
+        table->setItem(row, 2, new QTableWidgetItem(QString::number(quality.words)));
+        table->setItem(row, 3, new QTableWidgetItem(QString::number(quality.mean, 'f', 2)));
+        table->setItem(row, 4, new QTableWidgetItem(QString::number(quality.std, 'f', 2)));
+    }
+    table->resizeColumnsToContents();
+    layout->addWidget(table);
+    dialog.setLayout(layout);
+    dialog.setSizeGripEnabled(true);
+    dialog.resize(QSize(640, 480));
+    dialog.exec();
+}
+
 /*!
  * \fn MainWindow::on_actionWord_Count_triggered()
  * \brief This function displays word count in current page ,total number of pages and total number of words in all pages
@@ -49,6 +49,13 @@
 #include <QScrollBar>
 #include "customtextbrowser.h"
 #include "handlebbox.h"
+#include "commitqueue.h"
+#include "cpairjournal.h"
+#include "directorywatcher.h"
+#include "replacejournal.h"
+#include "tracer.h"
+#include "eventlog.h"
+#include "timelogstore.h"
 #include <QMediaRecorder>
 #include <QCalendarWidget>
 
@@ -190,7 +197,9 @@ private slots:
 
     void on_actionFetch_2_triggered();
 
-    void directoryChanged(const QString &path);
+    void directoryFilesChanged(QString path, QStringList added, QStringList removed);
+
+    void toggleTracing();
 
     void on_actionAccuracyLog_triggered();
 
@@ -216,7 +225,7 @@ private slots:
 
     void on_actionAdd_Image_triggered();
 
-    void SaveTimeLog();
+    void SaveTimeLog(const QString &key);
 
     void DisplayTimeLog();
 
@@ -484,6 +493,8 @@ private slots:
 
     void on_actionWord_Count_triggered();
 
+    void on_actionRank_Pages_triggered();
+
     void on_actionVoice_Typing_triggered();
 
     void getDate(QDate date, QCalendarWidget *calendar);
@@ -561,9 +572,6 @@ private:
     QGraphicsScene * graphic =nullptr;
     Graphics_view_zoom * z = nullptr;
     QModelIndex curr_idx;
-    QSet<QString> corrector_set;
-    QSet<QString> verifier_set;
-    QFileSystemWatcher watcher;
     QGraphicsRectItem* item1;
     QGraphicsRectItem* crop_rect;
     QString s1, s2;
@@ -595,6 +603,18 @@ private:
     bool check();
     bool check_access();
     void cloud_save();
+    void startCommitQueue();
+    void stopCommitQueue();
+    CommitQueue *mCommitQueue = nullptr;
+    QThread *mCommitThread = nullptr;
+    void startDirectoryWatcher();
+    void stopDirectoryWatcher();
+    DirectoryWatcher *mDirectoryWatcher = nullptr;
+    QThread *mWatcherThread = nullptr;
+    QSharedPointer<CPairJournal> mCPairJournal;   //! Shared with the addCpair workers, which may outlive the project
+    ReplaceJournal *mReplaceJournal = nullptr;
+    EventLog *mHighlightsLog = nullptr;
+    TimeLogStore *mTimeLog = nullptr;
     int saved = 0;
     void autoSave();
     void messageTimer();
@@ -0,0 +1,449 @@
+/*!
+ * \class MappedTable
+ * \brief Read-only string table of a side file of the project, such as Dicts/LSTM or Dicts/synonyms.csv, kept in a
+ * binary file in the user's cache folder and memory-mapped.
+ * \details LoadDataWorker parsed LSTM into a map<string, string> and synonyms.csv into a map<string, vector<int>> plus
+ * the rows, node by node, every time a project was opened. The tables are now built once into a file of cachePath()
+ * and mapped with QFile::map() afterwards, which takes the same time however large they are. The file starts
+ * with a Header that records the size and modification time of the source, so load() refuses a table whose source
+ * has changed and the caller builds it again.
+ * \details After the header come arrays of 32-bit offsets and ids and a pool holding every key, sorted by its bytes,
+ * back to back. A Pairs table has the values in the pool after the keys. A Groups table has, for every key, the ids
+ * of the groups it is in, and, for every group, the ids of its keys in their order in the source. An open addressing
+ * hash index of at least twice as many slots as keys finds a key, so find(), key(), value(), groups() and members()
+ * neither allocate nor insert anything and can be called from several threads at once.
+ * \details The files stay out of the project folder, which is a git repository, so they are never committed with it.
+ * When the table can't be written, it is kept in memory instead.
+ * \sa LoadDataWorker::LoadData(), slpNPatternDict::loadFileCSV()
+ */
+#include "mappedtable.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+static const quint32 TableMagic = 0x4d544231;    //! "MTB1"
+
+/*!
+ * \fn MappedTable::Text::operator==
+ * \return true if the bytes equal s
+ */
+bool MappedTable::Text::operator==(const std::string &s) const
+{
+    return size == s.size() && std::memcmp(data, s.data(), size) == 0;
+}
+
+/*!
+ * \fn MappedTable::MappedTable
+ * \brief Constructor of an empty table, load() or build() fills it.
+ */
+MappedTable::MappedTable()
+{
+    clear();
+}
+
+/*!
+ * \fn MappedTable::~MappedTable
+ * \brief Destructor, unmaps the file.
+ */
+MappedTable::~MappedTable()
+{
+    clear();
+}
+
+/*!
+ * \fn MappedTable::clear
+ * \brief Unmaps the table. Must not be called while another thread looks keys up.
+ */
+void MappedTable::clear()
+{
+    if (mFile.isOpen())
+        mFile.close();
+    mImage.clear();
+    mHeader = nullptr;
+    mKeyOffsets = mValueOffsets = mKeyGroups = mGroupIds = mGroupKeys = mMemberIds = mBuckets = nullptr;
+    mPool = nullptr;
+}
+
+/*!
+ * \fn MappedTable::hash
+ * \brief FNV-1a hash of a key.
+ */
+quint32 MappedTable::hash(const char *data, size_t size)
+{
+    quint32 h = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*!
+ * \fn MappedTable::modified
+ * \return Modification time of source in ms since the epoch
+ */
+qint64 MappedTable::modified(const QFileInfo &source)
+{
+    return source.lastModified().toMSecsSinceEpoch();
+}
+
+/*!
+ * \fn MappedTable::cachePath
+ * \brief File the table of source is kept in, named after the absolute path of source so that every project has its own
+ * \details Other caches of a project that must stay out of its repository, such as the pairs of CorrectionPairMiner,
+ * are kept here too under their own suffix.
+ * \param source File or folder the cache is built from
+ * \param suffix Extension of the cache file
+ * \return Path in the cache folder, empty when there is no cache folder
+ */
+QString MappedTable::cachePath(const QFileInfo &source, const QString &suffix)
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (dir.isEmpty())
+        return QString();
+    dir += "/IIT-B/OpenOCRCorrect/tables";
+    QDir().mkpath(dir);
+    QByteArray id = QCryptographicHash::hash(source.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return dir + "/" + QString::fromLatin1(id) + "." + source.fileName() + "." + suffix;
+}
+
+/*!
+ * \fn MappedTable::imageSize
+ * \return Bytes of a table with the counts of header
+ */
+size_t MappedTable::imageSize(const Header &header)
+{
+    size_t words = size_t(header.keys) + 1 + header.buckets;
+    if (header.kind == Pairs)
+        words += size_t(header.keys) + 1;
+    else
+        words += size_t(header.keys) + 1 + header.groupRefs + size_t(header.groups) + 1 + header.memberRefs;
+    return sizeof(Header) + words * sizeof(quint32) + header.poolBytes;
+}
+
+/*!
+ * \fn MappedTable::image
+ * \brief Lays a table out as it is written to its file.
+ * \param keys Sorted by their bytes
+ * \param values Value of every key for Pairs, empty for Groups
+ * \param keyGroups Groups of every key for Groups, empty for Pairs
+ * \param groupKeys Keys of every group for Groups, empty for Pairs
+ * \return The table, empty if it would not fit 32-bit offsets
+ */
+QByteArray MappedTable::image(Kind kind, const QFileInfo &source, const std::vector<const std::string *> &keys,
+                              const std::vector<const std::string *> &values,
+                              const std::vector<std::vector<quint32>> &keyGroups,
+                              const std::vector<std::vector<quint32>> &groupKeys)
+{
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = TableMagic;
+    header.kind = kind;
+    header.sourceSize = source.size();
+    header.sourceModified = modified(source);
+    header.keys = quint32(keys.size());
+    header.groups = quint32(groupKeys.size());
+    header.buckets = 1;
+    while (header.buckets < 2 * keys.size())
+        header.buckets <<= 1;
+    size_t pool = 0, groupRefs = 0, memberRefs = 0;
+    for (const std::string *key : keys)
+        pool += key->size();
+    for (const std::string *value : values)
+        pool += value->size();
+    for (const std::vector<quint32> &ids : keyGroups)
+        groupRefs += ids.size();
+    for (const std::vector<quint32> &ids : groupKeys)
+        memberRefs += ids.size();
+    if (pool > 0xffffffffu || groupRefs > 0xffffffffu || memberRefs > 0xffffffffu || keys.size() >= 0x7fffffffu)
+        return QByteArray();
+    header.poolBytes = quint32(pool);
+    header.groupRefs = quint32(groupRefs);
+    header.memberRefs = quint32(memberRefs);
+
+    QByteArray out(int(imageSize(header)), '\0');
+    char *at = out.data();
+    std::memcpy(at, &header, sizeof(header));
+    quint32 *words = reinterpret_cast<quint32 *>(at + sizeof(header));
+    char *pool8 = at + imageSize(header) - header.poolBytes;
+
+    //! Offsets of the strings, the keys first and then the values
+    quint32 offset = 0;
+    auto strings = [&](const std::vector<const std::string *> &list) {
+        for (const std::string *s : list) {
+            *words++ = offset;
+            std::memcpy(pool8 + offset, s->data(), s->size());
+            offset += quint32(s->size());
+        }
+        *words++ = offset;
+    };
+    auto lists = [&](const std::vector<std::vector<quint32>> &list) {
+        quint32 *starts = words;
+        quint32 *ids = words + list.size() + 1;
+        quint32 n = 0;
+        for (size_t i = 0; i < list.size(); i++) {
+            starts[i] = n;
+            for (quint32 id : list[i])
+                ids[n++] = id;
+        }
+        starts[list.size()] = n;
+        words = ids + n;
+    };
+    strings(keys);
+    if (kind == Pairs) {
+        strings(values);
+    } else {
+        lists(keyGroups);
+        lists(groupKeys);
+    }
+    quint32 mask = header.buckets - 1;
+    for (quint32 id = 0; id < header.keys; id++) {
+        quint32 slot = hash(keys[id]->data(), keys[id]->size()) & mask;
+        while (words[slot] != 0)
+            slot = (slot + 1) & mask;
+        words[slot] = id + 1;
+    }
+    return out;
+}
+
+/*!
+ * \fn MappedTable::pairsImage
+ * \param pairs Value of every key, e.g. the pairs of LSTM
+ * \param source File the pairs were read from
+ * \return The table for build()
+ */
+QByteArray MappedTable::pairsImage(const std::map<std::string, std::string> &pairs, const QFileInfo &source)
+{
+    std::vector<const std::string *> keys, values;
+    keys.reserve(pairs.size());
+    values.reserve(pairs.size());
+    for (const auto &pair : pairs) {
+        keys.push_back(&pair.first);
+        values.push_back(&pair.second);
+    }
+    return image(Pairs, source, keys, values, {}, {});
+}
+
+/*!
+ * \fn MappedTable::groupsImage
+ * \param keys Rows every key is in, as slpNPatternDict::loadFileCSV() fills synonym
+ * \param rows Keys of every row, as slpNPatternDict::loadFileCSV() fills synrows
+ * \param source File the rows were read from
+ * \return The table for build()
+ */
+QByteArray MappedTable::groupsImage(const std::map<std::string, std::vector<int>> &keys,
+                                    const std::vector<std::vector<std::string>> &rows, const QFileInfo &source)
+{
+    std::vector<const std::string *> sorted;
+    std::vector<std::vector<quint32>> keyGroups, groupKeys(rows.size());
+    sorted.reserve(keys.size());
+    keyGroups.reserve(keys.size());
+    for (const auto &key : keys) {
+        sorted.push_back(&key.first);
+        keyGroups.emplace_back(key.second.begin(), key.second.end());
+    }
+    auto less = [](const std::string *a, const std::string &b) { return *a < b; };
+    for (size_t g = 0; g < rows.size(); g++) {
+        for (const std::string &member : rows[g]) {
+            auto it = std::lower_bound(sorted.begin(), sorted.end(), member, less);
+            if (it != sorted.end() && **it == member)
+                groupKeys[g].push_back(quint32(it - sorted.begin()));
+        }
+    }
+    return image(Groups, source, sorted, {}, keyGroups, groupKeys);
+}
+
+/*!
+ * \fn MappedTable::attach
+ * \brief Points the arrays into a table image after checking its header.
+ * \param kind Kind the table must be, 0 for any
+ * \param source File the table must have been built from as it is now, nullptr to skip the check
+ * \return false if the image is not such a table
+ */
+bool MappedTable::attach(const uchar *data, qint64 size, int kind, const QFileInfo *source)
+{
+    if (!data || size < qint64(sizeof(Header)))
+        return false;
+    const Header *header = reinterpret_cast<const Header *>(data);
+    if (header->magic != TableMagic || (header->kind != Pairs && header->kind != Groups)
+            || (kind != 0 && int(header->kind) != kind) || imageSize(*header) != size_t(size)
+            || header->buckets == 0 || (header->buckets & (header->buckets - 1)) != 0
+            || header->buckets < header->keys)
+        return false;
+    if (source && (header->sourceSize != source->size() || header->sourceModified != modified(*source)))
+        return false;
+
+    const quint32 *words = reinterpret_cast<const quint32 *>(data + sizeof(Header));
+    const quint32 *keyOffsets = words;
+    words += header->keys + 1;
+    const quint32 *valueOffsets = nullptr, *keyGroups = nullptr, *groupIds = nullptr, *groupKeys = nullptr;
+    const quint32 *memberIds = nullptr;
+    if (header->kind == Pairs) {
+        valueOffsets = words;
+        words += header->keys + 1;
+        if (keyOffsets[header->keys] != valueOffsets[0] || valueOffsets[header->keys] != header->poolBytes)
+            return false;
+    } else {
+        keyGroups = words;
+        groupIds = keyGroups + header->keys + 1;
+        groupKeys = groupIds + header->groupRefs;
+        memberIds = groupKeys + header->groups + 1;
+        words = memberIds + header->memberRefs;
+        if (keyOffsets[header->keys] != header->poolBytes || keyGroups[header->keys] != header->groupRefs
+                || groupKeys[header->groups] != header->memberRefs)
+            return false;
+    }
+    mHeader = header;
+    mKeyOffsets = keyOffsets;
+    mValueOffsets = valueOffsets;
+    mKeyGroups = keyGroups;
+    mGroupIds = groupIds;
+    mGroupKeys = groupKeys;
+    mMemberIds = memberIds;
+    mBuckets = words;
+    mPool = reinterpret_cast<const char *>(words + header->buckets);
+    return true;
+}
+
+/*!
+ * \fn MappedTable::load
+ * \brief Maps a table built earlier.
+ * \param tablePath File of the table, from cachePath()
+ * \param kind
+ * \param source File the table is built from, as it is now
+ * \return false if there is no table of that kind for source as it is now, the caller then builds it
+ */
+bool MappedTable::load(const QString &tablePath, Kind kind, const QFileInfo &source)
+{
+    clear();
+    mFile.setFileName(tablePath);
+    if (!mFile.open(QIODevice::ReadOnly))
+        return false;
+    qint64 size = mFile.size();
+    if (!attach(size > 0 ? mFile.map(0, size) : nullptr, size, kind, &source)) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \fn MappedTable::build
+ * \brief Writes a table to its file atomically and maps it. If it can't be written, it is kept in memory.
+ * \param tablePath File of the table, from cachePath()
+ * \param image The table, from pairsImage() or groupsImage()
+ * \return false if image is not a table
+ */
+bool MappedTable::build(const QString &tablePath, const QByteArray &image)
+{
+    clear();
+    QSaveFile out(tablePath);
+    if (out.open(QIODevice::WriteOnly) && out.write(image) == image.size() && out.commit()) {
+        mFile.setFileName(tablePath);
+        if (mFile.open(QIODevice::ReadOnly)) {
+            qint64 size = mFile.size();
+            if (attach(size > 0 ? mFile.map(0, size) : nullptr, size, 0, nullptr))
+                return true;
+        }
+        clear();
+    } else {
+        qDebug() << "Can't write table" << tablePath << ", keeping it in memory";
+    }
+    mImage = image;
+    if (!attach(reinterpret_cast<const uchar *>(mImage.constData()), mImage.size(), 0, nullptr)) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \fn MappedTable::size
+ * \return Number of keys
+ */
+size_t MappedTable::size() const
+{
+    return mHeader ? mHeader->keys : 0;
+}
+
+/*!
+ * \fn MappedTable::groupCount
+ * \return Number of groups of a Groups table, e.g. the rows of synonyms.csv
+ */
+size_t MappedTable::groupCount() const
+{
+    return mHeader ? mHeader->groups : 0;
+}
+
+/*!
+ * \fn MappedTable::find
+ * \param key
+ * \return Id of key, -1 if it is not in the table
+ */
+int MappedTable::find(const std::string &key) const
+{
+    if (!mHeader)
+        return -1;
+    quint32 mask = mHeader->buckets - 1;
+    quint32 slot = hash(key.data(), key.size()) & mask;
+    for (quint32 probes = 0; probes < mHeader->buckets; probes++) {
+        quint32 id = mBuckets[slot];
+        if (id == 0 || id > mHeader->keys)
+            return -1;
+        if (this->key(id - 1) == key)
+            return int(id - 1);
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+/*!
+ * \fn MappedTable::key
+ * \param id Below size()
+ * \return Bytes of the key
+ */
+MappedTable::Text MappedTable::key(quint32 id) const
+{
+    return Text{ mPool + mKeyOffsets[id], size_t(mKeyOffsets[id + 1] - mKeyOffsets[id]) };
+}
+
+/*!
+ * \fn MappedTable::value
+ * \param id Key id of a Pairs table
+ * \return Bytes of the value of the key, empty for a Groups table
+ */
+MappedTable::Text MappedTable::value(quint32 id) const
+{
+    if (!mValueOffsets)
+        return Text{ "", 0 };
+    return Text{ mPool + mValueOffsets[id], size_t(mValueOffsets[id + 1] - mValueOffsets[id]) };
+}
+
+/*!
+ * \fn MappedTable::groups
+ * \param id Key id of a Groups table
+ * \return Ids of the groups the key is in, in the order of the source; none for a Pairs table
+ */
+MappedTable::Ids MappedTable::groups(quint32 id) const
+{
+    if (!mKeyGroups)
+        return Ids{ nullptr, nullptr };
+    return Ids{ mGroupIds + mKeyGroups[id], mGroupIds + mKeyGroups[id + 1] };
+}
+
+/*!
+ * \fn MappedTable::members
+ * \param group Below groupCount()
+ * \return Key ids of the group, in the order of the source
+ */
+MappedTable::Ids MappedTable::members(quint32 group) const
+{
+    if (!mGroupKeys)
+        return Ids{ nullptr, nullptr };
+    return Ids{ mMemberIds + mGroupKeys[group], mMemberIds + mGroupKeys[group + 1] };
+}
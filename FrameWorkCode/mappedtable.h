@@ -0,0 +1,102 @@
+#ifndef MAPPEDTABLE_H
+#define MAPPEDTABLE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+#include <map>
+#include <string>
+#include <vector>
+
+class MappedTable
+{
+public:
+    //! What the entries of a key are
+    enum Kind {
+        Pairs = 1,      //! One value per key, e.g. LSTM
+        Groups = 2      //! The rows the key is in, e.g. synonyms.csv
+    };
+
+    //! Bytes of a key or value inside the table, valid until the table is cleared
+    struct Text {
+        const char *data;
+        size_t size;
+        bool operator==(const std::string &s) const;
+        bool operator!=(const std::string &s) const { return !(*this == s); }
+        std::string toStdString() const { return std::string(data, size); }
+    };
+
+    //! Ids inside the table, walked with a range for
+    struct Ids {
+        const quint32 *first;
+        const quint32 *last;
+        const quint32 *begin() const { return first; }
+        const quint32 *end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+    MappedTable();
+    ~MappedTable();
+    MappedTable(const MappedTable &) = delete;
+    MappedTable &operator=(const MappedTable &) = delete;
+
+    static QByteArray pairsImage(const std::map<std::string, std::string> &pairs, const QFileInfo &source);
+    static QByteArray groupsImage(const std::map<std::string, std::vector<int>> &keys,
+                                  const std::vector<std::vector<std::string>> &rows, const QFileInfo &source);
+
+    static QString cachePath(const QFileInfo &source, const QString &suffix = QStringLiteral("table"));
+
+    bool load(const QString &tablePath, Kind kind, const QFileInfo &source);
+    bool build(const QString &tablePath, const QByteArray &image);
+    void clear();
+
+    bool isMapped() const { return mFile.isOpen(); }
+    bool empty() const { return size() == 0; }
+    size_t size() const;
+    size_t groupCount() const;
+
+    int find(const std::string &key) const;
+    Text key(quint32 id) const;
+    Text value(quint32 id) const;
+    Ids groups(quint32 id) const;
+    Ids members(quint32 group) const;
+
+private:
+    //! Start of a table, followed by the arrays it counts and the string pool
+    struct Header {
+        quint32 magic;
+        quint32 kind;
+        qint64 sourceSize;      //! Size and modification time of the file the table was built from
+        qint64 sourceModified;
+        quint32 keys;
+        quint32 groups;         //! 0 for Pairs
+        quint32 groupRefs;      //! Entries of the groups of every key, 0 for Pairs
+        quint32 memberRefs;     //! Entries of the keys of every group, 0 for Pairs
+        quint32 buckets;        //! Slots of the hash index, a power of two
+        quint32 poolBytes;
+    };
+
+    QFile mFile;
+    QByteArray mImage;          //! The table when it could not be written to its file
+    const Header *mHeader;
+    const quint32 *mKeyOffsets; //! keys + 1 offsets into mPool, keys sorted by their bytes
+    const quint32 *mValueOffsets;   //! Pairs: keys + 1 offsets into mPool, right after the last key
+    const quint32 *mKeyGroups;  //! Groups: keys + 1 offsets into mGroupIds
+    const quint32 *mGroupIds;
+    const quint32 *mGroupKeys;  //! Groups: groups + 1 offsets into mMemberIds
+    const quint32 *mMemberIds;
+    const quint32 *mBuckets;    //! Key id + 1 by hash, 0 for an empty slot
+    const char *mPool;
+
+    static quint32 hash(const char *data, size_t size);
+    static qint64 modified(const QFileInfo &source);
+    static size_t imageSize(const Header &header);
+    static QByteArray image(Kind kind, const QFileInfo &source, const std::vector<const std::string *> &keys,
+                            const std::vector<const std::string *> &values,
+                            const std::vector<std::vector<quint32>> &keyGroups,
+                            const std::vector<std::vector<quint32>> &groupKeys);
+    bool attach(const uchar *data, qint64 size, int kind, const QFileInfo *source);
+};
+
+#endif // MAPPEDTABLE_H
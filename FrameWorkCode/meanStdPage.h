@@ -1,6 +1,7 @@
 #ifndef MEANSTDPAGE_H
 #define MEANSTDPAGE_H
 #include <QString>
+#include "lexicon.h"
 #include "slpNPatternDict.h"
 #include<string>
 #include<vector>
@@ -8,7 +9,7 @@ using namespace std;
 
 class meanStdPage {
 public:
-    bool findMeanStd(double& mean, double& std,double& error, QString localmFilename1,QString localmFilename2, map<string, int>& GBook,map<string,int>&  PWords);
+    bool findMeanStd(double& mean, double& std,double& error, QString localmFilename1,QString localmFilename2, const Lexicon& GBook,const map<string,int>&  PWords);
 
 };
 
@@ -0,0 +1,280 @@
+/*!
+ * \class PageQualityEstimator
+ * \brief Estimates the OCR quality of every page of a book in parallel, so pages can be ranked by expected effort.
+ * \details The estimate is the one of meanStdPage::findMeanStd(): the OCR words that are found in the GBook or PWords
+ * frequency tables give the mean and standard deviation of the word length, and the share of them that has no equal
+ * word within a window around the same position of the corrected page is the error percentage.
+ * \details setTables() takes the frozen GBook Lexicon and freezes a snapshot of PWords, which MainWindow keeps
+ * updating. Pages are then measured on the global thread pool against those read-only lexicons; the shared maps of
+ * MainWindow are never touched, so nothing is inserted into them for a missed lookup. The window match looks the word
+ * up in a hash of the corrected page's word positions instead of scanning the window.
+ * \details Results are cached per page together with the size and modification time of both files, so estimating
+ * the book again only measures pages that were edited since. updateWords() takes a new snapshot, and forgets the
+ * results, only once words were added to PWords, e.g. by Spell Check or a replacement from the right-click menu.
+ * \sa meanStdPage, MainWindow::on_actionRank_Pages_triggered()
+ */
+#include "pagequalityestimator.h"
+#include "pagetokencache.h"
+#include <QAtomicInt>
+#include <QFileInfo>
+#include <QThread>
+#include "QtConcurrent/qtconcurrentrun.h"
+#include <QFuture>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+/*!
+ * \fn PageQualityEstimator::setTables
+ * \brief Takes a snapshot of the frequency tables and forgets every cached result. Must not be called while
+ *        estimate() runs.
+ * \param GBook Frozen GBook, e.g. LexGBook; must stay frozen while estimate() runs
+ * \param PWords
+ */
+void PageQualityEstimator::setTables(const Lexicon &GBook, const std::map<std::string, int> &PWords)
+{
+    mGBook = &GBook;
+    mPWords.freeze(PWords);
+    mPWordsSize = PWords.size();
+    clear();
+}
+
+/*!
+ * \fn PageQualityEstimator::updateWords
+ * \brief Takes a new snapshot of PWords if words were added to it since the last one. Must not be called while
+ *        estimate() runs.
+ * \details A page only asks whether a word is in PWords, and MainWindow only ever adds words to it or counts them
+ *          again, so the snapshot is out of date exactly when PWords has more words than it had.
+ * \param PWords
+ * \return true if the snapshot was taken again and the cached results forgotten
+ */
+bool PageQualityEstimator::updateWords(const std::map<std::string, int> &PWords)
+{
+    if (PWords.size() == mPWordsSize)
+        return false;
+    mPWords.freeze(PWords);
+    mPWordsSize = PWords.size();
+    clear();
+    return true;
+}
+
+/*!
+ * \fn PageQualityEstimator::clear
+ * \brief Forgets every cached result.
+ */
+void PageQualityEstimator::clear()
+{
+    QMutexLocker locker(&mMutex);
+    mCache.clear();
+}
+
+/*!
+ * \fn PageQualityEstimator::readWords
+ * \brief Reads the whitespace separated words of a file in SLP1.
+ * \details The file is tokenized by the shared PageTokenCache, so a page that was read before is not converted again.
+ * \param path
+ * \param ok Set to false if the file can't be opened
+ * \return Words in file order
+ */
+std::vector<std::string> PageQualityEstimator::readWords(const QString &path, bool *ok)
+{
+    return PageTokenCache::shared().file(path, ok)->slp1();
+}
+
+/*!
+ * \fn PageQualityEstimator::measure
+ * \brief Calculates the statistics of one page.
+ * \param corrected Words of the corrected page in SLP1
+ * \param ocr Words of the OCR page in SLP1
+ * \param known Returns true for a word of the frequency tables
+ * \return PageQuality
+ */
+PageQuality PageQualityEstimator::measure(const std::vector<std::string> &corrected, const std::vector<std::string> &ocr,
+                                          const std::function<bool(const std::string &)> &known)
+{
+    PageQuality quality;
+    quality.valid = true;
+
+    int vsz = int(corrected.size());
+    int win = std::max(std::abs(int(ocr.size()) - vsz), 5);
+
+    //! Positions of every corrected word, ascending
+    std::unordered_map<std::string, std::vector<int>> positions;
+    positions.reserve(corrected.size());
+    for (int t = 0; t < vsz; t++)
+        positions[corrected[t]].push_back(t);
+
+    size_t count = 0, correct = 0;
+    double len = 0, sumSq = 0;
+    for (int i = 0; i < int(ocr.size()); i++) {
+        const std::string &word = ocr[i];
+        if (!known(word))
+            continue;
+        auto found = positions.find(word);
+        if (found != positions.end()) {
+            const std::vector<int> &at = found->second;
+            auto first = std::lower_bound(at.begin(), at.end(), std::max(i - win, 0));
+            if (first != at.end() && *first < std::min(i + win, vsz))
+                correct++;
+        }
+        double sz = double(word.size());
+        count++;
+        len += sz;
+        sumSq += sz * sz;
+    }
+
+    quality.words = int(count);
+    if (count == 0)
+        return quality;
+    quality.mean = len / count;
+    if (count > 1)
+        quality.std = std::sqrt(std::max(0.0, (sumSq - count * quality.mean * quality.mean) / (count - 1)));
+    quality.error = 100.0 * (count - correct) / count;
+    return quality;
+}
+
+/*!
+ * \fn PageQualityEstimator::measurePage
+ * \brief Reads both files of a page once and measures it against the table snapshot.
+ * \param page
+ * \return PageQuality, not valid if a file can't be read
+ */
+PageQuality PageQualityEstimator::measurePage(const Page &page) const
+{
+    bool okCorrected, okOcr;
+    std::vector<std::string> corrected = readWords(page.correctedPath, &okCorrected);
+    std::vector<std::string> ocr = readWords(page.ocrPath, &okOcr);
+    if (!okCorrected || !okOcr)
+        return PageQuality();
+    return measure(corrected, ocr, [this](const std::string &word) {
+        return (mGBook && mGBook->contains(word)) || mPWords.contains(word);
+    });
+}
+
+/*!
+ * \fn PageQualityEstimator::stamp
+ * \return Cache entry describing the current state of the files of page
+ */
+PageQualityEstimator::Entry PageQualityEstimator::stamp(const Page &page)
+{
+    Entry entry;
+    QFileInfo corrected(page.correctedPath), ocr(page.ocrPath);
+    entry.correctedPath = page.correctedPath;
+    entry.ocrPath = page.ocrPath;
+    entry.correctedModified = corrected.lastModified();
+    entry.ocrModified = ocr.lastModified();
+    entry.correctedSize = corrected.exists() ? corrected.size() : -1;
+    entry.ocrSize = ocr.exists() ? ocr.size() : -1;
+    return entry;
+}
+
+/*!
+ * \fn PageQualityEstimator::sameFiles
+ * \return true if both entries were taken from the same, unchanged files
+ */
+bool PageQualityEstimator::sameFiles(const Entry &a, const Entry &b)
+{
+    return a.correctedPath == b.correctedPath && a.ocrPath == b.ocrPath
+            && a.correctedModified == b.correctedModified && a.ocrModified == b.ocrModified
+            && a.correctedSize == b.correctedSize && a.ocrSize == b.ocrSize;
+}
+
+/*!
+ * \fn PageQualityEstimator::estimate
+ * \brief Returns the estimate of every page, measuring the pages that are not cached or changed on disk in parallel.
+ * \param pages
+ * \return Estimates by page key
+ */
+QHash<QString, PageQuality> PageQualityEstimator::estimate(const QVector<Page> &pages)
+{
+    QHash<QString, PageQuality> result;
+    QVector<int> todo;
+    QVector<Entry> entries(pages.size());
+    {
+        QMutexLocker locker(&mMutex);
+        for (int i = 0; i < pages.size(); i++) {
+            entries[i] = stamp(pages[i]);
+            auto cached = mCache.constFind(pages[i].key);
+            if (cached != mCache.constEnd() && sameFiles(cached.value(), entries[i]))
+                result.insert(pages[i].key, cached->quality);
+            else
+                todo.append(i);
+        }
+    }
+    if (todo.isEmpty())
+        return result;
+
+    //! Workers take the next page from a shared counter, so one long page doesn't hold back a whole chunk
+    QAtomicInt next(0);
+    auto work = [&]() {
+        int n;
+        while ((n = next.fetchAndAddRelaxed(1)) < todo.size()) {
+            int i = todo[n];
+            entries[i].quality = measurePage(pages[i]);
+        }
+    };
+    int threads = std::max(1, std::min(QThread::idealThreadCount(), int(todo.size())));
+    QVector<QFuture<void>> futures;
+    for (int t = 1; t < threads; t++)
+        futures.append(QtConcurrent::run(work));
+    work();
+    for (QFuture<void> &future : futures)
+        future.waitForFinished();
+
+    QMutexLocker locker(&mMutex);
+    for (int i : todo) {
+        result.insert(pages[i].key, entries[i].quality);
+        if (entries[i].quality.valid)
+            mCache.insert(pages[i].key, entries[i]);
+    }
+    return result;
+}
+
+/*!
+ * \fn PageQualityEstimator::cached
+ * \brief Returns the last estimate of a page without checking its files.
+ * \param key
+ * \param quality
+ * \return false if the page was never estimated
+ */
+bool PageQualityEstimator::cached(const QString &key, PageQuality *quality) const
+{
+    QMutexLocker locker(&mMutex);
+    auto it = mCache.constFind(key);
+    if (it == mCache.constEnd())
+        return false;
+    *quality = it->quality;
+    return true;
+}
+
+/*!
+ * \fn PageQualityEstimator::ranked
+ * \brief Orders pages by expected correction effort: highest error first, the page with more words first on a tie.
+ *        Pages without a cached estimate go last, in the given order.
+ * \param keys
+ * \return QStringList
+ */
+QStringList PageQualityEstimator::ranked(const QStringList &keys) const
+{
+    QVector<QPair<PageQuality, QString>> known;
+    QStringList unknown;
+    {
+        QMutexLocker locker(&mMutex);
+        for (const QString &key : keys) {
+            auto it = mCache.constFind(key);
+            if (it == mCache.constEnd())
+                unknown.append(key);
+            else
+                known.append(qMakePair(it->quality, key));
+        }
+    }
+    std::stable_sort(known.begin(), known.end(), [](const QPair<PageQuality, QString> &a, const QPair<PageQuality, QString> &b) {
+        if (a.first.error != b.first.error)
+            return a.first.error > b.first.error;
+        return a.first.words > b.first.words;
+    });
+    QStringList order;
+    for (const auto &page : known)
+        order.append(page.second);
+    return order + unknown;
+}
@@ -0,0 +1,69 @@
+#ifndef PAGEQUALITYESTIMATOR_H
+#define PAGEQUALITYESTIMATOR_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "lexicon.h"
+
+//! Word length statistics and estimated OCR error of one page, as calculated by meanStdPage::findMeanStd()
+struct PageQuality {
+    double mean = 0;        //! Mean length of the OCR words found in the frequency tables
+    double std = 0;         //! Standard deviation of those lengths
+    double error = 0;       //! Percentage of those words that have no match near their position in the corrected page
+    int words = 0;          //! Number of OCR words found in the frequency tables
+    bool valid = false;     //! False if one of the files could not be read
+};
+
+class PageQualityEstimator
+{
+public:
+    //! One page of the book: the corrected text and the OCR text it is compared with
+    struct Page {
+        QString key;
+        QString correctedPath;
+        QString ocrPath;
+    };
+
+    void setTables(const Lexicon &GBook, const std::map<std::string, int> &PWords);
+    bool updateWords(const std::map<std::string, int> &PWords);
+    QHash<QString, PageQuality> estimate(const QVector<Page> &pages);
+    QStringList ranked(const QStringList &keys) const;
+    bool cached(const QString &key, PageQuality *quality) const;
+    void clear();
+
+    static std::vector<std::string> readWords(const QString &path, bool *ok);
+    static PageQuality measure(const std::vector<std::string> &corrected, const std::vector<std::string> &ocr,
+                               const std::function<bool(const std::string &)> &known);
+
+private:
+    //! Cached result with the state of the files it was calculated from
+    struct Entry {
+        QString correctedPath;
+        QString ocrPath;
+        QDateTime correctedModified;
+        QDateTime ocrModified;
+        qint64 correctedSize = -1;
+        qint64 ocrSize = -1;
+        PageQuality quality;
+    };
+
+    const Lexicon *mGBook = nullptr;            //! Frozen GBook, owned by the caller
+    Lexicon mPWords;                            //! Snapshot of PWords, which MainWindow keeps counting in
+    size_t mPWordsSize = 0;                     //! Words of PWords when mPWords was taken
+    mutable QMutex mMutex;                      //! Guards mCache
+    QHash<QString, Entry> mCache;
+
+    static Entry stamp(const Page &page);
+    static bool sameFiles(const Entry &a, const Entry &b);
+    PageQuality measurePage(const Page &page) const;
+};
+
+#endif // PAGEQUALITYESTIMATOR_H
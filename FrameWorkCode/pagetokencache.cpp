@@ -0,0 +1,261 @@
+/*!
+ * \class PageTokenCache
+ * \brief Tokens of the pages in use with their SLP1 and Devanagari forms, converted once and shared by every analyzer.
+ * \details Spell check, meanStdPage::findMeanStd(), the generatePairs functions of slpNPatternDict and
+ * CorrectionPairMiner each split a page at whitespace and called slpNPatternDict::toslp1() on every token, and the
+ * right click suggestions converted the selected word again for every source they asked. Here a text is split once
+ * into tokens with their byte offset and line, and every distinct token is interned with an id: its SLP1 form and
+ * whether it is mostly ASCII are found the first time the token is seen in the session, its Devanagari form the first
+ * time Form::dev() is asked for it.
+ * \details Pages are cached by a SHA-1 hash of their content, so an edited page is tokenized again and an unchanged
+ * one is not, whichever path it was read from. The least recently used pages are dropped once more than maxPages are
+ * held. The interned tokens stay until clear(), which MainWindow calls when a project is closed: the tokens interned
+ * so far form a generation that every page made from it shares, so a page still in use keeps its forms after clear()
+ * and the generation is freed with the last such page.
+ * \details A Page is never changed once made and is handed out as a shared pointer, so the GUI and worker threads can
+ * read it at once. Tokens are converted outside the lock, so threads only wait on each other to look tokens up.
+ * \details The forms are the ones of the default script of slpNPatternDict, the only one it converts with.
+ * \sa PageQualityEstimator::readWords(), CorrectionPairMiner, MainWindow::on_actionSpell_Check_triggered()
+ */
+#include "pagetokencache.h"
+#include "slpNPatternDict.h"
+#include <QCryptographicHash>
+#include <QFile>
+#include <QMutexLocker>
+
+/*!
+ * \fn PageTokenCache::Form::dev
+ * \return slpNPatternDict::toDev() of the SLP1 form, converted on the first call
+ */
+const std::string &PageTokenCache::Form::dev() const
+{
+    std::call_once(mDevOnce, [this]() {
+        slpNPatternDict slnp;
+        mDev = slnp.toDev(slp1);
+    });
+    return mDev;
+}
+
+/*!
+ * \fn PageTokenCache::Page::slp1
+ * \return SLP1 form of every token, in page order
+ */
+std::vector<std::string> PageTokenCache::Page::slp1() const
+{
+    std::vector<std::string> words;
+    words.reserve(tokens.size());
+    for (const Token &token : tokens)
+        words.push_back(token.form->slp1);
+    return words;
+}
+
+/*!
+ * \fn PageTokenCache::PageTokenCache
+ * \brief Constructor
+ * \param maxPages Pages kept before the least recently used one is dropped
+ */
+PageTokenCache::PageTokenCache(int maxPages)
+{
+    this->mMaxPages = maxPages;
+    this->mGeneration = std::make_shared<Generation>();
+}
+
+/*!
+ * \fn PageTokenCache::shared
+ * \brief Returns the cache shared by the GUI and the worker threads.
+ */
+PageTokenCache &PageTokenCache::shared()
+{
+    static PageTokenCache cache;
+    return cache;
+}
+
+/*!
+ * \fn PageTokenCache::add
+ * \brief Interns a converted token unless another thread did so first. Must be called with mMutex locked.
+ * \return Id of the token
+ */
+int PageTokenCache::add(const std::string &token, const std::string &slp1, bool ascii)
+{
+    auto found = mGeneration->ids.find(token);
+    if (found != mGeneration->ids.end())
+        return found->second;
+    int id = int(mGeneration->forms.size());
+    mGeneration->forms.emplace_back();
+    Form &form = mGeneration->forms.back();
+    form.text = token;
+    form.slp1 = slp1;
+    form.ascii = ascii;
+    mGeneration->ids.emplace(token, id);
+    mStats.converted++;
+    return id;
+}
+
+/*!
+ * \fn PageTokenCache::addConverted
+ * \brief Interns a token, converting it under the lock if it is not interned yet. Must be called with mMutex locked.
+ * \details Only needed for a token that was interned when text() looked but was dropped by clear() since.
+ * \return Id of the token
+ */
+int PageTokenCache::addConverted(const std::string &token)
+{
+    auto found = mGeneration->ids.find(token);
+    if (found != mGeneration->ids.end())
+        return found->second;
+    slpNPatternDict slnp;
+    return add(token, slnp.toslp1(token), slnp.hasM40PerAsci(token));
+}
+
+/*!
+ * \fn PageTokenCache::touch
+ * \brief Marks a cached page as the most recently used one. Must be called with mMutex locked.
+ */
+void PageTokenCache::touch(const QByteArray &hash)
+{
+    mOrder.removeOne(hash);
+    mOrder.append(hash);
+}
+
+/*!
+ * \fn PageTokenCache::intern
+ * \brief Looks a single token up, e.g. the word under the cursor, converting it if it was never seen.
+ * \param token
+ * \return Form, valid until the next clear()
+ */
+const PageTokenCache::Form &PageTokenCache::intern(const std::string &token)
+{
+    {
+        QMutexLocker locker(&mMutex);
+        auto found = mGeneration->ids.find(token);
+        if (found != mGeneration->ids.end())
+            return mGeneration->forms[found->second];
+    }
+    slpNPatternDict slnp;
+    std::string slp1 = slnp.toslp1(token);
+    bool ascii = slnp.hasM40PerAsci(token);
+    QMutexLocker locker(&mMutex);
+    return mGeneration->forms[add(token, slp1, ascii)];
+}
+
+/*!
+ * \fn PageTokenCache::text
+ * \brief Tokenizes a text at whitespace, as std::istream >> does, unless a text with the same content is cached.
+ * \param utf8 Text in UTF-8
+ * \return Page
+ */
+std::shared_ptr<const PageTokenCache::Page> PageTokenCache::text(const QByteArray &utf8)
+{
+    QByteArray hash = QCryptographicHash::hash(utf8, QCryptographicHash::Sha1);
+    {
+        QMutexLocker locker(&mMutex);
+        auto cached = mPages.constFind(hash);
+        if (cached != mPages.constEnd()) {
+            mStats.hits++;
+            touch(hash);
+            return cached.value();
+        }
+    }
+
+    //! Split at the bytes isspace() accepts in the C locale, which are all ASCII and never part of a UTF-8 sequence
+    struct Span { unsigned int offset, size, line; };
+    std::vector<Span> spans;
+    const char *data = utf8.constData();
+    unsigned int size = utf8.size(), line = 0;
+    for (unsigned int i = 0; i < size;) {
+        char c = data[i];
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r') {
+            if (c == '\n')
+                line++;
+            i++;
+            continue;
+        }
+        unsigned int start = i;
+        while (i < size && !(data[i] == ' ' || data[i] == '\t' || data[i] == '\n' || data[i] == '\v'
+                             || data[i] == '\f' || data[i] == '\r'))
+            i++;
+        spans.push_back({ start, i - start, line });
+    }
+
+    //! Tokens never seen before, converted without holding the lock
+    std::vector<std::string> fresh;
+    {
+        QMutexLocker locker(&mMutex);
+        std::unordered_map<std::string, bool> listed;
+        for (const Span &span : spans) {
+            std::string token(data + span.offset, span.size);
+            if (!mGeneration->ids.count(token) && listed.emplace(token, true).second)
+                fresh.push_back(token);
+        }
+    }
+    slpNPatternDict slnp;
+    std::vector<std::string> slp1(fresh.size());
+    std::vector<char> ascii(fresh.size());
+    for (size_t i = 0; i < fresh.size(); i++) {
+        slp1[i] = slnp.toslp1(fresh[i]);
+        ascii[i] = slnp.hasM40PerAsci(fresh[i]);
+    }
+
+    std::shared_ptr<Page> page = std::make_shared<Page>();
+    page->hash = hash;
+    page->lines = size == 0 ? 0 : line + (data[size - 1] != '\n');
+    page->tokens.reserve(spans.size());
+
+    QMutexLocker locker(&mMutex);
+    for (size_t i = 0; i < fresh.size(); i++)
+        add(fresh[i], slp1[i], ascii[i]);
+    page->generation = mGeneration;
+    for (const Span &span : spans) {
+        int id = addConverted(std::string(data + span.offset, span.size));
+        page->tokens.push_back({ id, &mGeneration->forms[id], span.offset, span.line });
+    }
+    mStats.misses++;
+    mPages.insert(hash, page);
+    touch(hash);
+    while (mOrder.size() > mMaxPages)
+        mPages.remove(mOrder.takeFirst());
+    return page;
+}
+
+/*!
+ * \fn PageTokenCache::file
+ * \brief Reads a file and tokenizes it, see text().
+ * \param path
+ * \param ok Set to false if the file can't be opened
+ * \return Page, without tokens if the file can't be opened
+ */
+std::shared_ptr<const PageTokenCache::Page> PageTokenCache::file(const QString &path, bool *ok)
+{
+    QFile f(path);
+    *ok = f.open(QIODevice::ReadOnly);
+    if (!*ok)
+        return std::make_shared<const Page>();
+    return text(f.readAll());
+}
+
+/*!
+ * \fn PageTokenCache::stats
+ * \return Stats
+ */
+PageTokenCache::Stats PageTokenCache::stats() const
+{
+    QMutexLocker locker(&mMutex);
+    Stats s = mStats;
+    s.pages = mPages.size();
+    s.forms = int(mGeneration->forms.size());
+    return s;
+}
+
+/*!
+ * \fn PageTokenCache::clear
+ * \brief Drops the cached pages and the interned tokens and resets the stats.
+ * \details The tokens go into a new generation. Pages still in use keep the old one, and the Forms they point to,
+ *          until the last of them is released; a Form returned by intern() before is no longer valid.
+ */
+void PageTokenCache::clear()
+{
+    QMutexLocker locker(&mMutex);
+    mPages.clear();
+    mOrder.clear();
+    mGeneration = std::make_shared<Generation>();
+    mStats = Stats();
+}
@@ -0,0 +1,90 @@
+#ifndef PAGETOKENCACHE_H
+#define PAGETOKENCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class PageTokenCache
+{
+    struct Generation;
+
+public:
+    //! A distinct token with its transliterations, interned once until the cache is cleared
+    struct Form {
+        std::string text;           //! Token as it appears in the page
+        std::string slp1;           //! slpNPatternDict::toslp1() of text
+        bool ascii = false;         //! slpNPatternDict::hasM40PerAsci() of text
+        const std::string &dev() const;
+
+    private:
+        mutable std::once_flag mDevOnce;
+        mutable std::string mDev;   //! slpNPatternDict::toDev() of slp1, converted the first time it is asked for
+    };
+
+    //! One whitespace separated token of a page
+    struct Token {
+        int id;                     //! Interned id, equal for equal tokens on every page
+        const Form *form;
+        unsigned int offset;        //! Byte offset of the token in the UTF-8 text
+        unsigned int line;          //! Line of the token, 0 based
+    };
+
+    //! Tokens of a text, shared read-only by everyone who asked for the same content
+    struct Page {
+        QByteArray hash;            //! SHA-1 of the text
+        std::vector<Token> tokens;
+        unsigned int lines = 0;     //! Number of lines std::getline() splits the text into
+        std::shared_ptr<const Generation> generation;  //! Keeps the forms of the tokens alive after clear()
+        std::vector<std::string> slp1() const;
+    };
+
+    //! Usage since the cache was created or cleared
+    struct Stats {
+        unsigned long long hits = 0;        //! Texts found in the cache
+        unsigned long long misses = 0;      //! Texts tokenized
+        unsigned long long converted = 0;   //! Tokens transliterated, once per distinct token
+        int pages = 0;                      //! Texts cached now
+        int forms = 0;                      //! Distinct tokens interned
+    };
+
+    explicit PageTokenCache(int maxPages = 64);
+    PageTokenCache(const PageTokenCache &) = delete;
+    PageTokenCache &operator=(const PageTokenCache &) = delete;
+    static PageTokenCache &shared();
+
+    std::shared_ptr<const Page> text(const QByteArray &utf8);
+    std::shared_ptr<const Page> file(const QString &path, bool *ok);
+    const Form &intern(const std::string &token);
+    const std::string &slp1(const std::string &token) { return intern(token).slp1; }
+    Stats stats() const;
+    void clear();
+
+private:
+    int mMaxPages;
+    //! Tokens interned since the cache was created or cleared
+    struct Generation {
+        std::deque<Form> forms;                             //! By id; a deque never moves what it holds
+        std::unordered_map<std::string, int> ids;           //! Id of every interned token
+    };
+
+    mutable QMutex mMutex;                                  //! Guards everything below
+    std::shared_ptr<Generation> mGeneration;
+    QHash<QByteArray, std::shared_ptr<const Page>> mPages;  //! Pages by hash
+    QList<QByteArray> mOrder;                               //! Hashes of mPages, least recently used first
+    Stats mStats;
+
+    int add(const std::string &token, const std::string &slp1, bool ascii);
+    int addConverted(const std::string &token);
+    void touch(const QByteArray &hash);
+};
+
+#endif // PAGETOKENCACHE_H
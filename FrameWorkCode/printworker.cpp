@@ -2,6 +2,7 @@
 
 #include <QTextDocument>
 #include <QPrinter>
+#include "tracer.h"
 
 /*!
  * \fn PrintWorker::PrintWorker
@@ -30,6 +31,7 @@ PrintWorker::~PrintWorker()
  */
 void PrintWorker::printPDF()
 {
+    TRACE_SCOPE("PrintWorker::printPDF");
     doc = new QTextDocument(this);
     doc->setHtml(fullHtml);
     doc->print(printer);
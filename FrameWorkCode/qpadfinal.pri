@@ -4,26 +4,48 @@
 
 HEADERS += ./Filters.h \
     $$PWD/about.h \
+    $$PWD/batchrunner.h \
+    $$PWD/commitqueue.h \
+    $$PWD/comparisonservice.h \
+    $$PWD/completionindex.h \
+    $$PWD/confusionrewriter.h \
+    $$PWD/correctionpairminer.h \
+    $$PWD/cpairjournal.h \
     $$PWD/crashlog.h \
     $$PWD/customtextbrowser.h \
     $$PWD/dashboard.h \
+    $$PWD/directorywatcher.h \
     $$PWD/editdistance.h \
     $$PWD/equationeditor.h \
+    $$PWD/eventlog.h \
     $$PWD/globalreplaceworker.h \
     $$PWD/handlebbox.h \
     $$PWD/indentoptions.h \
+    $$PWD/lcsaligner.h \
+    $$PWD/lexicon.h \
     $$PWD/loaddataworker.h \
     $$PWD/loadingspinner.h \
+    $$PWD/mappedtable.h \
     $$PWD/markRegion.h \
+    $$PWD/pagequalityestimator.h \
+    $$PWD/pagetokencache.h \
     $$PWD/pdfhandling.h \
     $$PWD/pdfrangedialog.h \
     $$PWD/printworker.h \
     $$PWD/progressbardialog.h \
+    $$PWD/replacejournal.h \
     $$PWD/rubberband.h \
+    $$PWD/sandhichecker.h \
     $$PWD/shortcutguidedialog.h \
+    $$PWD/spellchecker.h \
+    $$PWD/substringindex.h \
+    $$PWD/suggestionpipeline.h \
     $$PWD/textfinder.h \
     $$PWD/globalreplacedialog.h \
     $$PWD/threadingpush.h \
+    $$PWD/timelogstore.h \
+    $$PWD/tracer.h \
+    $$PWD/treesearchindex.h \
     $$PWD/undoglobalreplace.h \
     $$PWD/verifyset.h \
     $$PWD/worker.h \
@@ -56,29 +78,51 @@ HEADERS += ./Filters.h \
     $$PWD/globalreplaceinformation.h
 SOURCES += ./DiffView.cpp \
     $$PWD/about.cpp \
+    $$PWD/batchrunner.cpp \
+    $$PWD/commitqueue.cpp \
+    $$PWD/comparisonservice.cpp \
+    $$PWD/completionindex.cpp \
+    $$PWD/confusionrewriter.cpp \
+    $$PWD/correctionpairminer.cpp \
+    $$PWD/cpairjournal.cpp \
     $$PWD/crashlog.cpp \
     $$PWD/customtextbrowser.cpp \
     $$PWD/dashboard.cpp \
+    $$PWD/directorywatcher.cpp \
     $$PWD/eddis.cpp \
     $$PWD/editdistance.cpp \
     $$PWD/equationeditor.cpp \
+    $$PWD/eventlog.cpp \
     $$PWD/globalreplaceworker.cpp \
     $$PWD/handlebbox.cpp \
     $$PWD/indentoptions.cpp \
+    $$PWD/lcsaligner.cpp \
+    $$PWD/lexicon.cpp \
     $$PWD/loaddataworker.cpp \
     $$PWD/loadingspinner.cpp \
+    $$PWD/mappedtable.cpp \
     $$PWD/markRegion.cpp \
     $$PWD/meanStdPage.cpp \
+    $$PWD/pagequalityestimator.cpp \
+    $$PWD/pagetokencache.cpp \
     $$PWD/pdfhandling.cpp \
     $$PWD/pdfrangedialog.cpp \
     $$PWD/printworker.cpp \
     $$PWD/progressbardialog.cpp \
+    $$PWD/replacejournal.cpp \
     $$PWD/rubberband.cpp \
+    $$PWD/sandhichecker.cpp \
     $$PWD/shortcutguidedialog.cpp \
+    $$PWD/spellchecker.cpp \
     $$PWD/slpNPatternDict.cpp \
+    $$PWD/substringindex.cpp \
+    $$PWD/suggestionpipeline.cpp \
     $$PWD/textfinder.cpp \
     $$PWD/globalreplacedialog.cpp \
     $$PWD/threadingpush.cpp \
+    $$PWD/timelogstore.cpp \
+    $$PWD/tracer.cpp \
+    $$PWD/treesearchindex.cpp \
     $$PWD/trieEditdis.cpp \
     $$PWD/undoglobalreplace.cpp \
     $$PWD/verifyset.cpp \
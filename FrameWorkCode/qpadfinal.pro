@@ -9,6 +9,7 @@ QT += printsupport
 QT += xml
 QT += network networkauth
 QT += multimedia
+QT += concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -0,0 +1,343 @@
+/*!
+ * \class ReplaceJournal
+ * \brief Records what a global replace changed in every file, so that the replace can be undone exactly.
+ * \details GlobalReplaceWorker hands the content of each file before and after the replacement to record(), which
+ * stores the changed regions as (offset, old text, new text) together with SHA-1 hashes of both versions. A file that
+ * the run rewrites twice gets two steps, which are reverted last first. save()
+ * writes the journal of the run with QSaveFile, so undo also works after a restart. The journal holds absolute paths,
+ * so MainWindow keeps it in the user's cache folder, keyed on the project, rather than in the project's repository.
+ * \details undo() only visits the journaled files and applies the inverse hunks on the thread pool. A file whose hash
+ * differs from the one recorded after the replace was edited since; it is left alone and reported in
+ * UndoResult::skipped, so the caller can fall back to replacing the words again in just those files.
+ * \sa GlobalReplaceWorker::replaceWordsInFiles(), MainWindow::on_actionUndo_Global_Replace_triggered()
+ */
+#include "replacejournal.h"
+#include "diff_match_patch.h"
+#include <QAtomicInt>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QFuture>
+#include <QSaveFile>
+#include <QThread>
+#include <QDebug>
+#include "QtConcurrent/qtconcurrentrun.h"
+#include <algorithm>
+
+static const quint32 JournalMagic = 0x52504a31;    //! "RPJ1"
+
+/*!
+ * \fn ReplaceJournal::ReplaceJournal
+ * \brief Constructor
+ * \param path Journal file, e.g. MappedTable::cachePath() of the project
+ */
+ReplaceJournal::ReplaceJournal(QString path)
+{
+    this->mPath = path;
+}
+
+/*!
+ * \fn ReplaceJournal::begin
+ * \brief Starts the journal of a new global replace, dropping the previous one.
+ * \param words Replacements of the run, old word -> new word
+ */
+void ReplaceJournal::begin(const QMap<QString, QString> &words)
+{
+    QMutexLocker locker(&mMutex);
+    mWords = words;
+    mFiles.clear();
+    mFileIndex.clear();
+}
+
+/*!
+ * \fn ReplaceJournal::record
+ * \brief Records the change the replace made to one file. Safe to call from any thread.
+ * \param filePath
+ * \param before File content before the replace
+ * \param after File content after the replace
+ */
+void ReplaceJournal::record(const QString &filePath, const QByteArray &before, const QByteArray &after)
+{
+    if (before == after)
+        return;
+    Step step;
+    step.beforeHash = QCryptographicHash::hash(before, QCryptographicHash::Sha1);
+    step.afterHash = QCryptographicHash::hash(after, QCryptographicHash::Sha1);
+    step.hunks = diff(QString::fromUtf8(before), QString::fromUtf8(after));
+    QMutexLocker locker(&mMutex);
+    auto it = mFileIndex.constFind(filePath);
+    if (it == mFileIndex.constEnd()) {
+        mFileIndex.insert(filePath, mFiles.size());
+        mFiles.append(FilePatch());
+        mFiles.last().path = filePath;
+        mFiles.last().steps.append(step);
+    } else {
+        mFiles[it.value()].steps.append(step);
+    }
+}
+
+/*!
+ * \fn ReplaceJournal::diff
+ * \brief Turns the differences between two texts into hunks. Offsets refer to after and are ascending.
+ * \param before
+ * \param after
+ * \return QVector<Hunk>
+ */
+QVector<ReplaceJournal::Hunk> ReplaceJournal::diff(const QString &before, const QString &after)
+{
+    QVector<Hunk> hunks;
+    diff_match_patch dmp;
+    QList<Diff> diffs = dmp.diff_main(before, after);
+    int pos = 0;
+    Hunk *open = nullptr;
+    for (const Diff &d : diffs) {
+        if (d.operation == EQUAL) {
+            pos += d.text.size();
+            open = nullptr;
+            continue;
+        }
+        if (!open) {
+            hunks.append(Hunk());
+            open = &hunks.last();
+            open->offset = pos;
+        }
+        if (d.operation == DELETE) {
+            open->oldText += d.text;
+        } else {
+            open->newText += d.text;
+            pos += d.text.size();
+        }
+    }
+    return hunks;
+}
+
+/*!
+ * \fn ReplaceJournal::revert
+ * \brief Applies the inverse of hunks to the replaced text.
+ * \param text
+ * \param hunks
+ * \return false if the text doesn't contain the new text of every hunk where it was recorded
+ */
+bool ReplaceJournal::revert(QString *text, const QVector<Hunk> &hunks)
+{
+    //! From the end, so the offsets of the hunks still to come stay valid
+    for (int i = hunks.size() - 1; i >= 0; i--) {
+        const Hunk &h = hunks[i];
+        if (h.offset + h.newText.size() > text->size() || text->midRef(h.offset, h.newText.size()) != h.newText)
+            return false;
+        text->replace(h.offset, h.newText.size(), h.oldText);
+    }
+    return true;
+}
+
+/*!
+ * \fn ReplaceJournal::restore
+ * \brief Puts one file back into its state before the replace if it is unchanged since.
+ * \param patch
+ * \param hunks Set to the number of hunks reverted
+ * \return false if the file was edited or deleted since, or can't be written
+ */
+bool ReplaceJournal::restore(const FilePatch &patch, int *hunks)
+{
+    if (patch.steps.isEmpty())
+        return false;
+    QFile f(patch.path);
+    if (!f.open(QIODevice::ReadOnly))
+        return false;
+    QByteArray current = f.readAll();
+    f.close();
+    if (QCryptographicHash::hash(current, QCryptographicHash::Sha1) != patch.steps.last().afterHash)
+        return false;
+
+    QByteArray restored = current;
+    int reverted = 0;
+    for (int i = patch.steps.size() - 1; i >= 0; i--) {
+        const Step &step = patch.steps[i];
+        QString text = QString::fromUtf8(restored);
+        if (!revert(&text, step.hunks))
+            return false;
+        restored = text.toUtf8();
+        if (QCryptographicHash::hash(restored, QCryptographicHash::Sha1) != step.beforeHash) {
+            qDebug() << "Replace journal doesn't reproduce" << patch.path;
+            return false;
+        }
+        reverted += step.hunks.size();
+    }
+
+    QSaveFile out(patch.path);
+    if (!out.open(QIODevice::WriteOnly) || out.write(restored) != restored.size() || !out.commit())
+        return false;
+    *hunks = reverted;
+    return true;
+}
+
+/*!
+ * \fn ReplaceJournal::undo
+ * \brief Restores every journaled file in parallel and empties the journal.
+ * \return UndoResult
+ */
+ReplaceJournal::UndoResult ReplaceJournal::undo()
+{
+    QMutexLocker locker(&mMutex);
+    UndoResult result;
+    QVector<int> restored(mFiles.size(), -1);
+    QAtomicInt next(0);
+    auto work = [&]() {
+        int i;
+        while ((i = next.fetchAndAddRelaxed(1)) < mFiles.size()) {
+            int hunks = 0;
+            if (restore(mFiles[i], &hunks))
+                restored[i] = hunks;
+        }
+    };
+    int threads = std::max(1, std::min(QThread::idealThreadCount(), int(mFiles.size())));
+    QVector<QFuture<void>> futures;
+    for (int t = 1; t < threads; t++)
+        futures.append(QtConcurrent::run(work));
+    work();
+    for (QFuture<void> &future : futures)
+        future.waitForFinished();
+
+    for (int i = 0; i < mFiles.size(); i++) {
+        if (restored[i] < 0) {
+            result.skipped.append(mFiles[i].path);
+        } else {
+            result.files++;
+            result.hunks += restored[i];
+        }
+    }
+    mWords.clear();
+    mFiles.clear();
+    mFileIndex.clear();
+    QFile::remove(mPath);
+    return result;
+}
+
+/*!
+ * \fn ReplaceJournal::covers
+ * \brief Checks whether an undo selection is exactly the journaled run, i.e. whether undo() can serve it.
+ * \param undoMap Words to undo, new word -> old word, as returned by UndoGlobalReplace
+ * \return bool
+ */
+bool ReplaceJournal::covers(const QMap<QString, QString> &undoMap)
+{
+    QMutexLocker locker(&mMutex);
+    if (mWords.isEmpty() || mWords.size() != undoMap.size())
+        return false;
+    for (auto it = mWords.constBegin(); it != mWords.constEnd(); ++it)
+        if (!undoMap.contains(it.value()) || undoMap.value(it.value()) != it.key())
+            return false;
+    return true;
+}
+
+/*!
+ * \fn ReplaceJournal::save
+ * \brief Writes the journal atomically.
+ * \return bool
+ */
+bool ReplaceJournal::save()
+{
+    QMutexLocker locker(&mMutex);
+    QSaveFile file(mPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Can't write replace journal" << mPath;
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_3);
+    out << JournalMagic << mWords << qint32(mFiles.size());
+    for (const FilePatch &patch : mFiles) {
+        out << patch.path << qint32(patch.steps.size());
+        for (const Step &step : patch.steps) {
+            out << step.beforeHash << step.afterHash << qint32(step.hunks.size());
+            for (const Hunk &h : step.hunks)
+                out << qint32(h.offset) << h.oldText << h.newText;
+        }
+    }
+    return file.commit();
+}
+
+/*!
+ * \fn ReplaceJournal::load
+ * \brief Reads the journal of the last global replace, e.g. after the project was opened again.
+ * \return false if there is no readable journal
+ */
+bool ReplaceJournal::load()
+{
+    QMutexLocker locker(&mMutex);
+    mWords.clear();
+    mFiles.clear();
+    mFileIndex.clear();
+    QFile file(mPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_3);
+    quint32 magic;
+    qint32 files;
+    in >> magic;
+    if (magic != JournalMagic)
+        return false;
+    in >> mWords >> files;
+    for (qint32 f = 0; f < files && in.status() == QDataStream::Ok; f++) {
+        FilePatch patch;
+        qint32 steps;
+        in >> patch.path >> steps;
+        for (qint32 s = 0; s < steps && in.status() == QDataStream::Ok; s++) {
+            Step step;
+            qint32 hunks;
+            in >> step.beforeHash >> step.afterHash >> hunks;
+            for (qint32 i = 0; i < hunks && in.status() == QDataStream::Ok; i++) {
+                Hunk h;
+                qint32 offset;
+                in >> offset >> h.oldText >> h.newText;
+                h.offset = offset;
+                step.hunks.append(h);
+            }
+            patch.steps.append(step);
+        }
+        mFileIndex.insert(patch.path, mFiles.size());
+        mFiles.append(patch);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qDebug() << "Discarding damaged replace journal" << mPath;
+        mWords.clear();
+        mFiles.clear();
+        mFileIndex.clear();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \fn ReplaceJournal::clear
+ * \brief Forgets the journaled run, e.g. once it was undone the old way.
+ */
+void ReplaceJournal::clear()
+{
+    QMutexLocker locker(&mMutex);
+    mWords.clear();
+    mFiles.clear();
+    mFileIndex.clear();
+    QFile::remove(mPath);
+}
+
+/*!
+ * \fn ReplaceJournal::words
+ * \return Replacements of the journaled run, old word -> new word
+ */
+QMap<QString, QString> ReplaceJournal::words()
+{
+    QMutexLocker locker(&mMutex);
+    return mWords;
+}
+
+/*!
+ * \fn ReplaceJournal::fileCount
+ * \return Number of files changed by the journaled run
+ */
+int ReplaceJournal::fileCount()
+{
+    QMutexLocker locker(&mMutex);
+    return mFiles.size();
+}
@@ -0,0 +1,66 @@
+#ifndef REPLACEJOURNAL_H
+#define REPLACEJOURNAL_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class ReplaceJournal {
+public:
+    //! One changed region of a file: newText starts at offset in the replaced file and was oldText before
+    struct Hunk {
+        int offset = 0;
+        QString oldText;
+        QString newText;
+    };
+
+    //! Outcome of undo()
+    struct UndoResult {
+        int files = 0;              //! Files restored exactly
+        int hunks = 0;              //! Changed regions put back
+        QStringList skipped;        //! Files that were edited or deleted since the replace, left untouched
+    };
+
+    explicit ReplaceJournal(QString path);
+    void begin(const QMap<QString, QString> &words);
+    void record(const QString &filePath, const QByteArray &before, const QByteArray &after);
+    bool save();
+    bool load();
+    bool covers(const QMap<QString, QString> &undoMap);
+    UndoResult undo();
+    void clear();
+    int fileCount();
+    QMap<QString, QString> words();
+    QString path() const { return mPath; }
+
+    static QVector<Hunk> diff(const QString &before, const QString &after);
+    static bool revert(QString *text, const QVector<Hunk> &hunks);
+
+private:
+    //! One rewrite of a file; a run that replaces in two passes rewrites a file twice
+    struct Step {
+        QByteArray beforeHash;
+        QByteArray afterHash;
+        QVector<Hunk> hunks;
+    };
+
+    //! Everything needed to restore one file, and to check that it wasn't touched since
+    struct FilePatch {
+        QString path;
+        QVector<Step> steps;
+    };
+
+    QString mPath;
+    QMap<QString, QString> mWords;      //! Replacements of the journaled run, old word -> new word
+    QVector<FilePatch> mFiles;
+    QHash<QString, int> mFileIndex;     //! Position of each path in mFiles
+    QMutex mMutex;
+
+    static bool restore(const FilePatch &patch, int *hunks);
+};
+
+#endif // REPLACEJOURNAL_H
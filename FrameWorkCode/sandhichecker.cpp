@@ -0,0 +1,124 @@
+/*!
+ * \class SandhiChecker
+ * \brief Memoized samas and sandhi validity checks of slpNPatternDict for the suggestions of a word.
+ * \details samas() accepts a word that is in Dict or whose longest Dict prefix of more than 3 letters leaves more than
+ * 3 letters that are accepted in turn. sandhi() finds the rightmost letter, with more than 3 letters before and at
+ * least 2 after it, that has sandhi rules, and accepts the word if for one alternative the right part followed by the
+ * rest is a valid samas and the undone left part is a valid samas or sandhi.
+ * \details The SRules alternatives are split into (left, right) pairs once, in a table indexed by the letter they
+ * apply to; multi-letter keys of the file were never looked up and are left out. Every word either check sees is
+ * remembered, so the words generatePossibilitesNsuggest() derives from one OCR word share their answers. A word reached
+ * by sandhi() is a prefix of the OCR word with one letter undone, and a word reached by samas() is a part of it between
+ * two rule alternatives, so there are polynomially many of them, where the recursion of SandhiCheck() tried every
+ * combination of alternatives.
+ * \details Dict is a frozen Lexicon, so a check inserts nothing into it.
+ * \sa slpNPatternDict::SamasCheck(), slpNPatternDict::SandhiCheck(), slpNPatternDict::generatePossibilitesNsuggest()
+ */
+#include "sandhichecker.h"
+#include "lexicon.h"
+#include <sstream>
+
+/*!
+ * \fn SandhiChecker::SandhiChecker
+ * \brief Constructor for samas() checks only.
+ * \param Dict Must outlive the checker and not change while it is used
+ */
+SandhiChecker::SandhiChecker(const Lexicon &Dict) : mDict(Dict)
+{
+}
+
+/*!
+ * \fn SandhiChecker::SandhiChecker
+ * \brief Constructor
+ * \param Dict Must outlive the checker and not change while it is used
+ * \param SRules Sandhi rules as loaded by slpNPatternDict::loadSandhiRules(), e.g. o -> {"a u", ...}
+ */
+SandhiChecker::SandhiChecker(const Lexicon &Dict, const std::map<std::string, std::vector<std::string>> &SRules) : mDict(Dict)
+{
+    for (const auto &rule : SRules) {
+        if (rule.first.size() != 1)
+            continue;
+        std::vector<Rule> &alternatives = mRules[static_cast<unsigned char>(rule.first[0])];
+        for (const std::string &alternative : rule.second) {
+            std::istringstream s(alternative);
+            Rule r;
+            s >> r.left;
+            s >> r.right;
+            alternatives.push_back(r);
+        }
+    }
+}
+
+/*!
+ * \fn SandhiChecker::inDict
+ * \return true if word has a positive count in Dict
+ */
+bool SandhiChecker::inDict(const std::string &word) const
+{
+    return mDict.contains(word);
+}
+
+/*!
+ * \fn SandhiChecker::samas
+ * \brief Checks whether a word is a Dict word or a compound of Dict words.
+ * \param word SLP1 word
+ * \return bool
+ */
+bool SandhiChecker::samas(const std::string &word)
+{
+    if (word.empty())
+        return true;
+    auto memo = mSamas.find(word);
+    if (memo != mSamas.end())
+        return memo->second;
+
+    bool valid = inDict(word);
+    size_t sz = word.size();
+    for (size_t ts = sz > 4 ? sz - 4 : 0; !valid && ts > 3; ts--) {
+        if (inDict(word.substr(0, ts))) {
+            valid = samas(word.substr(ts));
+            break;
+        }
+    }
+    mSamas.emplace(word, valid);
+    return valid;
+}
+
+/*!
+ * \fn SandhiChecker::sandhi
+ * \brief Checks whether a word is made of valid words joined by one of the sandhi rules.
+ * \param word SLP1 word
+ * \return bool
+ */
+bool SandhiChecker::sandhi(const std::string &word)
+{
+    auto memo = mSandhi.find(word);
+    if (memo != mSandhi.end())
+        return memo->second;
+    if (inDict(word)) {
+        mSandhi.emplace(word, true);
+        return true;
+    }
+    //! A rule whose left part is longer than one letter could lead back to the same word
+    mSandhi.emplace(word, false);
+
+    bool valid = false;
+    size_t sz = word.size();
+    for (size_t ts = sz > 3 ? sz - 3 : 0; ts > 3; ts--) {
+        const std::vector<Rule> &alternatives = mRules[static_cast<unsigned char>(word[ts - 1])];
+        if (alternatives.empty())
+            continue;
+        std::string head = word.substr(0, ts - 1);
+        std::string rem = word.substr(ts);
+        for (const Rule &rule : alternatives) {
+            std::string s1new = head + rule.left;
+            if (samas(rule.right + rem) && (samas(s1new) || sandhi(s1new))) {
+                valid = true;
+                break;
+            }
+        }
+        break;
+    }
+    mSandhi[word] = valid;
+    return valid;
+}
@@ -0,0 +1,36 @@
+#ifndef SANDHICHECKER_H
+#define SANDHICHECKER_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Lexicon;
+
+class SandhiChecker
+{
+public:
+    explicit SandhiChecker(const Lexicon &Dict);
+    SandhiChecker(const Lexicon &Dict, const std::map<std::string, std::vector<std::string>> &SRules);
+
+    bool samas(const std::string &word);
+    bool sandhi(const std::string &word);
+    size_t states() const { return mSamas.size() + mSandhi.size(); }
+
+private:
+    //! One alternative of a sandhi rule: the letter ending the left word is undone into left, right starts the next word
+    struct Rule {
+        std::string left;
+        std::string right;
+    };
+
+    const Lexicon &mDict;
+    std::vector<Rule> mRules[256];                  //! Alternatives by the byte they apply to
+    std::unordered_map<std::string, bool> mSamas;   //! Answers of samas() for every word it has seen
+    std::unordered_map<std::string, bool> mSandhi;  //! Answers of sandhi(), false while a word is being checked
+
+    bool inDict(const std::string &word) const;
+};
+
+#endif // SANDHICHECKER_H
@@ -21,6 +21,11 @@
 #include <QFile>
 #include "eddis.h"
 #include "slpNPatternDict.h"
+#include "sandhichecker.h"
+#include "confusionrewriter.h"
+#include "lcsaligner.h"
+#include "lexicon.h"
+#include "pagetokencache.h"
 
 using namespace std;
 bool HinFlag = 0, SanFlag = 1;
@@ -480,7 +485,7 @@ void slpNPatternDict::loadMapPWords(vector<string>& vGBook,vector<string>& vIBoo
     cout << PWords.size() << " words loaded in PWords" << endl;
 }
 
-string slpNPatternDict::findDictEntries1(string s1,  map<string, int>& m2, map<string, int>& m1, int size) { //unordered_
+string slpNPatternDict::findDictEntries1(string s1,  const Lexicon& m2, const map<string, int>& m1, int size) { //unordered_
 
     if((s1.size() == 0) || (s1 == "")) return "";
 
@@ -492,7 +497,9 @@ string slpNPatternDict::findDictEntries1(string s1,  map<string, int>& m2, map<s
         for(size_t i = s1.size() - j; i > 0; i--){// j0 i = 9:1 rAmaAnand rAmaAnan rAmaAna.. , j1  8:2
             string str = s1.substr(j,i); //&&((str.size() >= 3)|| ( (str.size()==2) && (str[1] != 'a') &&( size< 3) ) || ((str.size() ==1)&&( size< 2) ) ))
             //cout << "str  "<< str << endl;
-            if((m2[str]>0)||(m1[str]>0)) { //cout << "here "<< str << "L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
+            auto inM1 = m1.find(str);
+            //! rAma and rAm are always Dict words, findDictEntries() used to add them to Dict
+            if(m2.contains(str)||(str == "rAma")||(str == "rAm")||(inM1 != m1.end() && inM1->second>0)) { //cout << "here "<< str << "L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
                 //colorFlag = !colorFlag;
                 //string strcolor = color[colorFlag];// << endl;
                 //cout << "str  "<< str << endl;
@@ -506,9 +513,7 @@ string slpNPatternDict::findDictEntries1(string s1,  map<string, int>& m2, map<s
     return ("<font color=\'red\'>" + toDev(s1) + "</font>");
 }
 
-string slpNPatternDict::findDictEntries(string s1,  map<string, int>& m2, map<string, int>& m1, int size) { //unordered_
-    m2["rAma"]++;
-    m2["rAm"]++;
+string slpNPatternDict::findDictEntries(string s1,  const Lexicon& m2, const map<string, int>& m1, int size) { //unordered_
     string s = findDictEntries1(s1,m2,m1, size);
 
     string vowel_dn[]={"आ","इ","ई","उ","ऊ","ऋ","ॠ","ऌ","ॡ","ए","ऐ","ओ","औ"};
@@ -628,7 +633,7 @@ size_t slpNPatternDict::loadDictPatternstoMap(map<string,int >& TPWordsP, map<st
  * \param count
  * \return
  */
-bool slpNPatternDict::getNgramFeaturesinVect(string str,map<string,int>& Dict,vector<bool>& vb,vector<size_t>& vbf, size_t& count){
+bool slpNPatternDict::getNgramFeaturesinVect(string str,const Lexicon& Dict,vector<bool>& vb,vector<size_t>& vbf, size_t& count){
     //! ADDED FOR FEATYRE EXTRACTION
     size_t sz = str.size();
     //cout<<sz<<endl;
@@ -637,7 +642,8 @@ bool slpNPatternDict::getNgramFeaturesinVect(string str,map<string,int>& Dict,ve
         string s1 = str.substr(0,i);
         //cout<<s1<<endl;
         if(s1.size() < 9){
-            if (Dict[s1]>0){vb.push_back(1); vbf.push_back(Dict[s1]);} else {vb.push_back(0); vbf.push_back(0);}
+            int f = Dict.frequency(s1);
+            if (f>0){vb.push_back(1); vbf.push_back(f);} else {vb.push_back(0); vbf.push_back(0);}
             count++;
         }
         //cout << vb[count]<<endl;
@@ -645,10 +651,6 @@ bool slpNPatternDict::getNgramFeaturesinVect(string str,map<string,int>& Dict,ve
     return getNgramFeaturesinVect(str.substr(1,sz-1),Dict,vb,vbf, count);//PWordsP
 }
 
-
-
-
-
 /*!
  * \brief slpNPatternDict::endsWith
  * \param s
@@ -841,141 +843,6 @@ void slpNPatternDict::allignlcsnew(string& str1,string& str2,string& str3){
 }
 
 
-typedef std::vector<int> lengths;
-
-/*
-  The "members" type is used as a sparse set for LCS calculations.
-  Given a sequence, xs, and members, m, then
-  if m[i] is true, xs[i] is in the LCS.
-*/
-typedef std::vector<bool> members;
-
-/*
-  Fill the LCS sequence from the members of a sequence, xs
-  x - an iterator into the sequence xs
-  xs_in_lcs - members of xs
-  lcs - an output results iterator
-*/
-template <typename it, typename ot>
-void slpNPatternDict::set_lcs(it x, members const & xs_in_lcs, ot lcs)
-{
-    for (members::const_iterator xs_in = xs_in_lcs.begin();
-         xs_in != xs_in_lcs.end(); ++xs_in, ++x)
-    {
-        if (*xs_in)
-        {
-            *lcs++ = *x;
-        }
-    }
-}
-
-/*
-  Calculate LCS row lengths given iterator ranges into two sequences.
-  On completion, `lens` holds LCS lengths in the final row.
-*/
-template <typename it>
-void slpNPatternDict::lcs_lens(it xlo, it xhi, it ylo, it yhi, lengths & lens)
-{
-    // Two rows of workspace.
-    // Careful! We need the 1 for the leftmost column.
-    lengths curr(1 + distance(ylo, yhi), 0);
-    lengths prev(curr);
-
-    for (it x = xlo; x != xhi; ++x)
-    {
-        swap(prev, curr);
-        int i = 0;
-        for (it y = ylo; y != yhi; ++y, ++i)
-        {
-            curr[i + 1] = *x == *y
-                    ? prev[i] + 1
-                    : std::max(curr[i], prev[i + 1]);
-        }
-    }
-    swap(lens, curr);
-}
-
-/*
-  Recursive LCS calculation.
-  See Hirschberg for the theory!
-  This is a divide and conquer algorithm.
-  In the recursive case, we split the xrange in two.
-  Then, by calculating lengths of LCSes from the start and end
-  corners of the [xlo, xhi] x [ylo, yhi] grid, we determine where
-  the yrange should be split.
-
-  xo is the origin (element 0) of the xs sequence
-  xlo, xhi is the range of xs being processed
-  ylo, yhi is the range of ys being processed
-  Parameter xs_in_lcs holds the members of xs in the LCS.
-*/
-template <typename it>
-void slpNPatternDict::calculate_lcs(it xo, it xlo, it xhi, it ylo, it yhi, members & xs_in_lcs)
-{
-    unsigned const nx = distance(xlo, xhi);
-
-    if (nx == 0)
-    {
-        // empty range. all done
-    }
-    else if (nx == 1)
-    {
-        // single item in x range.
-        // If it's in the yrange, mark its position in the LCS
-        xs_in_lcs[distance(xo, xlo)] = find(ylo, yhi, *xlo) != yhi;
-    }
-    else
-    {
-        // split the xrange
-        it xmid = xlo + nx / 2;
-
-        // Find LCS lengths at xmid, working from both ends of the range
-        lengths ll_b, ll_e;
-        std::reverse_iterator<it> hix(xhi), midx(xmid), hiy(yhi), loy(ylo);
-
-        lcs_lens(xlo, xmid, ylo, yhi, ll_b);
-        lcs_lens(hix, midx, hiy, loy, ll_e);
-
-        // Find the optimal place to split the y range
-        lengths::const_reverse_iterator e = ll_e.rbegin();
-        int lmax = -1;
-        it y = ylo, ymid = ylo;
-
-        for (lengths::const_iterator b = ll_b.begin();
-             b != ll_b.end(); ++b, ++e)
-        {
-            if (*b + *e > lmax)
-            {
-                lmax = *b + *e;
-                ymid = y;
-            }
-            // Care needed here!
-            // ll_b and ll_e contain one more value than the range [ylo, yhi)
-            // As b and e range over dereferenceable values of ll_b and ll_e,
-            // y ranges over iterator positions [ylo, yhi] _including_ yhi.
-            // That's fine, y is used to split [ylo, yhi), we do not
-            // dereference it. However, y cannot go beyond ++yhi.
-            if (y != yhi)
-            {
-                ++y;
-            }
-        }
-        // Split the range and recurse
-        calculate_lcs(xo, xlo, xmid, ylo, ymid, xs_in_lcs);
-        calculate_lcs(xo, xmid, xhi, ymid, yhi, xs_in_lcs);
-    }
-}
-
-// Calculate an LCS of (xs, ys), returning the result in an_lcs.
-template <typename seq>
-void slpNPatternDict::lcs(seq const & xs, seq const & ys, seq & an_lcs)
-{
-    members xs_in_lcs(xs.size(), false);
-    calculate_lcs(xs.begin(), xs.begin(), xs.end(),
-                  ys.begin(), ys.end(), xs_in_lcs);
-    set_lcs(xs.begin(), xs_in_lcs, back_inserter(an_lcs));
-}
-
 /*!
  * \fn slpNPatternDict::isNonVowel
  * \param ocrp
@@ -1118,8 +985,7 @@ void slpNPatternDict::removeEndCommonSpaces(string& str1, string& str2){
 
 /*
 vector<string> findConfisionsPair(string str1, string str2){
-    string str3;
-    lcs(str1,str2,str3);
+    string str3 = LcsAligner::lcs(str1,str2);
     allignlcsnew(str1,str2,str3);
     removeEndCommonSpaces(str1,str2);
     vector<string> vec = findConfisions(str1,str2);
@@ -1135,8 +1001,7 @@ vector<string> findConfisionsPair(string str1, string str2){
  */
 void slpNPatternDict::appendConfusionsPairs(string str1, string str2, vector<string>& vec){
     str1 = "@" + toslp1(str1) + "#"; str2 = "@" + toslp1(str2) + "#";
-    string str3;
-    lcs(str1,str2,str3);
+    string str3 = LcsAligner::lcs(str1,str2);
     allignlcsnew(str1,str2,str3);
     removeEndCommonSpaces(str1,str2);
     findConfisions(str1,str2,vec);
@@ -1154,8 +1019,7 @@ void slpNPatternDict::appendConfusionsPairs(string str1, string str2, vector<str
  */
 string slpNPatternDict::appendConfusionsPairsNindex(string str1, string str2, vector<string>& vec, vector<int>& vecind){
     str1 = "@" + toslp1(str1) + "#"; str2 = "@" + toslp1(str2) + "#";
-    string str3;
-    lcs(str1,str2,str3);
+    string str3 = LcsAligner::lcs(str1,str2);
     allignlcsnew(str1,str2,str3);
     removeEndCommonSpaces(str1,str2);
     findConfisionsNindex(str1,str2,vec,vecind);
@@ -1259,14 +1123,11 @@ void slpNPatternDict::loadConfusionsFont(vector<string> fileName1,vector<string>
  * \param localFilenameC
  */
 void slpNPatternDict::generateCorrectionPairs(vector<string> &wrong,vector<string> &right,string localFilenameI,string localFilenameC){
-    vector<string> vecpI, vecpC;
-    std::ifstream sIpage(localFilenameI);
-    if (!(sIpage.is_open())) {cout << "cannot open inds/corrected file" <<endl;  return;} // break the while loop for page_no
-    string localstr;
-    map<string, bool> isEngOrNOT;
-    while(sIpage >> localstr) vecpI.push_back(toslp1(localstr)); sIpage.close();
-    std::ifstream sCpage(localFilenameC);
-    while(sCpage >> localstr) { vecpC.push_back(toslp1(localstr)); sIpage.close(); if(hasM40PerAsci(localstr)) isEngOrNOT[toslp1(localstr)] = 1;}
+    //! Both pages come tokenized and in SLP1 from the shared cache, converted once per distinct word
+    bool ok;
+    vector<string> vecpI = PageTokenCache::shared().file(QString::fromStdString(localFilenameI), &ok)->slp1();
+    if (!ok) {cout << "cannot open inds/corrected file" <<endl;  return;} // break the while loop for page_no
+    vector<string> vecpC = PageTokenCache::shared().file(QString::fromStdString(localFilenameC), &ok)->slp1();
     int sizew = wrong.size();
     // if 1st word is wrong generate suggestions
     int vGsz = vecpC.size(), vIsz =  vecpI.size();
@@ -1283,9 +1144,9 @@ void slpNPatternDict::generateCorrectionPairs(vector<string> &wrong,vector<strin
         string s1 = vecpI[t]; //(vGBook[t1].find(s1) != string::npos) || (vGBook[t1] == s1)
         string sC;
         for(int t1 = maxIG(t-win,0); t1 < min(t+win,vGsz); t1++){
-            string sCt1 = vecpC[t1];
-            eddis e;
-            size_t mineditIC = e.editDist(s1,sCt1);
+            const string &sCt1 = vecpC[t1];
+            //! Only a closer word than the nearest so far matters, so the distance is bounded by it
+            size_t mineditIC = eddis::distanceAtMost(s1,sCt1,minedit - 1);
             if(mineditIC < minedit) {minedit = mineditIC; sC = sCt1;   }
             if (sCt1 == s1) {/*WER++;*/ break;}
         }
@@ -1303,14 +1164,10 @@ void slpNPatternDict::generateCorrectionPairs(vector<string> &wrong,vector<strin
  * \param localFilenameC
  */
 void slpNPatternDict::generatePairs(vector<string> &wrong,vector<string> &right,string localFilenameI,string localFilenameC){
-    vector<string> vecpI, vecpC;
-    std::ifstream sIpage(localFilenameI);
-    if (!(sIpage.is_open())) {cout << "cannot open inds/corrected file" <<endl;  return;} // break the while loop for page_no
-    string localstr;
-    map<string, bool> isEngOrNOT;
-    while(sIpage >> localstr) vecpI.push_back(toslp1(localstr)); sIpage.close();
-    std::ifstream sCpage(localFilenameC);
-    while(sCpage >> localstr) { vecpC.push_back(toslp1(localstr)); sIpage.close(); if(hasM40PerAsci(localstr)) isEngOrNOT[toslp1(localstr)] = 1;}
+    bool ok;
+    vector<string> vecpI = PageTokenCache::shared().file(QString::fromStdString(localFilenameI), &ok)->slp1();
+    if (!ok) {cout << "cannot open inds/corrected file" <<endl;  return;} // break the while loop for page_no
+    vector<string> vecpC = PageTokenCache::shared().file(QString::fromStdString(localFilenameC), &ok)->slp1();
     int sizew = wrong.size();
     // if 1st word is wrong generate suggestions
     int vGsz = vecpC.size(), vIsz =  vecpI.size();
@@ -1327,9 +1184,8 @@ void slpNPatternDict::generatePairs(vector<string> &wrong,vector<string> &right,
         string s1 = vecpI[t]; //(vGBook[t1].find(s1) != string::npos) || (vGBook[t1] == s1)
         string sC;
         for(int t1 = maxIG(t-win,0); t1 < min(t+win,vGsz); t1++){
-            string sCt1 = vecpC[t1];
-            eddis e;
-            size_t mineditIC = e.editDist(s1,sCt1);
+            const string &sCt1 = vecpC[t1];
+            size_t mineditIC = eddis::distanceAtMost(s1,sCt1,minedit - 1);
             if(mineditIC < minedit) {minedit = mineditIC; sC = sCt1; minediti = t1;  }
             if (sCt1 == s1) {/*WER++;*/ sC = s1; vecpC[t1] = ""; break;}
             /*size_t szt = sCt1.find(s1); size_t sCt1sz = sCt1.size();
@@ -1352,16 +1208,12 @@ void slpNPatternDict::generatePairs(vector<string> &wrong,vector<string> &right,
  * \param Repy
  */
 void slpNPatternDict::generatePairsIEROCR(string localFilenameI,string localFilenameC, string Rep, string Repy){
-    vector<string> vecpI, vecpC;
     std::ofstream repPair(Rep);
     std::ofstream repPairy(Repy);
-    std::ifstream sIpage(localFilenameI);
-    if (!(sIpage.is_open())) {cout << "cannot open inds/corrected file" <<endl;  return;} // break the while loop for page_no
-    string localstr;
-    map<string, bool> isEngOrNOT;
-    while(sIpage >> localstr) vecpI.push_back(toslp1(localstr)); sIpage.close();
-    std::ifstream sCpage(localFilenameC);
-    while(sCpage >> localstr) { vecpC.push_back(toslp1(localstr)); sIpage.close(); if(hasM40PerAsci(localstr)) isEngOrNOT[toslp1(localstr)] = 1;}
+    bool ok;
+    vector<string> vecpI = PageTokenCache::shared().file(QString::fromStdString(localFilenameI), &ok)->slp1();
+    if (!ok) {cout << "cannot open inds/corrected file" <<endl;  return;} // break the while loop for page_no
+    vector<string> vecpC = PageTokenCache::shared().file(QString::fromStdString(localFilenameC), &ok)->slp1();
     //int sizew = wrong.size();
     // if 1st word is wrong generate suggestions
     int vGsz = vecpC.size(), vIsz =  vecpI.size();
@@ -1378,9 +1230,8 @@ void slpNPatternDict::generatePairsIEROCR(string localFilenameI,string localFile
         string s1 = vecpI[t]; //(vGBook[t1].find(s1) != string::npos) || (vGBook[t1] == s1)
         string sC;
         for(int t1 = maxIG(t-win,0); t1 < min(t+win,vGsz); t1++){
-            string sCt1 = vecpC[t1];
-            eddis e;
-            size_t mineditIC = e.editDist(s1,sCt1);
+            const string &sCt1 = vecpC[t1];
+            size_t mineditIC = eddis::distanceAtMost(s1,sCt1,minedit - 1);
             if(mineditIC < minedit) {minedit = mineditIC; sC = sCt1; minediti = t1;  }
             if (sCt1 == s1) {/*WER++;*/ sC = s1; vecpC[t1] = ""; break;}
             /*size_t szt = sCt1.find(s1); size_t sCt1sz = sCt1.size();
@@ -1392,7 +1243,7 @@ void slpNPatternDict::generatePairsIEROCR(string localFilenameI,string localFile
             repPair << s1 << endl; repPairy << sC << endl;
         }
     }
-    repPairy.close(); repPair.close(); sIpage.close();sCpage.close();
+    repPairy.close(); repPair.close();
 }
 
 
@@ -1404,14 +1255,10 @@ void slpNPatternDict::generatePairsIEROCR(string localFilenameI,string localFile
  * \param localFilenameC
  */
 void slpNPatternDict::generatePairsSpaced(vector<string> &wrong,vector<string> &right,string localFilenameI,string localFilenameC){
-    vector<string> vecpI, vecpC;
-    std::ifstream sIpage(localFilenameI);
-    if (!(sIpage.is_open())) {cout << "cannot open inds/corrected file" <<endl;  return;} // break the while loop for page_no
-    string localstr;
-    map<string, bool> isEngOrNOT;
-    while(sIpage >> localstr) vecpI.push_back(toslp1(localstr)); sIpage.close();
-    std::ifstream sCpage(localFilenameC);
-    while(sCpage >> localstr) { vecpC.push_back(toslp1(localstr)); sIpage.close(); if(hasM40PerAsci(localstr)) isEngOrNOT[toslp1(localstr)] = 1;}
+    bool ok;
+    vector<string> vecpI = PageTokenCache::shared().file(QString::fromStdString(localFilenameI), &ok)->slp1();
+    if (!ok) {cout << "cannot open inds/corrected file" <<endl;  return;} // break the while loop for page_no
+    vector<string> vecpC = PageTokenCache::shared().file(QString::fromStdString(localFilenameC), &ok)->slp1();
     int sizew = wrong.size();
     // if 1st word is wrong generate suggestions
     int vGsz = vecpC.size(), vIsz =  vecpI.size();
@@ -1428,9 +1275,8 @@ void slpNPatternDict::generatePairsSpaced(vector<string> &wrong,vector<string> &
         string s1 = vecpI[t]; //(vGBook[t1].find(s1) != string::npos) || (vGBook[t1] == s1)
         string sC;
         for(int t1 = maxIG(t-win,0); t1 < min(t+win,vGsz); t1++){
-            string sCt1 = vecpC[t1];
-            eddis e;
-            size_t mineditIC = e.editDist(s1,sCt1);
+            const string &sCt1 = vecpC[t1];
+            size_t mineditIC = eddis::distanceAtMost(s1,sCt1,minedit - 1);
             if(mineditIC < minedit) {minedit = mineditIC; sC = sCt1; minediti = t1;  }
             if (sCt1 == s1) {/*WER++;*/ sC = s1; vecpC[t1] = ""; break;}
             /*size_t szt = sCt1.find(s1); size_t sCt1sz = sCt1.size();
@@ -1481,11 +1327,12 @@ void slpNPatternDict::loadTopConfusions(map<string,int>& ConfPmap,map<string, st
     {
         //std::cout << it->first << " " << it->second<< "\n";
         string rule = it->first; istringstream s(rule);string l,r; s>>l; s>>r;
-        //if(TopSuggFreq[l] < it->second){
-        TopSuggFreq[l] = it->second;
-        TopConfusions[l] = r;
+        //! keep the most frequent right side of every left side
+        if(TopSuggFreq[l] < it->second){
+            TopSuggFreq[l] = it->second;
+            TopConfusions[l] = r;
+        }
         TopConfusionsMask[l] ++;
-        //}
         l.clear(); r.clear();
     }
 }
@@ -1546,24 +1393,24 @@ void slpNPatternDict::printConfusionRulesmap(map<string,int>& ConfPmap){
  * \param wCindex
  * \return
  */
-int slpNPatternDict::loadWConfusionsNindex1(string str1,string str2,map<string,int>& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex){
+int slpNPatternDict::loadWConfusionsNindex1(string str1,string str2,const Lexicon& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex){
     string str1New = appendConfusionsPairsNindex(str1,str2,wordConfusions,wCindex);
 
     //!for choosing best out of nearest suggestions:-
     int szold = wordConfusions.size();// more confusions more szold
     //filter confusions:-
     //cout<< str1New << endl;
-    for(size_t t = 0; t<wordConfusions.size(); t++) { if(ConfPmap[wordConfusions[t]]>0) {/*cout << wCindex[t] << " "<< toDev(wordConfusions[t]) << endl;*/} else {wordConfusions.erase(wordConfusions.begin() + t); wCindex.erase(wCindex.begin() + t); t--;}}
+    for(size_t t = 0; t<wordConfusions.size(); t++) { if(ConfPmap.contains(wordConfusions[t])) {/*cout << wCindex[t] << " "<< toDev(wordConfusions[t]) << endl;*/} else {wordConfusions.erase(wordConfusions.begin() + t); wCindex.erase(wCindex.begin() + t); t--;}}
     return 	(szold - wordConfusions.size());//  more confusions are Indsenz OCR Confusions, less will be difference
 }
 
 //! for alligning OCR Pair words
-string slpNPatternDict::loadWConfusionsNindex(string str1,string str2,map<string,int>& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex){
+string slpNPatternDict::loadWConfusionsNindex(string str1,string str2,const Lexicon& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex){
     string str1New = appendConfusionsPairsNindex(str1,str2,wordConfusions,wCindex);
 
     //filter confusions:-
     //cout<< str1New << endl;
-    for(size_t t = 0; t<wordConfusions.size(); t++) { if(ConfPmap[wordConfusions[t]]>0) {/*cout << wCindex[t] << " "<< toDev(wordConfusions[t]) << endl;*/} else {wordConfusions.erase(wordConfusions.begin() + t); wCindex.erase(wCindex.begin() + t); t--;}}
+    for(size_t t = 0; t<wordConfusions.size(); t++) { if(ConfPmap.contains(wordConfusions[t])) {/*cout << wCindex[t] << " "<< toDev(wordConfusions[t]) << endl;*/} else {wordConfusions.erase(wordConfusions.begin() + t); wCindex.erase(wCindex.begin() + t); t--;}}
     return 	str1New;
 }
 
@@ -1680,17 +1527,17 @@ size_t slpNPatternDict::cntSamas(string in, string& out){
  * \param m1
  * \return
  */
-string slpNPatternDict::SamasLR(string s1, map<string, int>& m1) {//, map<string, int>& PWordsNew
+string slpNPatternDict::SamasLR(string s1, const Lexicon& m1) {//, map<string, int>& PWordsNew
 
     if((s1.size() == 0) || (s1 == "")) return "";
-    if((m1[s1]>0)) return " " + s1 + " ";//||PWordsNew[s1]>0
+    if(m1.contains(s1)) return " " + s1 + " ";//||PWordsNew[s1]>0
     //cout << "s1 "<< s1 << endl;
     for(size_t i = s1.size(); i > 0; i --){// DASOAHAM 8
         for(size_t j =0; j < s1.size() - i+1; j++){ // i determinze size of substring
             string str = s1.substr(j,i);//  i = 8, j = 0:0 DASOAHAM ; i = 7, j = 0:1  DASOAHA ASOAHAM..... ;i =1, j = 0:7 D A S O A H A M
             // checking str
             //cout <<"str outside " << str << endl;
-            if((m1[str]>0)) {//||PWordsNew[str]>0 //cout << "here "<< str << " L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
+            if(m1.contains(str)) {//||PWordsNew[str]>0 //cout << "here "<< str << " L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
                 //cout <<"str inside " << str << endl;
                 //cout <<"left "<< s1.substr(0,j) << " nearest "<< searchTrie(s1.substr(0,j)) << endl;
                 //cout <<"right "<< s1.substr(j+i,s1.size()-i) << " nearest "<< searchTrie(s1.substr(j+i,s1.size()-i)) << endl;
@@ -1709,17 +1556,17 @@ string slpNPatternDict::SamasLR(string s1, map<string, int>& m1) {//, map<string
  * \param m1
  * \return
  */
-string slpNPatternDict::SamasRL(string s1, map<string, int>& m1) { //, map<string, int>& PWordsNew
+string slpNPatternDict::SamasRL(string s1, const Lexicon& m1) { //, map<string, int>& PWordsNew
 
     if((s1.size() == 0) || (s1 == "")) return "";
-    if((m1[s1]>0)) return " " + s1 + " ";//||PWordsNew[s1]>0
+    if(m1.contains(s1)) return " " + s1 + " ";//||PWordsNew[s1]>0
     //cout << "s1 "<< s1 << endl;
     for(size_t i = s1.size(); i > 0; i --){// DASOAHAM 8
         for(size_t j =0; j < s1.size() - i+1; j++){ // i determinze size of substring
             //cout << s1.size() << " " << j << endl;
             size_t jd =s1.size() - i - j;
             string str = s1.substr(jd,i);
-            if((m1[str]>0)) {//||PWordsNew[str]>0 //cout << "here "<< str << " L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
+            if(m1.contains(str)) {//||PWordsNew[str]>0 //cout << "here "<< str << " L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
                 //cout <<"str inside " << str << endl;
                 //cout <<"left "<< s1.substr(0,j) << " nearest "<< searchTrie(s1.substr(0,j)) << endl;
                 //cout <<"right "<< s1.substr(j+i,s1.size()-i) << " nearest "<< searchTrie(s1.substr(j+i,s1.size()-i)) << endl;
@@ -1749,7 +1596,7 @@ size_t slpNPatternDict::minsize_t(size_t a,size_t b,bool& FlagLR){
  * \param Dict
  * \return
  */
-string slpNPatternDict::print2OCRSugg(string str1, string str2, map<string,int>& ConfPmap,map<string,int>& Dict){//,map<string,int> SmasWords
+string slpNPatternDict::print2OCRSugg(string str1, string str2, const Lexicon& ConfPmap,const Lexicon& Dict){//,map<string,int> SmasWords
 
     //cout << "generating Pair Sugg for "<<str1<< " ";//<<"suggestion for " << endl
     if((str2 == "") || (str2 == " ") || (str2 == "  ")) {/*cout << "no suggestion" << endl;*/ return "";}
@@ -1799,7 +1646,7 @@ string slpNPatternDict::print2OCRSugg(string str1, string str2, map<string,int>&
  * \param m1
  * \return
  */
-string slpNPatternDict::bestIG(string s1,string s2,map<string, int>& m1){
+string slpNPatternDict::bestIG(string s1,string s2,const Lexicon& m1){
     string s11 = s1; string s21 = s2;
     s1 = toslp1(s1); s2=toslp1(s2);
     string RL1 = SamasRL(s1,m1); string RLout1;
@@ -1850,19 +1697,11 @@ void slpNPatternDict::printSandhiRUles(map<string,vector<string> >& SRules){
  * \param OCRNew
  * \param Dict
  * \return
+ * \sa SandhiChecker::samas()
  */
-bool slpNPatternDict::SamasCheck(string OCRNew, map<string, int>& Dict){
-    if (OCRNew == "") return 1;
-    if (Dict[OCRNew] > 0) return 1;
-    //cout << endl<< "heres " << OCRNew << endl;
-    size_t sz = OCRNew.size();
-
-    for(size_t ts = sz ; ts > 0; ts--){// Bapyopetam Bapy 0 4 10
-        string s1 = OCRNew.substr(0,ts); string rem = OCRNew.substr(ts,sz-ts);
-        //cout << "s1 " << s1 << " rem " << rem << endl;
-        if((Dict[s1] > 0) &&(s1.size() >3) &&(rem.size() >3))/*try && rem.size >3*/ return SamasCheck(rem,Dict); // apply ending with a to aH, ending with consonants say c to ca etc // if not 1st leftstarting with a to remove a
-    }
-    return 0;
+bool slpNPatternDict::SamasCheck(string OCRNew, const Lexicon& Dict){
+    SandhiChecker checker(Dict);
+    return checker.samas(OCRNew);
 }
 
 /*!
@@ -1871,39 +1710,11 @@ bool slpNPatternDict::SamasCheck(string OCRNew, map<string, int>& Dict){
  * \param Dict
  * \param SRules
  * \return
+ * \sa SandhiChecker::sandhi()
  */
-bool slpNPatternDict::SandhiCheck(string OCRNew, map<string, int>& Dict,map<string, vector<string>>& SRules){
-    // Sandhi Check
-    //if (OCRNew == "") return 1;
-    if (Dict[OCRNew] > 0) return 1;
-    //cout << endl<< "hereS " << OCRNew << endl;
-    size_t sz = OCRNew.size();
-    for(size_t ts = sz ; ts > 0; ts--){// Bapyopetam Bapy 0 4 10
-        string s1 = OCRNew.substr(0,ts); string rem = OCRNew.substr(ts,sz-ts);
-
-        //cout << "S1 " << s1 << " " << ts << " " << sz  << endl;
-        if( (s1.size() >3)&&(rem.size() >2)){ //as r of S -> l+r will be added to rem
-            //cout << "s1 " << s1 << endl;
-            // applying o -> a u Sandhi rules i.e. k =1 for o, k = 2 for yu in yu -> yu -> i u | I u |
-            size_t k = 1;
-            vector<string> v = SRules[s1.substr(ts-k,k)];
-            size_t vsz = v.size();
-            //cout << " vsz " << vsz << endl;
-            if(vsz > 0) {
-                bool SandhiFlag = 0;
-                for(size_t vt =0; vt < vsz; vt++) {
-                    istringstream s(v[vt]); string l,r; s>>l; s>>r;
-                    string s1new = s1.substr(0,s1.size()-1)+l;
-                    if((Dict[s1new] > 0) ){
-                        //cout << "found " << s1new << endl;
-                        SandhiFlag = (SandhiFlag | SamasCheck(r+rem,Dict));
-                    } else { SandhiFlag = (SandhiFlag | (SandhiCheck(s1new,Dict,SRules) & SamasCheck(r+rem,Dict)) | (SamasCheck(s1new,Dict) & SamasCheck(r+rem,Dict)));} //else
-                }// for
-                return  SandhiFlag;
-            }// if vsz >0
-        }
-    }
-    return 0;
+bool slpNPatternDict::SandhiCheck(string OCRNew, const Lexicon& Dict,map<string, vector<string>>& SRules){
+    SandhiChecker checker(Dict, SRules);
+    return checker.sandhi(OCRNew);
 }
 
 
@@ -1912,35 +1723,24 @@ bool slpNPatternDict::SandhiCheck(string OCRNew, map<string, int>& Dict,map<stri
 // OCR Word = BApyopetam
 /*!
  * \fn slpNPatternDict::generatePossibilitesNsuggest
+ * \brief Suggests the first rewrite of an OCR word by one confusion rule that is a valid samas or sandhi.
+ * \details The rewrites are tried in descending rule frequency, then the word itself.
  * \param OCRWord
- * \param TopConfusions
- * \param TopConfusionsMask
+ * \param rewriter Confusion rules compiled from ConfPmap
  * \param Dict
  * \param SRules
- * \return
- */
-string slpNPatternDict::generatePossibilitesNsuggest(string OCRWord,map<string,string>& TopConfusions,map<string,int>& TopConfusionsMask,map<string, int>& Dict, map<string, vector<string>>& SRules){
-    string OCRWordOrig = OCRWord;
-    size_t sz = OCRWord.size() + 2;
-    // one confusion one sandhi at a time
-    size_t tSandhi = 0;
-    for( size_t t2 =1; t2 < 4 ; t2++){
-        for( size_t t =0; t <sz- t2 + 1 ; t++){
-            OCRWord = "@" + OCRWordOrig + "#";
-            // apply a confusion
-            string OCRNew = OCRWord;
-            //cout << "OCRWord " << OCRWord << endl;
-            size_t tc = t; while( tc < sz - t2 + 1) {  string s1 = OCRWord.substr(tc,t2); //cout << s1<< " "<< tc << " " << t2 << endl;
-                if (TopConfusionsMask[s1] > 0) { OCRNew = OCRWord;  OCRNew.replace(tc,s1.size(),TopConfusions[s1]);  t = tc; break; } else tc++; }
-            //cout << "OCRWord1 " << OCRNew << endl;
-            // apply Samas s
-            OCRNew = OCRNew.substr(0,OCRNew.size()-1); OCRNew = OCRNew.substr(1,OCRNew.size()-1);
-            //cout << "OCRWord2 " << OCRNew << endl;
-            if (SamasCheck(OCRNew, Dict)) return OCRNew;
-            // apply Sandhi S Rules
-            if (SandhiCheck(OCRNew, Dict,SRules)) return OCRNew;
-        }
+ * \return The suggestion, or "" if none is valid
+ * \sa ConfusionRewriter::rewrites()
+ */
+string slpNPatternDict::generatePossibilitesNsuggest(string OCRWord,const ConfusionRewriter& rewriter,const Lexicon& Dict, map<string, vector<string>>& SRules){
+    //! The candidates differ in one confusion only, so they share most of the words the checks look at
+    SandhiChecker checker(Dict, SRules);
+    //! As many candidates as the old scan over substrings of length 1 to 3 at every offset could build
+    size_t k = 3 * (OCRWord.size() + 2);
+    for (const ConfusionRewriter::Rewrite& rewrite : rewriter.rewrites(OCRWord, k, 4 * k)) {
+        if (checker.samas(rewrite.word) || checker.sandhi(rewrite.word)) return rewrite.word;
     }
+    if (checker.samas(OCRWord) || checker.sandhi(OCRWord)) return OCRWord;
     return "";
 }
 
@@ -25,6 +25,9 @@
 //#include "toFromslp1.h"
 using namespace std;
 
+class ConfusionRewriter;
+class Lexicon;
+
 class slpNPatternDict{
 public:
     //variables
@@ -66,9 +69,9 @@ public:
 
     void loadMapPWords(vector<string>& vGBook,vector<string>& vIBook, map<string,int>& PWords);
 
-    string findDictEntries1(string s1,  map<string, int>& m2, map<string, int>& m1, int size);
+    string findDictEntries1(string s1,  const Lexicon& m2, const map<string, int>& m1, int size);
 
-    string findDictEntries(string s1,  map<string, int>& m2, map<string, int>& m1, int size);
+    string findDictEntries(string s1,  const Lexicon& m2, const map<string, int>& m1, int size);
 
     bool hasM40PerAsci(string word1);
 
@@ -80,7 +83,7 @@ public:
 
     size_t loadDictPatternstoMap(map<string,int >& TPWordsP, map<string,int >& PWords,size_t& count6);
 
-    bool getNgramFeaturesinVect(string str,map<string,int>& Dict,vector<bool>& vb,vector<size_t>& vbf, size_t& count);
+    bool getNgramFeaturesinVect(string str,const Lexicon& Dict,vector<bool>& vb,vector<size_t>& vbf, size_t& count);
 
     bool endsWith(const std::string& s, const std::string& suffix);
 
@@ -100,56 +103,6 @@ public:
 
     void allignlcsnew(string& str1,string& str2,string& str3);
 
-
-    // typedefs
-    typedef std::vector<int> lengths;
-
-    /*
-      The "members" type is used as a sparse set for LCS calculations.
-      Given a sequence, xs, and members, m, then
-      if m[i] is true, xs[i] is in the LCS.
-    */
-    typedef std::vector<bool> members;
-
-    /*
-      Fill the LCS sequence from the members of a sequence, xs
-      x - an iterator into the sequence xs
-      xs_in_lcs - members of xs
-      lcs - an output results iterator
-    */
-
-    template <typename it, typename ot>
-    void set_lcs(it x, members const & xs_in_lcs, ot lcs);
-
-
-    /*
-      Calculate LCS row lengths given iterator ranges into two sequences.
-      On completion, `lens` holds LCS lengths in the final row.
-    */
-    template <typename it>
-    void lcs_lens(it xlo, it xhi, it ylo, it yhi, lengths & lens);
-
-    /*
-      Recursive LCS calculation.
-      See Hirschberg for the theory!
-      This is a divide and conquer algorithm.
-      In the recursive case, we split the xrange in two.
-      Then, by calculating lengths of LCSes from the start and end
-      corners of the [xlo, xhi] x [ylo, yhi] grid, we determine where
-      the yrange should be split.
-
-      xo is the origin (element 0) of the xs sequence
-      xlo, xhi is the range of xs being processed
-      ylo, yhi is the range of ys being processed
-      Parameter xs_in_lcs holds the members of xs in the LCS.
-    */
-    template <typename it>
-    void calculate_lcs(it xo, it xlo, it xhi, it ylo, it yhi, members & xs_in_lcs);
-
-    // Calculate an LCS of (xs, ys), returning the result in an_lcs.
-    template <typename seq>
-    void lcs(seq const & xs, seq const & ys, seq & an_lcs);
-
     bool isNonVowel(string ocrp);
 
     string removeSpaces(string input);
@@ -190,9 +143,9 @@ public:
 
     void printConfusionRulesmap(map<string,int>& ConfPmap);
 
-    int loadWConfusionsNindex1(string str1,string str2,map<string,int>& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex);
+    int loadWConfusionsNindex1(string str1,string str2,const Lexicon& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex);
 
-    string loadWConfusionsNindex(string str1,string str2,map<string,int>& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex);
+    string loadWConfusionsNindex(string str1,string str2,const Lexicon& ConfPmap,vector<string>& wordConfusions,vector<int>& wCindex);
 
     void replacestrcnf(string& newstring,size_t i,string cnfn);
 
@@ -204,28 +157,28 @@ public:
 
     size_t cntSamas(string in, string& out);
 
-    string SamasLR(string s1, map<string, int>& m1);
+    string SamasLR(string s1, const Lexicon& m1);
 
-    string SamasRL(string s1, map<string, int>& m1);
+    string SamasRL(string s1, const Lexicon& m1);
 
     size_t minsize_t(size_t a,size_t b,bool& FlagLR);
 
-    string print2OCRSugg(string str1, string str2, map<string,int>& ConfPmap,map<string,int>& Dict);
+    string print2OCRSugg(string str1, string str2, const Lexicon& ConfPmap,const Lexicon& Dict);
 
-    string bestIG(string s1,string s2,map<string, int>& m1);
+    string bestIG(string s1,string s2,const Lexicon& m1);
 
     void loadSandhiRules(string fileName, map<string, vector<string>>& SRules);
 
     void printSandhiRUles(map<string,vector<string> >& SRules);
 
-    bool SamasCheck(string OCRNew, map<string, int>& Dict);
+    bool SamasCheck(string OCRNew, const Lexicon& Dict);
 
-    bool SandhiCheck(string OCRNew, map<string, int>& Dict,map<string, vector<string>>& SRules);
+    bool SandhiCheck(string OCRNew, const Lexicon& Dict,map<string, vector<string>>& SRules);
 
     //Sandhi rules
 
     // OCR Word = BApyopetam
-    string generatePossibilitesNsuggest(string OCRWord,map<string,string>& TopConfusions,map<string,int>& TopConfusionsMask,map<string, int>& Dict, map<string, vector<string>>& SRules);
+    string generatePossibilitesNsuggest(string OCRWord,const ConfusionRewriter& rewriter,const Lexicon& Dict, map<string, vector<string>>& SRules);
 
 };
 
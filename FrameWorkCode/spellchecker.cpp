@@ -0,0 +1,99 @@
+/*!
+ * \class SpellChecker
+ * \brief Sorts the words of a page into the colours of the Spell Check action and writes the coloured html.
+ * \details A word that is mostly ASCII is left as it is. Otherwise, by its SLP1 form, a word in GBook is shown
+ * uncoloured, a word in PWords gray, a word that is not in Dict but was replaced from the right-click menu purple as
+ * its replacement, and every other word is coloured part by part by slpNPatternDict::findDictEntries().
+ * \details The checker only reads its tables, so pages can be checked from several threads at once. The action counts
+ * the GBook words of the page into PWords through the inBook callback of pageHtml(); the batch report and the
+ * benchmark leave PWords alone.
+ * \sa MainWindow::on_actionSpell_Check_triggered(), BatchRunner::spellCheckReport()
+ */
+#include "spellchecker.h"
+
+/*!
+ * \fn SpellChecker::SpellChecker
+ * \brief Constructor
+ * \param tables Tables the words are looked up in, which must live as long as the checker
+ */
+SpellChecker::SpellChecker(const Tables &tables)
+{
+    this->mTables = tables;
+}
+
+/*!
+ * \fn SpellChecker::classify
+ * \param form Word of a page, from PageTokenCache
+ * \return Colour the Spell Check action gives the word
+ */
+SpellChecker::Colour SpellChecker::classify(const PageTokenCache::Form &form) const
+{
+    const std::string &word = form.slp1;
+    if (form.ascii)
+        return Ascii;
+    if (mTables.GBook->contains(word))
+        return Book;
+    auto seen = mTables.PWords->find(word);
+    if (seen != mTables.PWords->end() && seen->second > 0)
+        return Seen;
+    auto pair = mTables.CPair->find(word);
+    if (!mTables.Dict->contains(word) && pair != mTables.CPair->end() && !pair->second.empty())
+        return Pair;
+    return Unknown;
+}
+
+/*!
+ * \fn SpellChecker::html
+ * \param form Word of a page
+ * \param colour classify() of the word
+ * \param slnp Converter of the calling thread
+ * \return The word as the Spell Check action shows it
+ */
+std::string SpellChecker::html(const PageTokenCache::Form &form, Colour colour, slpNPatternDict &slnp) const
+{
+    const std::string &word = form.slp1;
+    switch (colour) {
+    case Ascii:
+        return form.text;
+    case Book:
+        return form.dev();
+    case Seen:
+        return "<font color=\'gray\'>" + form.dev() + "</font>";
+    case Pair:
+        return "<font color=\'purple\'>" + slnp.toDev(mTables.CPair->at(word)) + "</font>";
+    case Unknown:
+        break;
+    }
+    std::string wordNext = slnp.findDictEntries(word, *mTables.Dict, *mTables.PWords, word.size());
+    wordNext = slnp.find_and_replace_oddInstancesblue(wordNext);
+    return slnp.find_and_replace_oddInstancesorange(wordNext);
+}
+
+/*!
+ * \fn SpellChecker::pageHtml
+ * \brief Colours every word of a page, one line of html per line of the page.
+ * \param page Tokens of the page, from PageTokenCache
+ * \param slnp Converter of the calling thread
+ * \param inBook Called with the SLP1 form of every GBook word as soon as it is met, e.g. to count it into PWords
+ * \return The html the Spell Check action sets on the page
+ */
+std::string SpellChecker::pageHtml(const PageTokenCache::Page &page, slpNPatternDict &slnp,
+                                   const std::function<void(const std::string &)> &inBook) const
+{
+    const std::vector<PageTokenCache::Token> &tokens = page.tokens;
+    std::string strHtml = "<html><body>";
+    size_t next = 0;
+    for (unsigned int line = 0; line < page.lines; line++) {
+        for (; next < tokens.size() && tokens[next].line == line; next++) {
+            const PageTokenCache::Form &form = *tokens[next].form;
+            Colour colour = classify(form);
+            strHtml += html(form, colour, slnp);
+            strHtml += " ";
+            if (colour == Book && inBook)
+                inBook(form.slp1);
+        }
+        strHtml += "<br>";
+    }
+    strHtml += "</body></html>";
+    return strHtml;
+}
@@ -0,0 +1,42 @@
+#ifndef SPELLCHECKER_H
+#define SPELLCHECKER_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include "lexicon.h"
+#include "pagetokencache.h"
+#include "slpNPatternDict.h"
+
+class SpellChecker
+{
+public:
+    //! How the Spell Check action shows a word
+    enum Colour {
+        Ascii,      //! Mostly latin text, left as it is
+        Book,       //! Found in GBook, shown uncoloured
+        Seen,       //! Found in PWords, shown gray
+        Pair,       //! Not in Dict but corrected earlier in the session, shown purple as its correction
+        Unknown     //! Coloured by slpNPatternDict::findDictEntries()
+    };
+
+    //! The tables the words are looked up in, owned by the caller and only read
+    struct Tables {
+        const Lexicon *GBook;
+        const Lexicon *Dict;
+        const std::map<std::string, int> *PWords;
+        const std::map<std::string, std::string> *CPair;   //! Correction pairs of the session, by SLP1 word
+    };
+
+    explicit SpellChecker(const Tables &tables);
+
+    Colour classify(const PageTokenCache::Form &form) const;
+    std::string html(const PageTokenCache::Form &form, Colour colour, slpNPatternDict &slnp) const;
+    std::string pageHtml(const PageTokenCache::Page &page, slpNPatternDict &slnp,
+                         const std::function<void(const std::string &)> &inBook = nullptr) const;
+
+private:
+    Tables mTables;
+};
+
+#endif // SPELLCHECKER_H
@@ -0,0 +1,191 @@
+/*!
+ * \class SubstringIndex
+ * \brief Index of every substring of a vocabulary, with the number of times it occurs in the vocabulary words.
+ * \details The vocabulary is kept as a generalized suffix automaton: every substring of every word is a path from the
+ * root, and the substrings that end at the same positions share one state. The automaton has fewer than twice as many
+ * states as the vocabulary has letters, where the pattern tries of loadPWordsPatternstoTrie() had a node, with its own
+ * copy of the string, for every prefix of every suffix of every word.
+ * \details contains() and frequency() walk one transition per letter of the query. frequency() counts every position a
+ * substring occurs at in every word once, as the pattern maps of slpNPatternDict::loadDictPatternstoMap() did.
+ * \details trieEditDis searches the automaton for the substring nearest to a word by edit distance. The transitions
+ * are kept in the order of the trie's std::map, so the search visits the substrings in the order it did in the trie
+ * and finds the same ones.
+ * \sa trieEditDis::loadPWordsPatternstoTrie(), trieEditDis::searchTrie1()
+ */
+#include "substringindex.h"
+#include <algorithm>
+
+/*!
+ * \fn SubstringIndex::SubstringIndex
+ * \brief Constructor of an empty index
+ */
+SubstringIndex::SubstringIndex()
+{
+    clear();
+}
+
+/*!
+ * \fn SubstringIndex::clear
+ * \brief Drops every word.
+ */
+void SubstringIndex::clear()
+{
+    mStates.assign(1, State());
+}
+
+/*!
+ * \fn SubstringIndex::find
+ * \return Target of the transition of state by c, -1 if there is none
+ */
+int SubstringIndex::find(int state, char c) const
+{
+    const std::vector<std::pair<char, int>> &next = mStates[state].next;
+    auto it = std::lower_bound(next.begin(), next.end(), std::make_pair(c, -1));
+    return (it != next.end() && it->first == c) ? it->second : -1;
+}
+
+/*!
+ * \fn SubstringIndex::next
+ * \return State reached from state by c, -1 if no substring continues that way
+ */
+int SubstringIndex::next(int state, char c) const
+{
+    return find(state, c);
+}
+
+/*!
+ * \fn SubstringIndex::setNext
+ * \brief Adds or redirects the transition of state by c.
+ */
+void SubstringIndex::setNext(int state, char c, int target)
+{
+    std::vector<std::pair<char, int>> &next = mStates[state].next;
+    auto it = std::lower_bound(next.begin(), next.end(), std::make_pair(c, -1));
+    if (it != next.end() && it->first == c)
+        it->second = target;
+    else
+        next.insert(it, std::make_pair(c, target));
+}
+
+/*!
+ * \fn SubstringIndex::clone
+ * \return A copy of state q with the given length and no positions of its own
+ */
+int SubstringIndex::clone(int q, int len)
+{
+    State copy = mStates[q];
+    copy.len = len;
+    copy.own = 0;
+    mStates.push_back(copy);
+    return mStates.size() - 1;
+}
+
+/*!
+ * \fn SubstringIndex::extend
+ * \brief Appends c to the word whose prefix so far ends in last.
+ * \return State of the prefix with c
+ */
+int SubstringIndex::extend(int last, char c)
+{
+    int q = find(last, c);
+    if (q >= 0) {
+        //! The prefix is already a substring of an earlier word
+        if (mStates[q].len == mStates[last].len + 1)
+            return q;
+        int copy = clone(q, mStates[last].len + 1);
+        for (int p = last; p >= 0 && find(p, c) == q; p = mStates[p].link)
+            setNext(p, c, copy);
+        mStates[q].link = copy;
+        return copy;
+    }
+
+    int cur = mStates.size();
+    mStates.push_back(State());
+    mStates[cur].len = mStates[last].len + 1;
+    int p = last;
+    for (; p >= 0 && find(p, c) < 0; p = mStates[p].link)
+        setNext(p, c, cur);
+    if (p < 0) {
+        mStates[cur].link = 0;
+        return cur;
+    }
+    q = find(p, c);
+    if (mStates[p].len + 1 == mStates[q].len) {
+        mStates[cur].link = q;
+        return cur;
+    }
+    int copy = clone(q, mStates[p].len + 1);
+    for (; p >= 0 && find(p, c) == q; p = mStates[p].link)
+        setNext(p, c, copy);
+    mStates[q].link = copy;
+    mStates[cur].link = copy;
+    return cur;
+}
+
+/*!
+ * \fn SubstringIndex::count
+ * \brief Sums the positions of every state into the states its suffix links lead to, longest states first.
+ */
+void SubstringIndex::count()
+{
+    std::vector<int> order(mStates.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [this](int a, int b) { return mStates[a].len > mStates[b].len; });
+    for (State &state : mStates)
+        state.count = state.own;
+    for (int s : order)
+        if (mStates[s].link >= 0)
+            mStates[mStates[s].link].count += mStates[s].count;
+}
+
+/*!
+ * \fn SubstringIndex::add
+ * \brief Adds the words of a frequency table, e.g. PWords or GBook.
+ * \param words Only the keys are used
+ * \return Number of substring positions added, the count loadPWordsPatternstoTrie() returned
+ */
+size_t SubstringIndex::add(const std::map<std::string, int> &words)
+{
+    size_t positions = 0;
+    for (const auto &word : words) {
+        const std::string &w = word.first;
+        if (w.empty())
+            continue;
+        int last = 0;
+        for (char c : w) {
+            last = extend(last, c);
+            mStates[last].own++;
+        }
+        //! Every prefix of every suffix, the empty one included
+        positions += w.size() * (w.size() + 3) / 2;
+    }
+    count();
+    return positions;
+}
+
+/*!
+ * \fn SubstringIndex::contains
+ * \return true if s is a substring of a word of the index
+ */
+bool SubstringIndex::contains(const std::string &s) const
+{
+    int state = 0;
+    for (char c : s)
+        if ((state = find(state, c)) < 0)
+            return false;
+    return !empty();
+}
+
+/*!
+ * \fn SubstringIndex::frequency
+ * \return Number of positions s occurs at in the words of the index, 0 if it is no substring
+ */
+int SubstringIndex::frequency(const std::string &s) const
+{
+    int state = 0;
+    for (char c : s)
+        if ((state = find(state, c)) < 0)
+            return 0;
+    return state == 0 ? 0 : mStates[state].count;
+}
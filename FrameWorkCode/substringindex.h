@@ -0,0 +1,45 @@
+#ifndef SUBSTRINGINDEX_H
+#define SUBSTRINGINDEX_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class SubstringIndex
+{
+public:
+    SubstringIndex();
+
+    size_t add(const std::map<std::string, int> &words);
+    void clear();
+    bool empty() const { return mStates.size() == 1; }
+    size_t states() const { return mStates.size(); }
+
+    bool contains(const std::string &s) const;
+    int frequency(const std::string &s) const;
+
+    //! The automaton, for searches that walk it like a trie: every path from root() spells a distinct substring
+    int root() const { return 0; }
+    int next(int state, char c) const;
+    const std::vector<std::pair<char, int>> &transitions(int state) const { return mStates[state].next; }
+
+private:
+    struct State {
+        int len = 0;                                //! Length of the longest substring ending in this state
+        int link = -1;                              //! Suffix link
+        int own = 0;                                //! Word positions that end exactly in this state
+        int count = 0;                              //! Occurrences of the substrings of this state in all words
+        std::vector<std::pair<char, int>> next;     //! Transitions sorted by char, as std::map<char, ...> orders them
+    };
+
+    std::vector<State> mStates;
+
+    int find(int state, char c) const;
+    void setNext(int state, char c, int target);
+    int clone(int q, int len);
+    int extend(int last, char c);
+    void count();
+};
+
+#endif // SUBSTRINGINDEX_H
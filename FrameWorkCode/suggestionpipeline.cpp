@@ -0,0 +1,441 @@
+/*!
+ * \class SuggestionPipeline
+ * \brief The sources of the right click suggestion menu as a list of named stages, each of which can be turned off,
+ * given a time budget and tuned by its latency.
+ * \details MainWindow::mousePressEvent() asked every source in turn for the word under the cursor, printed what each
+ * found and ranked the words they agreed on. Three of them, the nearest confirming word and the pair suggestion by the
+ * font confusions and the sandhi rewrites, were computed and then dropped, and the OCR sources were asked even when
+ * the project configuration did not count them. Here the sources are stages of a table in the constructor:
+ * \details aligned         - trieEditDis::print5NearestEntries() of TGBookP; no menu is shown without them
+ * \details cpairs          - up to six corrections of the word in CPairs
+ * \details primary_ocr     - the nearest word of the primary OCR, trieEditDis::print1OCRNearestEntries()
+ * \details secondary_ocr   - the word of the secondary OCR nearest by the confusions, slpNPatternDict::loadWConfusionsNindex1()
+ * \details pwords          - the same for the words of the proofread pages
+ * \details confusion_pair  - slpNPatternDict::print2OCRSugg() of the word and its first aligned word
+ * \details samas           - trieEditDis::SamasBreakLRCorrect()
+ * \details font_confirming - secondary_ocr by the font confusions, off by default
+ * \details font_pair       - confusion_pair of the word in SLP1, off by default
+ * \details sandhi          - slpNPatternDict::generatePossibilitesNsuggest(), off by default
+ * \details A stage that is off, or is an OCR stage while the project does not count them, is not run at all. Every
+ * stage gets a budget in milliseconds: cpairs, primary_ocr, secondary_ocr, pwords and font_confirming loop over
+ * candidates and stop at it with what they have. For confusion_pair, samas, font_pair and sandhi, which make one word
+ * in a single call, the budget is advisory only: their runs that took longer are counted in stats(), as are those of
+ * every stage. The words a stage found for a word are cached until invalidate() is
+ * called, which MainWindow does whenever the tables change, except for the stages that read tables the save workers
+ * change in their own thread. A run stopped at the budget is not cached.
+ * \details Each suggestion counts one vote per stage; they are ranked by their edit distance to the word, then
+ * alphabetically, as the menu was. Stages are set from the Suggestions group of the settings, e.g.
+ * "sandhi/enabled" and "samas/budgetMs", so that every installation can keep the sources worth their cost for its
+ * language.
+ * \details The pipeline is used from the GUI thread only.
+ * \sa MainWindow::mousePressEvent(), Tracer
+ */
+#include "suggestionpipeline.h"
+#include "eddis.h"
+#include "pagetokencache.h"
+#include "tracer.h"
+#include <QSettings>
+#include <algorithm>
+
+/*!
+ * \fn SuggestionPipeline::SuggestionPipeline
+ * \brief Constructor
+ * \param sources Tables the stages read, which must live as long as the pipeline
+ * \param maxCachedWords Words cached per stage before its cache is started over
+ */
+SuggestionPipeline::SuggestionPipeline(const Sources &sources, int maxCachedWords)
+{
+    this->mSources = sources;
+    this->mMaxCachedWords = maxCachedWords;
+
+    struct Spec {
+        const char *name;
+        bool enabled, ocrSource, votes, cached;
+        int budgetMs;
+        Run run;
+    };
+    const Spec specs[] = {
+        { "aligned",         true,  false, false, true,  0,  &SuggestionPipeline::aligned },
+        { "cpairs",          true,  false, true,  false, 20, &SuggestionPipeline::cpairs },
+        { "primary_ocr",     true,  true,  true,  true,  50, &SuggestionPipeline::primaryOcr },
+        { "secondary_ocr",   true,  true,  true,  true,  50, &SuggestionPipeline::secondaryOcr },
+        { "pwords",          true,  true,  true,  true,  50, &SuggestionPipeline::pwords },
+        { "confusion_pair",  true,  true,  true,  true,  50, &SuggestionPipeline::confusionPair },
+        { "samas",           true,  true,  true,  true,  50, &SuggestionPipeline::samas },
+        { "font_confirming", false, true,  true,  true,  50, &SuggestionPipeline::fontConfirming },
+        { "font_pair",       false, true,  true,  true,  50, &SuggestionPipeline::fontPair },
+        { "sandhi",          false, true,  true,  true,  50, &SuggestionPipeline::sandhi },
+    };
+    for (const Spec &spec : specs) {
+        Stage stage;
+        stage.stats.name = spec.name;
+        stage.stats.enabled = spec.enabled;
+        stage.stats.budgetMs = spec.budgetMs;
+        stage.ocrSource = spec.ocrSource;
+        stage.votes = spec.votes;
+        stage.cached = spec.cached;
+        stage.run = spec.run;
+        mStages.push_back(stage);
+    }
+}
+
+/*!
+ * \fn SuggestionPipeline::suggest
+ * \brief Asks every stage that is on for suggestions for a word and ranks them.
+ * \param selected Word under the cursor in UTF-8
+ * \param ocrSources Whether the OCR stages count, see Project::get_configuration()
+ * \param aligned Set to false if the aligned stage found nothing, in which case no menu is shown
+ * \return Suggestions, nearest first
+ */
+std::vector<SuggestionPipeline::Suggestion> SuggestionPipeline::suggest(const std::string &selected, bool ocrSources,
+                                                                        bool *aligned)
+{
+    TRACE_SCOPE("SuggestionPipeline::suggest");
+    std::vector<Suggestion> out;
+    *aligned = false;
+    if (selected.empty())
+        return out;
+
+    PageTokenCache &tokenCache = PageTokenCache::shared();
+    Request request;
+    request.text = selected;
+    request.slp1 = tokenCache.slp1(selected);
+    runStage(mStages[0], request, request.aligned);
+    *aligned = !request.aligned.empty();
+    if (!*aligned)
+        return out;
+
+    std::map<std::string, int> votes;
+    std::vector<std::string> words;
+    for (size_t i = 1; i < mStages.size(); i++) {
+        Stage &stage = mStages[i];
+        if (!stage.stats.enabled || (stage.ocrSource && !ocrSources))
+            continue;
+        runStage(stage, request, words);
+        for (const std::string &word : words)
+            if (!word.empty())
+                votes[word]++;
+    }
+
+    eddis e;
+    for (const auto &vote : votes)
+        out.push_back({ vote.first, vote.second, e.editDist(tokenCache.slp1(vote.first), request.slp1) });
+    std::sort(out.begin(), out.end(), [](const Suggestion &a, const Suggestion &b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.word < b.word;
+    });
+    return out;
+}
+
+/*!
+ * \fn SuggestionPipeline::runStage
+ * \brief Runs a stage for a request, or takes its words from the cache, and counts it in the stats.
+ * \param out Set to the words the stage found
+ */
+void SuggestionPipeline::runStage(Stage &stage, Request &request, std::vector<std::string> &out)
+{
+    StageStats &stats = stage.stats;
+    if (stage.cached) {
+        auto hit = stage.cache.find(request.text);
+        if (hit != stage.cache.end()) {
+            out = hit->second;
+            stats.cacheHits++;
+            stats.words += out.size();
+            return;
+        }
+    }
+
+    out.clear();
+    Budget budget;
+    budget.ns = qint64(stats.budgetMs) * 1000000;
+    qint64 start = Tracer::isEnabled() ? Tracer::now() : -1;
+    budget.clock.start();
+    bool complete = (this->*stage.run)(request, budget, out);
+    qint64 ns = budget.clock.nsecsElapsed();
+    if (start >= 0)
+        Tracer::record(stats.name, start, ns);
+
+    stats.runs++;
+    stats.totalNs += ns;
+    stats.maxNs = std::max(stats.maxNs, ns);
+    stats.words += out.size();
+    if (budget.ns > 0 && ns > budget.ns)
+        stats.overBudget++;
+    if (!complete) {
+        stats.cutShort++;
+        return;
+    }
+    if (stage.cached) {
+        //! Right clicks come back to the few words being corrected, so starting over loses little
+        if (int(stage.cache.size()) >= mMaxCachedWords)
+            stage.cache.clear();
+        stage.cache.emplace(request.text, out);
+    }
+}
+
+/*!
+ * \fn SuggestionPipeline::find
+ * \return The stage with the name, nullptr if there is none
+ */
+SuggestionPipeline::Stage *SuggestionPipeline::find(const QString &name)
+{
+    for (Stage &stage : mStages)
+        if (name == QLatin1String(stage.stats.name))
+            return &stage;
+    return nullptr;
+}
+
+/*!
+ * \fn SuggestionPipeline::setEnabled
+ * \brief Turns a stage on or off. The aligned stage can't be turned off, the menu depends on it.
+ * \return False if there is no such stage or it can't be turned off
+ */
+bool SuggestionPipeline::setEnabled(const QString &stage, bool enabled)
+{
+    Stage *found = find(stage);
+    if (!found || !found->votes)
+        return false;
+    found->stats.enabled = enabled;
+    return true;
+}
+
+/*!
+ * \fn SuggestionPipeline::setBudget
+ * \brief Sets the time a stage may take per word.
+ * \param budgetMs Milliseconds, 0 for no budget
+ * \return False if there is no such stage
+ */
+bool SuggestionPipeline::setBudget(const QString &stage, int budgetMs)
+{
+    Stage *found = find(stage);
+    if (!found)
+        return false;
+    found->stats.budgetMs = std::max(0, budgetMs);
+    return true;
+}
+
+/*!
+ * \fn SuggestionPipeline::loadSettings
+ * \brief Sets the stages from the Suggestions group, "<stage>/enabled" and "<stage>/budgetMs". Stages without an
+ * entry keep their setting.
+ * \param settings
+ */
+void SuggestionPipeline::loadSettings(QSettings &settings)
+{
+    settings.beginGroup("Suggestions");
+    for (Stage &stage : mStages) {
+        QString name = QLatin1String(stage.stats.name);
+        if (stage.votes)
+            stage.stats.enabled = settings.value(name + "/enabled", stage.stats.enabled).toBool();
+        stage.stats.budgetMs = std::max(0, settings.value(name + "/budgetMs", stage.stats.budgetMs).toInt());
+    }
+    settings.endGroup();
+}
+
+/*!
+ * \fn SuggestionPipeline::stats
+ * \return Every stage in the order they are run, with its settings and usage
+ */
+std::vector<SuggestionPipeline::StageStats> SuggestionPipeline::stats() const
+{
+    std::vector<StageStats> out;
+    for (const Stage &stage : mStages)
+        out.push_back(stage.stats);
+    return out;
+}
+
+/*!
+ * \fn SuggestionPipeline::resetStats
+ * \brief Sets the usage of every stage back to zero, keeping its settings.
+ */
+void SuggestionPipeline::resetStats()
+{
+    for (Stage &stage : mStages) {
+        StageStats stats;
+        stats.name = stage.stats.name;
+        stats.enabled = stage.stats.enabled;
+        stats.budgetMs = stage.stats.budgetMs;
+        stage.stats = stats;
+    }
+}
+
+/*!
+ * \fn SuggestionPipeline::invalidate
+ * \brief Drops the cached words of every stage. Must be called whenever the tables in Sources change.
+ */
+void SuggestionPipeline::invalidate()
+{
+    for (Stage &stage : mStages)
+        stage.cache.clear();
+}
+
+/*!
+ * \fn SuggestionPipeline::secondary
+ * \return trieEditDis::print5NearestEntries() of TGBook, found the first time a stage of the request asks for it
+ */
+const std::vector<std::string> &SuggestionPipeline::secondary(Request &request)
+{
+    if (!request.hasSecondary) {
+        request.secondary = mTrie.print5NearestEntries(*mSources.TGBook, request.text);
+        request.hasSecondary = true;
+    }
+    return request.secondary;
+}
+
+/*!
+ * \fn SuggestionPipeline::nearestConfirming
+ * \brief The candidate that the fewest confusions turn word into, the first one on ties.
+ * \param ok Set to false if the budget ran out before every candidate was tried
+ * \return The candidate, empty if none is confirmed
+ */
+std::string SuggestionPipeline::nearestConfirming(const std::string &word, const std::vector<std::string> &candidates,
+                                                  const Lexicon &confusions, const Budget &budget, bool *ok)
+{
+    std::string nearest;
+    int min = 100;
+    *ok = true;
+    for (size_t t = 0; t < candidates.size(); t++) {
+        if (t > 0 && budget.spent()) {
+            *ok = false;
+            break;
+        }
+        vector<string> wordConfusions;
+        vector<int> wCindex;
+        int minFactor = mSlnp.loadWConfusionsNindex1(word, candidates[t], confusions, wordConfusions, wCindex);
+        if (minFactor < min) {
+            min = minFactor;
+            nearest = candidates[t];
+        }
+    }
+    return nearest;
+}
+
+/*!
+ * \fn SuggestionPipeline::aligned
+ * \brief Words of the secondary OCR that contain the longest substrings of the word.
+ */
+bool SuggestionPipeline::aligned(Request &request, const Budget &, std::vector<std::string> &out)
+{
+    out = mTrie.print5NearestEntries(*mSources.TGBookP, request.text);
+    return true;
+}
+
+/*!
+ * \fn SuggestionPipeline::cpairs
+ * \brief The first six corrections of every CPairs entry of the word.
+ */
+bool SuggestionPipeline::cpairs(Request &request, const Budget &budget, std::vector<std::string> &out)
+{
+    PageTokenCache &tokenCache = PageTokenCache::shared();
+    size_t scanned = 0;
+    for (const auto &pair : *mSources.CPairs) {
+        if (++scanned % 256 == 0 && budget.spent())
+            return false;
+        if (tokenCache.slp1(pair.first) != request.slp1)
+            continue;
+        for (const std::string &right : pair.second) {
+            if (out.size() == 6)
+                return true;
+            out.push_back(tokenCache.slp1(tokenCache.slp1(right)));
+        }
+    }
+    return true;
+}
+
+/*!
+ * \fn SuggestionPipeline::primaryOcr
+ * \brief The nearest word of the primary OCR by edit distance.
+ */
+bool SuggestionPipeline::primaryOcr(Request &request, const Budget &budget, std::vector<std::string> &out)
+{
+    bool complete;
+    vector<string> words = mTrie.print1OCRNearestEntries(request.slp1, *mSources.vIBook,
+                                                         [&budget]() { return budget.spent(); }, &complete);
+    if (!words.empty())
+        out.push_back(PageTokenCache::shared().slp1(words[0]));
+    return complete;
+}
+
+/*!
+ * \fn SuggestionPipeline::secondaryOcr
+ * \brief The word of the secondary OCR nearest to the word by the confusions.
+ */
+bool SuggestionPipeline::secondaryOcr(Request &request, const Budget &budget, std::vector<std::string> &out)
+{
+    const std::vector<std::string> &words = secondary(request);
+    if (words.empty())
+        return true;
+    bool ok;
+    std::string nearest = nearestConfirming(request.text, words, *mSources.LexConfPmap, budget, &ok);
+    out.push_back(PageTokenCache::shared().slp1(nearest));
+    return ok;
+}
+
+/*!
+ * \fn SuggestionPipeline::pwords
+ * \brief The word of the proofread pages nearest to the word by the confusions.
+ */
+bool SuggestionPipeline::pwords(Request &request, const Budget &budget, std::vector<std::string> &out)
+{
+    vector<string> words = mTrie.print5NearestEntries(*mSources.TPWords, request.text);
+    if (words.empty())
+        return true;
+    bool ok;
+    std::string nearest = nearestConfirming(request.text, words, *mSources.LexConfPmap, budget, &ok);
+    out.push_back(PageTokenCache::shared().slp1(nearest));
+    return ok;
+}
+
+/*!
+ * \fn SuggestionPipeline::confusionPair
+ * \brief The dictionary word the confusions make of the word and its first aligned word.
+ */
+bool SuggestionPipeline::confusionPair(Request &request, const Budget &, std::vector<std::string> &out)
+{
+    string pair = mSlnp.print2OCRSugg(request.text, request.aligned[0], *mSources.LexConfPmap, *mSources.LexDict);
+    if (!pair.empty())
+        out.push_back(PageTokenCache::shared().slp1(pair));
+    return true;
+}
+
+/*!
+ * \fn SuggestionPipeline::samas
+ * \brief The word corrected as a compound of dictionary words and words of the proofread pages.
+ */
+bool SuggestionPipeline::samas(Request &request, const Budget &, std::vector<std::string> &out)
+{
+    out.push_back(mTrie.SamasBreakLRCorrect(request.slp1, *mSources.LexDict, *mSources.PWords, *mSources.TPWords,
+                                            *mSources.TPWordsP));
+    return true;
+}
+
+/*!
+ * \fn SuggestionPipeline::fontConfirming
+ * \brief The word of the secondary OCR nearest to the word by the font confusions.
+ */
+bool SuggestionPipeline::fontConfirming(Request &request, const Budget &budget, std::vector<std::string> &out)
+{
+    bool ok;
+    out.push_back(nearestConfirming(request.slp1, secondary(request), *mSources.LexConfPmapFont, budget, &ok));
+    return ok;
+}
+
+/*!
+ * \fn SuggestionPipeline::fontPair
+ * \brief confusionPair() of the word in SLP1.
+ */
+bool SuggestionPipeline::fontPair(Request &request, const Budget &, std::vector<std::string> &out)
+{
+    out.push_back(mSlnp.print2OCRSugg(request.slp1, request.aligned[0], *mSources.LexConfPmap, *mSources.LexDict));
+    return true;
+}
+
+/*!
+ * \fn SuggestionPipeline::sandhi
+ * \brief The dictionary word the top confusions and the sandhi rules make of the word.
+ */
+bool SuggestionPipeline::sandhi(Request &request, const Budget &, std::vector<std::string> &out)
+{
+    out.push_back(mSlnp.generatePossibilitesNsuggest(request.slp1, *mSources.ConfRewriter, *mSources.LexDict,
+                                                     *mSources.SRules));
+    return true;
+}
@@ -0,0 +1,124 @@
+#ifndef SUGGESTIONPIPELINE_H
+#define SUGGESTIONPIPELINE_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "confusionrewriter.h"
+#include "lexicon.h"
+#include "slpNPatternDict.h"
+#include "substringindex.h"
+#include "trieEditdis.h"
+
+class QSettings;
+
+class SuggestionPipeline
+{
+public:
+    //! The tables the stages look words up in, filled by LoadDataWorker and owned by the caller
+    struct Sources {
+        SubstringIndex *TGBookP;
+        trie *TGBook;
+        trie *TPWords;
+        SubstringIndex *TPWordsP;
+        std::vector<std::string> *vIBook;
+        std::map<std::string, int> *PWords;
+        std::map<std::string, std::set<std::string>> *CPairs;
+        Lexicon *LexDict;
+        Lexicon *LexConfPmap;
+        Lexicon *LexConfPmapFont;
+        ConfusionRewriter *ConfRewriter;
+        std::map<std::string, std::vector<std::string>> *SRules;
+    };
+
+    //! One entry of the suggestion menu
+    struct Suggestion {
+        std::string word;           //! As the stages suggested it, in SLP1
+        int votes;                  //! Number of stages that suggested it
+        size_t distance;            //! eddis::editDist() of word and the selected word in SLP1
+    };
+
+    //! A stage with its settings and its usage since the pipeline was created or the stats were reset
+    struct StageStats {
+        const char *name;
+        bool enabled;
+        int budgetMs;                       //! 0 for no budget
+        unsigned long long runs = 0;        //! Words the stage was run for
+        unsigned long long cacheHits = 0;   //! Words answered from its cache
+        unsigned long long cutShort = 0;    //! Runs that stopped at the budget, which are not cached
+        unsigned long long overBudget = 0;  //! Runs that took longer than the budget, cut short or not
+        qint64 totalNs = 0;                 //! Time spent in the runs
+        qint64 maxNs = 0;                   //! Longest run
+        unsigned long long words = 0;       //! Words suggested by the runs and the cache hits
+    };
+
+    explicit SuggestionPipeline(const Sources &sources, int maxCachedWords = 256);
+    SuggestionPipeline(const SuggestionPipeline &) = delete;
+    SuggestionPipeline &operator=(const SuggestionPipeline &) = delete;
+
+    std::vector<Suggestion> suggest(const std::string &selected, bool ocrSources, bool *aligned);
+    bool setEnabled(const QString &stage, bool enabled);
+    bool setBudget(const QString &stage, int budgetMs);
+    void loadSettings(QSettings &settings);
+    std::vector<StageStats> stats() const;
+    void resetStats();
+    void invalidate();
+
+private:
+    //! The word a suggestion is asked for, with what the stages share
+    struct Request {
+        std::string text;                   //! As selected, in UTF-8
+        std::string slp1;
+        std::vector<std::string> aligned;   //! Output of the aligned stage
+        std::vector<std::string> secondary; //! trieEditDis::print5NearestEntries() of TGBook, found once
+        bool hasSecondary = false;
+    };
+
+    //! Time a stage may still take
+    struct Budget {
+        QElapsedTimer clock;
+        qint64 ns;
+        bool spent() const { return ns > 0 && clock.nsecsElapsed() > ns; }
+    };
+
+    //! Runs a stage for a request. Returns false if it stopped at the budget.
+    typedef bool (SuggestionPipeline::*Run)(Request &request, const Budget &budget, std::vector<std::string> &out);
+
+    struct Stage {
+        StageStats stats;
+        bool ocrSource;             //! Only asked when the project is configured for the OCR sources
+        bool votes;                 //! False for the aligned stage, whose words only feed the others
+        bool cached;                //! False if the tables it reads change outside the GUI thread
+        Run run;
+        std::unordered_map<std::string, std::vector<std::string>> cache;   //! Words by selected word
+    };
+
+    Sources mSources;
+    int mMaxCachedWords;
+    std::vector<Stage> mStages;
+    slpNPatternDict mSlnp;
+    trieEditDis mTrie;
+
+    void runStage(Stage &stage, Request &request, std::vector<std::string> &out);
+    Stage *find(const QString &name);
+    const std::vector<std::string> &secondary(Request &request);
+    std::string nearestConfirming(const std::string &word, const std::vector<std::string> &candidates,
+                                  const Lexicon &confusions, const Budget &budget, bool *ok);
+
+    bool aligned(Request &request, const Budget &budget, std::vector<std::string> &out);
+    bool cpairs(Request &request, const Budget &budget, std::vector<std::string> &out);
+    bool primaryOcr(Request &request, const Budget &budget, std::vector<std::string> &out);
+    bool secondaryOcr(Request &request, const Budget &budget, std::vector<std::string> &out);
+    bool pwords(Request &request, const Budget &budget, std::vector<std::string> &out);
+    bool confusionPair(Request &request, const Budget &budget, std::vector<std::string> &out);
+    bool samas(Request &request, const Budget &budget, std::vector<std::string> &out);
+    bool fontConfirming(Request &request, const Budget &budget, std::vector<std::string> &out);
+    bool fontPair(Request &request, const Budget &budget, std::vector<std::string> &out);
+    bool sandhi(Request &request, const Budget &budget, std::vector<std::string> &out);
+};
+
+#endif // SUGGESTIONPIPELINE_H
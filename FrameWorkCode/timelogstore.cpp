@@ -0,0 +1,251 @@
+/*!
+ * \class TimeLogStore
+ * \brief Incremental store behind Comments/<role>_Timelog.json.
+ * \details The store keeps the current time of every page in memory and persists a change as one 16 byte record
+ * (key id, seconds, date/time in ms since epoch) appended to a hidden .<name>.log next to the JSON file.
+ * Key ids are positions in a second hidden .<name>.keys file that gets a line only when a page is timed for the first
+ * time, so saving a page writes 16 bytes however many pages, roles and versions the time log holds.
+ * \details compact() writes the JSON file in its existing {key: {directory, seconds, Date/Time}} layout with
+ * QSaveFile and empties both files; toJson() gives the same object without touching the disk. A record holds the
+ * page's total rather than the difference, so replaying a log that a crash left behind after compaction is harmless.
+ */
+#include "timelogstore.h"
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QtEndian>
+#include <QDebug>
+
+/*!
+ * \fn TimeLogStore::TimeLogStore
+ * \brief Constructor
+ * \param jsonPath Timelog JSON file
+ * \param compactThreshold Number of records after which record() compacts the log into the JSON file
+ */
+TimeLogStore::TimeLogStore(QString jsonPath, int compactThreshold)
+{
+    QFileInfo info(jsonPath);
+    this->mJsonPath = jsonPath;
+    this->mLogPath = info.absolutePath() + "/." + info.fileName() + ".log";
+    this->mKeysPath = info.absolutePath() + "/." + info.fileName() + ".keys";
+    this->compactThreshold = compactThreshold;
+}
+
+/*!
+ * \fn TimeLogStore::~TimeLogStore
+ * \brief Destructor. Records that were not compacted stay in the log and are read by the next open().
+ */
+TimeLogStore::~TimeLogStore()
+{
+    if (mLog.isOpen())
+        mLog.close();
+    if (mKeysFile.isOpen())
+        mKeysFile.close();
+}
+
+/*!
+ * \fn TimeLogStore::open
+ * \brief Loads the JSON file, applies the records left in the log and opens the log for appending.
+ * \return bool
+ */
+bool TimeLogStore::open()
+{
+    mEntries.clear();
+    QFile json(mJsonPath);
+    if (json.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QJsonObject mainObj = QJsonDocument::fromJson(json.readAll()).object();
+        json.close();
+        for (auto it = mainObj.constBegin(); it != mainObj.constEnd(); ++it) {
+            QJsonObject page = it.value().toObject();
+            Entry &entry = mEntries[page.value("directory").toString(it.key())];
+            entry.seconds = page.value("seconds").toInt();
+            entry.dateTime = page.value("Date/Time").toString();
+        }
+    }
+    if (!loadKeys() || !replayLog())
+        return false;
+    return openForAppend();
+}
+
+/*!
+ * \fn TimeLogStore::loadKeys
+ * \brief Reads the keys file, dropping a last line that was cut off before its newline.
+ * \return bool
+ */
+bool TimeLogStore::loadKeys()
+{
+    mKeys.clear();
+    mKeyIds.clear();
+    QFile keys(mKeysPath);
+    if (!keys.exists())
+        return true;
+    if (!keys.open(QIODevice::ReadWrite)) {
+        qDebug() << "Can't open time log keys" << mKeysPath;
+        return false;
+    }
+    QByteArray data = keys.readAll();
+    int complete = data.lastIndexOf('\n') + 1;
+    if (complete < data.size())
+        keys.resize(complete);
+    keys.close();
+    int start = 0;
+    while (start < complete) {
+        int end = data.indexOf('\n', start);
+        mKeys.append(QString::fromUtf8(data.constData() + start, end - start));
+        start = end + 1;
+    }
+    for (int i = 0; i < mKeys.size(); i++)
+        mKeyIds.insert(mKeys[i], quint32(i));
+    return true;
+}
+
+/*!
+ * \fn TimeLogStore::replayLog
+ * \brief Applies the records of the log to mEntries. A torn last record, or one whose key never reached the keys file,
+ * is cut off the log.
+ * \return bool
+ */
+bool TimeLogStore::replayLog()
+{
+    mRecords = 0;
+    QFile log(mLogPath);
+    if (!log.exists())
+        return true;
+    if (!log.open(QIODevice::ReadWrite)) {
+        qDebug() << "Can't open time log" << mLogPath;
+        return false;
+    }
+    QByteArray data = log.readAll();
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    int pos = 0;
+    for (; pos + RecordSize <= data.size(); pos += RecordSize) {
+        quint32 keyId = qFromLittleEndian<quint32>(p + pos);
+        qint32 seconds = qFromLittleEndian<qint32>(p + pos + 4);
+        qint64 msecs = qFromLittleEndian<qint64>(p + pos + 8);
+        if (keyId >= quint32(mKeys.size()))
+            break;
+        Entry &entry = mEntries[mKeys[keyId]];
+        entry.seconds = seconds;
+        entry.dateTime = QDateTime::fromMSecsSinceEpoch(msecs).toString();
+        mRecords++;
+    }
+    if (pos < data.size()) {
+        qDebug() << "Discarding torn time log record in" << mLogPath;
+        log.resize(pos);
+    }
+    log.close();
+    return true;
+}
+
+/*!
+ * \fn TimeLogStore::openForAppend
+ * \return bool
+ */
+bool TimeLogStore::openForAppend()
+{
+    mLog.setFileName(mLogPath);
+    mKeysFile.setFileName(mKeysPath);
+    if (!mLog.open(QIODevice::WriteOnly | QIODevice::Append) || !mKeysFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "Can't open time log for appending" << mLogPath;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \fn TimeLogStore::record
+ * \brief Sets the time spent on a page and appends the change to the log.
+ * \param key Page key, e.g. "Verifier:page-3.html:V-2"
+ * \param seconds Total seconds spent on the page
+ * \param when Date/time of the change
+ * \return bool
+ */
+bool TimeLogStore::record(const QString &key, int seconds, const QDateTime &when)
+{
+    if (!mLog.isOpen() && !open())
+        return false;
+
+    auto id = mKeyIds.constFind(key);
+    quint32 keyId;
+    if (id == mKeyIds.constEnd()) {
+        keyId = quint32(mKeys.size());
+        QByteArray line = key.toUtf8() + '\n';
+        if (mKeysFile.write(line) != line.size() || !mKeysFile.flush()) {
+            qDebug() << "Can't write time log keys" << mKeysPath;
+            return false;
+        }
+        mKeys.append(key);
+        mKeyIds.insert(key, keyId);
+    } else {
+        keyId = id.value();
+    }
+
+    Entry &entry = mEntries[key];
+    uchar rec[RecordSize];
+    qToLittleEndian<quint32>(keyId, rec);
+    qToLittleEndian<qint32>(seconds, rec + 4);
+    qToLittleEndian<qint64>(when.toMSecsSinceEpoch(), rec + 8);
+    if (mLog.write(reinterpret_cast<const char *>(rec), RecordSize) != RecordSize || !mLog.flush()) {
+        qDebug() << "Can't write time log" << mLogPath;
+        return false;
+    }
+    entry.seconds = seconds;
+    entry.dateTime = when.toString();
+
+    if (++mRecords >= compactThreshold)
+        compact();
+    return true;
+}
+
+/*!
+ * \fn TimeLogStore::toJson
+ * \return The current time log in the layout of the Timelog JSON file
+ */
+QJsonObject TimeLogStore::toJson() const
+{
+    QJsonObject mainObj;
+    for (auto it = mEntries.constBegin(); it != mEntries.constEnd(); ++it) {
+        QJsonObject page;
+        page["directory"] = it.key();
+        page["seconds"] = it.value().seconds;
+        page["Date/Time"] = it.value().dateTime;
+        mainObj.insert(it.key(), page);
+    }
+    return mainObj;
+}
+
+/*!
+ * \fn TimeLogStore::compact
+ * \brief Writes toJson() to the JSON file atomically and empties the log and the keys file.
+ * \return bool
+ */
+bool TimeLogStore::compact()
+{
+    if (mRecords == 0 && QFile::exists(mJsonPath))
+        return true;
+    QSaveFile json(mJsonPath);
+    if (!json.open(QIODevice::WriteOnly))
+        return false;
+    json.write(QJsonDocument(toJson()).toJson());
+    if (!json.commit()) {
+        qDebug() << "Time log compaction failed, log kept" << mJsonPath;
+        return false;
+    }
+
+    //! The log goes first: a record must never outlive the key it refers to
+    bool wasOpen = mLog.isOpen();
+    if (wasOpen) {
+        mLog.close();
+        mKeysFile.close();
+    }
+    QFile log(mLogPath);
+    if (log.exists() && !log.resize(0))
+        return false;
+    QFile keys(mKeysPath);
+    if (keys.exists() && !keys.resize(0))
+        return false;
+    mRecords = 0;
+    mKeys.clear();
+    mKeyIds.clear();
+    return wasOpen ? openForAppend() : true;
+}
@@ -0,0 +1,50 @@
+#ifndef TIMELOGSTORE_H
+#define TIMELOGSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QDateTime>
+#include <QJsonObject>
+
+class TimeLogStore {
+public:
+    struct Entry {
+        int seconds = 0;
+        QString dateTime;
+    };
+
+    explicit TimeLogStore(QString jsonPath, int compactThreshold = 1000);
+    ~TimeLogStore();
+    bool open();
+    bool record(const QString &key, int seconds, const QDateTime &when);
+    const QMap<QString, Entry> &entries() const { return mEntries; }
+    QJsonObject toJson() const;
+    bool compact();
+    QString jsonPath() const { return mJsonPath; }
+    QString logPath() const { return mLogPath; }
+    QString keysPath() const { return mKeysPath; }
+
+private:
+    //! One fixed-size record of the log, stored little-endian
+    enum { RecordSize = 16 };
+
+    QString mJsonPath;
+    QString mLogPath;
+    QString mKeysPath;
+    int compactThreshold;
+    int mRecords = 0;
+    QMap<QString, Entry> mEntries;  //! Current value of every page, i.e. the JSON file with the log applied
+    QStringList mKeys;              //! Keys the records refer to, by position in the keys file
+    QHash<QString, quint32> mKeyIds;
+    QFile mLog;
+    QFile mKeysFile;
+
+    bool loadKeys();
+    bool replayLog();
+    bool openForAppend();
+};
+
+#endif // TIMELOGSTORE_H
@@ -0,0 +1,230 @@
+/*!
+ * \class Tracer
+ * \brief Records how long the hot paths of the editor take, for "save is slow" and "right-click takes seconds" reports.
+ * \details TRACE_SCOPE("name") at the top of a function times it as one span, TRACE_SCOPE_AS(var, "name") one that
+ * TRACE_END(var) ends early. While tracing is off a span costs one relaxed atomic load; building with QPAD_NO_TRACING
+ * removes the spans altogether. Tracing is switched on with the QPAD_TRACE environment variable or from MainWindow
+ * (Ctrl+Alt+Shift+T).
+ * \details Every span updates a histogram of its name with four buckets per power of two microseconds, which gives
+ * the percentiles of summary(). The last MaxEvents spans are also kept with their thread and start time, and
+ * writeChromeTrace() exports them in the Trace Event Format that chrome://tracing and Perfetto open.
+ * \sa TraceScope
+ */
+#include "tracer.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <QtAlgorithms>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+
+std::atomic<bool> Tracer::sEnabled(false);
+
+namespace {
+
+const int MaxEvents = 200000;
+const int Buckets = 4 * 40;
+
+//! One finished span
+struct Event {
+    const char *name;
+    int thread;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+//! Durations of all spans of one name
+struct Histogram {
+    quint64 count = 0;
+    qint64 totalNs = 0;
+    qint64 maxNs = 0;
+    QVector<quint32> buckets = QVector<quint32>(Buckets, 0);
+};
+
+QMutex gMutex;
+QVector<Event> gEvents;                     //! Ring buffer of the last MaxEvents spans
+int gNextEvent = 0;
+QHash<const char *, Histogram> gHistograms;
+std::atomic<int> gThreadCount(0);
+
+//! Time base of all spans, started on first use
+const QElapsedTimer &clock()
+{
+    static const QElapsedTimer started = []() { QElapsedTimer t; t.start(); return t; }();
+    return started;
+}
+
+//! Small stable id of the calling thread, for the tid field of the trace
+int threadId()
+{
+    thread_local int id = gThreadCount.fetch_add(1) + 1;
+    return id;
+}
+
+//! Bucket of a duration: exact below 4us, then four buckets per power of two
+int bucketFor(qint64 us)
+{
+    if (us < 4)
+        return int(std::max<qint64>(us, 0));
+    int e = 63 - int(qCountLeadingZeroBits(quint64(us)));
+    int sub = int(us >> (e - 2)) - 4;
+    return std::min(4 * e + sub - 4, Buckets - 1);
+}
+
+//! Upper bound in microseconds of the durations counted in a bucket
+qint64 bucketLimit(int bucket)
+{
+    if (bucket < 4)
+        return bucket;
+    int e = bucket / 4 + 1;
+    int sub = bucket % 4;
+    return (qint64(4 + sub + 1) << (e - 2)) - 1;
+}
+
+//! Duration in ms below which fraction p of the spans of a histogram lie
+double percentile(const Histogram &h, double p)
+{
+    quint64 rank = quint64(p * (h.count - 1)) + 1;
+    quint64 seen = 0;
+    for (int b = 0; b < Buckets; b++) {
+        seen += h.buckets[b];
+        if (seen >= rank)
+            return std::min(bucketLimit(b) * 1000, h.maxNs) / 1e6;
+    }
+    return h.maxNs / 1e6;
+}
+
+QString jsonString(const char *name)
+{
+    QString s = QString::fromUtf8(name);
+    s.replace("\\", "\\\\").replace("\"", "\\\"");
+    return "\"" + s + "\"";
+}
+
+}
+
+/*!
+ * \fn Tracer::setEnabled
+ * \brief Switches tracing on or off. Spans already running when it is switched on are not recorded.
+ * \param on
+ */
+void Tracer::setEnabled(bool on)
+{
+    clock();
+    sEnabled.store(on, std::memory_order_relaxed);
+}
+
+/*!
+ * \fn Tracer::now
+ * \return Nanoseconds since the tracer's clock was started
+ */
+qint64 Tracer::now()
+{
+    return clock().nsecsElapsed();
+}
+
+/*!
+ * \fn Tracer::record
+ * \brief Adds a finished span. Called by TraceScope; safe to call from any thread.
+ * \param name String literal naming the span
+ * \param startNs
+ * \param durationNs
+ */
+void Tracer::record(const char *name, qint64 startNs, qint64 durationNs)
+{
+    int thread = threadId();
+    QMutexLocker locker(&gMutex);
+    Histogram &h = gHistograms[name];
+    h.count++;
+    h.totalNs += durationNs;
+    h.maxNs = std::max(h.maxNs, durationNs);
+    h.buckets[bucketFor(durationNs / 1000)]++;
+
+    Event e = { name, thread, startNs, durationNs };
+    if (gEvents.size() < MaxEvents)
+        gEvents.append(e);
+    else
+        gEvents[gNextEvent] = e;
+    gNextEvent = (gNextEvent + 1) % MaxEvents;
+}
+
+/*!
+ * \fn Tracer::writeChromeTrace
+ * \brief Writes the kept spans as Chrome trace JSON.
+ * \param path
+ * \return bool
+ */
+bool Tracer::writeChromeTrace(const QString &path)
+{
+    QVector<Event> events;
+    {
+        QMutexLocker locker(&gMutex);
+        events = gEvents;
+    }
+    std::sort(events.begin(), events.end(), [](const Event &a, const Event &b) { return a.startNs < b.startNs; });
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (int i = 0; i < events.size(); i++) {
+        const Event &e = events[i];
+        if (i)
+            out << ",";
+        out << "\n{\"name\":" << jsonString(e.name) << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+            << ",\"ts\":" << QString::number(e.startNs / 1000.0, 'f', 3)
+            << ",\"dur\":" << QString::number(e.durationNs / 1000.0, 'f', 3) << "}";
+    }
+    out << "\n]}\n";
+    out.flush();
+    return file.commit();
+}
+
+/*!
+ * \fn Tracer::summary
+ * \brief Formats count, total, mean, percentiles and maximum of every span name, slowest total first.
+ * \return Plain text table
+ */
+QString Tracer::summary()
+{
+    QVector<QPair<QString, Histogram>> rows;
+    {
+        QMutexLocker locker(&gMutex);
+        for (auto it = gHistograms.constBegin(); it != gHistograms.constEnd(); ++it)
+            rows.append(qMakePair(QString::fromUtf8(it.key()), it.value()));
+    }
+    std::sort(rows.begin(), rows.end(), [](const QPair<QString, Histogram> &a, const QPair<QString, Histogram> &b) {
+        return a.second.totalNs > b.second.totalNs;
+    });
+
+    QString table;
+    QTextStream out(&table);
+    out << qSetFieldWidth(36) << left << "span" << qSetFieldWidth(10) << right << "count" << "total ms" << "mean ms"
+        << "p50 ms" << "p90 ms" << "p99 ms" << "max ms" << qSetFieldWidth(0) << "\n";
+    for (const auto &row : rows) {
+        const Histogram &h = row.second;
+        out << qSetFieldWidth(36) << left << row.first << qSetFieldWidth(10) << right << h.count
+            << QString::number(h.totalNs / 1e6, 'f', 1) << QString::number(h.totalNs / 1e6 / h.count, 'f', 2)
+            << QString::number(percentile(h, 0.50), 'f', 2) << QString::number(percentile(h, 0.90), 'f', 2)
+            << QString::number(percentile(h, 0.99), 'f', 2) << QString::number(h.maxNs / 1e6, 'f', 2)
+            << qSetFieldWidth(0) << "\n";
+    }
+    out.flush();
+    return table;
+}
+
+/*!
+ * \fn Tracer::reset
+ * \brief Forgets every recorded span.
+ */
+void Tracer::reset()
+{
+    QMutexLocker locker(&gMutex);
+    gEvents.clear();
+    gNextEvent = 0;
+    gHistograms.clear();
+}
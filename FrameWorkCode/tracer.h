@@ -0,0 +1,56 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+class Tracer
+{
+public:
+    static void setEnabled(bool on);
+    static bool isEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+    static qint64 now();
+    static void record(const char *name, qint64 startNs, qint64 durationNs);
+    static bool writeChromeTrace(const QString &path);
+    static QString summary();
+    static void reset();
+
+private:
+    static std::atomic<bool> sEnabled;
+};
+
+//! Times the enclosing scope as one span while tracing is enabled. name must be a string literal.
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name)
+        : mName(name), mStart(Tracer::isEnabled() ? Tracer::now() : -1) {}
+    ~TraceScope() { end(); }
+    //! Ends the span early, e.g. before a menu waits for the user
+    void end()
+    {
+        if (mStart >= 0)
+            Tracer::record(mName, mStart, Tracer::now() - mStart);
+        mStart = -1;
+    }
+
+private:
+    const char *mName;
+    qint64 mStart;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+//! TRACE_SCOPE_AS names the span so that TRACE_END can end it early
+#ifdef QPAD_NO_TRACING
+#define TRACE_SCOPE(name)
+#define TRACE_SCOPE_AS(var, name)
+#define TRACE_END(var)
+#else
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_SCOPE_AS(var, name) TraceScope var(name)
+#define TRACE_END(var) var.end()
+#endif
+
+#endif // TRACER_H
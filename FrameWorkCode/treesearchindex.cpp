@@ -0,0 +1,188 @@
+/*!
+ * \class TreeSearchIndex
+ * \brief Flat index of the names shown in the project tree, used by the tree filter box.
+ * \details Project keeps the index next to the TreeModel: process_node(), addFile() and AddTemp() append a name
+ * whenever they add a file, also to a folder that keeps it pending until it is expanded, and removeFile() removes it
+ * again, so the index never has to walk the model. A folder with a hit is fetched before its rows are selected.
+ * \details The names of the children of each tree node are kept in row order as one '\n' separated string. A query
+ * is a QStringMatcher scan over that string, which gives the matching rows in order so that neighbouring hits are
+ * merged into one QItemSelectionRange and the whole result is applied as a single QItemSelection.
+ * \sa MainWindow::on_lineEditSearch_textChanged()
+ */
+#include "treesearchindex.h"
+#include "TreeItem.h"
+#include <QAbstractItemModel>
+#include <QStringMatcher>
+#include <algorithm>
+
+/*!
+ * \fn TreeSearchIndex::clear
+ * \brief Forgets every name, e.g. before a project is processed again.
+ */
+void TreeSearchIndex::clear()
+{
+    mGroups.clear();
+    mOrder.clear();
+}
+
+/*!
+ * \fn TreeSearchIndex::pageNumber
+ * \brief Returns the number in front of the extension of a file name, e.g. 12 for page-12.html.
+ * \param name
+ * \return Page number, -1 if the name has none
+ */
+int TreeSearchIndex::pageNumber(const QString &name)
+{
+    int end = name.indexOf('.');
+    if (end < 0)
+        end = name.size();
+    int start = end;
+    while (start > 0 && name[start - 1].isDigit())
+        start--;
+    if (start == end)
+        return -1;
+    return name.midRef(start, end - start).toInt();
+}
+
+/*!
+ * \fn TreeSearchIndex::append
+ * \brief Records a child appended to parent in the tree.
+ * \param parent
+ * \param name Display name of the child
+ */
+void TreeSearchIndex::append(TreeItem *parent, const QString &name)
+{
+    auto it = mGroups.find(parent);
+    if (it == mGroups.end()) {
+        it = mGroups.insert(parent, Group());
+        mOrder.append(parent);
+    }
+    Group &group = it.value();
+    group.names.append(name);
+    group.pages.append(pageNumber(name));
+    if (!group.dirty) {
+        group.offsets.append(group.blob.size());
+        group.blob += name;
+        group.blob += '\n';
+    }
+}
+
+/*!
+ * \fn TreeSearchIndex::remove
+ * \brief Records that the child at row of parent was removed from the tree.
+ * \param parent
+ * \param row
+ */
+void TreeSearchIndex::remove(TreeItem *parent, int row)
+{
+    auto it = mGroups.find(parent);
+    if (it == mGroups.end() || row < 0 || row >= it->names.size())
+        return;
+    it->names.removeAt(row);
+    it->pages.remove(row);
+    it->dirty = true;
+}
+
+/*!
+ * \fn TreeSearchIndex::size
+ * \return Number of names in the index
+ */
+int TreeSearchIndex::size() const
+{
+    int n = 0;
+    for (const Group &group : mGroups)
+        n += group.names.size();
+    return n;
+}
+
+/*!
+ * \fn TreeSearchIndex::rebuild
+ * \brief Joins the names of a group again after a removal.
+ * \param group
+ */
+void TreeSearchIndex::rebuild(Group &group)
+{
+    group.blob.clear();
+    group.offsets.clear();
+    group.offsets.reserve(group.names.size());
+    for (const QString &name : group.names) {
+        group.offsets.append(group.blob.size());
+        group.blob += name;
+        group.blob += '\n';
+    }
+    group.dirty = false;
+}
+
+/*!
+ * \fn TreeSearchIndex::select
+ * \brief Selects every node whose name contains text.
+ * \param model Model the index mirrors
+ * \param root Root item of the model
+ * \param text
+ * \param pageHit If text is a page number, set to the first node of that page
+ * \return QItemSelection with one range per run of consecutive matching rows
+ */
+QItemSelection TreeSearchIndex::select(QAbstractItemModel *model, TreeItem *root, const QString &text, QModelIndex *pageHit)
+{
+    QItemSelection selection;
+    if (pageHit)
+        *pageHit = QModelIndex();
+    if (text.isEmpty())
+        return selection;
+
+    int page = -1;
+    if (std::all_of(text.begin(), text.end(), [](const QChar &c) { return c.isDigit(); }))
+        page = text.toInt();
+
+    QStringMatcher matcher(text);
+    for (TreeItem *parent : mOrder) {
+        Group &group = mGroups[parent];
+        if (group.names.isEmpty())
+            continue;
+        if (group.dirty)
+            rebuild(group);
+
+        QModelIndex parentIndex;
+        if (parent != root) {
+            QVector<TreeItem *> path;
+            for (TreeItem *item = parent; item && item != root; item = item->parentItem())
+                path.prepend(item);
+            for (TreeItem *item : path)
+                parentIndex = model->index(item->row(), 0, parentIndex);
+            if (!parentIndex.isValid())
+                continue;
+        }
+
+        //! Files of a folder that was never expanded only become rows once the folder is fetched
+        if (model->canFetchMore(parentIndex) && matcher.indexIn(group.blob, 0) >= 0)
+            model->fetchMore(parentIndex);
+
+        int first = -1, last = -1;
+        int from = 0;
+        while ((from = matcher.indexIn(group.blob, from)) >= 0) {
+            int row = int(std::upper_bound(group.offsets.constBegin(), group.offsets.constEnd(), from) - group.offsets.constBegin()) - 1;
+            if (first >= 0 && row == last + 1) {
+                last = row;
+            } else {
+                if (first >= 0)
+                    selection.append(QItemSelectionRange(model->index(first, 0, parentIndex), model->index(last, 0, parentIndex)));
+                first = last = row;
+            }
+            if (row + 1 >= group.offsets.size())
+                break;
+            from = group.offsets[row + 1];
+        }
+        if (first >= 0)
+            selection.append(QItemSelectionRange(model->index(first, 0, parentIndex), model->index(last, 0, parentIndex)));
+
+        if (pageHit && page >= 0 && !pageHit->isValid()) {
+            int row = group.pages.indexOf(page);
+            if (row >= 0) {
+                if (model->canFetchMore(parentIndex))
+                    model->fetchMore(parentIndex);
+                *pageHit = model->index(row, 0, parentIndex);
+            }
+        }
+    }
+    return selection;
+}
@@ -0,0 +1,38 @@
+#ifndef TREESEARCHINDEX_H
+#define TREESEARCHINDEX_H
+
+#include <QHash>
+#include <QItemSelection>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QAbstractItemModel;
+class TreeItem;
+
+class TreeSearchIndex
+{
+public:
+    void clear();
+    void append(TreeItem *parent, const QString &name);
+    void remove(TreeItem *parent, int row);
+    int size() const;
+    QItemSelection select(QAbstractItemModel *model, TreeItem *root, const QString &text, QModelIndex *pageHit = nullptr);
+    static int pageNumber(const QString &name);
+
+private:
+    //! Names of the children of one tree node, in row order
+    struct Group {
+        QStringList names;
+        QVector<int> pages;         //! Page number of each name, -1 if it has none
+        QString blob;               //! names joined by '\n', rebuilt on the first query after a removal
+        QVector<int> offsets;       //! Start of each name in blob
+        bool dirty = false;
+    };
+    QHash<TreeItem *, Group> mGroups;
+    QVector<TreeItem *> mOrder;     //! Groups in the order they were created, i.e. tree order
+
+    static void rebuild(Group &group);
+};
+
+#endif // TREESEARCHINDEX_H
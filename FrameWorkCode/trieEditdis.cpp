@@ -161,6 +161,114 @@ string trieEditDis::searchTrie1(trie& tree, string word)
 
 
 // treeonesearch ends
+
+// substring index search
+/*!
+ * \fn trieEditDis::search_impl
+ * \brief search_impl() and search_impl1() over the automaton of a SubstringIndex, whose paths are the words
+ * \param index
+ * \param state
+ * \param ch
+ * \param last_row
+ * \param word
+ * \param path Substring spelled by the path to state, without the leading '$'
+ * \param min_str Collects the entries as search_impl() does, if not null
+ * \param min_one Keeps the last nearest entry as search_impl1() does, if not null
+ */
+void trieEditDis::search_impl(const SubstringIndex& index, int state, char ch, const vector<int>& last_row, const string& word, string& path, vector<pair<int,string>>* min_str, string* min_one)
+{
+    int sz = last_row.size();
+
+    vector<int> current_row(sz);
+    current_row[0] = last_row[0] + 1;
+
+    //! Calculate the min cost of insertion, deletion, match or substution
+    int insert_or_del, replace;
+    for (int i = 1; i < sz; ++i) {
+        insert_or_del = min(current_row[i-1] + 1, last_row[i] + 1);
+        replace = (word[i-1] == ch) ? last_row[i-1] : (last_row[i-1] + 1);
+
+        current_row[i] = min(insert_or_del, replace);
+    }
+
+    //! Every path of the automaton is a substring, so every state is an entry
+    if (current_row[sz-1] < min_cost + 1) {
+        if (min_str) min_str->push_back(make_pair(current_row[sz-1], path));
+        if (min_one) *min_one = path;
+    }
+    if (current_row[sz-1] < min_cost) min_cost = current_row[sz-1];
+
+    //! If there is an element wich is smaller than the current minimum cost, we can have another cost smaller than the current minimum cost
+    if (*min_element(current_row.begin(), current_row.end()) < min_cost) {
+        for (const pair<char, int>& t : index.transitions(state)) {
+            path.push_back(t.first);
+            search_impl(index, t.second, t.first, current_row, word, path, min_str, min_one);
+            path.pop_back();
+        }
+    }
+}
+
+/*!
+ * \fn trieEditDis::searchTrie
+ * \brief searchTrie() over the substrings of a SubstringIndex
+ * \param index
+ * \param word
+ * \return
+ */
+vector<pair<int,string>> trieEditDis::searchTrie(const SubstringIndex& index, string word)
+{   vector<pair<int,string>> min_str;
+    word = string("$") + word;
+
+    int sz = word.size();
+    min_cost = 0x3f3f3f3f;
+
+    vector<int> current_row(sz + 1);
+
+    //! Naive DP initialization
+    for (int i = 0; i < sz; ++i) current_row[i] = i;
+    current_row[sz] = sz;
+
+    //! The tries had one child of the root, '$', above the substrings
+    string path;
+    for (int i = 0 ; i < sz; ++i) {
+        if ((word[i] == '$') && !index.empty()) {
+            search_impl(index, index.root(), word[i], current_row, word, path, &min_str, nullptr);
+        }
+    }
+
+    return min_str;
+}
+
+/*!
+ * \fn trieEditDis::searchTrie1
+ * \brief searchTrie1() over the substrings of a SubstringIndex
+ * \param index
+ * \param word
+ * \return
+ */
+string trieEditDis::searchTrie1(const SubstringIndex& index, string word)
+{   string min_str;
+    word = string("$") + word;
+
+    int sz = word.size();
+    min_cost = 0x3f3f3f3f;
+
+    vector<int> current_row(sz + 1);
+
+    //! Naive DP initialization
+    for (int i = 0; i < sz; ++i) current_row[i] = i;
+    current_row[sz] = sz;
+
+    string path;
+    for (int i = 0 ; i < sz; ++i) {
+        if ((word[i] == '$') && !index.empty()) {
+            search_impl(index, index.root(), word[i], current_row, word, path, nullptr, &min_str);
+        }
+    }
+
+    return min_str;
+}
+
 void trieEditDis::loadmaptoTrie(trie& tree,map<string,int > m2){
     for( map<string,int >::const_iterator ptr=m2.begin();
          ptr!=m2.end(); ptr++) {
@@ -178,10 +286,33 @@ void trieEditDis::loadmaptoTrie(trie& tree,map<string,int > m2){
  * \return
  */
 vector<string> trieEditDis::print5NearestEntries(trie& tree,string OCRWord){
-vector<string> out;
 slpNPatternDict slnp;
 OCRWord = slnp.toslp1(OCRWord);
-vector<pair<int,string>> minGooglestr = searchTrie(tree,OCRWord);
+return nearestEntries(OCRWord, searchTrie(tree,OCRWord));
+}
+
+/*!
+ * \fn trieEditDis::print5NearestEntries
+ * \brief Same as print5NearestEntries() over a trie, for the substrings of a SubstringIndex
+ * \param index
+ * \param OCRWord
+ * \return
+ */
+vector<string> trieEditDis::print5NearestEntries(const SubstringIndex& index,string OCRWord){
+slpNPatternDict slnp;
+OCRWord = slnp.toslp1(OCRWord);
+return nearestEntries(OCRWord, searchTrie(index,OCRWord));
+}
+
+/*!
+ * \fn trieEditDis::nearestEntries
+ * \brief Picks up to 5 of the nearest entries a search found, other than OCRWord itself
+ * \param OCRWord
+ * \param minGooglestr Entries with their edit distance, as searchTrie() returns them
+ * \return
+ */
+vector<string> trieEditDis::nearestEntries(const string& OCRWord, vector<pair<int,string>> minGooglestr){
+vector<string> out;
     sort(minGooglestr.begin(), minGooglestr.end());
     bool boolFlag =0;
 
@@ -198,23 +329,27 @@ vector<pair<int,string>> minGooglestr = searchTrie(tree,OCRWord);
          if(boolFlag) {if (OCRWord != minGooglestr[i].second) out.push_back(minGooglestr[i].second); break;} //<< minGooglestr[i].first << ", " <<
     }
 return out;
-    //cout << "searchTrie(str) = " <<  << endl;
 }
 
 /*!
  * \fn trieEditDis::print1OCRNearestEntries
  * \param OCRWord
  * \param vec
+ * \param spent Asked every 256 words whether the time for the scan is up; the words nearest so far are returned then
+ * \param complete Set to false if the scan stopped at spent
  * \return
  */
-vector<string> trieEditDis::print1OCRNearestEntries(string OCRWord, vector<string> vec){
+vector<string> trieEditDis::print1OCRNearestEntries(string OCRWord, const vector<string>& vec,
+                                                    const std::function<bool()>& spent, bool* complete){
 
 vector<pair<int,string>> minIstr;
 size_t minEditDis = 100;
 size_t sz = vec.size();
+if (complete) *complete = true;
     for(size_t t =0; t< sz; t++){
-    eddis e;
-    size_t  ed = e.editDist(vec[t],OCRWord);
+    if (spent && t > 0 && t % 256 == 0 && spent()) { if (complete) *complete = false; break; }
+    //! Words further than minEditDis + 1 are never kept
+    size_t  ed = eddis::distanceAtMost(vec[t],OCRWord,minEditDis + 1);
     if (ed < minEditDis) { minEditDis = ed; minIstr.push_back(make_pair(ed, vec[t]));}
     else if(ed < minEditDis+2) minIstr.push_back(make_pair(ed, vec[t]));
     }
@@ -242,45 +377,25 @@ return out;
 
 }
 
-/*!
- * \fn trieEditDis::insertPatternsOf
- * \param str
- * \param TPWordsP
- * \param count
- * \return
- */
-bool trieEditDis::insertPatternsOf(string str, trie& TPWordsP, size_t& count){ //map<string,int >&  PWordsP
-    size_t sz = str.size();
-    if(sz == 0) return 1;
-    for(size_t i = 0; i < (sz+1); i++){
-        string s1 = str.substr(0,i);
-        TPWordsP.insert(s1); count++;//PWordsP[s1]++;
-    }
-    return insertPatternsOf(str.substr(1,sz-1),TPWordsP,count);//PWordsP
-}
-
 /*!
  * \fn trieEditDis::loadPWordsPatternstoTrie
+ * \brief Adds every substring of the words of PWords to TPWordsP
  * \param TPWordsP
  * \param PWords
- * \return
+ * \return Number of substring positions added
  */
-size_t trieEditDis::loadPWordsPatternstoTrie(trie& TPWordsP, map<string,int >& PWords){ // arg1(strt from 0) ,map<string,int >& PWordsP
-    size_t count = 0;
-
-        for( map<string,int >::const_iterator ptr=PWords.begin();
-             ptr!=PWords.end(); ptr++) {
-           insertPatternsOf(ptr->first, TPWordsP,count);
-        }
-        return count;
-    }
+size_t trieEditDis::loadPWordsPatternstoTrie(SubstringIndex& TPWordsP, map<string,int >& PWords){
+    return TPWordsP.add(PWords);
+}
 
 
 
 //!applicable when trieeditdisone is used as searchTrie will give str as output, else it give vector<string>
-string trieEditDis::SamasBreakLRCorrect(string s1, map<string, int>& m1, map<string, int>& PWordsNew,trie& tree, trie& treeP) { //unordered_
+string trieEditDis::SamasBreakLRCorrect(string s1, const Lexicon& m1, const map<string, int>& PWordsNew,trie& tree, const SubstringIndex& treeP) { //unordered_
 if((s1.size() == 0) || (s1 == "")) return "";
-if((m1[s1]>0)||PWordsNew[s1]>0) return  s1;
+//! PWords still learns words during a session, it is only looked up here
+auto inPWords = [&PWordsNew](const string& w) { auto it = PWordsNew.find(w); return it != PWordsNew.end() && it->second > 0; };
+if(m1.contains(s1)||inPWords(s1)) return  s1;
 //cout << "s1 "<< s1 << endl;
 
 for(size_t i = s1.size(); i > 0; i --){            // DASOAHAM 8
@@ -290,7 +405,7 @@ for(size_t i = s1.size(); i > 0; i --){            // DASOAHAM 8
 
     //!checking str
     //cout <<"str outside " << str << endl;
-    if((m1[str]>0)||PWordsNew[str]>0) {
+    if(m1.contains(str)||inPWords(str)) {
 
     //cout << "here "<< str << " L " << s1.substr(0,j) << "R " << s1.substr(j+i,s1.size()-i) << endl;
     //cout <<"str inside " << str << endl;
@@ -5,7 +5,10 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <functional>
 #include "slpNPatternDict.h"
+#include "substringindex.h"
+#include "lexicon.h"
 #include <cctype>
 #include <vector>
 //#include <boost/range/adaptor/reversed.hpp>
@@ -70,17 +73,26 @@ public:
 
     string searchTrie1(trie& tree, string word);
 
+    void search_impl(const SubstringIndex& index, int state, char ch, const vector<int>& last_row, const string& word, string& path, vector<pair<int,string>>* min_str, string* min_one);
+
+    vector<pair<int,string>> searchTrie(const SubstringIndex& index, string word);
+
+    string searchTrie1(const SubstringIndex& index, string word);
+
     void loadmaptoTrie(trie& tree,map<string,int > m2);
 
     vector<string> print5NearestEntries(trie& tree,string OCRWord);
 
-    vector<string> print1OCRNearestEntries(string OCRWord, vector<string> vec);
+    vector<string> print5NearestEntries(const SubstringIndex& index,string OCRWord);
+
+    static vector<string> nearestEntries(const string& OCRWord, vector<pair<int,string>> minGooglestr);
 
-    bool insertPatternsOf(string str, trie& TPWordsP, size_t& count);
+    vector<string> print1OCRNearestEntries(string OCRWord, const vector<string>& vec,
+                                           const std::function<bool()>& spent = std::function<bool()>(), bool* complete = nullptr);
 
-    size_t loadPWordsPatternstoTrie(trie& TPWordsP, map<string,int >& PWords);
+    size_t loadPWordsPatternstoTrie(SubstringIndex& TPWordsP, map<string,int >& PWords);
 
-    string SamasBreakLRCorrect(string s1, map<string, int>& m1, map<string, int>& PWordsNew,trie& tree, trie& treeP);
+    string SamasBreakLRCorrect(string s1, const Lexicon& m1, const map<string, int>& PWordsNew,trie& tree, const SubstringIndex& treeP);
 
 };
 
@@ -1,6 +1,7 @@
 #include "worker.h"
 #include "slpNPatternDict.h"
 #include "editdistance.h"
+#include "tracer.h"
 
 
 /*!
@@ -16,6 +17,9 @@
  * \param CPair_editDis
  * \param CPairs
  * \param filestructure_fw
+ * \param dict_set1
+ * \param mRole
+ * \param cpairJournal Journal of the CPair file, shared so that closing the project while addCpair() runs is safe
  */
 Worker::Worker(QObject *parent,
                Project* mProject,
@@ -28,7 +32,8 @@ Worker::Worker(QObject *parent,
                std::map<string, set<string> >* CPairs,
                map<QString, QString> filestructure_fw,
                QSet<QString>* dict_set1,
-               QString mRole
+               QString mRole,
+               QSharedPointer<CPairJournal> cpairJournal
                ) : QObject(parent)
 {
     this->CPairs = CPairs;
@@ -42,6 +47,7 @@ Worker::Worker(QObject *parent,
     this->filestructure_fw = filestructure_fw;
     this->dict_set1 = dict_set1;
     this->mRole = mRole;
+    this->cpairJournal = cpairJournal;
 }
 
 slpNPatternDict slnp;
@@ -58,6 +64,7 @@ slpNPatternDict slnp;
  */
 void Worker::doSaveBackend()
 {
+    TRACE_SCOPE("Worker::doSaveBackend");
     QVector <QString> changedWords;
     QString tempPageName = gCurrentPageName;
 
@@ -115,6 +122,9 @@ void Worker::doSaveBackend()
  * \fn Worker::addCpair
  * \brief It adds the replacements done using global-replace to the CPair.
  * \details This is done to show better suggestions to the user when he/she right clicks on a word.
+ * \details The pairs are appended to the CPair journal and the journal is compacted into the CPair file on this
+ * worker thread once it grows past its threshold.
+ * \sa CPairJournal
  */
 void Worker:: addCpair()
 {
@@ -133,79 +143,14 @@ void Worker:: addCpair()
         }
     }
 
-    //! Reflecting CPairs entries in the file /Dicts/CPair; Making it dynamic
-    QString filename12 = (*mProject).GetDir().absolutePath() + "/Dicts/" + mRole +"_CPair";
-    QFile file12(filename12);
-    QStringList split1;
-    if(!file12.exists())
+    //! Reflecting the new pairs in the file /Dicts/CPair; Making it dynamic.
+    //! Only the pairs of this replace are appended to the CPair journal, the file is never rewritten here.
+    if (cpairJournal)
     {
-        //       qDebug() << "No exist file "<<filename12;
-    }
-    else
-    {
-        QFile myfile(filename12);
-        myfile.open(QIODevice::ReadOnly | QIODevice::Text);
-        QTextStream out1(&myfile);
-        out1.setCodec("UTF-8");
-        QString text;
-        while(!out1.atEnd())
-        {
-            text = out1.readLine();
-            split1.append(text.split('\t'));
-        }
-        myfile.close();
-    }
-
-    //! Insert entries in Correct Formatting Hello (/t) hi,(comma)hiii
-    if (file12.open(QIODevice::ReadWrite  | QIODevice::Text | QIODevice::Truncate))
-    {
-        QTextStream out(&file12);
-        out.setCodec("UTF-8");
-        map<string, set<string>>::iterator itr;
-        set<string>::iterator set_it;
-        int flag = 0;
-
-        for (itr = (*CPairs).begin(); itr != (*CPairs).end(); ++itr)
-        {
-            //!Don't add special symbols to cpair file
-            QString special_symbols = "~`!@#$%^&*()-+={}[]|\"/:\ ;'<>,.?;";
-            int replaceFlag = 0;
-            for(int i=0;i<QString::fromStdString(itr->first).size();i++){
-                int count =0;
-                for(int k=0;k<special_symbols.size();k++){
-                    if(QString::fromStdString(itr->first)[i] != special_symbols[k]){
-                        count +=1;
-                    }
-                    if(count == special_symbols.size()){
-                        replaceFlag = 1;
-                        break;
-                    }
-                }
-                if(replaceFlag == 1)
-                    break;
-            }
-
-            for(int i =0;i<split1.size();i+=2){
-                if(QString::fromStdString(itr->first) == split1[i]){
-                    flag = 1;
-                    break;}
-            }
-            if(flag == 0 && replaceFlag == 1){
-                split1.append(QString::fromStdString(itr->first));
-                set_it = itr->second.begin();
-                {
-                    split1.append(QString::fromStdString(*set_it));
-
-                }
-            }
-
-            flag = 0;
-        }
-
-        //!Add entries to cpair file {hi \t hello \n}
-        for(int i=0;i<split1.size()-1;i+=2){
-            out <<  split1[i] << '\t'<<split1[i+1]<<"\n";
-        }
-        file12.close();
+        if (cpairJournal->append(CPair_editDis) < 0)
+            qDebug() << "Can't append to CPair journal" << cpairJournal->journalPath();
+        if (cpairJournal->needsCompaction())
+            cpairJournal->compact();
     }
+    emit finished();
 }
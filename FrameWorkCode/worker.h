@@ -2,7 +2,9 @@
 #define WORKER_H
 
 #include <QObject>
+#include <QSharedPointer>
 #include "Project.h"
+#include "cpairjournal.h"
 #include <set>
 
 class Worker : public QObject
@@ -20,7 +22,8 @@ public:
                     std::map<std::string, std::set<std::string> >* CPairs = nullptr,
                     std::map<QString, QString> filestructure_fw = {},
                     QSet<QString>* dict_set1 = {},
-                    QString mRole = "Corrector");
+                    QString mRole = "Corrector",
+                    QSharedPointer<CPairJournal> cpairJournal = QSharedPointer<CPairJournal>());
 
 private:
     QString gCurrentPageName;
@@ -33,6 +36,7 @@ private:
     std::map<std::string, std::set<std::string> >* CPairs;
     QSet<QString>* dict_set1;
     QString mRole;
+    QSharedPointer<CPairJournal> cpairJournal;  //! Kept alive until this worker is done, even if the project is closed
 
 signals:
     void finished();
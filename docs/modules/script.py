@@ -1,13 +1,22 @@
 class_list = [
         "AverageAccuracies",
+        "BatchRunner",
         "CommentsView",
+        "CommitQueue",
+        "ComparisonService",
+        "CompletionIndex",
+        "ConfusionRewriter",
+        "CorrectionPairMiner",
+        "CPairJournal",
         "CreateProjectPage",
         "CustomTextBrowser",
         "dashboard",
         "DiffView",
+        "DirectoryWatcher",
         "eddis",
         "edit_Distance",
         "equationeditor",
+        "EventLog",
         "Filter",
         "GlobalReplaceDialog",
         "globalReplaceInformation",
@@ -15,13 +24,18 @@ class_list = [
         "GlobalReplaceWorker",
         "HandleBbox",
         "InternDiffView",
+        "LcsAligner",
+        "Lexicon",
         "lg2_common",
         "LoadDataWorker",
         "LoadingSpinner",
         "LoginPageView",
         "MainWindow",
+        "MappedTable",
         "markRegion",
         "meanStdPage",
+        "PageQualityEstimator",
+        "PageTokenCache",
         "PDFHandling",
         "PdfRangeDialog",
         "PrintWorker",
@@ -29,13 +43,20 @@ class_list = [
         "Project",
         "ProjectHierarchyWindow",
         "ProjectWizard",
+        "ReplaceJournal",
         "ResizeImageView",
+        "SandhiChecker",
         "ShortcutGuideDialog",
         "slpNPatternDict",
+        "SubstringIndex",
+        "SuggestionPipeline",
         "SymbolsView",
         "TextFinder",
+        "TimeLogStore",
+        "Tracer",
         "TreeItem",
         "TreeModel",
+        "TreeSearchIndex",
         "trieEditDis",
         "UndoGlobalReplace",
         "VerifySet",